@@ -0,0 +1,229 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "AppRegistry.h"
+#include <algorithm>
+#include <chrono>
+#include <ctype.h>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        AppRegistry::App::App()
+            : active(false)
+            , launching(false)
+            , destroying(false)
+            , externalDestroying(false)
+            , suspendStateKnown(false)
+            , suspended(false)
+            , lastUsed(0)
+        {
+        }
+
+        AppRegistry::AppRegistry()
+            : mIndex(std::make_shared<Index>())
+        {
+        }
+
+        std::shared_ptr<const AppRegistry::Index> AppRegistry::snapshot() const
+        {
+            return std::atomic_load(&mIndex);
+        }
+
+        AppRegistry::AppPtr AppRegistry::find(const std::string& callsign) const
+        {
+            std::shared_ptr<const Index> index = snapshot();
+            Index::const_iterator it = index->find(callsign);
+            return (it != index->end()) ? it->second : AppPtr();
+        }
+
+        AppRegistry::AppPtr AppRegistry::findClient(const std::string& client) const
+        {
+            std::shared_ptr<const Index> index = snapshot();
+            Index::const_iterator it = index->find(client);
+            if (it != index->end())
+            {
+                return it->second;
+            }
+            for (it = index->begin(); it != index->end(); it++)
+            {
+                const std::string& callsign = it->first;
+                if ((callsign.size() == client.size()) && std::equal(callsign.begin(), callsign.end(), client.begin(),
+                    [](unsigned char first, unsigned char second) { return tolower(first) == tolower(second); }))
+                {
+                    return it->second;
+                }
+            }
+            return AppPtr();
+        }
+
+        std::vector<AppRegistry::AppPtr> AppRegistry::activeApps() const
+        {
+            std::shared_ptr<const Index> index = snapshot();
+            std::vector<AppPtr> apps;
+            for (Index::const_iterator it = index->begin(); it != index->end(); it++)
+            {
+                if (it->second->active)
+                {
+                    apps.push_back(it->second);
+                }
+            }
+            return apps;
+        }
+
+        bool AppRegistry::isActive(const std::string& callsign) const
+        {
+            AppPtr app = find(callsign);
+            return app && app->active;
+        }
+
+        bool AppRegistry::isBeingDestroyed(const std::string& callsign, bool includeExternal) const
+        {
+            AppPtr app = find(callsign);
+            return app && (app->destroying || (includeExternal && app->externalDestroying));
+        }
+
+        bool AppRegistry::isAnyLaunching() const
+        {
+            std::shared_ptr<const Index> index = snapshot();
+            for (Index::const_iterator it = index->begin(); it != index->end(); it++)
+            {
+                if (it->second->launching)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool AppRegistry::update(const std::string& callsign, Update apply, bool value, const std::string* className)
+        {
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+            std::shared_ptr<const Index> current = snapshot();
+            Index::const_iterator it = current->find(callsign);
+
+            std::shared_ptr<App> app = (it != current->end()) ? std::make_shared<App>(*it->second) : std::make_shared<App>();
+            app->callsign = callsign;
+            if (!apply(*app, value))
+            {
+                return false;
+            }
+            if ((nullptr != className) && app->className.empty())
+            {
+                app->className = *className;
+            }
+
+            std::shared_ptr<Index> index = std::make_shared<Index>(*current);
+            if (!app->active && !app->launching && !app->destroying && !app->externalDestroying && !app->suspendStateKnown)
+            {
+                index->erase(callsign);
+            }
+            else
+            {
+                (*index)[callsign] = app;
+            }
+            std::atomic_store(&mIndex, std::shared_ptr<const Index>(index));
+            return true;
+        }
+
+        void AppRegistry::activate(const std::string& callsign, const std::string& className)
+        {
+            update(callsign, [](App& app, bool) { app.active = true; return true; }, true, &className);
+        }
+
+        void AppRegistry::deactivate(const std::string& callsign)
+        {
+            update(callsign, [](App& app, bool) { app.active = false; app.className.clear(); return true; }, false);
+        }
+
+        bool AppRegistry::beginLaunch(const std::string& callsign)
+        {
+            return update(callsign, [](App& app, bool) {
+                if (app.destroying)
+                {
+                    return false;
+                }
+                app.launching = true;
+                return true;
+            }, true);
+        }
+
+        void AppRegistry::endLaunch(const std::string& callsign)
+        {
+            update(callsign, [](App& app, bool) { app.launching = false; return true; }, false);
+        }
+
+        bool AppRegistry::beginDestroy(const std::string& callsign)
+        {
+            return update(callsign, [](App& app, bool) {
+                if (app.launching)
+                {
+                    return false;
+                }
+                app.destroying = true;
+                return true;
+            }, true);
+        }
+
+        void AppRegistry::endDestroy(const std::string& callsign)
+        {
+            update(callsign, [](App& app, bool) { app.destroying = false; return true; }, false);
+        }
+
+        void AppRegistry::beginExternalDestroy(const std::string& callsign)
+        {
+            update(callsign, [](App& app, bool) {
+                if (!app.destroying)
+                {
+                    app.externalDestroying = true;
+                }
+                return true;
+            }, true);
+        }
+
+        void AppRegistry::endExternalDestroy(const std::string& callsign)
+        {
+            update(callsign, [](App& app, bool) { app.externalDestroying = false; return true; }, false);
+        }
+
+        void AppRegistry::setSuspended(const std::string& callsign, bool suspended)
+        {
+            update(callsign, [](App& app, bool value) { app.suspendStateKnown = true; app.suspended = value; return true; }, suspended);
+        }
+
+        void AppRegistry::resetSuspended(const std::string& callsign)
+        {
+            update(callsign, [](App& app, bool) { app.suspendStateKnown = false; app.suspended = false; return true; }, false);
+        }
+
+        void AppRegistry::touch(const std::string& callsign)
+        {
+            update(callsign, [](App& app, bool) {
+                app.lastUsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+                return true;
+            }, true);
+        }
+
+        void AppRegistry::clear()
+        {
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+            std::atomic_store(&mIndex, std::shared_ptr<const Index>(std::make_shared<Index>()));
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
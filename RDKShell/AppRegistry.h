@@ -0,0 +1,96 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <map>
+#include <stdint.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Apps known to RDKShell together with their launch, destroy and suspend state.
+        // Readers take an immutable snapshot without locking, writers copy the index and
+        // publish the new one under a mutex. Apps are kept by their callsign exactly as given,
+        // the lower case client names used by the compositor are looked up with findClient.
+        class AppRegistry
+        {
+        public:
+            struct App
+            {
+                App();
+                std::string callsign;
+                std::string className;
+                // plugin is activated and has a compositor client
+                bool active;
+                bool launching;
+                bool destroying;
+                // deactivation not requested through RDKShell.destroy
+                bool externalDestroying;
+                bool suspendStateKnown;
+                bool suspended;
+                // steady clock ms of the last launch or focus, orders apps for eviction
+                uint64_t lastUsed;
+            };
+            typedef std::shared_ptr<const App> AppPtr;
+
+            AppRegistry();
+            AppRegistry(const AppRegistry&) = delete;
+            AppRegistry& operator=(const AppRegistry&) = delete;
+
+            AppPtr find(const std::string& callsign) const;
+            // the app of a compositor client, client names are callsigns in lower case
+            AppPtr findClient(const std::string& client) const;
+            std::vector<AppPtr> activeApps() const;
+            bool isActive(const std::string& callsign) const;
+            bool isBeingDestroyed(const std::string& callsign, bool includeExternal = true) const;
+            bool isAnyLaunching() const;
+
+            void activate(const std::string& callsign, const std::string& className);
+            void deactivate(const std::string& callsign);
+            // fails while the app is being destroyed
+            bool beginLaunch(const std::string& callsign);
+            void endLaunch(const std::string& callsign);
+            // fails while the app is being launched
+            bool beginDestroy(const std::string& callsign);
+            void endDestroy(const std::string& callsign);
+            // marks a deactivation that was not requested through RDKShell
+            void beginExternalDestroy(const std::string& callsign);
+            void endExternalDestroy(const std::string& callsign);
+            void setSuspended(const std::string& callsign, bool suspended);
+            void resetSuspended(const std::string& callsign);
+            void touch(const std::string& callsign);
+            void clear();
+
+        private:
+            typedef std::map<std::string, AppPtr> Index;
+            typedef bool (*Update)(App& app, bool value);
+
+            std::shared_ptr<const Index> snapshot() const;
+            bool update(const std::string& callsign, Update apply, bool value, const std::string* className = nullptr);
+
+            std::mutex mWriteMutex;
+            std::shared_ptr<const Index> mIndex;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,294 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "TimerWheel.h"
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Tracks the state of every app on its own channel. A waiter is registered on the
+        // channel of its app and is completed by the state change it waits for, so a change
+        // only wakes the waiters of that app and a state that is passed through quickly is
+        // not missed. Asynchronous waiters get their callback on the thread that reported the
+        // state, or on the TimerWheel thread when the state did not arrive in time, callbacks
+        // must not block.
+        template <typename State>
+        class AppStateChannels
+        {
+        public:
+            typedef std::function<void(bool reached)> Callback;
+
+            explicit AppStateChannels(State unknown)
+                : mUnknown(unknown)
+                , mWaits(0)
+                , mImmediate(0)
+                , mReached(0)
+                , mTimeouts(0)
+                , mTotalWaitTime(0)
+                , mMaxWaitTime(0)
+            {
+            }
+
+            ~AppStateChannels()
+            {
+                std::vector<TimerWheel::Handle> timeouts;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    for (typename std::map<std::string, std::shared_ptr<Channel>>::iterator channel = mChannels.begin(); channel != mChannels.end(); channel++)
+                    {
+                        for (size_t i = 0; i < channel->second->waiters.size(); i++)
+                        {
+                            timeouts.push_back(channel->second->waiters[i]->timeout);
+                        }
+                    }
+                }
+                cancelTimeouts(timeouts);
+            }
+
+            AppStateChannels(const AppStateChannels&) = delete;
+            AppStateChannels& operator=(const AppStateChannels&) = delete;
+
+            State get(const std::string& app)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                typename std::map<std::string, std::shared_ptr<Channel>>::iterator channel = mChannels.find(app);
+                return (channel != mChannels.end()) ? channel->second->state : mUnknown;
+            }
+
+            void set(const std::string& app, State state)
+            {
+                std::vector<Callback> reached;
+                std::vector<TimerWheel::Handle> timeouts;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    std::shared_ptr<Channel> channel = channelFor(app);
+                    channel->state = state;
+                    bool wake = false;
+                    for (typename std::vector<std::shared_ptr<Waiter>>::iterator it = channel->waiters.begin(); it != channel->waiters.end();)
+                    {
+                        if ((*it)->state != state)
+                        {
+                            it++;
+                            continue;
+                        }
+                        complete(**it, true);
+                        if ((*it)->callback)
+                        {
+                            reached.push_back((*it)->callback);
+                            timeouts.push_back((*it)->timeout);
+                        }
+                        else
+                        {
+                            wake = true;
+                        }
+                        it = channel->waiters.erase(it);
+                    }
+                    if (wake)
+                    {
+                        channel->condition.notify_all();
+                    }
+                }
+                // the timeout callback takes mMutex, it is only waited for after releasing it
+                cancelTimeouts(timeouts);
+                for (size_t i = 0; i < reached.size(); i++)
+                {
+                    reached[i](true);
+                }
+            }
+
+            // blocks until the app reaches state, false on timeout
+            bool wait(const std::string& app, State state, uint32_t timeoutMs)
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                std::shared_ptr<Channel> channel = channelFor(app);
+                mWaits++;
+                if (channel->state == state)
+                {
+                    mImmediate++;
+                    return true;
+                }
+                std::shared_ptr<Waiter> waiter = std::make_shared<Waiter>(state, timeoutMs);
+                channel->waiters.push_back(waiter);
+                if (!channel->condition.wait_until(lock, waiter->deadline, [&waiter]() { return waiter->done; }))
+                {
+                    remove(*channel, waiter);
+                    complete(*waiter, false);
+                }
+                return waiter->reached;
+            }
+
+            // calls callback once the app reaches state or with false after timeoutMs
+            void waitAsync(const std::string& app, State state, uint32_t timeoutMs, const Callback& callback)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    std::shared_ptr<Channel> channel = channelFor(app);
+                    mWaits++;
+                    if (channel->state != state)
+                    {
+                        std::shared_ptr<Waiter> waiter = std::make_shared<Waiter>(state, timeoutMs);
+                        waiter->callback = callback;
+                        channel->waiters.push_back(waiter);
+                        waiter->timeout = TimerWheel::instance().schedule("AppStateChannels", timeoutMs, 0, std::bind(&AppStateChannels::expire, this, channel, waiter));
+                        return;
+                    }
+                    mImmediate++;
+                }
+                callback(true);
+            }
+
+            void toJson(JsonObject& stats)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                uint32_t pending = 0;
+                for (typename std::map<std::string, std::shared_ptr<Channel>>::iterator it = mChannels.begin(); it != mChannels.end(); it++)
+                {
+                    pending += it->second->waiters.size();
+                }
+                const uint32_t waited = mReached + mTimeouts;
+                stats["waits"] = mWaits;
+                stats["immediate"] = mImmediate;
+                stats["reached"] = mReached;
+                stats["timeouts"] = mTimeouts;
+                stats["pending"] = pending;
+                stats["averageWaitUs"] = (waited > 0) ? (uint32_t)(mTotalWaitTime / waited) : 0;
+                stats["maxWaitUs"] = (uint32_t)mMaxWaitTime;
+            }
+
+        private:
+            struct Waiter
+            {
+                Waiter(State waitState, uint32_t timeoutMs)
+                    : state(waitState)
+                    , start(std::chrono::steady_clock::now())
+                    , deadline(start + std::chrono::milliseconds(timeoutMs))
+                    , timeout(0)
+                    , done(false)
+                    , reached(false)
+                {
+                }
+
+                State state;
+                std::chrono::steady_clock::time_point start;
+                std::chrono::steady_clock::time_point deadline;
+                // empty for blocking waiters
+                Callback callback;
+                TimerWheel::Handle timeout;
+                bool done;
+                bool reached;
+            };
+
+            struct Channel
+            {
+                explicit Channel(State initial) : state(initial) {}
+
+                State state;
+                std::condition_variable condition;
+                std::vector<std::shared_ptr<Waiter>> waiters;
+            };
+
+            // called with mMutex held
+            std::shared_ptr<Channel> channelFor(const std::string& app)
+            {
+                std::shared_ptr<Channel>& channel = mChannels[app];
+                if (!channel)
+                {
+                    channel = std::make_shared<Channel>(mUnknown);
+                }
+                return channel;
+            }
+
+            void complete(Waiter& waiter, bool reached)
+            {
+                waiter.done = true;
+                waiter.reached = reached;
+                const uint64_t waitTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - waiter.start).count();
+                mTotalWaitTime += waitTime;
+                if (waitTime > mMaxWaitTime)
+                {
+                    mMaxWaitTime = waitTime;
+                }
+                if (reached)
+                {
+                    mReached++;
+                }
+                else
+                {
+                    mTimeouts++;
+                }
+            }
+
+            static void remove(Channel& channel, const std::shared_ptr<Waiter>& waiter)
+            {
+                for (typename std::vector<std::shared_ptr<Waiter>>::iterator it = channel.waiters.begin(); it != channel.waiters.end(); it++)
+                {
+                    if (*it == waiter)
+                    {
+                        channel.waiters.erase(it);
+                        return;
+                    }
+                }
+            }
+
+            // times out an asynchronous waiter, blocking waiters time out on their own
+            void expire(const std::shared_ptr<Channel>& channel, const std::shared_ptr<Waiter>& waiter)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (waiter->done)
+                    {
+                        return;
+                    }
+                    remove(*channel, waiter);
+                    complete(*waiter, false);
+                }
+                waiter->callback(false);
+            }
+
+            static void cancelTimeouts(const std::vector<TimerWheel::Handle>& timeouts)
+            {
+                for (size_t i = 0; i < timeouts.size(); i++)
+                {
+                    TimerWheel::instance().cancel(timeouts[i]);
+                }
+            }
+
+            const State mUnknown;
+            std::mutex mMutex;
+            std::map<std::string, std::shared_ptr<Channel>> mChannels;
+            uint32_t mWaits;
+            uint32_t mImmediate;
+            uint32_t mReached;
+            uint32_t mTimeouts;
+            uint64_t mTotalWaitTime;
+            uint64_t mMaxWaitTime;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,225 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "BulkTeardown.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        namespace {
+            uint32_t elapsedSince(const std::chrono::steady_clock::time_point& start)
+            {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+
+        BulkTeardown::BulkTeardown()
+            : mTotalTime(0)
+            , mFanOut(0)
+        {
+        }
+
+        BulkTeardown::~BulkTeardown()
+        {
+            join();
+        }
+
+        void BulkTeardown::reapStageThreads()
+        {
+            for (std::list<StageThread>::iterator it = mStageThreads.begin(); it != mStageThreads.end();)
+            {
+                if (*it->finished)
+                {
+                    it->thread.join();
+                    it = mStageThreads.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+        void BulkTeardown::join()
+        {
+            std::list<StageThread> stageThreads;
+            {
+                std::lock_guard<std::mutex> lock(mStageMutex);
+                stageThreads.swap(mStageThreads);
+            }
+            for (std::list<StageThread>::iterator it = stageThreads.begin(); it != stageThreads.end(); it++)
+            {
+                it->thread.join();
+            }
+        }
+
+        bool BulkTeardown::runStage(const Stage& stage, const std::string& callsign, uint32_t deadline, bool& timedOut)
+        {
+            timedOut = false;
+            if (!stage.action)
+            {
+                return false;
+            }
+            // a blocked controller call can not be cancelled, it is left to finish on its own
+            // thread while the app escalates to the next stage and is joined later
+            std::shared_ptr<std::promise<bool>> promise = std::make_shared<std::promise<bool>>();
+            std::future<bool> result = promise->get_future();
+            std::function<bool(const std::string&)> action = stage.action;
+            StageThread stageThread;
+            stageThread.finished = std::make_shared<std::atomic<bool>>(false);
+            std::shared_ptr<std::atomic<bool>> finished = stageThread.finished;
+            stageThread.thread = std::thread([promise, action, callsign, finished]() {
+                promise->set_value(action(callsign));
+                *finished = true;
+            });
+            {
+                std::lock_guard<std::mutex> lock(mStageMutex);
+                reapStageThreads();
+                mStageThreads.push_back(std::move(stageThread));
+            }
+            if (result.wait_for(std::chrono::milliseconds(deadline)) != std::future_status::ready)
+            {
+                timedOut = true;
+                return false;
+            }
+            return result.get();
+        }
+
+        BulkTeardown::Outcome BulkTeardown::teardown(const std::string& callsign, const std::vector<Stage>& stages, uint32_t deadline)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            Outcome outcome;
+            outcome.callsign = callsign;
+            outcome.success = false;
+            outcome.straggler = false;
+            bool firstFinalStage = true;
+            for (size_t i = 0; i < stages.size(); i++)
+            {
+                bool timedOut = false;
+                bool succeeded = runStage(stages[i], callsign, deadline, timedOut);
+                if (timedOut)
+                {
+                    outcome.timedOut.push_back(stages[i].name);
+                }
+                if (!stages[i].final)
+                {
+                    continue;
+                }
+                if (succeeded)
+                {
+                    outcome.stage = stages[i].name;
+                    outcome.success = true;
+                    break;
+                }
+                if (firstFinalStage)
+                {
+                    outcome.straggler = true;
+                    firstFinalStage = false;
+                }
+            }
+            if (!outcome.success)
+            {
+                outcome.straggler = true;
+            }
+            outcome.time = elapsedSince(start);
+            return outcome;
+        }
+
+        std::vector<BulkTeardown::Outcome> BulkTeardown::run(const std::vector<std::string>& apps, const std::vector<Stage>& stages, uint32_t fanOut, uint32_t deadline)
+        {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::vector<Outcome> outcomes(apps.size());
+            std::mutex indexMutex;
+            size_t nextApp = 0;
+            auto worker = [&]() {
+                while (true)
+                {
+                    size_t index = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(indexMutex);
+                        if (nextApp >= apps.size())
+                        {
+                            return;
+                        }
+                        index = nextApp++;
+                    }
+                    outcomes[index] = teardown(apps[index], stages, deadline);
+                }
+            };
+
+            fanOut = std::max(fanOut, 1u);
+            std::vector<std::thread> workers;
+            const size_t threads = std::min<size_t>(fanOut, apps.size());
+            for (size_t i = 1; i < threads; i++)
+            {
+                workers.push_back(std::thread(worker));
+            }
+            worker();
+            for (size_t i = 0; i < workers.size(); i++)
+            {
+                workers[i].join();
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mOutcomes = outcomes;
+            mTotalTime = elapsedSince(start);
+            mFanOut = fanOut;
+            return outcomes;
+        }
+
+        void BulkTeardown::toJson(JsonObject& report)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            JsonArray apps;
+            JsonArray stragglers;
+            for (size_t i = 0; i < mOutcomes.size(); i++)
+            {
+                const Outcome& outcome = mOutcomes[i];
+                JsonObject app;
+                app["callsign"] = outcome.callsign;
+                app["stage"] = outcome.stage;
+                app["success"] = outcome.success;
+                app["timeMs"] = outcome.time;
+                if (!outcome.timedOut.empty())
+                {
+                    JsonArray timedOut;
+                    for (size_t t = 0; t < outcome.timedOut.size(); t++)
+                    {
+                        timedOut.Add(outcome.timedOut[t]);
+                    }
+                    app["timedOut"] = timedOut;
+                }
+                apps.Add(app);
+                if (outcome.straggler)
+                {
+                    stragglers.Add(outcome.callsign);
+                }
+            }
+            report["apps"] = apps;
+            report["stragglers"] = stragglers;
+            report["totalMs"] = mTotalTime;
+            report["fanOut"] = mFanOut;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
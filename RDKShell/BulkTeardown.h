@@ -0,0 +1,95 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Tears down a set of apps, fanOut of them at a time. Every app goes through the
+        // stages in order until a final stage succeeds, a stage that fails or does not
+        // finish within the deadline escalates to the next one. Apps that needed more than
+        // their first final stage are reported as stragglers. A stage that missed its
+        // deadline keeps running on a thread owned by the teardown until join() waits for it.
+        class BulkTeardown
+        {
+        public:
+            struct Stage
+            {
+                std::string name;
+                std::function<bool(const std::string&)> action;
+                // the app is gone once a final stage succeeded
+                bool final;
+            };
+
+            struct Outcome
+            {
+                std::string callsign;
+                // stage that took the app down, empty when none did
+                std::string stage;
+                bool success;
+                bool straggler;
+                uint32_t time;
+                std::vector<std::string> timedOut;
+            };
+
+            BulkTeardown();
+            ~BulkTeardown();
+            BulkTeardown(const BulkTeardown&) = delete;
+            BulkTeardown& operator=(const BulkTeardown&) = delete;
+
+            // blocks until every app was handled, deadline is per stage in ms
+            std::vector<Outcome> run(const std::vector<std::string>& apps, const std::vector<Stage>& stages, uint32_t fanOut, uint32_t deadline);
+            // waits for the stages still running after their deadline, the actions must not
+            // be used any more once it returned
+            void join();
+            // report of the last run
+            void toJson(JsonObject& report);
+
+        private:
+            struct StageThread
+            {
+                std::thread thread;
+                std::shared_ptr<std::atomic<bool>> finished;
+            };
+
+            bool runStage(const Stage& stage, const std::string& callsign, uint32_t deadline, bool& timedOut);
+            Outcome teardown(const std::string& callsign, const std::vector<Stage>& stages, uint32_t deadline);
+            // joins the stage threads that are done, called with mStageMutex held
+            void reapStageThreads();
+
+            std::mutex mStageMutex;
+            std::list<StageThread> mStageThreads;
+            std::mutex mMutex;
+            std::vector<Outcome> mOutcomes;
+            uint32_t mTotalTime;
+            uint32_t mFanOut;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
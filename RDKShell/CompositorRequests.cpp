@@ -0,0 +1,280 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "CompositorRequests.h"
+#include <stdlib.h>
+#include <algorithm>
+#include <ctype.h>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        static std::string toLowerCase(const std::string& name)
+        {
+            std::string lowerName = name;
+            std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), [](unsigned char c){ return std::tolower(c); });
+            return lowerName;
+        }
+
+        CompositorRequests::TransactionOperation::TransactionOperation()
+            : type(BOUNDS)
+            , x(0)
+            , y(0)
+            , w(0)
+            , h(0)
+            , opacity(0)
+            , scaleX(1.0)
+            , scaleY(1.0)
+            , flag(false)
+            , hasX(false)
+            , hasY(false)
+            , hasW(false)
+            , hasH(false)
+            , hasScaleX(false)
+            , hasScaleY(false)
+        {
+        }
+
+        CompositorRequests::Animation::Animation()
+            : duration(0)
+            , x(0)
+            , y(0)
+            , w(0)
+            , h(0)
+            , scaleX(1.0)
+            , scaleY(1.0)
+            , opacity(0)
+            , delay(0)
+            , hasX(false)
+            , hasY(false)
+            , hasW(false)
+            , hasH(false)
+            , hasScaleX(false)
+            , hasScaleY(false)
+            , hasOpacity(false)
+            , hasTween(false)
+            , hasDelay(false)
+        {
+        }
+
+        double CompositorRequests::Animation::length() const
+        {
+            return duration + (hasDelay ? delay : 0);
+        }
+
+        bool CompositorRequests::parseNumber(const JsonObject& object, const char* label, double& value)
+        {
+            const std::string text = object[label].String();
+            char* end = nullptr;
+            value = strtod(text.c_str(), &end);
+            return !text.empty() && (end != nullptr) && (*end == '\0');
+        }
+
+        bool CompositorRequests::parseTransactionOperation(const JsonObject& entry, TransactionOperation& operation, std::string& message)
+        {
+            if (!entry.HasLabel("method"))
+            {
+                message = "please specify method";
+                return false;
+            }
+            if (!entry.HasLabel("client") && !entry.HasLabel("callsign"))
+            {
+                message = "please specify client";
+                return false;
+            }
+            const std::string method = entry["method"].String();
+            operation = TransactionOperation();
+            operation.client = toLowerCase(entry.HasLabel("client") ? entry["client"].String() : entry["callsign"].String());
+
+            if (method == "setBounds")
+            {
+                operation.type = TransactionOperation::BOUNDS;
+                operation.hasX = entry.HasLabel("x");
+                operation.hasY = entry.HasLabel("y");
+                operation.hasW = entry.HasLabel("w");
+                operation.hasH = entry.HasLabel("h");
+                if (operation.hasX)
+                {
+                    operation.x = entry["x"].Number();
+                }
+                if (operation.hasY)
+                {
+                    operation.y = entry["y"].Number();
+                }
+                if (operation.hasW)
+                {
+                    operation.w = entry["w"].Number();
+                }
+                if (operation.hasH)
+                {
+                    operation.h = entry["h"].Number();
+                }
+            }
+            else if (method == "setOpacity")
+            {
+                if (!entry.HasLabel("opacity"))
+                {
+                    message = "please specify opacity";
+                    return false;
+                }
+                operation.type = TransactionOperation::OPACITY;
+                operation.opacity = entry["opacity"].Number();
+            }
+            else if (method == "setScale")
+            {
+                if (!entry.HasLabel("sx") && !entry.HasLabel("sy"))
+                {
+                    message = "please specify sx and/or sy";
+                    return false;
+                }
+                operation.type = TransactionOperation::SCALE;
+                operation.hasScaleX = entry.HasLabel("sx");
+                operation.hasScaleY = entry.HasLabel("sy");
+                if (operation.hasScaleX && !parseNumber(entry, "sx", operation.scaleX))
+                {
+                    message = "invalid sx";
+                    return false;
+                }
+                if (operation.hasScaleY && !parseNumber(entry, "sy", operation.scaleY))
+                {
+                    message = "invalid sy";
+                    return false;
+                }
+            }
+            else if (method == "setVisibility")
+            {
+                if (!entry.HasLabel("visible"))
+                {
+                    message = "please specify visibility (visible = true/false)";
+                    return false;
+                }
+                operation.type = TransactionOperation::VISIBILITY;
+                operation.flag = entry["visible"].Boolean();
+            }
+            else if (method == "setHolePunch")
+            {
+                if (!entry.HasLabel("holePunch"))
+                {
+                    message = "please specify hole punch (holePunch = true/false)";
+                    return false;
+                }
+                operation.type = TransactionOperation::HOLE_PUNCH;
+                operation.flag = entry["holePunch"].Boolean();
+            }
+            else if (method == "moveToFront")
+            {
+                operation.type = TransactionOperation::MOVE_TO_FRONT;
+            }
+            else if (method == "moveToBack")
+            {
+                operation.type = TransactionOperation::MOVE_TO_BACK;
+            }
+            else if (method == "moveBehind")
+            {
+                if (!entry.HasLabel("target"))
+                {
+                    message = "please specify target";
+                    return false;
+                }
+                operation.type = TransactionOperation::MOVE_BEHIND;
+                operation.target = toLowerCase(entry["target"].String());
+            }
+            else
+            {
+                message = "unsupported method " + method;
+                return false;
+            }
+            return true;
+        }
+
+        bool CompositorRequests::parseAnimation(const JsonObject& entry, Animation& animation, std::vector<std::string>& invalidFields, std::string& message)
+        {
+            if (!entry.HasLabel("client") || !entry.HasLabel("duration"))
+            {
+                message = "please specify client and duration";
+                return false;
+            }
+            animation = Animation();
+            animation.client = entry["client"].String();
+            if (!parseNumber(entry, "duration", animation.duration))
+            {
+                message = "invalid duration";
+                return false;
+            }
+            if (entry.HasLabel("x"))
+            {
+                animation.x = entry["x"].Number();
+                animation.hasX = true;
+            }
+            if (entry.HasLabel("y"))
+            {
+                animation.y = entry["y"].Number();
+                animation.hasY = true;
+            }
+            if (entry.HasLabel("w"))
+            {
+                animation.w = entry["w"].Number();
+                animation.hasW = true;
+            }
+            if (entry.HasLabel("h"))
+            {
+                animation.h = entry["h"].Number();
+                animation.hasH = true;
+            }
+            if (entry.HasLabel("sx"))
+            {
+                animation.hasScaleX = parseNumber(entry, "sx", animation.scaleX);
+                if (!animation.hasScaleX)
+                {
+                    animation.scaleX = 1.0;
+                    invalidFields.push_back("sx");
+                }
+            }
+            if (entry.HasLabel("sy"))
+            {
+                animation.hasScaleY = parseNumber(entry, "sy", animation.scaleY);
+                if (!animation.hasScaleY)
+                {
+                    animation.scaleY = 1.0;
+                    invalidFields.push_back("sy");
+                }
+            }
+            if (entry.HasLabel("a"))
+            {
+                animation.opacity = entry["a"].Number();
+                animation.hasOpacity = true;
+            }
+            if (entry.HasLabel("tween"))
+            {
+                animation.tween = entry["tween"].String();
+                animation.hasTween = true;
+            }
+            if (entry.HasLabel("delay"))
+            {
+                animation.hasDelay = parseNumber(entry, "delay", animation.delay);
+                if (!animation.hasDelay)
+                {
+                    animation.delay = 0;
+                    invalidFields.push_back("delay");
+                }
+            }
+            return true;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
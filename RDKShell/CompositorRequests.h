@@ -0,0 +1,77 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Parameters of compositor requests, read and validated before the rdkshell mutex is
+        // taken. Transaction client names are lower cased like the compositor keeps them,
+        // looking the clients up and applying the request is left to the caller.
+        class CompositorRequests
+        {
+        public:
+            struct TransactionOperation
+            {
+                TransactionOperation();
+                enum Type { BOUNDS, OPACITY, SCALE, VISIBILITY, HOLE_PUNCH, MOVE_TO_FRONT, MOVE_TO_BACK, MOVE_BEHIND };
+                Type type;
+                std::string client;
+                std::string target;
+                unsigned int x, y, w, h;
+                unsigned int opacity;
+                double scaleX, scaleY;
+                bool flag;
+                // which of x, y, w, h, sx and sy were given, the others keep the current value
+                bool hasX, hasY, hasW, hasH, hasScaleX, hasScaleY;
+            };
+
+            struct Animation
+            {
+                Animation();
+                std::string client;
+                // in seconds, like the delay
+                double duration;
+                int32_t x, y;
+                uint32_t w, h;
+                double scaleX, scaleY;
+                uint32_t opacity;
+                std::string tween;
+                double delay;
+                // which properties were given, only those are animated
+                bool hasX, hasY, hasW, hasH, hasScaleX, hasScaleY, hasOpacity, hasTween, hasDelay;
+                // duration plus delay
+                double length() const;
+            };
+
+            // numbers that may be given as numbers or as strings
+            static bool parseNumber(const JsonObject& object, const char* label, double& value);
+            // reads and validates one applyTransaction entry
+            static bool parseTransactionOperation(const JsonObject& entry, TransactionOperation& operation, std::string& message);
+            // reads one addAnimation entry, optional fields that are not valid numbers are left out
+            // and named in invalidFields, the caller decides whether the animation is still added
+            static bool parseAnimation(const JsonObject& entry, Animation& animation, std::vector<std::string>& invalidFields, std::string& message);
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
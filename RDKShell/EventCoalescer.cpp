@@ -0,0 +1,234 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "EventCoalescer.h"
+#include <algorithm>
+#include <chrono>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        EventCoalescer::EventCoalescer()
+            : mRunning(false)
+            , mReceived(0)
+            , mSent(0)
+            , mCoalesced(0)
+        {
+        }
+
+        EventCoalescer::~EventCoalescer()
+        {
+            stop();
+        }
+
+        uint64_t EventCoalescer::now()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void EventCoalescer::start(const Sender& sender)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mRunning)
+            {
+                return;
+            }
+            mSender = sender;
+            mRunning = true;
+            mThread = std::thread(&EventCoalescer::run, this);
+        }
+
+        void EventCoalescer::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mRunning)
+                {
+                    return;
+                }
+                mRunning = false;
+                mCondition.notify_all();
+            }
+            mThread.join();
+            std::lock_guard<std::mutex> sendLock(mSendMutex);
+            flush(true);
+            std::lock_guard<std::mutex> lock(mMutex);
+            mSender = Sender();
+        }
+
+        void EventCoalescer::setRules(const std::vector<Rule>& rules)
+        {
+            std::lock_guard<std::mutex> sendLock(mSendMutex);
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mRules.clear();
+                for (size_t i = 0; i < rules.size(); i++)
+                {
+                    mRules[rules[i].event] = rules[i];
+                }
+            }
+            // events held back under the old rules go out now
+            flush(true);
+        }
+
+        std::vector<EventCoalescer::Rule> EventCoalescer::rules()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::vector<Rule> rules;
+            for (std::map<std::string, Rule>::iterator it = mRules.begin(); it != mRules.end(); it++)
+            {
+                rules.push_back(it->second);
+            }
+            return rules;
+        }
+
+        bool EventCoalescer::dispatch(const std::string& event, const JsonObject& parameters)
+        {
+            std::unique_lock<std::mutex> sendLock(mSendMutex);
+            std::unique_lock<std::mutex> lock(mMutex);
+            mReceived++;
+            if (!mRunning)
+            {
+                mSent++;
+                return false;
+            }
+            std::map<std::string, Rule>::iterator rule = mRules.find(event);
+            if ((rule == mRules.end()) || (rule->second.window == 0))
+            {
+                // whatever was held back was raised before this event
+                lock.unlock();
+                flush(true);
+                lock.lock();
+                mSent++;
+                Sender sender = mSender;
+                lock.unlock();
+                sender(event, parameters);
+                return true;
+            }
+            sendLock.unlock();
+            std::string pendingKey = event;
+            if (!rule->second.key.empty() && parameters.HasLabel(rule->second.key.c_str()))
+            {
+                pendingKey += "/" + parameters[rule->second.key.c_str()].String();
+            }
+            std::map<std::string, Pending>::iterator pending = mPending.find(pendingKey);
+            if (pending != mPending.end())
+            {
+                // latest value wins, the deadline of the first event is kept so a
+                // steady stream still goes out once per window
+                pending->second.parameters = parameters;
+                mCoalesced++;
+            }
+            else
+            {
+                Pending& entry = mPending[pendingKey];
+                entry.event = event;
+                entry.parameters = parameters;
+                entry.deadline = now() + rule->second.window;
+                mCondition.notify_all();
+            }
+            return true;
+        }
+
+        void EventCoalescer::run()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mRunning)
+            {
+                if (mPending.empty())
+                {
+                    mCondition.wait(lock);
+                    continue;
+                }
+                uint64_t deadline = mPending.begin()->second.deadline;
+                for (std::map<std::string, Pending>::iterator it = mPending.begin(); it != mPending.end(); it++)
+                {
+                    deadline = std::min(deadline, it->second.deadline);
+                }
+                uint64_t currentTime = now();
+                if (deadline > currentTime)
+                {
+                    mCondition.wait_for(lock, std::chrono::milliseconds(deadline - currentTime));
+                    continue;
+                }
+                lock.unlock();
+                {
+                    std::lock_guard<std::mutex> sendLock(mSendMutex);
+                    flush(false);
+                }
+                lock.lock();
+            }
+        }
+
+        // called with mSendMutex held
+        void EventCoalescer::flush(bool all)
+        {
+            std::vector<Pending> due;
+            Sender sender;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                const uint64_t currentTime = now();
+                for (std::map<std::string, Pending>::iterator it = mPending.begin(); it != mPending.end();)
+                {
+                    if (all || (it->second.deadline <= currentTime))
+                    {
+                        due.push_back(it->second);
+                        it = mPending.erase(it);
+                    }
+                    else
+                    {
+                        it++;
+                    }
+                }
+                mSent += due.size();
+                sender = mSender;
+            }
+            if (!sender)
+            {
+                return;
+            }
+            for (size_t i = 0; i < due.size(); i++)
+            {
+                sender(due[i].event, due[i].parameters);
+            }
+        }
+
+        void EventCoalescer::toJson(JsonObject& status)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            JsonArray events;
+            for (std::map<std::string, Rule>::iterator it = mRules.begin(); it != mRules.end(); it++)
+            {
+                JsonObject rule;
+                rule["event"] = it->second.event;
+                rule["window"] = it->second.window;
+                if (!it->second.key.empty())
+                {
+                    rule["key"] = it->second.key;
+                }
+                events.Add(rule);
+            }
+            status["events"] = events;
+            status["received"] = mReceived;
+            status["sent"] = mSent;
+            status["coalesced"] = mCoalesced;
+            status["pending"] = (uint32_t)mPending.size();
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,94 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Holds back state-type events for a short window and only sends the latest value,
+        // so bursts during animations and launches reach subscribers as a single event.
+        // Events can be coalesced per value of one of their parameters, e.g. per client.
+        // While running, all events go out through the coalescer. An event without a rule
+        // first sends everything held back, so subscribers see events in the order they
+        // were raised.
+        class EventCoalescer
+        {
+        public:
+            struct Rule
+            {
+                std::string event;
+                uint32_t window;
+                // parameter that keeps events apart, empty to coalesce all of them
+                std::string key;
+            };
+            // sends the events that were held back
+            typedef std::function<void(const std::string&, const JsonObject&)> Sender;
+
+            EventCoalescer();
+            ~EventCoalescer();
+            EventCoalescer(const EventCoalescer&) = delete;
+            EventCoalescer& operator=(const EventCoalescer&) = delete;
+
+            void start(const Sender& sender);
+            // sends what is still held back
+            void stop();
+            void setRules(const std::vector<Rule>& rules);
+            std::vector<Rule> rules();
+            // sends or holds back the event, returns false when not running and the caller has to send it
+            bool dispatch(const std::string& event, const JsonObject& parameters);
+            void toJson(JsonObject& status);
+
+        private:
+            struct Pending
+            {
+                std::string event;
+                JsonObject parameters;
+                uint64_t deadline;
+            };
+
+            void run();
+            void flush(bool all);
+            static uint64_t now();
+
+            // held while sending, keeps the events in order, taken before mMutex
+            std::mutex mSendMutex;
+            std::mutex mMutex;
+            std::condition_variable mCondition;
+            std::thread mThread;
+            Sender mSender;
+            std::map<std::string, Rule> mRules;
+            // keyed by event and coalescing key value
+            std::map<std::string, Pending> mPending;
+            bool mRunning;
+            uint32_t mReceived;
+            uint32_t mSent;
+            uint32_t mCoalesced;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
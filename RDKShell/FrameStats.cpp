@@ -0,0 +1,288 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "FrameStats.h"
+#include <algorithm>
+#include <fstream>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // upper bounds in microseconds, the last bucket collects everything above
+        static const double sBucketLimits[] = { 250, 500, 1000, 2000, 4000, 8000, 16667, 33333, 66667, 133333, 266667, 0 };
+        static const char* sBucketNames[] = { "250us", "500us", "1ms", "2ms", "4ms", "8ms", "16ms", "33ms", "66ms", "133ms", "266ms", "max" };
+
+        FrameStats::Frame::Frame()
+            : frameNumber(0)
+            , startTime(0)
+            , createDisplayRequests(0)
+            , killClientRequests(0)
+            , flagRequests(0)
+            , tasks(0)
+            , screenshot(false)
+            , missedDeadline(false)
+        {
+            for (int i = 0; i < PHASE_COUNT; i++)
+            {
+                phaseTime[i] = 0;
+            }
+        }
+
+        FrameStats::FrameStats()
+            : mRecentFramesIndex(0)
+        {
+            mRecentFrames.resize(RECENT_FRAMES);
+            reset();
+        }
+
+        const char* FrameStats::phaseName(Phase phase)
+        {
+            switch (phase)
+            {
+                case REQUESTS: return "requests";
+                case DRAW: return "draw";
+                case SCREENSHOT: return "screenshot";
+                case UPDATE: return "update";
+                case TASKS: return "tasks";
+                case FRAME: return "frame";
+                default: return "unknown";
+            }
+        }
+
+        int FrameStats::bucketIndex(double time)
+        {
+            for (int i = 0; i < HISTOGRAM_BUCKETS - 1; i++)
+            {
+                if (time < sBucketLimits[i])
+                {
+                    return i;
+                }
+            }
+            return HISTOGRAM_BUCKETS - 1;
+        }
+
+        void FrameStats::record(Frame& frame, double frameBudget)
+        {
+            frame.frameNumber = mFrames.fetch_add(1, std::memory_order_relaxed) + 1;
+            frame.missedDeadline = (frame.phaseTime[FRAME] > frameBudget);
+            if (frame.missedDeadline)
+            {
+                mMissedDeadlines.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            for (int i = 0; i < PHASE_COUNT; i++)
+            {
+                if ((i == SCREENSHOT) && !frame.screenshot)
+                {
+                    continue;
+                }
+                PhaseStats& phase = mPhases[i];
+                uint32_t time = (frame.phaseTime[i] > 0) ? (uint32_t)frame.phaseTime[i] : 0;
+                phase.count.fetch_add(1, std::memory_order_relaxed);
+                phase.totalTime.fetch_add(time, std::memory_order_relaxed);
+                if (time > phase.maxTime.load(std::memory_order_relaxed))
+                {
+                    phase.maxTime.store(time, std::memory_order_relaxed);
+                }
+                phase.buckets[bucketIndex(frame.phaseTime[i])].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // only frames that did not meet the deadline need the lock
+            if (frame.missedDeadline && mFramesMutex.try_lock())
+            {
+                if (mSlowestFrames.size() < SLOWEST_FRAMES)
+                {
+                    mSlowestFrames.push_back(frame);
+                }
+                else
+                {
+                    std::vector<Frame>::iterator fastest = mSlowestFrames.begin();
+                    for (std::vector<Frame>::iterator it = mSlowestFrames.begin(); it != mSlowestFrames.end(); it++)
+                    {
+                        if (it->phaseTime[FRAME] < fastest->phaseTime[FRAME])
+                        {
+                            fastest = it;
+                        }
+                    }
+                    if (fastest->phaseTime[FRAME] < frame.phaseTime[FRAME])
+                    {
+                        *fastest = frame;
+                    }
+                }
+                mFramesMutex.unlock();
+            }
+
+            if (mFramesMutex.try_lock())
+            {
+                mRecentFrames[mRecentFramesIndex] = frame;
+                mRecentFramesIndex = (mRecentFramesIndex + 1) % RECENT_FRAMES;
+                mFramesMutex.unlock();
+            }
+        }
+
+        void FrameStats::reset()
+        {
+            mFrames.store(0);
+            mMissedDeadlines.store(0);
+            for (int i = 0; i < PHASE_COUNT; i++)
+            {
+                PhaseStats& phase = mPhases[i];
+                phase.count.store(0);
+                phase.totalTime.store(0);
+                phase.maxTime.store(0);
+                for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+                {
+                    phase.buckets[b].store(0);
+                }
+            }
+            std::lock_guard<std::mutex> lock(mFramesMutex);
+            mSlowestFrames.clear();
+            std::fill(mRecentFrames.begin(), mRecentFrames.end(), Frame());
+            mRecentFramesIndex = 0;
+        }
+
+        void FrameStats::toJson(JsonObject& stats)
+        {
+            stats["frames"] = mFrames.load(std::memory_order_relaxed);
+            stats["missedDeadlines"] = mMissedDeadlines.load(std::memory_order_relaxed);
+
+            JsonObject phases;
+            for (int i = 0; i < PHASE_COUNT; i++)
+            {
+                PhaseStats& phase = mPhases[i];
+                JsonObject phaseInfo;
+                uint32_t count = phase.count.load(std::memory_order_relaxed);
+                uint32_t buckets[HISTOGRAM_BUCKETS];
+                for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+                {
+                    buckets[b] = phase.buckets[b].load(std::memory_order_relaxed);
+                }
+
+                // percentiles are reported as the upper bound of the bucket they fall into
+                uint32_t p50 = 0, p99 = 0, seen = 0;
+                bool p50Found = false, p99Found = false;
+                JsonObject histogram;
+                for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+                {
+                    histogram[sBucketNames[b]] = buckets[b];
+                    seen += buckets[b];
+                    uint32_t limit = (b < HISTOGRAM_BUCKETS - 1) ? (uint32_t)sBucketLimits[b] : phase.maxTime.load(std::memory_order_relaxed);
+                    if (!p50Found && count > 0 && seen * 2 >= count)
+                    {
+                        p50 = limit;
+                        p50Found = true;
+                    }
+                    if (!p99Found && count > 0 && seen * 100 >= count * 99)
+                    {
+                        p99 = limit;
+                        p99Found = true;
+                    }
+                }
+
+                phaseInfo["count"] = count;
+                phaseInfo["averageUs"] = (count > 0) ? (uint32_t)(phase.totalTime.load(std::memory_order_relaxed) / count) : 0;
+                phaseInfo["maxUs"] = phase.maxTime.load(std::memory_order_relaxed);
+                phaseInfo["p50Us"] = p50;
+                phaseInfo["p99Us"] = p99;
+                phaseInfo["histogram"] = histogram;
+                phases[phaseName((Phase)i)] = phaseInfo;
+            }
+            stats["phases"] = phases;
+
+            std::vector<Frame> slowestFrames;
+            {
+                std::lock_guard<std::mutex> lock(mFramesMutex);
+                slowestFrames = mSlowestFrames;
+            }
+            std::sort(slowestFrames.begin(), slowestFrames.end(), [](const Frame& a, const Frame& b) {
+                return a.phaseTime[FRAME] > b.phaseTime[FRAME];
+            });
+            JsonArray slowest;
+            for (size_t i = 0; i < slowestFrames.size(); i++)
+            {
+                const Frame& frame = slowestFrames[i];
+                JsonObject frameInfo;
+                frameInfo["frame"] = frame.frameNumber;
+                for (int p = 0; p < PHASE_COUNT; p++)
+                {
+                    frameInfo[(std::string(phaseName((Phase)p)) + "Us").c_str()] = (uint32_t)frame.phaseTime[p];
+                }
+                frameInfo["createDisplayRequests"] = frame.createDisplayRequests;
+                frameInfo["killClientRequests"] = frame.killClientRequests;
+                frameInfo["flagRequests"] = frame.flagRequests;
+                frameInfo["tasks"] = frame.tasks;
+                frameInfo["screenshot"] = frame.screenshot;
+                slowest.Add(frameInfo);
+            }
+            stats["slowestFrames"] = slowest;
+        }
+
+        bool FrameStats::writeChromeTrace(const std::string& path)
+        {
+            std::vector<Frame> recentFrames;
+            {
+                std::lock_guard<std::mutex> lock(mFramesMutex);
+                for (size_t i = 0; i < RECENT_FRAMES; i++)
+                {
+                    const Frame& frame = mRecentFrames[(mRecentFramesIndex + i) % RECENT_FRAMES];
+                    if (frame.frameNumber > 0)
+                    {
+                        recentFrames.push_back(frame);
+                    }
+                }
+            }
+
+            std::ofstream trace(path.c_str(), std::ios::out | std::ios::trunc);
+            if (!trace.is_open())
+            {
+                return false;
+            }
+
+            // chrome://tracing "complete" events, phases are laid out back to back inside each frame
+            trace << "{\"traceEvents\":[";
+            bool first = true;
+            for (size_t i = 0; i < recentFrames.size(); i++)
+            {
+                const Frame& frame = recentFrames[i];
+                trace << (first ? "" : ",") << "{\"name\":\"frame " << frame.frameNumber << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+                      << ",\"ts\":" << (uint64_t)frame.startTime << ",\"dur\":" << (uint64_t)frame.phaseTime[FRAME]
+                      << ",\"args\":{\"createDisplayRequests\":" << frame.createDisplayRequests
+                      << ",\"killClientRequests\":" << frame.killClientRequests
+                      << ",\"flagRequests\":" << frame.flagRequests
+                      << ",\"tasks\":" << frame.tasks
+                      << ",\"missedDeadline\":" << (frame.missedDeadline ? "true" : "false") << "}}";
+                first = false;
+                double phaseStart = frame.startTime;
+                for (int p = 0; p < FRAME; p++)
+                {
+                    if (frame.phaseTime[p] <= 0)
+                    {
+                        continue;
+                    }
+                    trace << ",{\"name\":\"" << phaseName((Phase)p) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+                          << ",\"ts\":" << (uint64_t)phaseStart << ",\"dur\":" << (uint64_t)frame.phaseTime[p] << "}";
+                    phaseStart += frame.phaseTime[p];
+                }
+            }
+            trace << "]}";
+            trace.close();
+            return true;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,97 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Per phase timing of the RDKShell render loop. Only the render thread records
+        // frames, histogram and counters are atomics so getFrameStats never blocks it.
+        class FrameStats
+        {
+        public:
+            enum Phase
+            {
+                REQUESTS = 0,
+                DRAW,
+                SCREENSHOT,
+                UPDATE,
+                TASKS,
+                FRAME,
+                PHASE_COUNT
+            };
+
+            struct Frame
+            {
+                Frame();
+                uint32_t frameNumber;
+                double startTime;
+                double phaseTime[PHASE_COUNT];
+                uint32_t createDisplayRequests;
+                uint32_t killClientRequests;
+                uint32_t flagRequests;
+                uint32_t tasks;
+                bool screenshot;
+                bool missedDeadline;
+            };
+
+            FrameStats();
+            FrameStats(const FrameStats&) = delete;
+            FrameStats& operator=(const FrameStats&) = delete;
+
+            void record(Frame& frame, double frameBudget);
+            void reset();
+            void toJson(JsonObject& stats);
+            bool writeChromeTrace(const std::string& path);
+
+            static const char* phaseName(Phase phase);
+
+        private:
+            static const int HISTOGRAM_BUCKETS = 12;
+            static const size_t SLOWEST_FRAMES = 10;
+            static const size_t RECENT_FRAMES = 256;
+
+            struct PhaseStats
+            {
+                std::atomic<uint32_t> count;
+                std::atomic<uint64_t> totalTime;
+                std::atomic<uint32_t> maxTime;
+                std::atomic<uint32_t> buckets[HISTOGRAM_BUCKETS];
+            };
+
+            static int bucketIndex(double time);
+
+            std::atomic<uint32_t> mFrames;
+            std::atomic<uint32_t> mMissedDeadlines;
+            PhaseStats mPhases[PHASE_COUNT];
+
+            std::mutex mFramesMutex;
+            std::vector<Frame> mSlowestFrames;
+            std::vector<Frame> mRecentFrames;
+            size_t mRecentFramesIndex;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
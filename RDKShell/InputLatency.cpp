@@ -0,0 +1,245 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "InputLatency.h"
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // upper bounds in microseconds, the last bucket collects everything above
+        static const double sBucketLimits[] = { 250, 500, 1000, 2000, 4000, 8000, 16667, 33333, 66667, 133333, 266667, 0 };
+        static const char* sBucketNames[] = { "250us", "500us", "1ms", "2ms", "4ms", "8ms", "16ms", "33ms", "66ms", "133ms", "266ms", "max" };
+
+        InputLatency::Histogram::Histogram()
+            : count(0)
+            , totalTime(0)
+            , maxTime(0)
+        {
+            for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+            {
+                buckets[b] = 0;
+            }
+        }
+
+        void InputLatency::Histogram::add(double time)
+        {
+            if (time < 0)
+            {
+                time = 0;
+            }
+            count++;
+            totalTime += time;
+            if (time > maxTime)
+            {
+                maxTime = time;
+            }
+            buckets[bucketIndex(time)]++;
+        }
+
+        void InputLatency::Histogram::toJson(JsonObject& stage) const
+        {
+            // percentiles are reported as the upper bound of the bucket they fall into
+            uint32_t p50 = 0, p99 = 0, seen = 0;
+            bool p50Found = false, p99Found = false;
+            JsonObject histogram;
+            for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+            {
+                histogram[sBucketNames[b]] = buckets[b];
+                seen += buckets[b];
+                uint32_t limit = (b < HISTOGRAM_BUCKETS - 1) ? (uint32_t)sBucketLimits[b] : (uint32_t)maxTime;
+                if (!p50Found && count > 0 && seen * 2 >= count)
+                {
+                    p50 = limit;
+                    p50Found = true;
+                }
+                if (!p99Found && count > 0 && seen * 100 >= count * 99)
+                {
+                    p99 = limit;
+                    p99Found = true;
+                }
+            }
+            stage["count"] = count;
+            stage["averageUs"] = (count > 0) ? (uint32_t)(totalTime / count) : 0;
+            stage["maxUs"] = (uint32_t)maxTime;
+            stage["p50Us"] = p50;
+            stage["p99Us"] = p99;
+            stage["histogram"] = histogram;
+        }
+
+        InputLatency::InputLatency()
+            : mAwaitingFrame(0)
+            , mNextId(0)
+            , mKeys(0)
+            , mRendered(0)
+            , mFailed(0)
+            , mDropped(0)
+        {
+        }
+
+        const char* InputLatency::stageName(Stage stage)
+        {
+            switch (stage)
+            {
+                case DISPATCH: return "dispatch";
+                case RENDER: return "render";
+                case TOTAL: return "total";
+                default: return "unknown";
+            }
+        }
+
+        int InputLatency::bucketIndex(double time)
+        {
+            for (int i = 0; i < HISTOGRAM_BUCKETS - 1; i++)
+            {
+                if (time < sBucketLimits[i])
+                {
+                    return i;
+                }
+            }
+            return HISTOGRAM_BUCKETS - 1;
+        }
+
+        uint32_t InputLatency::keyArrived(double time)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mPending.size() >= MAX_PENDING_KEYS)
+            {
+                if (mPending.front().dispatched)
+                {
+                    mAwaitingFrame.fetch_sub(1, std::memory_order_relaxed);
+                }
+                mPending.pop_front();
+                mDropped++;
+            }
+            Key key;
+            key.id = ++mNextId;
+            key.arrival = time;
+            key.dispatch = 0;
+            key.dispatched = false;
+            mPending.push_back(key);
+            mKeys++;
+            return key.id;
+        }
+
+        void InputLatency::keyDispatched(uint32_t id, const std::vector<std::string>& clients, bool success, double time)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (std::deque<Key>::iterator it = mPending.begin(); it != mPending.end(); it++)
+            {
+                if (it->id != id)
+                {
+                    continue;
+                }
+                if (!success)
+                {
+                    mPending.erase(it);
+                    mFailed++;
+                    return;
+                }
+                it->dispatch = time;
+                it->dispatched = true;
+                it->clients = clients;
+                mAwaitingFrame.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        void InputLatency::frameRendered(double drawStart, double drawEnd)
+        {
+            if (mAwaitingFrame.load(std::memory_order_relaxed) == 0)
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (std::deque<Key>::iterator it = mPending.begin(); it != mPending.end();)
+            {
+                // keys dispatched while this frame was drawn show up in the next one
+                if (it->dispatched && (it->dispatch <= drawStart))
+                {
+                    record(*it, drawEnd);
+                    mAwaitingFrame.fetch_sub(1, std::memory_order_relaxed);
+                    it = mPending.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+        void InputLatency::record(const Key& key, double photon)
+        {
+            const double times[STAGE_COUNT] = { key.dispatch - key.arrival, photon - key.dispatch, photon - key.arrival };
+            for (int s = 0; s < STAGE_COUNT; s++)
+            {
+                mAll.stages[s].add(times[s]);
+                for (size_t c = 0; c < key.clients.size(); c++)
+                {
+                    mClients[key.clients[c]].stages[s].add(times[s]);
+                }
+            }
+            mRendered++;
+        }
+
+        void InputLatency::reset()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mKeys = 0;
+            mRendered = 0;
+            mFailed = 0;
+            mDropped = 0;
+            mAll = ClientStats();
+            mClients.clear();
+        }
+
+        void InputLatency::toJson(JsonObject& stats)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            stats["keys"] = mKeys;
+            stats["rendered"] = mRendered;
+            stats["failed"] = mFailed;
+            stats["dropped"] = mDropped;
+            stats["pending"] = (uint32_t)mPending.size();
+
+            JsonObject all;
+            for (int s = 0; s < STAGE_COUNT; s++)
+            {
+                JsonObject stage;
+                mAll.stages[s].toJson(stage);
+                all[stageName((Stage)s)] = stage;
+            }
+            stats["all"] = all;
+
+            JsonArray clients;
+            for (std::map<std::string, ClientStats>::iterator it = mClients.begin(); it != mClients.end(); it++)
+            {
+                JsonObject client;
+                client["client"] = it->first;
+                for (int s = 0; s < STAGE_COUNT; s++)
+                {
+                    JsonObject stage;
+                    it->second.stages[s].toJson(stage);
+                    client[stageName((Stage)s)] = stage;
+                }
+                clients.Add(client);
+            }
+            stats["clients"] = clients;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,106 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Key to photon latency of the keys that pass through RDKShell. A key is timestamped
+        // when it arrives, when the compositor dispatched it and when the first frame after
+        // that was drawn, and the stages are kept as histograms per receiving client.
+        class InputLatency
+        {
+        public:
+            enum Stage
+            {
+                DISPATCH = 0,
+                RENDER,
+                TOTAL,
+                STAGE_COUNT
+            };
+
+            InputLatency();
+            InputLatency(const InputLatency&) = delete;
+            InputLatency& operator=(const InputLatency&) = delete;
+
+            // times are in microseconds, returns the id the later stages refer to
+            uint32_t keyArrived(double time);
+            void keyDispatched(uint32_t id, const std::vector<std::string>& clients, bool success, double time);
+            // called by the render thread after every draw
+            void frameRendered(double drawStart, double drawEnd);
+            void reset();
+            void toJson(JsonObject& stats);
+
+            static const char* stageName(Stage stage);
+
+        private:
+            static const int HISTOGRAM_BUCKETS = 12;
+            static const size_t MAX_PENDING_KEYS = 256;
+
+            struct Key
+            {
+                uint32_t id;
+                double arrival;
+                double dispatch;
+                bool dispatched;
+                std::vector<std::string> clients;
+            };
+
+            struct Histogram
+            {
+                Histogram();
+                void add(double time);
+                void toJson(JsonObject& stage) const;
+                uint32_t count;
+                double totalTime;
+                double maxTime;
+                uint32_t buckets[HISTOGRAM_BUCKETS];
+            };
+
+            struct ClientStats
+            {
+                Histogram stages[STAGE_COUNT];
+            };
+
+            static int bucketIndex(double time);
+            void record(const Key& key, double photon);
+
+            std::mutex mMutex;
+            // keys dispatched and waiting for a frame, checked by the render thread without the lock
+            std::atomic<uint32_t> mAwaitingFrame;
+            std::deque<Key> mPending;
+            uint32_t mNextId;
+            uint32_t mKeys;
+            uint32_t mRendered;
+            uint32_t mFailed;
+            uint32_t mDropped;
+            ClientStats mAll;
+            std::map<std::string, ClientStats> mClients;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,267 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "KeyDispatchTable.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        const uint32_t KeyDispatchTable::ANY_KEY_CODE;
+
+        KeyDispatchTable::Registration::Registration()
+            : type(KEY_LISTENER)
+            , keyCode(0)
+            , flags(0)
+            , activate(false)
+            , propagate(true)
+        {
+        }
+
+        KeyDispatchTable::KeyDispatchTable()
+            : mTable(std::make_shared<const Table>())
+        {
+        }
+
+        uint64_t KeyDispatchTable::index(uint32_t keyCode, uint32_t flags)
+        {
+            return (static_cast<uint64_t>(keyCode) << 32) | flags;
+        }
+
+        std::shared_ptr<const KeyDispatchTable::Table> KeyDispatchTable::snapshot() const
+        {
+            return std::atomic_load(&mTable);
+        }
+
+        void KeyDispatchTable::publish(const std::shared_ptr<const Table>& table)
+        {
+            std::atomic_store(&mTable, table);
+        }
+
+        void KeyDispatchTable::insert(Table& table, const Registration& registration)
+        {
+            Entry& entry = table[index(registration.keyCode, registration.flags)];
+            if (registration.type == INTERCEPT)
+            {
+                if (std::find(entry.intercepts.begin(), entry.intercepts.end(), registration.client) == entry.intercepts.end())
+                {
+                    entry.intercepts.push_back(registration.client);
+                }
+                return;
+            }
+            std::vector<Registration>& listeners = (registration.type == KEY_LISTENER) ? entry.keyListeners : entry.nativeKeyListeners;
+            for (size_t i = 0; i < listeners.size(); i++)
+            {
+                if (listeners[i].client == registration.client)
+                {
+                    listeners[i] = registration;
+                    return;
+                }
+            }
+            listeners.push_back(registration);
+        }
+
+        void KeyDispatchTable::erase(Table& table, const Registration& registration)
+        {
+            Table::iterator it = table.find(index(registration.keyCode, registration.flags));
+            if (it == table.end())
+            {
+                return;
+            }
+            Entry& entry = it->second;
+            if (registration.type == INTERCEPT)
+            {
+                entry.intercepts.erase(std::remove(entry.intercepts.begin(), entry.intercepts.end(), registration.client), entry.intercepts.end());
+            }
+            else
+            {
+                std::vector<Registration>& listeners = (registration.type == KEY_LISTENER) ? entry.keyListeners : entry.nativeKeyListeners;
+                for (std::vector<Registration>::iterator listener = listeners.begin(); listener != listeners.end(); listener++)
+                {
+                    if (listener->client == registration.client)
+                    {
+                        listeners.erase(listener);
+                        break;
+                    }
+                }
+            }
+            if (entry.intercepts.empty() && entry.keyListeners.empty() && entry.nativeKeyListeners.empty())
+            {
+                table.erase(it);
+            }
+        }
+
+        void KeyDispatchTable::add(const std::vector<Registration>& registrations)
+        {
+            if (registrations.empty())
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::shared_ptr<Table> table = std::make_shared<Table>(*snapshot());
+            for (size_t i = 0; i < registrations.size(); i++)
+            {
+                insert(*table, registrations[i]);
+            }
+            publish(table);
+        }
+
+        void KeyDispatchTable::remove(const std::vector<Registration>& registrations)
+        {
+            if (registrations.empty())
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::shared_ptr<Table> table = std::make_shared<Table>(*snapshot());
+            for (size_t i = 0; i < registrations.size(); i++)
+            {
+                erase(*table, registrations[i]);
+            }
+            publish(table);
+        }
+
+        void KeyDispatchTable::removeClient(const std::string& client)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::shared_ptr<Table> table = std::make_shared<Table>(*snapshot());
+            bool changed = false;
+            for (Table::iterator it = table->begin(); it != table->end();)
+            {
+                Entry& entry = it->second;
+                const size_t previousSize = entry.intercepts.size() + entry.keyListeners.size() + entry.nativeKeyListeners.size();
+                entry.intercepts.erase(std::remove(entry.intercepts.begin(), entry.intercepts.end(), client), entry.intercepts.end());
+                std::vector<Registration>* listeners[] = { &entry.keyListeners, &entry.nativeKeyListeners };
+                for (size_t l = 0; l < 2; l++)
+                {
+                    for (std::vector<Registration>::iterator listener = listeners[l]->begin(); listener != listeners[l]->end();)
+                    {
+                        listener = (listener->client == client) ? listeners[l]->erase(listener) : listener + 1;
+                    }
+                }
+                const size_t size = entry.intercepts.size() + entry.keyListeners.size() + entry.nativeKeyListeners.size();
+                changed = changed || (size != previousSize);
+                it = (size == 0) ? table->erase(it) : std::next(it);
+            }
+            if (changed)
+            {
+                publish(table);
+            }
+        }
+
+        bool KeyDispatchTable::contains(const Registration& registration) const
+        {
+            std::shared_ptr<const Table> table = snapshot();
+            Table::const_iterator it = table->find(index(registration.keyCode, registration.flags));
+            if (it == table->end())
+            {
+                return false;
+            }
+            if (registration.type == INTERCEPT)
+            {
+                return std::find(it->second.intercepts.begin(), it->second.intercepts.end(), registration.client) != it->second.intercepts.end();
+            }
+            const std::vector<Registration>& listeners = (registration.type == KEY_LISTENER) ? it->second.keyListeners : it->second.nativeKeyListeners;
+            for (size_t i = 0; i < listeners.size(); i++)
+            {
+                if (listeners[i].client == registration.client)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void KeyDispatchTable::collect(const Entry& entry, Type listenerType, Route& route)
+        {
+            route.intercepts.insert(route.intercepts.end(), entry.intercepts.begin(), entry.intercepts.end());
+            const std::vector<Registration>& listeners = (listenerType == NATIVE_KEY_LISTENER) ? entry.nativeKeyListeners : entry.keyListeners;
+            route.listeners.insert(route.listeners.end(), listeners.begin(), listeners.end());
+        }
+
+        void KeyDispatchTable::lookup(Type listenerType, uint32_t keyCode, uint32_t flags, Route& route) const
+        {
+            route.intercepts.clear();
+            route.listeners.clear();
+            std::shared_ptr<const Table> table = snapshot();
+            Table::const_iterator it = table->find(index(keyCode, flags));
+            if (it != table->end())
+            {
+                collect(it->second, listenerType, route);
+            }
+            if (keyCode != ANY_KEY_CODE)
+            {
+                it = table->find(index(ANY_KEY_CODE, flags));
+                if (it != table->end())
+                {
+                    collect(it->second, listenerType, route);
+                }
+            }
+        }
+
+        uint32_t KeyDispatchTable::size() const
+        {
+            std::shared_ptr<const Table> table = snapshot();
+            uint32_t count = 0;
+            for (Table::const_iterator it = table->begin(); it != table->end(); it++)
+            {
+                count += it->second.intercepts.size() + it->second.keyListeners.size() + it->second.nativeKeyListeners.size();
+            }
+            return count;
+        }
+
+        void KeyDispatchTable::toJson(JsonArray& registrations) const
+        {
+            static const char* typeNames[] = { "intercept", "keyListener", "nativeKeyListener" };
+            std::shared_ptr<const Table> table = snapshot();
+            for (Table::const_iterator it = table->begin(); it != table->end(); it++)
+            {
+                const uint32_t keyCode = static_cast<uint32_t>(it->first >> 32);
+                const uint32_t flags = static_cast<uint32_t>(it->first);
+                for (size_t i = 0; i < it->second.intercepts.size(); i++)
+                {
+                    JsonObject registration;
+                    registration["type"] = typeNames[INTERCEPT];
+                    registration["client"] = it->second.intercepts[i];
+                    registration["keyCode"] = keyCode;
+                    registration["flags"] = flags;
+                    registrations.Add(registration);
+                }
+                const std::vector<Registration>* listeners[] = { &it->second.keyListeners, &it->second.nativeKeyListeners };
+                for (size_t l = 0; l < 2; l++)
+                {
+                    for (size_t i = 0; i < listeners[l]->size(); i++)
+                    {
+                        const Registration& listener = (*listeners[l])[i];
+                        JsonObject registration;
+                        registration["type"] = typeNames[listener.type];
+                        registration["client"] = listener.client;
+                        registration["keyCode"] = keyCode;
+                        registration["flags"] = flags;
+                        registration["activate"] = listener.activate;
+                        registration["propagate"] = listener.propagate;
+                        registrations.Add(registration);
+                    }
+                }
+            }
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,101 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Key intercepts and key listeners of all clients indexed on key code and modifier
+        // flags. Changes are applied in batches to a copy of the table which then replaces
+        // the current one, so lookups never wait for registrations or the compositor lock.
+        // Keys are still delivered by the compositor, the table answers getKeyRoute and the
+        // clients for the input latency and has to follow the compositor when clients go away.
+        class KeyDispatchTable
+        {
+        public:
+            enum Type
+            {
+                INTERCEPT = 0,
+                KEY_LISTENER,
+                NATIVE_KEY_LISTENER
+            };
+
+            struct Registration
+            {
+                Registration();
+                Type type;
+                std::string client;
+                uint32_t keyCode;
+                uint32_t flags;
+                bool activate;
+                bool propagate;
+            };
+
+            struct Route
+            {
+                std::vector<std::string> intercepts;
+                std::vector<Registration> listeners;
+            };
+
+            // key code that matches every key, as used by the key listener api
+            static const uint32_t ANY_KEY_CODE = 65536;
+
+            KeyDispatchTable();
+            KeyDispatchTable(const KeyDispatchTable&) = delete;
+            KeyDispatchTable& operator=(const KeyDispatchTable&) = delete;
+
+            void add(const std::vector<Registration>& registrations);
+            void remove(const std::vector<Registration>& registrations);
+            void removeClient(const std::string& client);
+            bool contains(const Registration& registration) const;
+            // intercepts and listeners for the key, listeners on any key included
+            void lookup(Type listenerType, uint32_t keyCode, uint32_t flags, Route& route) const;
+            uint32_t size() const;
+            void toJson(JsonArray& registrations) const;
+
+        private:
+            struct Entry
+            {
+                std::vector<std::string> intercepts;
+                std::vector<Registration> keyListeners;
+                std::vector<Registration> nativeKeyListeners;
+            };
+            typedef std::unordered_map<uint64_t, Entry> Table;
+
+            static uint64_t index(uint32_t keyCode, uint32_t flags);
+            static void insert(Table& table, const Registration& registration);
+            static void erase(Table& table, const Registration& registration);
+            static void collect(const Entry& entry, Type listenerType, Route& route);
+            std::shared_ptr<const Table> snapshot() const;
+            void publish(const std::shared_ptr<const Table>& table);
+
+            // serializes writers, readers only load the table
+            std::mutex mMutex;
+            std::shared_ptr<const Table> mTable;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,222 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "LaunchTracer.h"
+#include <chrono>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        LaunchTracer::Trace::Trace()
+            : id(0)
+            , startTime(0)
+            , duration(0)
+            , success(false)
+            , pending(false)
+        {
+        }
+
+        LaunchTracer::Session::Session(LaunchTracer& tracer, const std::string& client, const std::string& operation)
+            : mTracer(tracer)
+            , mPhaseOpen(false)
+            , mFinished(false)
+        {
+            mTrace.client = client;
+            mTrace.operation = operation;
+            mTrace.startTime = LaunchTracer::now();
+        }
+
+        LaunchTracer::Session::~Session()
+        {
+            // requests returning early never call finish, keep them as failed
+            if (!mFinished)
+            {
+                finish(false);
+            }
+        }
+
+        void LaunchTracer::Session::closePhase(uint64_t now)
+        {
+            if (mPhaseOpen)
+            {
+                Span& span = mTrace.spans.back();
+                span.duration = now - span.startTime;
+                mPhaseOpen = false;
+            }
+        }
+
+        void LaunchTracer::Session::phase(const char* name)
+        {
+            if (mFinished)
+            {
+                return;
+            }
+            uint64_t now = LaunchTracer::now();
+            closePhase(now);
+            Span span;
+            span.name = name;
+            span.startTime = now;
+            span.duration = 0;
+            mTrace.spans.push_back(span);
+            mPhaseOpen = true;
+        }
+
+        void LaunchTracer::Session::finish(bool success, const std::string& launchType, bool pending)
+        {
+            if (mFinished)
+            {
+                return;
+            }
+            uint64_t now = LaunchTracer::now();
+            closePhase(now);
+            mTrace.duration = now - mTrace.startTime;
+            mTrace.success = success;
+            mTrace.pending = success && pending;
+            mTrace.launchType = launchType;
+            if (!mTrace.client.empty())
+            {
+                mTracer.store(mTrace);
+            }
+            mFinished = true;
+        }
+
+        LaunchTracer::LaunchTracer()
+            : mNextId(0)
+        {
+        }
+
+        uint64_t LaunchTracer::now()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void LaunchTracer::store(Trace& trace)
+        {
+            trace.id = mNextId.fetch_add(1, std::memory_order_relaxed) + 1;
+            std::lock_guard<std::mutex> lock(mTracesMutex);
+            std::deque<Trace>& traces = mTraces[trace.client];
+            traces.push_back(trace);
+            if (traces.size() > TRACES_PER_CLIENT)
+            {
+                traces.pop_front();
+            }
+            if (mTraces.size() > MAX_CLIENTS)
+            {
+                // forget the client that has been quiet for the longest time
+                std::map<std::string, std::deque<Trace>>::iterator oldest = mTraces.begin();
+                for (std::map<std::string, std::deque<Trace>>::iterator it = mTraces.begin(); it != mTraces.end(); it++)
+                {
+                    if (it->second.back().startTime < oldest->second.back().startTime)
+                    {
+                        oldest = it;
+                    }
+                }
+                mTraces.erase(oldest);
+            }
+        }
+
+        bool LaunchTracer::completePending(const std::string& client, const char* name)
+        {
+            std::lock_guard<std::mutex> lock(mTracesMutex);
+            std::map<std::string, std::deque<Trace>>::iterator it = mTraces.find(client);
+            if ((it == mTraces.end()) || it->second.empty() || !it->second.back().pending)
+            {
+                return false;
+            }
+            Trace& trace = it->second.back();
+            Span span;
+            span.name = name;
+            span.startTime = trace.startTime + trace.duration;
+            span.duration = now() - span.startTime;
+            trace.spans.push_back(span);
+            trace.duration += span.duration;
+            trace.pending = false;
+            return true;
+        }
+
+        void LaunchTracer::traceToJson(const Trace& trace, JsonObject& json)
+        {
+            json["id"] = trace.id;
+            json["client"] = trace.client;
+            json["operation"] = trace.operation;
+            if (!trace.launchType.empty())
+            {
+                json["launchType"] = trace.launchType;
+            }
+            json["timestamp"] = trace.startTime;
+            json["durationUs"] = trace.duration;
+            json["success"] = trace.success;
+            json["pending"] = trace.pending;
+            JsonArray phases;
+            for (size_t i = 0; i < trace.spans.size(); i++)
+            {
+                const Span& span = trace.spans[i];
+                JsonObject phase;
+                phase["name"] = span.name;
+                phase["offsetUs"] = span.startTime - trace.startTime;
+                phase["durationUs"] = span.duration;
+                phases.Add(phase);
+            }
+            json["phases"] = phases;
+        }
+
+        bool LaunchTracer::latestToJson(const std::string& client, JsonObject& trace)
+        {
+            std::lock_guard<std::mutex> lock(mTracesMutex);
+            std::map<std::string, std::deque<Trace>>::iterator it = mTraces.find(client);
+            if ((it == mTraces.end()) || it->second.empty())
+            {
+                return false;
+            }
+            traceToJson(it->second.back(), trace);
+            return true;
+        }
+
+        void LaunchTracer::toJson(const std::string& client, JsonArray& traces)
+        {
+            std::lock_guard<std::mutex> lock(mTracesMutex);
+            for (std::map<std::string, std::deque<Trace>>::iterator it = mTraces.begin(); it != mTraces.end(); it++)
+            {
+                if (!client.empty() && (it->first != client))
+                {
+                    continue;
+                }
+                for (size_t i = 0; i < it->second.size(); i++)
+                {
+                    JsonObject trace;
+                    traceToJson(it->second[i], trace);
+                    traces.Add(trace);
+                }
+            }
+        }
+
+        void LaunchTracer::clear(const std::string& client)
+        {
+            std::lock_guard<std::mutex> lock(mTracesMutex);
+            if (client.empty())
+            {
+                mTraces.clear();
+            }
+            else
+            {
+                mTraces.erase(client);
+            }
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
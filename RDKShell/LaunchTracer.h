@@ -0,0 +1,106 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Phase timings of launch, suspend and destroy requests. Every request fills a
+        // Session on its own stack and hands it over once done, so the lock is only
+        // taken when a trace is stored or read. Timestamps are monotonic microseconds.
+        class LaunchTracer
+        {
+        public:
+            struct Span
+            {
+                std::string name;
+                uint64_t startTime;
+                uint64_t duration;
+            };
+
+            struct Trace
+            {
+                Trace();
+                uint32_t id;
+                std::string client;
+                std::string operation;
+                std::string launchType;
+                uint64_t startTime;
+                uint64_t duration;
+                bool success;
+                bool pending;
+                std::vector<Span> spans;
+            };
+
+            class Session
+            {
+            public:
+                Session(LaunchTracer& tracer, const std::string& client, const std::string& operation);
+                ~Session();
+                Session(const Session&) = delete;
+                Session& operator=(const Session&) = delete;
+
+                // closes the running phase, if any, and starts the named one
+                void phase(const char* name);
+                // stores the trace, pending traces wait for completePending to close them
+                void finish(bool success, const std::string& launchType = std::string(), bool pending = false);
+
+            private:
+                void closePhase(uint64_t now);
+
+                LaunchTracer& mTracer;
+                Trace mTrace;
+                bool mPhaseOpen;
+                bool mFinished;
+            };
+
+            LaunchTracer();
+            LaunchTracer(const LaunchTracer&) = delete;
+            LaunchTracer& operator=(const LaunchTracer&) = delete;
+
+            // adds a span from the end of the pending trace of client until now
+            bool completePending(const std::string& client, const char* name);
+            bool latestToJson(const std::string& client, JsonObject& trace);
+            void toJson(const std::string& client, JsonArray& traces);
+            void clear(const std::string& client);
+
+            static uint64_t now();
+
+        private:
+            static const size_t TRACES_PER_CLIENT = 8;
+            static const size_t MAX_CLIENTS = 64;
+
+            void store(Trace& trace);
+            static void traceToJson(const Trace& trace, JsonObject& json);
+
+            std::atomic<uint32_t> mNextId;
+            std::mutex mTracesMutex;
+            std::map<std::string, std::deque<Trace>> mTraces;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,392 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "MemoryPressure.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        static const char* MEMORY_PRESSURE_PATH = "/proc/pressure/memory";
+        // window of the avg10 PSI average
+        static const uint32_t MEMORY_PRESSURE_AVERAGE_WINDOW = 10000;
+
+        MemoryPressureManager::Config::Config()
+            : enabled(false)
+            , interval(1000)
+            , suspendThreshold(10)
+            , hibernateThreshold(20)
+            , destroyThreshold(40)
+            , hysteresis(5)
+            , settleTime(MEMORY_PRESSURE_AVERAGE_WINDOW)
+            , appRamLimit(0)
+            , hibernateSupported(false)
+        {
+        }
+
+        MemoryPressureManager::MemoryPressureManager()
+            : mRunning(false)
+            , mPsiAvailable(false)
+            , mSomeAvg10(0)
+            , mFullAvg10(0)
+            , mWarningLevel(NONE)
+            , mPsiLevel(NONE)
+            , mLevel(NONE)
+            , mLastActionTime(0)
+        {
+            for (int i = 0; i <= DESTROY; i++)
+            {
+                mActions[i] = 0;
+            }
+        }
+
+        MemoryPressureManager::~MemoryPressureManager()
+        {
+            stop();
+        }
+
+        uint64_t MemoryPressureManager::now()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        const char* MemoryPressureManager::actionName(Action action)
+        {
+            switch (action)
+            {
+                case SUSPEND: return "suspend";
+                case HIBERNATE: return "hibernate";
+                case DESTROY: return "destroy";
+                default: return "none";
+            }
+        }
+
+        bool MemoryPressureManager::readPressure(const std::string& path, double& someAvg10, double& fullAvg10)
+        {
+            // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+            // full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+            std::ifstream file(path.c_str());
+            if (!file.is_open())
+            {
+                return false;
+            }
+            bool someFound = false;
+            std::string line;
+            while (std::getline(file, line))
+            {
+                double avg10 = 0;
+                if (sscanf(line.c_str(), "some avg10=%lf", &avg10) == 1)
+                {
+                    someAvg10 = avg10;
+                    someFound = true;
+                }
+                else if (sscanf(line.c_str(), "full avg10=%lf", &avg10) == 1)
+                {
+                    fullAvg10 = avg10;
+                }
+            }
+            return someFound;
+        }
+
+        MemoryPressureManager::Action MemoryPressureManager::pressureLevel(const Config& config, double someAvg10, Action current)
+        {
+            const double thresholds[] = { config.suspendThreshold, config.hibernateThreshold, config.destroyThreshold };
+            for (int level = DESTROY; level >= SUSPEND; level--)
+            {
+                double threshold = thresholds[level - SUSPEND];
+                if (level <= current)
+                {
+                    threshold -= config.hysteresis;
+                }
+                if (someAvg10 >= threshold)
+                {
+                    return (Action)level;
+                }
+            }
+            return NONE;
+        }
+
+        bool MemoryPressureManager::selectVictim(const Config& config, Action level, std::vector<Candidate> candidates,
+            const std::map<std::string, std::pair<Action, uint64_t>>& applied, std::string& callsign, Action& action)
+        {
+            // apps missing in the priority list go first, then the listed ones from the end of the list
+            auto rank = [&config](const std::string& app) {
+                std::vector<std::string>::const_iterator it = std::find(config.priorities.begin(), config.priorities.end(), app);
+                return (it == config.priorities.end()) ? 0 : (int)(config.priorities.end() - it);
+            };
+            std::stable_sort(candidates.begin(), candidates.end(), [&rank](const Candidate& first, const Candidate& second) {
+                int firstRank = rank(first.callsign);
+                int secondRank = rank(second.callsign);
+                return (firstRank != secondRank) ? (firstRank < secondRank) : (first.lastUsed < second.lastUsed);
+            });
+
+            for (size_t i = 0; i < candidates.size(); i++)
+            {
+                const Candidate& candidate = candidates[i];
+                Action appLevel = level;
+                if ((config.appRamLimit > 0) && (candidate.ram > config.appRamLimit))
+                {
+                    // suspending keeps the memory, the app has to be hibernated or destroyed
+                    appLevel = std::max(appLevel, config.hibernateSupported ? HIBERNATE : DESTROY);
+                }
+                if (appLevel == NONE)
+                {
+                    continue;
+                }
+
+                Action step = NONE;
+                std::map<std::string, std::pair<Action, uint64_t>>::const_iterator appliedIt = applied.find(candidate.callsign);
+                if ((appliedIt != applied.end()) && (appliedIt->second.second >= candidate.lastUsed))
+                {
+                    step = appliedIt->second.first;
+                }
+                if ((step == NONE) && candidate.suspended)
+                {
+                    step = SUSPEND;
+                }
+                if (step == DESTROY)
+                {
+                    continue;
+                }
+                Action next = (Action)(step + 1);
+                if ((next == HIBERNATE) && !config.hibernateSupported)
+                {
+                    next = DESTROY;
+                }
+                if (next <= appLevel)
+                {
+                    callsign = candidate.callsign;
+                    action = next;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void MemoryPressureManager::start(const CandidatesCallback& candidates, const ActionCallback& action)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mRunning)
+            {
+                return;
+            }
+            mCandidates = candidates;
+            mAction = action;
+            mRunning = true;
+            mThread = std::thread(&MemoryPressureManager::run, this);
+        }
+
+        void MemoryPressureManager::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mRunning)
+                {
+                    return;
+                }
+                mRunning = false;
+                mCondition.notify_all();
+            }
+            mThread.join();
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCandidates = CandidatesCallback();
+            mAction = ActionCallback();
+            mApplied.clear();
+            mWarningLevel = NONE;
+            mPsiLevel = NONE;
+            mLevel = NONE;
+            mLastActionTime = 0;
+        }
+
+        void MemoryPressureManager::configure(const Config& config)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mConfig = config;
+            if (mConfig.interval == 0)
+            {
+                mConfig.interval = 1000;
+            }
+            if (mConfig.settleTime < MEMORY_PRESSURE_AVERAGE_WINDOW)
+            {
+                mConfig.settleTime = MEMORY_PRESSURE_AVERAGE_WINDOW;
+            }
+            mCondition.notify_all();
+        }
+
+        MemoryPressureManager::Config MemoryPressureManager::config()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mConfig;
+        }
+
+        MemoryPressureManager::Action MemoryPressureManager::level()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return std::max(mLevel, mWarningLevel);
+        }
+
+        void MemoryPressureManager::setWarningLevel(Action level)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mWarningLevel = level;
+            if (level != NONE)
+            {
+                mCondition.notify_all();
+            }
+        }
+
+        void MemoryPressureManager::run()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mRunning)
+            {
+                if (mConfig.enabled)
+                {
+                    mCondition.wait_for(lock, std::chrono::milliseconds(mConfig.interval));
+                }
+                else
+                {
+                    mCondition.wait(lock, [this]() { return !mRunning || mConfig.enabled; });
+                }
+                if (!mRunning)
+                {
+                    break;
+                }
+                if (mConfig.enabled)
+                {
+                    lock.unlock();
+                    evaluate();
+                    lock.lock();
+                }
+            }
+        }
+
+        void MemoryPressureManager::evaluate()
+        {
+            double someAvg10 = 0;
+            double fullAvg10 = 0;
+            bool psiAvailable = readPressure(MEMORY_PRESSURE_PATH, someAvg10, fullAvg10);
+
+            CandidatesCallback candidatesCallback;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                candidatesCallback = mCandidates;
+            }
+            std::vector<Candidate> candidates = candidatesCallback();
+
+            std::string callsign;
+            Action action = NONE;
+            ActionCallback actionCallback;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mPsiAvailable = psiAvailable;
+                mSomeAvg10 = someAvg10;
+                mFullAvg10 = fullAvg10;
+                mPsiLevel = psiAvailable ? pressureLevel(mConfig, someAvg10, mPsiLevel) : NONE;
+                mLevel = std::max(mPsiLevel, mWarningLevel);
+
+                // apps that left the background or went away start over
+                for (std::map<std::string, std::pair<Action, uint64_t>>::iterator it = mApplied.begin(); it != mApplied.end();)
+                {
+                    bool found = false;
+                    for (size_t i = 0; i < candidates.size(); i++)
+                    {
+                        if (candidates[i].callsign == it->first)
+                        {
+                            found = true;
+                            break;
+                        }
+                    }
+                    if (found)
+                    {
+                        it++;
+                    }
+                    else
+                    {
+                        it = mApplied.erase(it);
+                    }
+                }
+
+                // the average still shows the pressure from before the last action for a while
+                bool settled = (mLastActionTime == 0) || ((now() - mLastActionTime) >= mConfig.settleTime);
+                if (settled && selectVictim(mConfig, mLevel, candidates, mApplied, callsign, action))
+                {
+                    actionCallback = mAction;
+                }
+            }
+            if (actionCallback)
+            {
+                std::cout << "memory pressure " << someAvg10 << "%, " << actionName(action) << " " << callsign << std::endl;
+                if (!actionCallback(callsign, action))
+                {
+                    std::cout << "memory pressure action on " << callsign << " not started" << std::endl;
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(mMutex);
+                uint64_t actionTime = now();
+                mApplied[callsign] = std::make_pair(action, actionTime);
+                mActions[action]++;
+                mLastActionTime = actionTime;
+            }
+        }
+
+        void MemoryPressureManager::toJson(JsonObject& status)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            status["enabled"] = mConfig.enabled;
+            status["interval"] = mConfig.interval;
+            status["suspendThreshold"] = mConfig.suspendThreshold;
+            status["hibernateThreshold"] = mConfig.hibernateThreshold;
+            status["destroyThreshold"] = mConfig.destroyThreshold;
+            status["hysteresis"] = mConfig.hysteresis;
+            status["settleTime"] = mConfig.settleTime;
+            status["appRamLimit"] = mConfig.appRamLimit;
+            JsonArray priorities;
+            for (size_t i = 0; i < mConfig.priorities.size(); i++)
+            {
+                priorities.Add(mConfig.priorities[i]);
+            }
+            status["priorities"] = priorities;
+            status["psiAvailable"] = mPsiAvailable;
+            status["someAvg10"] = mSomeAvg10;
+            status["fullAvg10"] = mFullAvg10;
+            status["level"] = actionName(mLevel);
+            status["warningLevel"] = actionName(mWarningLevel);
+            JsonObject actions;
+            for (int i = SUSPEND; i <= DESTROY; i++)
+            {
+                actions[actionName((Action)i)] = mActions[i];
+            }
+            status["actions"] = actions;
+            JsonArray apps;
+            for (std::map<std::string, std::pair<Action, uint64_t>>::iterator it = mApplied.begin(); it != mApplied.end(); it++)
+            {
+                JsonObject app;
+                app["callsign"] = it->first;
+                app["action"] = actionName(it->second.first);
+                apps.Add(app);
+            }
+            status["apps"] = apps;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,130 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Frees memory ahead of the kernel OOM killer by suspending, then hibernating and
+        // finally destroying background apps. The pressure level comes from the memory PSI
+        // average and the low ram warnings of the memory monitor, background apps over the
+        // per app ram limit are handled as if memory was under pressure. At most one app
+        // is acted on per interval, lowest priority and least recently used first. As the
+        // PSI average lags, nothing more is done until the settle time after an action has
+        // passed, and a level is left only once the average drops the hysteresis below it.
+        class MemoryPressureManager
+        {
+        public:
+            enum Action
+            {
+                NONE = 0,
+                SUSPEND,
+                HIBERNATE,
+                DESTROY
+            };
+
+            struct Config
+            {
+                Config();
+                bool enabled;
+                uint32_t interval;
+                // thresholds on the PSI "some" avg10 percentage to enter a level
+                double suspendThreshold;
+                double hibernateThreshold;
+                double destroyThreshold;
+                // percentage points below its threshold the average has to drop to leave a level
+                double hysteresis;
+                // ms to wait after an action before the next one, at least the avg10 window
+                uint32_t settleTime;
+                // per app resident memory limit in KB, 0 disables it
+                int32_t appRamLimit;
+                bool hibernateSupported;
+                // apps evicted last, the first entry is kept the longest
+                std::vector<std::string> priorities;
+            };
+
+            struct Candidate
+            {
+                std::string callsign;
+                uint64_t lastUsed;
+                int32_t ram;
+                bool suspended;
+            };
+
+            typedef std::function<std::vector<Candidate>()> CandidatesCallback;
+            // returns false if the action could not be started
+            typedef std::function<bool(const std::string&, Action)> ActionCallback;
+
+            MemoryPressureManager();
+            ~MemoryPressureManager();
+            MemoryPressureManager(const MemoryPressureManager&) = delete;
+            MemoryPressureManager& operator=(const MemoryPressureManager&) = delete;
+
+            void start(const CandidatesCallback& candidates, const ActionCallback& action);
+            void stop();
+            void configure(const Config& config);
+            Config config();
+            Action level();
+            // level requested by the memory monitor warnings, NONE when cleared
+            void setWarningLevel(Action level);
+            void toJson(JsonObject& status);
+
+            static const char* actionName(Action action);
+            static bool readPressure(const std::string& path, double& someAvg10, double& fullAvg10);
+            // level for a PSI average, levels up to current use the exit thresholds
+            static Action pressureLevel(const Config& config, double someAvg10, Action current);
+            // picks the app to act on and the action, the candidates must be background apps
+            static bool selectVictim(const Config& config, Action level, std::vector<Candidate> candidates,
+                const std::map<std::string, std::pair<Action, uint64_t>>& applied, std::string& callsign, Action& action);
+
+        private:
+            void run();
+            void evaluate();
+            static uint64_t now();
+
+            std::mutex mMutex;
+            std::condition_variable mCondition;
+            std::thread mThread;
+            Config mConfig;
+            CandidatesCallback mCandidates;
+            ActionCallback mAction;
+            bool mRunning;
+            bool mPsiAvailable;
+            double mSomeAvg10;
+            double mFullAvg10;
+            Action mWarningLevel;
+            Action mPsiLevel;
+            Action mLevel;
+            uint64_t mLastActionTime;
+            // last action per app and when it was taken
+            std::map<std::string, std::pair<Action, uint64_t>> mApplied;
+            uint32_t mActions[DESTROY + 1];
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -26,9 +26,13 @@
 #include <fstream>
 #include <future>
 #include <set>
+#include <algorithm>
 #include <sstream>
 #include <condition_variable>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <cerrno>
 #include <rdkshell/compositorcontroller.h>
 #include <rdkshell/application.h>
 #include <rdkshell/logger.h>
@@ -47,6 +51,19 @@
 #include "UtilsUnused.h"
 #include "UtilsgetRFCConfig.h"
 #include "UtilsString.h"
+#include "FrameStats.h"
+#include "LaunchTracer.h"
+#include "AppRegistry.h"
+#include "RequestPool.h"
+#include "ResourceTable.h"
+#include "MemoryPressure.h"
+#include "WarmPool.h"
+#include "EventCoalescer.h"
+#include "KeyDispatchTable.h"
+#include "InputLatency.h"
+#include "StartupScheduler.h"
+#include "BulkTeardown.h"
+#include "CompositorRequests.h"
 
 #ifdef RDKSHELL_READ_MAC_ON_STARTUP
 #include "FactoryProtectHal.h"
@@ -145,6 +162,23 @@ const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_AV_BLOCKED_APPS
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_KEY_REPEAT_CONFIG = "keyRepeatConfig";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_GRAPHICS_FRAME_RATE = "getGraphicsFrameRate";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_GRAPHICS_FRAME_RATE = "setGraphicsFrameRate";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_FRAME_STATS = "getFrameStats";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_LAUNCH_TIMINGS = "getLaunchTimings";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_REQUEST_QUEUE_STATS = "getRequestQueueStats";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_APPLY_TRANSACTION = "applyTransaction";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_MEMORY_PRESSURE_POLICY = "setMemoryPressurePolicy";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_MEMORY_PRESSURE_STATUS = "getMemoryPressureStatus";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_WARM_POOL_CONFIG = "setWarmPoolConfig";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_WARM_POOL_STATUS = "getWarmPoolStatus";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_EVENT_COALESCING = "setEventCoalescing";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_EVENT_COALESCING = "getEventCoalescing";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_KEY_ROUTE = "getKeyRoute";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_INPUT_LATENCY = "getInputLatency";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_ADD_ANIMATION_TIMELINE = "addAnimationTimeline";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_STARTUP_TIMELINE = "getStartupTimeline";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_TEARDOWN_REPORT = "getTeardownReport";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_RIALTO_STATS = "getRialtoStats";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_TIMER_STATS = "getTimerStats";
 #ifdef HIBERNATE_SUPPORT_ENABLED
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_HIBERNATE = "hibernate";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_RESTORE = "restore";
@@ -171,6 +205,10 @@ const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_DEVICE_CRITICALLY_LO
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_EASTER_EGG = "onEasterEgg";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_WILL_DESTROY = "onWillDestroy";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE = "onScreenshotComplete";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_MEMORY_PRESSURE_ACTION = "onMemoryPressureAction";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_DISPLAY_CREATED = "onDisplayCreated";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_CLIENT_KILLED = "onClientKilled";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_ANIMATION_TIMELINE_COMPLETE = "onAnimationTimelineComplete";
 #ifdef HIBERNATE_SUPPORT_ENABLED
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_HIBERNATED = "onHibernated";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_RESTORED = "onRestored";
@@ -201,12 +239,86 @@ bool sFactoryModeBlockResidentApp = false;
 bool sForceResidentAppLaunch = false;
 static bool sRunning = true;
 bool needsScreenshot = false;
+std::vector<WPEFramework::Plugin::ScreenshotEncoder::Options> gScreenshotRequests;
+uint32_t gScreenshotCounter = 0;
 sem_t gInitializeSemaphore;
 
-#ifdef HIBERNATE_SUPPORT_ENABLED
-std::mutex gSuspendedOrHibernatedApplicationsMutex;
-map<string, bool> gSuspendedOrHibernatedApplications;
+#define RDKSHELL_IDLE_GRACE_PERIOD_IN_MS 2000
+
+std::mutex gRenderWakeupMutex;
+std::condition_variable gRenderWakeupCondVariable;
+bool gRenderWakeupPending = false;
+double gRenderActiveUntilTime = 0;
+unsigned int gIdleFramerate = 0;
+
+std::mutex gScreenshotMutex;
+std::condition_variable gScreenshotCondVariable;
+uint32_t gPendingScreenshots = 0;
+WPEFramework::Plugin::FrameStats gFrameStats;
+WPEFramework::Plugin::LaunchTracer gLaunchTracer;
+WPEFramework::Plugin::AppRegistry gAppRegistry;
+WPEFramework::Plugin::RequestPool gRequestPool;
+WPEFramework::Plugin::ResourceTable gResourceTable;
+WPEFramework::Plugin::MemoryPressureManager gMemoryPressure;
+WPEFramework::Plugin::WarmPool gWarmPool;
+WPEFramework::Plugin::EventCoalescer gEventCoalescer;
+WPEFramework::Plugin::KeyDispatchTable gKeyDispatchTable;
+WPEFramework::Plugin::InputLatency gInputLatency;
+WPEFramework::Plugin::StartupScheduler gStartupScheduler;
+WPEFramework::Plugin::BulkTeardown gBulkTeardown;
+
+// keeps the full framerate for activeTimeInMs, gRenderWakeupMutex must be held
+static void extendRenderActiveTime(double activeTimeInMs)
+{
+    double activeUntilTime = RdkShell::milliseconds() + activeTimeInMs;
+    if (activeUntilTime > gRenderActiveUntilTime)
+    {
+        gRenderActiveUntilTime = activeUntilTime;
+    }
+}
+
+// wakes the render thread so posted requests are handled without waiting for the
+// remainder of the current frame, and keeps the full framerate for activeTimeInMs
+static void wakeRenderThread(double activeTimeInMs = RDKSHELL_IDLE_GRACE_PERIOD_IN_MS)
+{
+    std::unique_lock<std::mutex> lock(gRenderWakeupMutex);
+    gRenderWakeupPending = true;
+    extendRenderActiveTime(activeTimeInMs);
+    lock.unlock();
+    gRenderWakeupCondVariable.notify_one();
+}
+
+// keeps the full framerate without waking the render thread, called by the render thread itself
+static void keepRenderThreadActive()
+{
+    std::lock_guard<std::mutex> lock(gRenderWakeupMutex);
+    extendRenderActiveTime(RDKSHELL_IDLE_GRACE_PERIOD_IN_MS);
+}
+
+static void waitForRenderWakeup(double sleepTimeInUs)
+{
+    std::unique_lock<std::mutex> lock(gRenderWakeupMutex);
+    if (!gRenderWakeupPending && sleepTimeInUs > 0)
+    {
+        gRenderWakeupCondVariable.wait_for(lock, std::chrono::microseconds((int64_t)sleepTimeInUs), []{ return gRenderWakeupPending; });
+    }
+    gRenderWakeupPending = false;
+}
+
+// idle mode is only entered when RDKSHELL_IDLE_FRAMERATE is set and nothing was
+// posted to the render thread, no animation was running, no key was pressed and
+// no client was visible for the grace period
+static bool isRenderThreadIdle()
+{
+    if (0 == gIdleFramerate)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(gRenderWakeupMutex);
+    return RdkShell::milliseconds() > gRenderActiveUntilTime;
+}
 
+#ifdef HIBERNATE_SUPPORT_ENABLED
 std::mutex gHibernateBlockedMutex;
 int gHibernateBlocked;
 std::condition_variable gHibernateBlockedCondVariable;
@@ -223,8 +335,32 @@ std::mutex gLaunchedToSuspendedMutex;
 #define THUNDER_ACCESS_DEFAULT_VALUE "127.0.0.1:9998"
 #define RDKSHELL_WILLDESTROY_EVENT_WAITTIME 1
 #define RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS 250
+#define RDKSHELL_REQUEST_THREADS 4
+#define RDKSHELL_REQUEST_QUEUE_SIZE 64
+#define RDKSHELL_REQUEST_STOP_TIMEOUT_IN_MS 2000
+#define RDKSHELL_RESOURCE_REFRESH_INTERVAL_IN_MS 5000
+#define RDKSHELL_LAUNCH_HISTORY_PATH "/opt/persistent/rdkshell_launch_history"
+#define RDKSHELL_EVENT_COALESCING_WINDOW_IN_MS 50
+#define RDKSHELL_STARTUP_PARALLELISM 1
+#define RDKSHELL_TEARDOWN_FAN_OUT 4
+#define RDKSHELL_TEARDOWN_DEADLINE_IN_MS 3000
+#define RDKSHELL_MAX_TRANSACTION_OPERATIONS 64
+#define RDKSHELL_BOUNDS_SETTLE_TIME_IN_US 68000
 
 static std::string gThunderAccessValue = THUNDER_ACCESS_DEFAULT_VALUE;
+
+#define RDKSHELL_THUNDER_CLIENT_IDLE_TIMEOUT_IN_MS 60000
+
+struct ThunderClientEntry
+{
+    ThunderClientEntry() : mLastUsedTime(0) {}
+    std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> mClient;
+    std::string mToken;
+    std::string mThunderAccess;
+    double mLastUsedTime;
+};
+static std::mutex gThunderClientsMutex;
+static std::map<std::string, ThunderClientEntry> gThunderClients;
 static uint32_t gWillDestroyEventWaitTime = RDKSHELL_WILLDESTROY_EVENT_WAITTIME;
 #define SYSTEM_SERVICE_CALLSIGN "org.rdk.System"
 #define RESIDENTAPP_CALLSIGN "ResidentApp"
@@ -232,12 +368,15 @@ static uint32_t gWillDestroyEventWaitTime = RDKSHELL_WILLDESTROY_EVENT_WAITTIME;
 #define LISA_CALLSIGN "LISA"
 
 #define RECONNECTION_TIME_IN_MILLISECONDS 5000
+#define RECONNECTION_TIMER_SLACK_IN_MILLISECONDS 500
 
 #define REMOTECONTROL_CALLSIGN "org.rdk.RemoteControl.1"
 #define KEYCODE_INVALID -1
 #define RETRY_INTERVAL_250MS 250000
 
 #define RDKSHELL_SURFACECLIENT_DISPLAYNAME "rdkshell_display"
+#define RDKSHELL_OUTPUT_DIRECTORY "/tmp/rdkshell"
+#define RDKSHELL_OUTPUT_MAX_SCREENSHOTS 16
 enum FactoryAppLaunchStatus
 {
     NOTLAUNCHED = 0,
@@ -304,6 +443,66 @@ static bool waitForHibernateUnblocked(int timeoutMs)
 
 #endif
 
+// files written on behalf of api callers only go to RDKSHELL_OUTPUT_DIRECTORY, the
+// caller can only choose the name of the file
+static bool outputFilePath(const std::string& name, std::string& path)
+{
+    if (name.empty() || (name == ".") || (name == "..") || (name.find('/') != std::string::npos))
+    {
+        return false;
+    }
+    struct stat info;
+    if ((mkdir(RDKSHELL_OUTPUT_DIRECTORY, 0700) != 0) && (errno != EEXIST))
+    {
+        return false;
+    }
+    // refuse a directory someone else put there, or a symlink to somewhere else
+    if ((lstat(RDKSHELL_OUTPUT_DIRECTORY, &info) != 0) || !S_ISDIR(info.st_mode) || (info.st_uid != geteuid()))
+    {
+        std::cout << "unable to use " << RDKSHELL_OUTPUT_DIRECTORY << " for output files" << std::endl;
+        return false;
+    }
+    path = std::string(RDKSHELL_OUTPUT_DIRECTORY) + "/" + name;
+    return true;
+}
+
+// deletes the oldest screenshots of RDKSHELL_OUTPUT_DIRECTORY so it does not fill up tmpfs,
+// traces and other files written there are left alone
+static void pruneScreenshots()
+{
+    DIR* directory = opendir(RDKSHELL_OUTPUT_DIRECTORY);
+    if (nullptr == directory)
+    {
+        return;
+    }
+    // modification times in nanoseconds, several screenshots are often taken within a second
+    std::vector<std::pair<uint64_t, std::string>> files;
+    struct dirent* entry = nullptr;
+    while ((entry = readdir(directory)) != nullptr)
+    {
+        if (!WPEFramework::Plugin::ScreenshotEncoder::isScreenshotFile(entry->d_name))
+        {
+            continue;
+        }
+        std::string path = std::string(RDKSHELL_OUTPUT_DIRECTORY) + "/" + entry->d_name;
+        struct stat info;
+        if ((lstat(path.c_str(), &info) == 0) && S_ISREG(info.st_mode))
+        {
+            files.push_back(std::make_pair((uint64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec, path));
+        }
+    }
+    closedir(directory);
+    if (files.size() <= RDKSHELL_OUTPUT_MAX_SCREENSHOTS)
+    {
+        return;
+    }
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i < files.size() - RDKSHELL_OUTPUT_MAX_SCREENSHOTS; i++)
+    {
+        unlink(files[i].second.c_str());
+    }
+}
+
 namespace WPEFramework {
     namespace Plugin {
 
@@ -357,6 +556,35 @@ namespace WPEFramework {
             private:
                 std::function<void()> _work;
             };
+            // a screen capture handed to the worker pool, owned by the job. Deinitialize waits for
+            // it, the count drops once the job is released, also when it was dropped without running
+            class PendingScreenshot {
+            public:
+                PendingScreenshot(uint8_t* data)
+                    : _data(data)
+                {
+                    std::lock_guard<std::mutex> lock(gScreenshotMutex);
+                    gPendingScreenshots++;
+                }
+                ~PendingScreenshot()
+                {
+                    free(_data);
+                    {
+                        std::lock_guard<std::mutex> lock(gScreenshotMutex);
+                        gPendingScreenshots--;
+                    }
+                    gScreenshotCondVariable.notify_all();
+                }
+                PendingScreenshot(const PendingScreenshot&) = delete;
+                PendingScreenshot& operator=(const PendingScreenshot&) = delete;
+                uint8_t* data() const
+                {
+                    return _data;
+                }
+
+            private:
+                uint8_t* _data;
+            };
             uint32_t cloneService(PluginHost::IShell* shell, const string& basecallsign, const string& newcallsign)
             {
                 uint32_t result = Core::ERROR_ASYNC_FAILED;
@@ -502,6 +730,88 @@ namespace WPEFramework {
                 event.Lock();
                 return result;
             }
+
+            // reads an RFC parameter on the worker pool so the lookup overlaps with the
+            // launch steps before the value is needed
+            class RFCPrefetch
+            {
+            public:
+                RFCPrefetch()
+                    : mEvent(false, true)
+                    , mName(nullptr)
+                    , mStarted(false)
+                    , mResult(false)
+                {
+                    memset(&mParam, 0, sizeof(mParam));
+                }
+                ~RFCPrefetch()
+                {
+                    wait();
+                }
+                void start(const char* name)
+                {
+                    mName = name;
+                    mStarted = true;
+#ifndef USE_THUNDER_R4
+                    Core::IWorkerPool::Instance().Submit(Core::ProxyType<Core::IDispatchType<void>>(Core::ProxyType<Job>::Create([this, name]() {
+#else
+                    Core::IWorkerPool::Instance().Submit(Core::ProxyType<Core::IDispatch>(Core::ProxyType<Job>::Create([this, name]() {
+#endif /* USE_THUNDER_R4 */
+                        mResult = Utils::getRFCConfig(name, mParam);
+                        mEvent.SetEvent();
+                    })));
+                }
+                bool get(const char* name, RFC_ParamData_t& param)
+                {
+                    if (!mStarted || (strcmp(mName, name) != 0))
+                    {
+                        return Utils::getRFCConfig(name, param);
+                    }
+                    wait();
+                    param = mParam;
+                    return mResult;
+                }
+
+            private:
+                void wait()
+                {
+                    if (mStarted)
+                    {
+                        mEvent.Lock();
+                    }
+                }
+
+                Core::Event mEvent;
+                const char* mName;
+                bool mStarted;
+                bool mResult;
+                RFC_ParamData_t mParam;
+            };
+
+            const char* dobbyRFCForType(const string& type)
+            {
+                if (type == "Netflix")
+                {
+                    return "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Netflix.Enable";
+                }
+                if (type == "Cobalt")
+                {
+                    return "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Cobalt.Enable";
+                }
+                if ((type == "HtmlApp") || (type == "LightningApp"))
+                {
+                    return "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.WPE.Enable";
+                }
+                if (type == "SearchAndDiscoveryApp")
+                {
+                    return "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.SAD.Enable";
+                }
+                if (type == "Amazon")
+                {
+                    return "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Amazon.Enable";
+                }
+                return nullptr;
+            }
         }
 
         struct JSONRPCDirectLink
@@ -693,13 +1003,17 @@ namespace WPEFramework {
                JsonObject params;
                params["client"] = mCallSign;
                params["launchType"] = (isSuspended)?"suspend":"resume";
+               JsonObject timings;
+               gLaunchTracer.completePending(mCallSign, "stateChange");
+               if (gLaunchTracer.latestToJson(mCallSign, timings))
+               {
+                   params["timings"] = timings;
+               }
                mRDKShell.notify(RDKShell::RDKSHELL_EVENT_ON_LAUNCHED, params);
                mLaunchEnabled = false;
             }
 #ifdef HIBERNATE_SUPPORT_ENABLED
-            gSuspendedOrHibernatedApplicationsMutex.lock();
-            gSuspendedOrHibernatedApplications[mCallSign] = isSuspended;
-            gSuspendedOrHibernatedApplicationsMutex.unlock();
+            gAppRegistry.setSuspended(mCallSign, isSuspended);
 #endif
 
             if (isSuspended)
@@ -720,15 +1034,17 @@ namespace WPEFramework {
                     if (!l2s && (mCallSign.find("Netflix") != std::string::npos || mCallSign.find("Cobalt") != std::string::npos || mCallSign.find("Amazon") != std::string::npos || mCallSign.find("YouTube") != std::string::npos))
                     {
                         // call RDKShell.hibernate
-                        std::thread requestsThread =
-                            std::thread([=]()
+                        const std::string callsign = mCallSign;
+                        RDKShell& shell = mRDKShell;
+                        if (!gRequestPool.submit(RequestPool::LOW, callsign, [callsign, &shell]()
                                         {
                         JsonObject hibernateParams;
                         JsonObject hibernatetResponse;
-                        hibernateParams["callsign"] = mCallSign;
-                        mRDKShell.getThunderControllerClient("org.rdk.RDKShell.1")->Invoke<JsonObject, JsonObject>(0, "hibernate", hibernateParams, hibernatetResponse); });
-
-                        requestsThread.detach();
+                        hibernateParams["callsign"] = callsign;
+                        shell.getThunderControllerClient("org.rdk.RDKShell.1")->Invoke<JsonObject, JsonObject>(0, "hibernate", hibernateParams, hibernatetResponse); }))
+                        {
+                            std::cout << "request queue is full, not hibernating " << callsign << std::endl;
+                        }
                     }
                 }
 #endif
@@ -748,14 +1064,12 @@ namespace WPEFramework {
             std::string rfc;
             std::string thunderApi;
             JsonObject params;
+            std::string name;
+            std::vector<std::string> dependsOn;
         };
 
-        std::map<std::string, PluginData> gActivePluginsData;
         std::map<std::string, PluginStateChangeData*> gPluginsEventListener;
         std::vector<RDKShellStartupConfig> gStartupConfigs;
-        std::map<std::string, bool> gDestroyApplications;
-        std::map<std::string, bool> gExternalDestroyApplications;
-        std::map<std::string, bool> gLaunchApplications;
         std::map<std::string, AppLastExitReason> gApplicationsExitReason;
         std::map<std::string, std::string> gPluginDisplayNameMap;
         
@@ -777,13 +1091,156 @@ namespace WPEFramework {
           return flag;
         }
 
+        // parses one entry of the keys parameter of addKeyListeners and removeKeyListeners
+        bool parseKeyListener(const string& client, const JsonObject& keyInfo, KeyDispatchTable::Registration& registration,
+            std::map<std::string, RdkShellData>& properties)
+        {
+            if (keyInfo.HasLabel("keyCode") && keyInfo.HasLabel("nativeKeyCode"))
+            {
+                std::cout << "ERROR: keyCode and nativeKeyCode can't be set both at the same time" << std::endl;
+                return false;
+            }
+            if (!keyInfo.HasLabel("keyCode") && !keyInfo.HasLabel("nativeKeyCode"))
+            {
+                std::cout << "ERROR: Neither keyCode nor nativeKeyCode provided" << std::endl;
+                return false;
+            }
+            const char* label = keyInfo.HasLabel("keyCode") ? "keyCode" : "nativeKeyCode";
+            registration.type = keyInfo.HasLabel("keyCode") ? KeyDispatchTable::KEY_LISTENER : KeyDispatchTable::NATIVE_KEY_LISTENER;
+            registration.client = client;
+            std::string keystring = keyInfo[label].String();
+            if (keystring.compare("*") == 0)
+            {
+                registration.keyCode = ANY_KEY;
+            }
+            else
+            {
+                registration.keyCode = keyInfo[label].Number();
+            }
+            const JsonArray modifiers = keyInfo.HasLabel("modifiers") ? keyInfo["modifiers"].Array() : JsonArray();
+            registration.flags = 0;
+            for (int i=0; i<modifiers.Length(); i++) {
+              registration.flags |= getKeyFlag(modifiers[i].String());
+            }
+            if (keyInfo.HasLabel("activate"))
+            {
+                registration.activate = keyInfo["activate"].Boolean();
+                properties["activate"] = registration.activate;
+            }
+            if (keyInfo.HasLabel("propagate"))
+            {
+                registration.propagate = keyInfo["propagate"].Boolean();
+                properties["propagate"] = registration.propagate;
+            }
+            return true;
+        }
+
+        // compositor side of the key dispatch table, called with gRdkShellMutex held
+        bool registerKey(const KeyDispatchTable::Registration& registration, const std::map<std::string, RdkShellData>& properties)
+        {
+            if (registration.type == KeyDispatchTable::INTERCEPT)
+            {
+                return CompositorController::addKeyIntercept(registration.client, registration.keyCode, registration.flags);
+            }
+            else if (registration.type == KeyDispatchTable::KEY_LISTENER)
+            {
+                return CompositorController::addKeyListener(registration.client, registration.keyCode, registration.flags, properties);
+            }
+            return CompositorController::addNativeKeyListener(registration.client, registration.keyCode, registration.flags, properties);
+        }
+
+        bool unregisterKey(const KeyDispatchTable::Registration& registration)
+        {
+            if (registration.type == KeyDispatchTable::INTERCEPT)
+            {
+                return CompositorController::removeKeyIntercept(registration.client, registration.keyCode, registration.flags);
+            }
+            else if (registration.type == KeyDispatchTable::KEY_LISTENER)
+            {
+                return CompositorController::removeKeyListener(registration.client, registration.keyCode, registration.flags);
+            }
+            return CompositorController::removeNativeKeyListener(registration.client, registration.keyCode, registration.flags);
+        }
+
+        // registers all of the keys or none of them, called with gRdkShellMutex held
+        bool registerKeys(const std::vector<KeyDispatchTable::Registration>& registrations, const std::vector<std::map<std::string, RdkShellData>>& properties)
+        {
+            size_t registered = 0;
+            for (; registered < registrations.size(); registered++)
+            {
+                if (!registerKey(registrations[registered], properties[registered]))
+                {
+                    break;
+                }
+            }
+            if (registered == registrations.size())
+            {
+                return true;
+            }
+            for (size_t i = 0; i < registered; i++)
+            {
+                // keys the client had before this batch stay registered
+                if (!gKeyDispatchTable.contains(registrations[i]))
+                {
+                    unregisterKey(registrations[i]);
+                }
+            }
+            return false;
+        }
+
+        // clients a key goes to, for the input latency per client. Called with gRdkShellMutex held
+        std::vector<std::string> keyTargets(uint32_t keyCode, uint32_t flags)
+        {
+            KeyDispatchTable::Route route;
+            gKeyDispatchTable.lookup(KeyDispatchTable::KEY_LISTENER, keyCode, flags, route);
+            std::vector<std::string> clients(route.intercepts);
+            for (size_t i = 0; i < route.listeners.size(); i++)
+            {
+                clients.push_back(route.listeners[i].client);
+            }
+            std::string focusedClient;
+            if (route.intercepts.empty() && CompositorController::getFocused(focusedClient) && !focusedClient.empty())
+            {
+                clients.push_back(focusedClient);
+            }
+            std::sort(clients.begin(), clients.end());
+            clients.erase(std::unique(clients.begin(), clients.end()), clients.end());
+            return clients;
+        }
+
         SERVICE_REGISTRATION(RDKShell, API_VERSION_NUMBER_MAJOR, API_VERSION_NUMBER_MINOR, API_VERSION_NUMBER_PATCH);
 
         RDKShell* RDKShell::_instance = nullptr;
         std::mutex gRdkShellMutex;
         std::mutex gPluginDataMutex;
-        std::mutex gLaunchDestroyMutex;
-        std::mutex gDestroyMutex;
+        // deactivation and interface queries of one app are serialized, different apps
+        // are torn down in parallel
+        std::mutex gDestroyMutexesLock;
+        std::map<std::string, std::shared_ptr<std::mutex>> gDestroyMutexes;
+
+        static std::shared_ptr<std::mutex> destroyMutex(const std::string& callsign)
+        {
+            std::lock_guard<std::mutex> lock(gDestroyMutexesLock);
+            std::shared_ptr<std::mutex>& appMutex = gDestroyMutexes[callsign];
+            if (!appMutex)
+            {
+                appMutex = std::make_shared<std::mutex>();
+            }
+            return appMutex;
+        }
+
+        // drops the mutex of an app once nobody else uses it, so the map does not keep
+        // an entry for every app that was ever launched
+        static void releaseDestroyMutex(const std::string& callsign, std::shared_ptr<std::mutex>& appMutex)
+        {
+            appMutex.reset();
+            std::lock_guard<std::mutex> lock(gDestroyMutexesLock);
+            std::map<std::string, std::shared_ptr<std::mutex>>::iterator it = gDestroyMutexes.find(callsign);
+            if ((it != gDestroyMutexes.end()) && (it->second.use_count() == 1))
+            {
+                gDestroyMutexes.erase(it);
+            }
+        }
 
         std::mutex gLaunchMutex;
         std::mutex gExitReasonMutex;
@@ -794,7 +1251,7 @@ namespace WPEFramework {
 
         struct CreateDisplayRequest
         {
-            CreateDisplayRequest(std::string client, std::string displayName, uint32_t displayWidth=0, uint32_t displayHeight=0, bool virtualDisplayEnabled=false, uint32_t virtualWidth=0, uint32_t virtualHeight=0, bool topmost = false, bool focus = false): mClient(client), mDisplayName(displayName), mDisplayWidth(displayWidth), mDisplayHeight(displayHeight), mVirtualDisplayEnabled(virtualDisplayEnabled), mVirtualWidth(virtualWidth),mVirtualHeight(virtualHeight), mTopmost(topmost), mFocus(focus), mResult(false) , mAutoDestroy(true)
+            CreateDisplayRequest(std::string client, std::string displayName, uint32_t displayWidth=0, uint32_t displayHeight=0, bool virtualDisplayEnabled=false, uint32_t virtualWidth=0, uint32_t virtualHeight=0, bool topmost = false, bool focus = false): mClient(client), mDisplayName(displayName), mDisplayWidth(displayWidth), mDisplayHeight(displayHeight), mVirtualDisplayEnabled(virtualDisplayEnabled), mVirtualWidth(virtualWidth),mVirtualHeight(virtualHeight), mTopmost(topmost), mFocus(focus), mResult(false) , mAutoDestroy(true), mToken(0)
             {
                 sem_init(&mSemaphore, 0, 0);
             }
@@ -816,11 +1273,13 @@ namespace WPEFramework {
             sem_t mSemaphore;
             bool mResult;
 	    bool mAutoDestroy;
+            uint32_t mToken;
+            RDKShell::DisplayRequestCompletion mCompletion;
         };
 
         struct KillClientRequest
         {
-            KillClientRequest(std::string client): mClient(client), mResult(false)
+            KillClientRequest(std::string client): mClient(client), mResult(false), mToken(0)
             {
                 sem_init(&mSemaphore, 0, 0);
             }
@@ -833,14 +1292,40 @@ namespace WPEFramework {
             std::string mClient;
             sem_t mSemaphore;
             bool mResult;
+            uint32_t mToken;
+            RDKShell::DisplayRequestCompletion mCompletion;
         };
 
         std::vector<std::shared_ptr<CreateDisplayRequest>> gCreateDisplayRequests;
         std::vector<std::shared_ptr<KillClientRequest>> gKillClientRequests;
+        // guarded by gRdkShellMutex, 0 is never handed out
+        uint32_t gDisplayRequestToken = 0;
+
+        struct AnimationTimeline
+        {
+            struct Animation
+            {
+                std::string client;
+                double duration;
+                std::map<std::string, RdkShellData> properties;
+            };
+
+            std::string id;
+            std::vector<Animation> animations;
+            // longest duration plus delay of the animations, in seconds
+            double length;
+            double requestTime;
+            double startTime;
+        };
+
+        // timelines waiting for the render thread and timelines it has started, guarded by gRdkShellMutex
+        std::vector<std::shared_ptr<AnimationTimeline>> gAnimationTimelines;
+        std::vector<std::shared_ptr<AnimationTimeline>> gRunningAnimationTimelines;
+        uint32_t gAnimationTimelineCount = 0;
 
-        void RDKShell::launchRequestThread(RDKShellApiRequest apiRequest)
+        bool RDKShell::launchRequestThread(RDKShellApiRequest apiRequest)
         {
-	    std::thread rdkshellRequestsThread = std::thread([=]() {
+            bool submitted = gRequestPool.submit(RequestPool::NORMAL, string(), [=]() {
                 JsonObject result;
                 std::string requestName = apiRequest.mName;
                 if (requestName.compare("launchFactoryApp") == 0)
@@ -863,6 +1348,11 @@ namespace WPEFramework {
                 {
                     launchFactoryAppShortcutWrapper(apiRequest.mRequest, result);
                 }
+                else if (requestName.compare("warmPoolPrelaunch") == 0)
+                {
+                    JsonObject request = apiRequest.mRequest;
+                    launchApp(request, result, (uint32_t)request["warmPoolRequest"].Number());
+                }
 		else if (requestName.compare("deactivateresidentapp") == 0)
                 {
                     auto deactivateStatus = deactivate(mCurrentService, "ResidentApp");
@@ -898,7 +1388,11 @@ namespace WPEFramework {
                     thunderController->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, api.c_str(), apiRequest.mRequest, joResult);
                 } 
             });
-            rdkshellRequestsThread.detach();
+            if (!submitted)
+            {
+                std::cout << "unable to queue request " << apiRequest.mName << std::endl;
+            }
+            return submitted;
         }
 
         void lockRdkShellMutex()
@@ -920,6 +1414,16 @@ namespace WPEFramework {
             }*/
         }
 
+        // holds gRdkShellMutex for a scope, taken the same way as lockRdkShellMutex
+        class RdkShellMutexLock
+        {
+        public:
+            RdkShellMutexLock() { lockRdkShellMutex(); }
+            ~RdkShellMutexLock() { gRdkShellMutex.unlock(); }
+            RdkShellMutexLock(const RdkShellMutexLock&) = delete;
+            RdkShellMutexLock& operator=(const RdkShellMutexLock&) = delete;
+        };
+
         static bool isClientExists(std::string client)
         {
             bool exist = false;
@@ -1050,20 +1554,14 @@ namespace WPEFramework {
                            gRdkShellMutex.lock();
                            gCreateDisplayRequests.push_back(request);
                            gRdkShellMutex.unlock();
+                           wakeRenderThread();
                            sem_wait(&request->mSemaphore);
                        }
                        gRdkShellMutex.lock();
                        RdkShell::CompositorController::addListener(service->Callsign(), mShell.mEventListener);
                        gRdkShellMutex.unlock();
-                       gPluginDataMutex.lock();
-                       std::string className = service->ClassName();
-                       PluginData pluginData;
-                       pluginData.mClassName = className;
-                       if (gActivePluginsData.find(serviceCallsign) == gActivePluginsData.end())
-                       {
-                           gActivePluginsData[serviceCallsign] = pluginData;
-                       }
-                       gPluginDataMutex.unlock();
+                       gAppRegistry.activate(serviceCallsign, service->ClassName());
+                       gResourceTable.requestRefresh();
                    }
                 }
            }
@@ -1108,12 +1606,7 @@ namespace WPEFramework {
         {
             if (service)
             {
-		 gLaunchDestroyMutex.lock();
-                if (gDestroyApplications.find(service->Callsign()) == gDestroyApplications.end())
-                {
-                     gExternalDestroyApplications[service->Callsign()] = true;
-                }
-                    gLaunchDestroyMutex.unlock();
+                gAppRegistry.beginExternalDestroy(service->Callsign());
                     StateControlNotification* notification = nullptr;
                     gPluginDataMutex.lock();
                     auto notificationIt = gStateNotifications.find(service->Callsign());
@@ -1138,13 +1631,7 @@ namespace WPEFramework {
 
 #ifdef HIBERNATE_SUPPORT_ENABLED
                 //Reset app suspended/hibernated
-                gSuspendedOrHibernatedApplicationsMutex.lock();
-                auto suspendedOrHibernatedIt = gSuspendedOrHibernatedApplications.find(service->Callsign());
-                if (suspendedOrHibernatedIt != gSuspendedOrHibernatedApplications.end())
-                {
-                    gSuspendedOrHibernatedApplications.erase(suspendedOrHibernatedIt);
-                }
-                gSuspendedOrHibernatedApplicationsMutex.unlock();
+                gAppRegistry.resetSuspended(service->Callsign());
 #endif
                 if(service->Reason() == PluginHost::IShell::FAILURE)
                 {
@@ -1171,18 +1658,16 @@ namespace WPEFramework {
                     gRdkShellMutex.lock();
                     gKillClientRequests.push_back(request);
                     gRdkShellMutex.unlock();
+                    wakeRenderThread();
                     sem_wait(&request->mSemaphore);
                     gRdkShellMutex.lock();
                     RdkShell::CompositorController::removeListener(service->Callsign(), mShell.mEventListener);
                     gRdkShellMutex.unlock();
                 }
                 
+                gAppRegistry.deactivate(service->Callsign());
+                gResourceTable.requestRefresh();
                 gPluginDataMutex.lock();
-                std::map<std::string, PluginData>::iterator pluginToRemove = gActivePluginsData.find(service->Callsign());
-                if (pluginToRemove != gActivePluginsData.end())
-                {
-                    gActivePluginsData.erase(pluginToRemove);
-                }
                 std::map<std::string, PluginStateChangeData*>::iterator pluginStateChangeEntry = gPluginsEventListener.find(service->Callsign());
                 if (pluginStateChangeEntry != gPluginsEventListener.end())
                 {
@@ -1196,12 +1681,8 @@ namespace WPEFramework {
                     gPluginsEventListener.erase(pluginStateChangeEntry);
                 }
                 gPluginDataMutex.unlock();
-                gLaunchDestroyMutex.lock();
-                if (gExternalDestroyApplications.find(service->Callsign()) != gExternalDestroyApplications.end())
-                {
-                    gExternalDestroyApplications.erase(service->Callsign());
-                }
-                gLaunchDestroyMutex.unlock();
+                gAppRegistry.endExternalDestroy(service->Callsign());
+                gRequestPool.cancel(service->Callsign());
             }
         }
 
@@ -1217,13 +1698,7 @@ namespace WPEFramework {
                      gApplicationsExitReason[service->Callsign()] = AppLastExitReason::DEACTIVATED;
 #ifdef HIBERNATE_SUPPORT_ENABLED
                     //Reset app suspended/hibernated on Deactivation/Destroy
-                    gSuspendedOrHibernatedApplicationsMutex.lock();
-                    auto suspendedOrHibernatedIt = gSuspendedOrHibernatedApplications.find(service->Callsign());
-                    if (suspendedOrHibernatedIt != gSuspendedOrHibernatedApplications.end())
-                    {
-                        gSuspendedOrHibernatedApplications.erase(suspendedOrHibernatedIt);
-                    }
-                    gSuspendedOrHibernatedApplicationsMutex.unlock();
+                    gAppRegistry.resetSuspended(service->Callsign());
 #endif
                 }
                 if(service->Reason() == PluginHost::IShell::FAILURE)
@@ -1255,20 +1730,14 @@ namespace WPEFramework {
                            gRdkShellMutex.lock();
                            gCreateDisplayRequests.push_back(request);
                            gRdkShellMutex.unlock();
+                           wakeRenderThread();
                            sem_wait(&request->mSemaphore);
                        }
                        gRdkShellMutex.lock();
                        RdkShell::CompositorController::addListener(service->Callsign(), mShell.mEventListener);
                        gRdkShellMutex.unlock();
-                       gPluginDataMutex.lock();
-                       std::string className = service->ClassName();
-                       PluginData pluginData;
-                       pluginData.mClassName = className;
-                       if (gActivePluginsData.find(serviceCallsign) == gActivePluginsData.end())
-                       {
-                           gActivePluginsData[serviceCallsign] = pluginData;
-                       }
-                       gPluginDataMutex.unlock();
+                       gAppRegistry.activate(serviceCallsign, service->ClassName());
+                       gResourceTable.requestRefresh();
                    }
                 }
                 else if (currentState == PluginHost::IShell::ACTIVATED && service->Callsign() == WPEFramework::Plugin::RDKShell::SERVICE_NAME)
@@ -1312,12 +1781,7 @@ namespace WPEFramework {
                 }
                 else if (currentState == PluginHost::IShell::DEACTIVATION)
                 {
-                    gLaunchDestroyMutex.lock();
-                    if (gDestroyApplications.find(service->Callsign()) == gDestroyApplications.end())
-                    {
-                        gExternalDestroyApplications[service->Callsign()] = true;
-                    }
-                    gLaunchDestroyMutex.unlock();
+                    gAppRegistry.beginExternalDestroy(service->Callsign());
                     StateControlNotification* notification = nullptr;
                     gPluginDataMutex.lock();
                     auto notificationIt = gStateNotifications.find(service->Callsign());
@@ -1353,18 +1817,16 @@ namespace WPEFramework {
                         gRdkShellMutex.lock();
                         gKillClientRequests.push_back(request);
                         gRdkShellMutex.unlock();
+                        wakeRenderThread();
                         sem_wait(&request->mSemaphore);
                         gRdkShellMutex.lock();
                         RdkShell::CompositorController::removeListener(service->Callsign(), mShell.mEventListener);
                         gRdkShellMutex.unlock();
                     }
                     
+                    gAppRegistry.deactivate(service->Callsign());
+                    gResourceTable.requestRefresh();
                     gPluginDataMutex.lock();
-                    std::map<std::string, PluginData>::iterator pluginToRemove = gActivePluginsData.find(service->Callsign());
-                    if (pluginToRemove != gActivePluginsData.end())
-                    {
-                        gActivePluginsData.erase(pluginToRemove);
-                    }
                     std::map<std::string, PluginStateChangeData*>::iterator pluginStateChangeEntry = gPluginsEventListener.find(service->Callsign());
                     if (pluginStateChangeEntry != gPluginsEventListener.end())
                     {
@@ -1378,12 +1840,8 @@ namespace WPEFramework {
                         gPluginsEventListener.erase(pluginStateChangeEntry);
                     }
                     gPluginDataMutex.unlock();
-                    gLaunchDestroyMutex.lock();
-                    if (gExternalDestroyApplications.find(service->Callsign()) != gExternalDestroyApplications.end())
-                    {
-                        gExternalDestroyApplications.erase(service->Callsign());
-                    }
-                    gLaunchDestroyMutex.unlock();
+                    gAppRegistry.endExternalDestroy(service->Callsign());
+                    gRequestPool.cancel(service->Callsign());
                 }
             }
         }
@@ -1442,6 +1900,7 @@ namespace WPEFramework {
                 mCurrentService(nullptr), mLastWakeupKeyCode(0),
                 mLastWakeupKeyModifiers(0),
                 mLastWakeupKeyTimestamp(0),
+                m_timer("RDKShell.SystemServices"),
                 mEnableEasterEggs(true),
                 mScreenCapture(this),
                 mErmEnabled(false),
@@ -1538,6 +1997,23 @@ namespace WPEFramework {
             Register(RDKSHELL_METHOD_SET_GRAPHICS_FRAME_RATE, &RDKShell::setGraphicsFrameRateWrapper, this);
             Register(RDKSHELL_METHOD_SET_AV_BLOCKED, &RDKShell::setAVBlockedWrapper, this);
             Register(RDKSHELL_METHOD_GET_AV_BLOCKED_APPS, &RDKShell::getBlockedAVApplicationsWrapper, this);
+            Register(RDKSHELL_METHOD_GET_FRAME_STATS, &RDKShell::getFrameStatsWrapper, this);
+            Register(RDKSHELL_METHOD_GET_LAUNCH_TIMINGS, &RDKShell::getLaunchTimingsWrapper, this);
+            Register(RDKSHELL_METHOD_GET_REQUEST_QUEUE_STATS, &RDKShell::getRequestQueueStatsWrapper, this);
+            Register(RDKSHELL_METHOD_APPLY_TRANSACTION, &RDKShell::applyTransactionWrapper, this);
+            Register(RDKSHELL_METHOD_SET_MEMORY_PRESSURE_POLICY, &RDKShell::setMemoryPressurePolicyWrapper, this);
+            Register(RDKSHELL_METHOD_GET_MEMORY_PRESSURE_STATUS, &RDKShell::getMemoryPressureStatusWrapper, this);
+            Register(RDKSHELL_METHOD_SET_WARM_POOL_CONFIG, &RDKShell::setWarmPoolConfigWrapper, this);
+            Register(RDKSHELL_METHOD_GET_WARM_POOL_STATUS, &RDKShell::getWarmPoolStatusWrapper, this);
+            Register(RDKSHELL_METHOD_SET_EVENT_COALESCING, &RDKShell::setEventCoalescingWrapper, this);
+            Register(RDKSHELL_METHOD_GET_EVENT_COALESCING, &RDKShell::getEventCoalescingWrapper, this);
+            Register(RDKSHELL_METHOD_GET_KEY_ROUTE, &RDKShell::getKeyRouteWrapper, this);
+            Register(RDKSHELL_METHOD_GET_INPUT_LATENCY, &RDKShell::getInputLatencyWrapper, this);
+            Register(RDKSHELL_METHOD_ADD_ANIMATION_TIMELINE, &RDKShell::addAnimationTimelineWrapper, this);
+            Register(RDKSHELL_METHOD_GET_STARTUP_TIMELINE, &RDKShell::getStartupTimelineWrapper, this);
+            Register(RDKSHELL_METHOD_GET_TEARDOWN_REPORT, &RDKShell::getTeardownReportWrapper, this);
+            Register(RDKSHELL_METHOD_GET_RIALTO_STATS, &RDKShell::getRialtoStatsWrapper, this);
+            Register(RDKSHELL_METHOD_GET_TIMER_STATS, &RDKShell::getTimerStatsWrapper, this);
 #ifdef HIBERNATE_SUPPORT_ENABLED
             Register(RDKSHELL_METHOD_HIBERNATE, &RDKShell::hibernateWrapper, this);
             Register(RDKSHELL_METHOD_RESTORE, &RDKShell::restoreWrapper, this);
@@ -1566,6 +2042,168 @@ namespace WPEFramework {
 
             mCurrentService = service;
             CompositorController::setEventListener(mEventListener);
+            unsigned int requestThreads = RDKSHELL_REQUEST_THREADS;
+            char* requestThreadsValue = getenv("RDKSHELL_REQUEST_THREADS");
+            if ((NULL != requestThreadsValue) && (atoi(requestThreadsValue) > 0))
+            {
+                requestThreads = atoi(requestThreadsValue);
+            }
+            gRequestPool.start(requestThreads, RDKSHELL_REQUEST_QUEUE_SIZE);
+            // the startup entries are added again every time the plugin is initialized
+            gStartupScheduler.clear();
+            char* eventCoalescingValue = getenv("RDKSHELL_EVENT_COALESCING");
+            if ((NULL == eventCoalescingValue) || (strcmp(eventCoalescingValue, "false") != 0))
+            {
+                // state-type events, only the latest focus and size change of each client matters
+                std::vector<EventCoalescer::Rule> coalescingRules(3);
+                coalescingRules[0].event = RDKSHELL_EVENT_ON_APP_FOCUSCHANGED;
+                coalescingRules[0].window = RDKSHELL_EVENT_COALESCING_WINDOW_IN_MS;
+                coalescingRules[1].event = RDKSHELL_EVENT_SIZE_CHANGE_COMPLETE;
+                coalescingRules[1].window = RDKSHELL_EVENT_COALESCING_WINDOW_IN_MS;
+                coalescingRules[1].key = "client";
+                coalescingRules[2].event = RDKSHELL_EVENT_ON_USER_INACTIVITY;
+                coalescingRules[2].window = RDKSHELL_EVENT_COALESCING_WINDOW_IN_MS;
+                gEventCoalescer.setRules(coalescingRules);
+            }
+            gEventCoalescer.start([this](const std::string& event, const JsonObject& parameters) { sendNotify(event.c_str(), parameters); });
+            unsigned int resourceRefreshInterval = RDKSHELL_RESOURCE_REFRESH_INTERVAL_IN_MS;
+            char* resourceRefreshIntervalValue = getenv("RDKSHELL_RESOURCE_REFRESH_INTERVAL");
+            if ((NULL != resourceRefreshIntervalValue) && (atoi(resourceRefreshIntervalValue) > 0))
+            {
+                resourceRefreshInterval = atoi(resourceRefreshIntervalValue);
+            }
+            gResourceTable.start(resourceRefreshInterval, []() {
+                std::vector<std::string> callsigns;
+                std::vector<AppRegistry::AppPtr> apps = gAppRegistry.activeApps();
+                for (size_t i = 0; i < apps.size(); i++)
+                {
+                    if (!apps[i]->destroying && !apps[i]->externalDestroying)
+                    {
+                        callsigns.push_back(apps[i]->callsign);
+                    }
+                }
+                return callsigns;
+            }, [this](const std::string& callsign) {
+                // querying IMemory of a suspended or hibernated plugin may restore it, those keep their last sample
+#ifdef HIBERNATE_SUPPORT_ENABLED
+                // and hibernations wait until the query of a resumed plugin returns
+                setHibernateBlocked(true);
+#endif
+                AppRegistry::AppPtr app = gAppRegistry.find(callsign);
+                const bool suspended = app && app->suspendStateKnown && app->suspended;
+                int32_t ram = suspended ? ResourceTable::NOT_SAMPLED : pluginMemoryUsage(callsign);
+#ifdef HIBERNATE_SUPPORT_ENABLED
+                setHibernateBlocked(false);
+#endif
+                return ram;
+            });
+            MemoryPressureManager::Config memoryPressureConfig = gMemoryPressure.config();
+#ifdef HIBERNATE_SUPPORT_ENABLED
+            memoryPressureConfig.hibernateSupported = true;
+#endif
+            char* memoryPressurePolicyValue = getenv("RDKSHELL_ENABLE_MEMORY_PRESSURE_POLICY");
+            if ((NULL != memoryPressurePolicyValue) && (strcmp(memoryPressurePolicyValue, "true") == 0))
+            {
+                memoryPressureConfig.enabled = true;
+            }
+            gMemoryPressure.configure(memoryPressureConfig);
+            gMemoryPressure.start([]() {
+                // background apps only, the resident app and visible or focused apps are never evicted
+                std::vector<MemoryPressureManager::Candidate> candidates;
+                std::vector<AppRegistry::AppPtr> apps = gAppRegistry.activeApps();
+                std::string focusedClient;
+                lockRdkShellMutex();
+                CompositorController::getFocused(focusedClient);
+                for (size_t i = 0; i < apps.size(); i++)
+                {
+                    const AppRegistry::App& app = *apps[i];
+                    if (app.launching || app.destroying || app.externalDestroying || (app.callsign == RESIDENTAPP_CALLSIGN))
+                    {
+                        continue;
+                    }
+                    const std::string client = toLower(app.callsign);
+                    bool visible = false;
+                    CompositorController::getVisibility(client, visible);
+                    if (visible || (client == focusedClient))
+                    {
+                        continue;
+                    }
+                    MemoryPressureManager::Candidate candidate;
+                    candidate.callsign = app.callsign;
+                    candidate.lastUsed = app.lastUsed;
+                    candidate.suspended = app.suspendStateKnown && app.suspended;
+                    candidates.push_back(candidate);
+                }
+                gRdkShellMutex.unlock();
+                for (size_t i = 0; i < candidates.size(); i++)
+                {
+                    candidates[i].ram = gResourceTable.residentMemory(candidates[i].callsign);
+                }
+                return candidates;
+            }, [this](const std::string& callsign, MemoryPressureManager::Action action) {
+                JsonObject request;
+                request["callsign"] = callsign;
+                RDKShellApiRequest apiRequest;
+                apiRequest.mName = MemoryPressureManager::actionName(action);
+                apiRequest.mRequest = request;
+                if (!launchRequestThread(apiRequest))
+                {
+                    return false;
+                }
+                JsonObject params;
+                params["callsign"] = callsign;
+                params["action"] = MemoryPressureManager::actionName(action);
+                notify(RDKSHELL_EVENT_ON_MEMORY_PRESSURE_ACTION, params);
+                return true;
+            });
+            WarmPool::Config warmPoolConfig = gWarmPool.config();
+            char* warmPoolValue = getenv("RDKSHELL_ENABLE_WARM_POOL");
+            if ((NULL != warmPoolValue) && (strcmp(warmPoolValue, "true") == 0))
+            {
+                warmPoolConfig.enabled = true;
+            }
+            gWarmPool.configure(warmPoolConfig);
+            std::string launchHistoryPath = RDKSHELL_LAUNCH_HISTORY_PATH;
+            char* launchHistoryPathValue = getenv("RDKSHELL_LAUNCH_HISTORY_PATH");
+            if (NULL != launchHistoryPathValue)
+            {
+                launchHistoryPath = launchHistoryPathValue;
+            }
+            WarmPool::Callbacks warmPoolCallbacks;
+            warmPoolCallbacks.canPrelaunch = []() {
+                // no launch, destroy or other request is being worked on and memory is not short
+                return gRequestPool.isIdle() && !gAppRegistry.isAnyLaunching() && (gMemoryPressure.level() == MemoryPressureManager::NONE);
+            };
+            warmPoolCallbacks.isRunning = [](const std::string& callsign) { return gAppRegistry.isActive(callsign); };
+            warmPoolCallbacks.residentMemory = [](const std::string& callsign) { return gResourceTable.residentMemory(callsign); };
+            warmPoolCallbacks.prelaunch = [this](const std::string& callsign, const std::string& type, uint32_t id) {
+                JsonObject request;
+                request["callsign"] = callsign;
+                request["warmPoolRequest"] = id;
+                if (!type.empty())
+                {
+                    request["type"] = type;
+                }
+                request["suspend"] = true;
+                request["visible"] = false;
+                request["focused"] = false;
+                RDKShellApiRequest apiRequest;
+                apiRequest.mName = "warmPoolPrelaunch";
+                apiRequest.mRequest = request;
+                if (!launchRequestThread(apiRequest))
+                {
+                    gWarmPool.endPrelaunch(id, false);
+                }
+            };
+            warmPoolCallbacks.release = [this](const std::string& callsign) {
+                JsonObject request;
+                request["callsign"] = callsign;
+                RDKShellApiRequest apiRequest;
+                apiRequest.mName = "destroy";
+                apiRequest.mRequest = request;
+                launchRequestThread(apiRequest);
+            };
+            gWarmPool.start(launchHistoryPath, warmPoolCallbacks);
             bool factoryMacMatched = false;
 #ifdef RFC_ENABLED
             RFC_ParamData_t param;
@@ -1636,6 +2274,18 @@ namespace WPEFramework {
                 sFactoryModeBlockResidentApp = true;
             }
 
+            char* idleFramerateValue = getenv("RDKSHELL_IDLE_FRAMERATE");
+            if (NULL != idleFramerateValue)
+            {
+                int idleFramerate = atoi(idleFramerateValue);
+                if ((idleFramerate > 0) && (idleFramerate <= 1000))
+                {
+                    std::cout << "RDKShell idle framerate is set to " << idleFramerate << std::endl;
+                    gIdleFramerate = idleFramerate;
+                }
+            }
+            wakeRenderThread();
+
             mErmEnabled = CompositorController::isErmEnabled();
             sem_init(&gInitializeSemaphore, 0, 0);
             shellThread = std::thread([=]() {
@@ -1683,9 +2333,18 @@ namespace WPEFramework {
                 gRdkShellMutex.unlock();
                 gRdkShellSurfaceModeEnabled = CompositorController::isSurfaceModeEnabled();
                 sem_post(&gInitializeSemaphore);
+                // the last key the compositor received, keys from input devices do not pass the plugin
+                uint32_t lastKeyCode = 0, lastKeyModifiers = 0;
+                uint64_t lastKeyTime = 0;
+                // completions that did not fit in the request pool are kept for the next frame
+                std::vector<std::function<void()>> completions;
                 while(isRunning) {
-                  const double maxSleepTime = (1000 / gCurrentFramerate) * 1000;
+                  const bool idle = isRenderThreadIdle();
+                  const double frameBudget = (1000 / gCurrentFramerate) * 1000;
+                  const double maxSleepTime = idle ? (1000 / gIdleFramerate) * 1000 : frameBudget;
                   double startFrameTime = RdkShell::microseconds();
+                  FrameStats::Frame frame;
+                  frame.startTime = startFrameTime;
                   gRdkShellMutex.lock();
                   if (!sPersistentStorePreLaunchChecked)
                   {
@@ -1747,6 +2406,11 @@ namespace WPEFramework {
                       }
                       request->mResult = CompositorController::createDisplay(request->mClient, request->mDisplayName, request->mDisplayWidth, request->mDisplayHeight, request->mVirtualDisplayEnabled, request->mVirtualWidth, request->mVirtualHeight, request->mTopmost, request->mFocus , request->mAutoDestroy);
                       gCreateDisplayRequests.erase(gCreateDisplayRequests.begin());
+                      frame.createDisplayRequests++;
+                      if (request->mCompletion)
+                      {
+                          completions.push_back(std::bind(request->mCompletion, request->mToken, request->mResult));
+                      }
                       sem_post(&request->mSemaphore);
                   }
                   while (gKillClientRequests.size() > 0)
@@ -1759,69 +2423,180 @@ namespace WPEFramework {
                       }
                       request->mResult = CompositorController::kill(request->mClient);
                       gKillClientRequests.erase(gKillClientRequests.begin());
+                      frame.killClientRequests++;
+                      if (request->mCompletion)
+                      {
+                          completions.push_back(std::bind(request->mCompletion, request->mToken, request->mResult));
+                      }
                       sem_post(&request->mSemaphore);
                   }
+                  for (size_t i = 0; i < gAnimationTimelines.size(); i++)
+                  {
+                      // all animations of a timeline are added in the same frame
+                      std::shared_ptr<AnimationTimeline> timeline = gAnimationTimelines[i];
+                      timeline->startTime = RdkShell::microseconds();
+                      for (size_t a = 0; a < timeline->animations.size(); a++)
+                      {
+                          const AnimationTimeline::Animation& animation = timeline->animations[a];
+                          CompositorController::addAnimation(animation.client, animation.duration, animation.properties);
+                      }
+                      gRunningAnimationTimelines.push_back(timeline);
+                      frame.flagRequests++;
+                  }
+                  gAnimationTimelines.clear();
                   if (receivedResolutionRequest)
                   {
                     CompositorController::setScreenResolution(resolutionWidth, resolutionHeight);
                     receivedResolutionRequest = false;
+                    frame.flagRequests++;
                   }
                   if (receivedFullScreenImageRequest)
                   {
                     CompositorController::showFullScreenImage(fullScreenImagePath);
                     fullScreenImagePath = "";
                     receivedFullScreenImageRequest = false;
+                    frame.flagRequests++;
                   }
                   if (receivedShowWatermarkRequest)
                   {
                     CompositorController::showWatermark();
                     receivedShowWatermarkRequest = false;
+                    frame.flagRequests++;
                   }
                   if (receivedShowSplashScreenRequest)
                   {
                     CompositorController::showSplashScreen(gSplashScreenDisplayTime);
                     gSplashScreenDisplayTime = 0;
                     receivedShowSplashScreenRequest = false;
+                    frame.flagRequests++;
                   }
+                  double phaseStartTime = RdkShell::microseconds();
+                  frame.phaseTime[FrameStats::REQUESTS] = phaseStartTime - startFrameTime;
                   RdkShell::draw();
-                  if (needsScreenshot)
+                  double phaseEndTime = RdkShell::microseconds();
+                  frame.phaseTime[FrameStats::DRAW] = phaseEndTime - phaseStartTime;
+                  gInputLatency.frameRendered(phaseStartTime, phaseEndTime);
+                  phaseStartTime = phaseEndTime;
+                  if (needsScreenshot || !gScreenshotRequests.empty())
                   {
+                      frame.screenshot = true;
                       uint8_t* data = nullptr;
-                      uint32_t size;
-                      string screenshotBase64;
+                      uint32_t size = 0;
                       CompositorController::screenShot(data, size);
-		      Utils::String::imageEncoder(&data[0], size, true, screenshotBase64);
                       std::cout << "Screenshot success size:" << size << std::endl;
-                      JsonObject params;
-                      params["imageData"] = screenshotBase64;
-
-                      // Calling Notify instead of  RDKShell::notify to avoid logging of entire screen content
-                      LOGINFO("Notify %s", RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE.c_str());
-                      Notify(RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE, params);
 
                       unsigned int width = 0,height = 0;
-                      if (CompositorController::getScreenResolution(width, height))
-                          mScreenCapture.onScreenCapture(&data[0], width, height);
+                      if (!CompositorController::getScreenResolution(width, height))
+                      {
+                          width = 0;
+                          height = 0;
+                      }
 
-                      free(data);
+                      // encoding and delivery run on the worker pool so the frame is not held up
+                      const bool legacyScreenshot = needsScreenshot;
+                      std::vector<ScreenshotEncoder::Options> screenshotRequests;
+                      screenshotRequests.swap(gScreenshotRequests);
+                      std::shared_ptr<PendingScreenshot> screenshot = std::make_shared<PendingScreenshot>(data);
+#ifndef USE_THUNDER_R4
+                      Core::IWorkerPool::Instance().Submit(Core::ProxyType<Core::IDispatchType<void>>(Core::ProxyType<Job>::Create([=]() {
+#else
+                      Core::IWorkerPool::Instance().Submit(Core::ProxyType<Core::IDispatch>(Core::ProxyType<Job>::Create([=]() {
+#endif /* USE_THUNDER_R4 */
+                          processScreenshot(screenshot->data(), size, width, height, legacyScreenshot, screenshotRequests);
+                      })));
                       needsScreenshot = false;
                   }
+                  phaseEndTime = RdkShell::microseconds();
+                  frame.phaseTime[FrameStats::SCREENSHOT] = phaseEndTime - phaseStartTime;
+                  phaseStartTime = phaseEndTime;
                   RdkShell::update();
                   isRunning = sRunning;
+                  if (0 != gIdleFramerate)
+                  {
+                      // input is read in update(), a key keeps the framerate up for the frames it causes
+                      uint32_t keyCode = 0, keyModifiers = 0;
+                      uint64_t keyTime = 0;
+                      CompositorController::getLastKeyPress(keyCode, keyModifiers, keyTime);
+                      bool active = (keyCode != lastKeyCode) || (keyModifiers != lastKeyModifiers) || (keyTime != lastKeyTime);
+                      lastKeyCode = keyCode;
+                      lastKeyModifiers = keyModifiers;
+                      lastKeyTime = keyTime;
+                      if (!active)
+                      {
+                          // the compositor does not report damage, a visible client may draw at any time
+                          std::vector<std::string> clients;
+                          CompositorController::getClients(clients);
+                          for (size_t i = 0; (i < clients.size()) && !active; i++)
+                          {
+                              bool visible = false;
+                              active = CompositorController::getVisibility(clients[i], visible) && visible;
+                          }
+                      }
+                      if (active)
+                      {
+                          keepRenderThreadActive();
+                      }
+                  }
+                  phaseEndTime = RdkShell::microseconds();
+                  frame.phaseTime[FrameStats::UPDATE] = phaseEndTime - phaseStartTime;
+                  phaseStartTime = phaseEndTime;
+                  for (std::vector<std::shared_ptr<AnimationTimeline>>::iterator it = gRunningAnimationTimelines.begin(); it != gRunningAnimationTimelines.end();)
+                  {
+                      std::shared_ptr<AnimationTimeline> timeline = *it;
+                      if (phaseEndTime - timeline->startTime < timeline->length * 1000000)
+                      {
+                          it++;
+                          continue;
+                      }
+                      // the compositor does not report when an animation ends, only the start is measured
+                      completions.push_back([this, timeline]() {
+                          JsonObject params;
+                          params["id"] = timeline->id;
+                          params["requestedMs"] = (uint32_t)(timeline->length * 1000);
+                          params["startDelayMs"] = (uint32_t)((timeline->startTime - timeline->requestTime) / 1000);
+                          notify(RDKSHELL_EVENT_ON_ANIMATION_TIMELINE_COMPLETE, params);
+                      });
+                      it = gRunningAnimationTimelines.erase(it);
+                  }
 
                   TaskQueue::Task task;
                   while(mTaskQueue.pop(task)){
                     task();
+                    frame.tasks++;
                   }
 
                   gRdkShellMutex.unlock();
+                  // completion handlers take the lock and send events, run them on the request pool
+                  // and keep the rest in order for the next frame when it is full
+                  size_t submitted = 0;
+                  while ((submitted < completions.size()) && gRequestPool.submit(RequestPool::HIGH, string(), completions[submitted]))
+                  {
+                      submitted++;
+                  }
+                  completions.erase(completions.begin(), completions.begin() + submitted);
+                  if (!completions.empty())
+                  {
+                      keepRenderThreadActive();
+                  }
+                  phaseEndTime = RdkShell::microseconds();
+                  frame.phaseTime[FrameStats::TASKS] = phaseEndTime - phaseStartTime;
+                  frame.phaseTime[FrameStats::FRAME] = phaseEndTime - startFrameTime;
+                  gFrameStats.record(frame, frameBudget);
                   double frameTime = (int)RdkShell::microseconds() - (int)startFrameTime;
                   if (frameTime < maxSleepTime)
                   {
                       int sleepTime = (int)maxSleepTime-(int)frameTime;
-                      usleep(sleepTime);
+                      waitForRenderWakeup(sleepTime);
                   }
                 }
+                // there is no next frame, the remaining completions run here
+                for (size_t i = 0; i < completions.size(); i++)
+                {
+                    if (!gRequestPool.submit(RequestPool::HIGH, string(), completions[i]))
+                    {
+                        completions[i]();
+                    }
+                }
             });
 
             service->Register(mClientsMonitor);
@@ -1839,6 +2614,7 @@ namespace WPEFramework {
             }
 
             m_timer.setInterval(RECONNECTION_TIME_IN_MILLISECONDS);
+            m_timer.setSlack(RECONNECTION_TIMER_SLACK_IN_MILLISECONDS);
             m_timer.start();
             std::cout << "Started SystemServices connection timer" << std::endl;
             char* rdkshelltype = getenv("RDKSHELL_COMPOSITOR_TYPE");
@@ -1943,6 +2719,16 @@ namespace WPEFramework {
                         config.rfc = rfc;
                         config.thunderApi = thunderApi;
                         config.params = params;
+                        //entries are referred to by name in dependsOn, the thunder api is the default name
+                        config.name = configEntry.HasLabel("name") ? configEntry["name"].String() : thunderApi;
+                        if (configEntry.HasLabel("dependsOn") && (configEntry["dependsOn"].Content() == JsonValue::type::ARRAY))
+                        {
+                            const JsonArray& dependsOn = configEntry["dependsOn"].Array();
+                            for (int d = 0; d < dependsOn.Length(); d++)
+                            {
+                                config.dependsOn.push_back(dependsOn[d].String());
+                            }
+                        }
                         gStartupConfigs.push_back(config);
                     }
                 }
@@ -1963,29 +2749,49 @@ namespace WPEFramework {
         void RDKShell::invokeStartupThunderApis()
         {
 #ifdef RFC_ENABLED
+            uint32_t parallelism = RDKSHELL_STARTUP_PARALLELISM;
+            char* parallelismValue = getenv("RDKSHELL_STARTUP_PARALLELISM");
+            if (NULL != parallelismValue && atoi(parallelismValue) > 0)
+            {
+                parallelism = atoi(parallelismValue);
+            }
             for (std::vector<RDKShellStartupConfig>::iterator iter = gStartupConfigs.begin() ; iter != gStartupConfigs.end(); iter++)
             {
-                std::string rfc = iter->rfc;
-                std::string thunderApi = iter->thunderApi;
-                JsonObject& apiParams = iter->params;
-
-                RFC_ParamData_t rfcParam;
-                bool ret = Utils::getRFCConfig((char*)rfc.c_str(), rfcParam);
-                if (true == ret && (strncasecmp(rfcParam.value,"true",4) == 0))
-                {
-                    std::cout << "invoking thunder api " << thunderApi << std::endl;
-                    uint32_t status = 0;
-                    JsonObject joResult;
-                    status = getThunderControllerClient()->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, thunderApi.c_str(), apiParams, joResult);
-                    if (status > 0)
+                const RDKShellStartupConfig config = *iter;
+                StartupScheduler::Entry entry;
+                entry.name = config.name;
+                entry.dependsOn = config.dependsOn;
+                entry.task = [this, config]() {
+                    RFC_ParamData_t rfcParam;
+                    bool ret = Utils::getRFCConfig((char*)config.rfc.c_str(), rfcParam);
+                    if (true == ret && (strncasecmp(rfcParam.value,"true",4) == 0))
+                    {
+                        std::cout << "invoking thunder api " << config.thunderApi << std::endl;
+                        uint32_t status = 0;
+                        JsonObject apiParams = config.params;
+                        JsonObject joResult;
+                        status = getThunderControllerClient()->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, config.thunderApi.c_str(), apiParams, joResult);
+                        if (status > 0)
+                        {
+                            std::cout << "invoking thunder api " << config.thunderApi << " failed - " << status << std::endl;
+                            return false;
+                        }
+                    }
+                    else
                     {
-                        std::cout << "invoking thunder api " << thunderApi << " failed - " << status << std::endl;
+                        std::cout << "rfc " << config.rfc << " not enabled " << std::endl;
                     }
-                }
-                else
-                {
-                    std::cout << "rfc " << rfc << " not enabled " << std::endl;
-                }
+                    return true;
+                };
+                gStartupScheduler.add(entry);
+            }
+            // entries that do not depend on each other are invoked concurrently
+            gStartupScheduler.run(parallelism);
+            std::vector<StartupScheduler::Result> timeline = gStartupScheduler.timeline();
+            for (size_t i = 0; i < timeline.size(); i++)
+            {
+                std::cout << "startup entry " << timeline[i].name << " " << StartupScheduler::stateName(timeline[i].state)
+                          << " " << timeline[i].start << "-" << timeline[i].end << "ms " << timeline[i].reason << std::endl;
             }
 #else
             std::cout << "rfc is not enabled and not invoking thunder apis " << std::endl;
@@ -1996,11 +2802,26 @@ namespace WPEFramework {
         void RDKShell::Deinitialize(PluginHost::IShell* service)
         {
             LOGINFO("Deinitialize");
+            // teardown stages that missed their deadline still use the plugin and the render thread
+            gBulkTeardown.join();
             gRdkShellMutex.lock();
             RdkShell::deinitialize();
             sRunning = false;
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             shellThread.join();
+            {
+                std::unique_lock<std::mutex> lock(gScreenshotMutex);
+                while (gPendingScreenshots > 0)
+                {
+                    gScreenshotCondVariable.wait(lock);
+                }
+            }
+            gWarmPool.stop();
+            gMemoryPressure.stop();
+            gEventCoalescer.stop();
+            gResourceTable.stop();
+            gRequestPool.stop(RDKSHELL_REQUEST_STOP_TIMEOUT_IN_MS);
             std::vector<std::string> clientList;
             CompositorController::getClients(clientList);
             std::vector<std::string>::iterator ptr;
@@ -2016,7 +2837,6 @@ namespace WPEFramework {
             CompositorController::setEventListener(nullptr);
             mEventListener = nullptr;
             mEnableUserInactivityNotification = false;
-            gActivePluginsData.clear();
             gRdkShellMutex.lock();
             for (unsigned int i=0; i<gCreateDisplayRequests.size(); i++)
             {
@@ -2036,8 +2856,11 @@ namespace WPEFramework {
                 }
             }
             gKillClientRequests.clear();
+            gAnimationTimelines.clear();
+            gRunningAnimationTimelines.clear();
             gRdkShellMutex.unlock();
-            gExternalDestroyApplications.clear();
+            gAppRegistry.clear();
+            releaseThunderControllerClients();
             sem_destroy(&gInitializeSemaphore);
         }
 
@@ -2046,7 +2869,7 @@ namespace WPEFramework {
             return(string("{\"service\": \"") + SERVICE_NAME + string("\"}"));
         }
 
-        std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > RDKShell::getThunderControllerClient(std::string callsign, std::string localidentifier)
+        std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > RDKShell::createThunderControllerClient(std::string callsign, std::string localidentifier)
         {
             string query = "token=" + sThunderSecurityToken;
             Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T(gThunderAccessValue)));
@@ -2054,18 +2877,54 @@ namespace WPEFramework {
             return thunderClient;
         }
 
+        // Links are shared per callsign and local identifier, so callers that subscribe to
+        // events must use createThunderControllerClient to get a link of their own.
+        std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > RDKShell::getThunderControllerClient(std::string callsign, std::string localidentifier)
+        {
+            const std::string key = callsign + "/" + localidentifier;
+            const double now = RdkShell::milliseconds();
+            std::lock_guard<std::mutex> lock(gThunderClientsMutex);
+
+            std::map<std::string, ThunderClientEntry>::iterator clientsIterator = gThunderClients.begin();
+            while (clientsIterator != gThunderClients.end())
+            {
+                // evict links nobody used for a while and nobody holds any more
+                if ((clientsIterator->first != key) && (clientsIterator->second.mClient.use_count() == 1) &&
+                    ((now - clientsIterator->second.mLastUsedTime) > RDKSHELL_THUNDER_CLIENT_IDLE_TIMEOUT_IN_MS))
+                {
+                    clientsIterator = gThunderClients.erase(clientsIterator);
+                }
+                else
+                {
+                    clientsIterator++;
+                }
+            }
+
+            ThunderClientEntry& entry = gThunderClients[key];
+            if ((!entry.mClient) || (entry.mToken != sThunderSecurityToken) || (entry.mThunderAccess != gThunderAccessValue))
+            {
+                entry.mClient = createThunderControllerClient(callsign, localidentifier);
+                entry.mToken = sThunderSecurityToken;
+                entry.mThunderAccess = gThunderAccessValue;
+            }
+            entry.mLastUsedTime = now;
+            return entry.mClient;
+        }
+
+        void RDKShell::releaseThunderControllerClients()
+        {
+            std::lock_guard<std::mutex> lock(gThunderClientsMutex);
+            gThunderClients.clear();
+        }
+
         std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> RDKShell::getPackagerPlugin()
         {
-            string query = "token=" + sThunderSecurityToken;
-            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T(gThunderAccessValue)));
-            return make_shared<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>>("Packager.1", "", false, query);
+            return getThunderControllerClient("Packager.1");
         }
 
         std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> RDKShell::getOCIContainerPlugin()
         {
-            string query = "token=" + sThunderSecurityToken;
-            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T(gThunderAccessValue)));
-            return make_shared<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>>("org.rdk.OCIContainer.1", "", false, query);
+            return getThunderControllerClient("org.rdk.OCIContainer.1");
         }
 
         void RDKShell::pluginEventHandler(const JsonObject& parameters)
@@ -2119,6 +2978,8 @@ namespace WPEFramework {
         void RDKShell::RdkShellListener::onApplicationDisconnected(const std::string& client)
         {
           std::cout << "RDKShell onApplicationDisconnected event received ..." << client << std::endl;
+          // the compositor dropped the keys of the client with it
+          gKeyDispatchTable.removeClient(client);
           JsonObject params;
           params["client"] = client;
           mShell.notify(RDKSHELL_EVENT_ON_APP_DISCONNECTED, params);
@@ -2127,6 +2988,7 @@ namespace WPEFramework {
         void RDKShell::RdkShellListener::onApplicationTerminated(const std::string& client)
         {
           std::cout << "RDKShell onApplicationTerminated event received ..." << client << std::endl;
+          gKeyDispatchTable.removeClient(client);
           JsonObject params;
           params["client"] = client;
           mShell.notify(RDKSHELL_EVENT_ON_APP_TERMINATED, params);
@@ -2188,6 +3050,7 @@ namespace WPEFramework {
           params["availablememory"] = availableKb;
           params["usedswap"] = usedSwapKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_LOW_RAM_WARNING, params);
+          gMemoryPressure.setWarningLevel(MemoryPressureManager::SUSPEND);
         }
 
         void RDKShell::RdkShellListener::onDeviceCriticallyLowRamWarning(const int32_t freeKb, const int32_t availableKb, const int32_t usedSwapKb)
@@ -2198,6 +3061,7 @@ namespace WPEFramework {
           params["availablememory"] = availableKb;
           params["usedswap"] = usedSwapKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_CRITICALLY_LOW_RAM_WARNING, params);
+          gMemoryPressure.setWarningLevel(MemoryPressureManager::HIBERNATE);
         }
 
         void RDKShell::RdkShellListener::onDeviceLowRamWarningCleared(const int32_t freeKb, const int32_t availableKb, const int32_t usedSwapKb)
@@ -2208,6 +3072,7 @@ namespace WPEFramework {
           params["availablememory"] = availableKb;
           params["usedswap"] = usedSwapKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_LOW_RAM_WARNING_CLEARED, params);
+          gMemoryPressure.setWarningLevel(MemoryPressureManager::NONE);
         }
 
         void RDKShell::RdkShellListener::onDeviceCriticallyLowRamWarningCleared(const int32_t freeKb, const int32_t availableKb, const int32_t usedSwapKb)
@@ -2218,6 +3083,7 @@ namespace WPEFramework {
           params["availablememory"] = availableKb;
           params["usedswap"] = usedSwapKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_CRITICALLY_LOW_RAM_WARNING_CLEARED, params);
+          gMemoryPressure.setWarningLevel(MemoryPressureManager::SUSPEND);
         }
 
         void RDKShell::RdkShellListener::onEasterEgg(const std::string& name, const std::string& actionJson)
@@ -2601,6 +3467,31 @@ namespace WPEFramework {
                 }
 #endif
 
+                bool async = parameters.HasLabel("async") ? parameters["async"].Boolean() : false;
+                if (async)
+                {
+                    // returns right away, onClientKilled reports the result
+                    const bool isDacApp = (mimeType == RDKSHELL_APPLICATION_MIME_TYPE_DAC_NATIVE);
+                    uint32_t token = killAsync(client, [this, client, isDacApp](uint32_t token, bool success) {
+                        JsonObject params;
+                        params["client"] = client;
+                        params["token"] = token;
+                        if (success && isDacApp)
+                        {
+                            string message;
+                            success = stopContainer(client, message);
+                            if (!success)
+                            {
+                                params["message"] = message;
+                            }
+                        }
+                        params["success"] = success;
+                        notify(RDKSHELL_EVENT_ON_CLIENT_KILLED, params);
+                    });
+                    response["token"] = token;
+                    returnResponse(true);
+                }
+
                 // Kill the display
                 result = kill(client);
                 if (!result)
@@ -2612,57 +3503,69 @@ namespace WPEFramework {
                 // App was a DAC app, so kill the container if it's still running
                 if (mimeType == RDKSHELL_APPLICATION_MIME_TYPE_DAC_NATIVE)
                 {
-                    LOGINFO("Killing container");
-
-                    auto ociContainerPlugin = getOCIContainerPlugin();
-                    if (!ociContainerPlugin)
+                    string message;
+                    result = stopContainer(client, message);
+                    if (!result)
                     {
-                        response["message"] = "OCIContainer plugin initialisation failed";
-                        returnResponse(false);
+                        response["message"] = message;
                     }
+                }
+            }
+            returnResponse(result);
+        }
 
-                    JsonObject containerInfoResult;
-                    JsonObject stopContainerResult;
-                    JsonObject param;
-                    param["containerId"] = client;
+        bool RDKShell::stopContainer(const string& client, string& message)
+        {
+            LOGINFO("Killing container");
+
+            auto ociContainerPlugin = getOCIContainerPlugin();
+            if (!ociContainerPlugin)
+            {
+                message = "OCIContainer plugin initialisation failed";
+                return false;
+            }
 
-                    ociContainerPlugin->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, "getContainerInfo", param, containerInfoResult);
+            bool result = true;
+            JsonObject containerInfoResult;
+            JsonObject stopContainerResult;
+            JsonObject param;
+            param["containerId"] = client;
 
-                    // If success is false, the container isn't running so nothing to do
-                    if (containerInfoResult["success"].Boolean())
-                    {
-                        auto containerInfo = containerInfoResult["info"].Object();
+            ociContainerPlugin->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, "getContainerInfo", param, containerInfoResult);
 
-                        // Dobby knows about that container - what's it doing?
-                        if (containerInfo["state"] == "running" || containerInfo["state"] == "starting")
-                        {
-                            ociContainerPlugin->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, "stopContainer", param, stopContainerResult);
-                        }
-                        else if (containerInfo["state"] == "paused")
-                        {
-                            // Paused, so force stop
-                            param["force"] = true;
-                            ociContainerPlugin->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, "stopContainer", param, stopContainerResult);
-                        }
-                        else
-                        {
-                            response["message"] = "Container is not in a state that can be stopped";
-                            returnResponse(false);
-                        }
+            // If success is false, the container isn't running so nothing to do
+            if (containerInfoResult["success"].Boolean())
+            {
+                auto containerInfo = containerInfoResult["info"].Object();
 
-                        if (!stopContainerResult["success"].Boolean())
-                        {
-                            result = false;
-                            response["message"] = "Failed to stop container";
-                        }
+                // Dobby knows about that container - what's it doing?
+                if (containerInfo["state"] == "running" || containerInfo["state"] == "starting")
+                {
+                    ociContainerPlugin->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, "stopContainer", param, stopContainerResult);
+                }
+                else if (containerInfo["state"] == "paused")
+                {
+                    // Paused, so force stop
+                    param["force"] = true;
+                    ociContainerPlugin->Invoke<JsonObject, JsonObject>(RDKSHELL_THUNDER_TIMEOUT, "stopContainer", param, stopContainerResult);
+                }
+                else
+                {
+                    message = "Container is not in a state that can be stopped";
+                    return false;
+                }
+
+                if (!stopContainerResult["success"].Boolean())
+                {
+                    result = false;
+                    message = "Failed to stop container";
+                }
 #ifdef ENABLE_RIALTO_FEATURE
-                            rialtoConnector->deactivateSession(client);
-                            //Should we wait for the state change ? Naaah
+                    rialtoConnector->deactivateSession(client);
+                    //Should we wait for the state change ? Naaah
 #endif //ENABLE_RIALTO_FEATURE
-                    }
-                }
             }
-            returnResponse(result);
+            return result;
         }
 
         uint32_t RDKShell::addKeyInterceptWrapper(const JsonObject& parameters, JsonObject& response)
@@ -3070,6 +3973,34 @@ namespace WPEFramework {
                     focus = parameters["focus"].Boolean();
                 }
 
+                bool async = parameters.HasLabel("async") ? parameters["async"].Boolean() : false;
+                if (async)
+                {
+#ifdef ENABLE_RIALTO_FEATURE
+                    if (parameters.HasLabel("rialtoSocket"))
+                    {
+                        response["message"] = "rialtoSocket is not supported with async";
+                        returnResponse(false);
+                    }
+#endif //ENABLE_RIALTO_FEATURE
+                    // returns right away, onDisplayCreated reports the result
+                    uint32_t token = createDisplayAsync(client, displayName, displayWidth, displayHeight,
+                        virtualDisplay, virtualWidth, virtualHeight, [this, client](uint32_t token, bool success) {
+                            JsonObject params;
+                            params["client"] = client;
+                            params["token"] = token;
+                            params["success"] = success;
+                            notify(RDKSHELL_EVENT_ON_DISPLAY_CREATED, params);
+                        });
+                    if (0 == token)
+                    {
+                        response["message"] = "failed to create display";
+                        returnResponse(false);
+                    }
+                    response["token"] = token;
+                    returnResponse(true);
+                }
+
                 result = createDisplay(client, displayName, displayWidth, displayHeight,
                     virtualDisplay, virtualWidth, virtualHeight, topmost, focus);
                 if (false == result) {
@@ -3592,6 +4523,7 @@ namespace WPEFramework {
                 gSplashScreenDisplayTime = displayTime;
                 receivedShowSplashScreenRequest = true;
                 gRdkShellMutex.unlock();
+                wakeRenderThread();
             }
             returnResponse(result);
         }
@@ -3605,6 +4537,7 @@ namespace WPEFramework {
             lockRdkShellMutex();
             result = CompositorController::hideSplashScreen();
             gRdkShellMutex.unlock();
+            wakeRenderThread();
 
             returnResponse(result);
         }
@@ -3656,6 +4589,71 @@ namespace WPEFramework {
             returnResponse(result);
         }
 
+        uint32_t RDKShell::addAnimationTimelineWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("animations"))
+            {
+                result = false;
+                response["message"] = "please specify animations";
+            }
+            if (result)
+            {
+                const JsonArray animations = parameters["animations"].Array();
+                string id = parameters.HasLabel("id") ? parameters["id"].String() : string();
+                double length = 0;
+                int failedAnimation = -1;
+                string message;
+                result = addAnimationTimeline(animations, id, length, failedAnimation, message);
+                if (result)
+                {
+                    response["id"] = id;
+                    response["durationMs"] = (uint32_t)(length * 1000);
+                }
+                else
+                {
+                    response["message"] = message;
+                    if (failedAnimation >= 0)
+                    {
+                        response["failedAnimation"] = failedAnimation;
+                    }
+                }
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::applyTransactionWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("operations"))
+            {
+                result = false;
+                response["message"] = "please specify operations";
+            }
+            if (result)
+            {
+                const JsonArray operations = parameters["operations"].Array();
+                int failedOperation = -1;
+                string message;
+                result = applyTransaction(operations, failedOperation, message);
+                if (false == result)
+                {
+                    response["message"] = message;
+                    if (failedOperation >= 0)
+                    {
+                        response["failedOperation"] = failedOperation;
+                    }
+                }
+                else
+                {
+                    response["applied"] = operations.Length();
+                }
+            }
+            returnResponse(result);
+        }
+
         uint32_t RDKShell::enableInactivityReportingWrapper(const JsonObject& parameters, JsonObject& response)
         {
             LOGINFOMETHOD();
@@ -3776,6 +4774,7 @@ namespace WPEFramework {
                 }
                 result = CompositorController::scaleToFit(client, x, y, clientWidth, clientHeight);
                 gRdkShellMutex.unlock();
+                wakeRenderThread();
 
                 if (!result) {
                   response["message"] = "failed to scale to fit";
@@ -3787,8 +4786,15 @@ namespace WPEFramework {
         uint32_t RDKShell::launchWrapper(const JsonObject& parameters, JsonObject& response)
         {
             LOGINFOMETHOD();
+            // prelaunches for the warm pool only come from the plugin itself
+            return launchApp(parameters, response, 0);
+        }
 
+        uint32_t RDKShell::launchApp(const JsonObject& parameters, JsonObject& response, const uint32_t warmPoolRequest)
+        {
             double launchStartTime = RdkShell::seconds();
+            LaunchTracer::Session launchTrace(gLaunchTracer, parameters.HasLabel("callsign") ? parameters["callsign"].String() : string(), RDKSHELL_METHOD_LAUNCH);
+            launchTrace.phase("prepare");
             bool result = true;
 	    bool autoDestroy = true;
 
@@ -3830,17 +4836,7 @@ namespace WPEFramework {
                 {
                     LOG_MILESTONE("PLUI_LAUNCH_START");
                 }
-                bool isApplicationBeingDestroyed = false;
-                gLaunchDestroyMutex.lock();
-                if (gDestroyApplications.find(appCallsign) != gDestroyApplications.end())
-                {
-                    isApplicationBeingDestroyed = true;
-                }
-                else
-                {
-                    gLaunchApplications[appCallsign] = true;
-                }
-                gLaunchDestroyMutex.unlock();
+                bool isApplicationBeingDestroyed = !gAppRegistry.beginLaunch(appCallsign);
                 if (isApplicationBeingDestroyed)
                 {
                     gLaunchMutex.lock();
@@ -3857,6 +4853,23 @@ namespace WPEFramework {
                 {
                     type = parameters["type"].String();
                 }
+                if (warmPoolRequest > 0)
+                {
+                    if (!gWarmPool.isPrelaunchCurrent(warmPoolRequest))
+                    {
+                        gLaunchMutex.lock();
+                        gLaunchCount = 0;
+                        gLaunchMutex.unlock();
+                        gAppRegistry.endLaunch(appCallsign);
+                        response["message"] = "prelaunch cancelled";
+                        returnResponse(false);
+                    }
+                }
+                else
+                {
+                    // a prelaunch of the app that is queued or running must not suspend it
+                    gWarmPool.cancelPrelaunch(callsign);
+                }
                 string version = "0.0";
                 string uri;
                 int32_t x = 0;
@@ -3972,13 +4985,7 @@ namespace WPEFramework {
                 }
 #ifdef HIBERNATE_SUPPORT_ENABLED
                 //Reset app suspended/hibernated for launch
-                gSuspendedOrHibernatedApplicationsMutex.lock();
-                auto suspendedOrHibernatedIt = gSuspendedOrHibernatedApplications.find(appCallsign);
-                if (suspendedOrHibernatedIt != gSuspendedOrHibernatedApplications.end())
-                {
-                    gSuspendedOrHibernatedApplications.erase(suspendedOrHibernatedIt);
-                }
-                gSuspendedOrHibernatedApplicationsMutex.unlock();
+                gAppRegistry.resetSuspended(appCallsign);
 #endif
 #ifdef HIBERNATE_NATIVE_APPS_ON_SUSPENDED
                 gLaunchedToSuspendedMutex.lock();
@@ -3992,22 +4999,27 @@ namespace WPEFramework {
                 }
                 gLaunchedToSuspendedMutex.unlock();
 #endif
+#ifdef RFC_ENABLED
+                // the dobby RFC of the type is read while the plugin is cloned and its display created
+                RFCPrefetch dobbyRFC;
+                const char* dobbyRFCName = dobbyRFCForType(type);
+                if (nullptr != dobbyRFCName)
+                {
+                    dobbyRFC.start(dobbyRFCName);
+                }
+#endif
 
                 //check to see if plugin already exists
                 bool newPluginFound = false;
                 bool originalPluginFound = false;
-                for (std::map<std::string, PluginData>::iterator pluginDataEntry = gActivePluginsData.begin(); pluginDataEntry != gActivePluginsData.end(); pluginDataEntry++)
+                std::shared_ptr<CreateDisplayRequest> createDisplayRequest;
+                if (gAppRegistry.isActive(callsign))
                 {
-                    std::string pluginName = pluginDataEntry->first;
-                    if (pluginName == callsign)
-                    {
-                      newPluginFound = true;
-                      break;
-                    }
-                    else if (pluginName == type)
-                    {
-                      originalPluginFound = true;
-                    }
+                    newPluginFound = true;
+                }
+                else if (!type.empty() && gAppRegistry.isActive(type))
+                {
+                    originalPluginFound = true;
                 }
                 if ((false == newPluginFound) && (false == originalPluginFound)) {
                     PluginHost::IShell::state state;
@@ -4024,15 +5036,14 @@ namespace WPEFramework {
                     gLaunchMutex.lock();
                     gLaunchCount = 0;
                     gLaunchMutex.unlock();
-		    gLaunchDestroyMutex.lock();
-                    gLaunchApplications.erase(appCallsign);
-		    gLaunchDestroyMutex.unlock();
+                    gAppRegistry.endLaunch(appCallsign);
                     std::cout << "new launch count loc1: 0\n";
                     returnResponse(false);
                 }
                 else if (!newPluginFound)
                 {
                     std::cout << "attempting to clone type: " << type << " into " << callsign << std::endl;
+                    launchTrace.phase("clone");
                     uint32_t status = cloneService(mCurrentService, type, callsign);
 
                     std::cout << "clone status: " << status << std::endl;
@@ -4044,6 +5055,7 @@ namespace WPEFramework {
                     }
 
                     launchType = RDKShellLaunchType::CREATE;
+                    launchTrace.phase("createDisplay");
                     {
                         bool lockAcquired = false;
                         double startTime = RdkShell::milliseconds();
@@ -4064,20 +5076,23 @@ namespace WPEFramework {
                     gRdkShellMutex.unlock();
                     if (!isClientExists(callsign))
                     {
-                        std::shared_ptr<CreateDisplayRequest> request = std::make_shared<CreateDisplayRequest>(callsign, displayName, width, height);
-                        request->mAutoDestroy = autoDestroy;
+                        // the render thread creates the display while the configuration is
+                        // fetched and merged below, it is only waited for before activation
+                        createDisplayRequest = std::make_shared<CreateDisplayRequest>(callsign, displayName, width, height);
+                        createDisplayRequest->mAutoDestroy = autoDestroy;
                         lockRdkShellMutex();
                         gPluginDisplayNameMap[callsign] = displayName;
                         std::cout << "Added displayname : "<<displayName<< std::endl;
-                        gCreateDisplayRequests.push_back(request);
+                        gCreateDisplayRequests.push_back(createDisplayRequest);
                         gRdkShellMutex.unlock();
-                        sem_wait(&request->mSemaphore);
+                        wakeRenderThread();
                     }
                 }
 
                 string configString;
 
                 uint32_t status = 0;
+                launchTrace.phase("getConfig");
                 status = getConfig(mCurrentService, callsign, configString);
 
                 std::cout << "config status: " << status << std::endl;
@@ -4113,7 +5128,7 @@ namespace WPEFramework {
 
 #ifdef RFC_ENABLED
                     RFC_ParamData_t param;
-                    if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Netflix.Enable", param))
+                    if (dobbyRFC.get("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Netflix.Enable", param))
                     {
                         JsonObject root;
                         if (strncasecmp(param.value, "true", 4) == 0)
@@ -4151,7 +5166,7 @@ namespace WPEFramework {
 
 #ifdef RFC_ENABLED
                     RFC_ParamData_t param;
-                    if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Cobalt.Enable", param))
+                    if (dobbyRFC.get("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Cobalt.Enable", param))
                     {
                         JsonObject root;
                         if (strncasecmp(param.value, "true", 4) == 0)
@@ -4182,7 +5197,7 @@ namespace WPEFramework {
                 {
 #ifdef RFC_ENABLED
                     RFC_ParamData_t param;
-                    if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.WPE.Enable", param))
+                    if (dobbyRFC.get("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.WPE.Enable", param))
                     {
                         JsonObject root;
                         if (strncasecmp(param.value, "true", 4) == 0)
@@ -4212,7 +5227,7 @@ namespace WPEFramework {
                 {
 #ifdef RFC_ENABLED
                     RFC_ParamData_t param;
-                    if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.SAD.Enable", param))
+                    if (dobbyRFC.get("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.SAD.Enable", param))
                     {
                         JsonObject root;
                         if (strncasecmp(param.value, "true", 4) == 0)
@@ -4242,7 +5257,7 @@ namespace WPEFramework {
 		{
 #ifdef RFC_ENABLED
 			RFC_ParamData_t param;
-			if (Utils::getRFCConfig("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Amazon.Enable", param))
+			if (dobbyRFC.get("Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.Dobby.Amazon.Enable", param))
 			{
 				JsonObject root;
 				if (strncasecmp(param.value, "true", 4) == 0)
@@ -4270,6 +5285,7 @@ namespace WPEFramework {
 
                 string configSetAsString;
                 configSet.ToString(configSetAsString);
+                launchTrace.phase("setConfig");
                 Core::JSON::String configSetAsJsonString;
                 configSetAsJsonString.FromString(configSetAsString);
                 status = setConfig(mCurrentService, callsign, configSetAsJsonString.Value());
@@ -4282,6 +5298,14 @@ namespace WPEFramework {
                     std::cout << "set status: " << status << std::endl;
                 }
 
+                if (createDisplayRequest)
+                {
+                    launchTrace.phase("waitForDisplay");
+                    sem_wait(&createDisplayRequest->mSemaphore);
+                    createDisplayRequest = nullptr;
+                }
+
+                launchTrace.phase("activate");
                 if (launchType == RDKShellLaunchType::UNKNOWN)
                 {
                     status = 0;
@@ -4348,6 +5372,7 @@ namespace WPEFramework {
                 }
                 else
                 {
+                    launchTrace.phase("bounds");
                     uint32_t tempX = 0;
                     uint32_t tempY = 0;
                     uint32_t screenWidth = 0;
@@ -4410,6 +5435,7 @@ namespace WPEFramework {
                     CompositorController::setBounds(callsign, 0, 0, 1, 1); //forcing a compositor resize flush
                     CompositorController::setBounds(callsign, x, y, width, height);
                     gRdkShellMutex.unlock();
+                    wakeRenderThread();
 
                     if (scaleToFit)
                     {
@@ -4438,6 +5464,7 @@ namespace WPEFramework {
                         }
                     }
 
+                    launchTrace.phase("stateControl");
                     gPluginDataMutex.lock();
                     {
                       auto notificationIt = gStateNotifications.find(callsign);
@@ -4449,12 +5476,19 @@ namespace WPEFramework {
                           stateControl->Release();
                           gStateNotifications[callsign] = handler;
                         }
-                      } else {
+                      } else if (warmPoolRequest == 0) {
                         notificationIt->second->enableLaunch(true);
                         deferLaunch = true;
                       }
                     }
                     gPluginDataMutex.unlock();
+
+                    // the user launched the app while it was prelaunched, its launch sets the state
+                    bool prelaunchCancelled = (warmPoolRequest > 0) && !gWarmPool.isPrelaunchCurrent(warmPoolRequest);
+                    if (prelaunchCancelled)
+                    {
+                        setSuspendResumeStateOnLaunch = false;
+                    }
  
                     if (setSuspendResumeStateOnLaunch)
                     {
@@ -4464,7 +5498,7 @@ namespace WPEFramework {
                             {
                                 gPluginDataMutex.lock();
                                 std::map<std::string, PluginStateChangeData*>::iterator pluginStateChangeEntry = gPluginsEventListener.find(callsign);
-                                if (pluginStateChangeEntry != gPluginsEventListener.end())
+                                if ((pluginStateChangeEntry != gPluginsEventListener.end()) && (warmPoolRequest == 0))
                                 {
                                     PluginStateChangeData* data = pluginStateChangeEntry->second;
                                     data->enableLaunch(true);
@@ -4487,7 +5521,7 @@ namespace WPEFramework {
                             {
                                 gPluginDataMutex.lock();
                                 std::map<std::string, PluginStateChangeData*>::iterator pluginStateChangeEntry = gPluginsEventListener.find(callsign);
-                                if (pluginStateChangeEntry != gPluginsEventListener.end())
+                                if ((pluginStateChangeEntry != gPluginsEventListener.end()) && (warmPoolRequest == 0))
                                 {
                                     PluginStateChangeData* data = pluginStateChangeEntry->second;
                                     data->enableLaunch(true);
@@ -4505,12 +5539,17 @@ namespace WPEFramework {
                         }
                     }
 
-                    setVisibility(callsign, visible);
+                    launchTrace.phase("visibility");
+                    if (!prelaunchCancelled)
+                    {
+                        setVisibility(callsign, visible);
+                    }
                     setHolePunch(callsign, holePunch);
                     if (!visible)
                     {
                         focused = false;
                     }
+                    launchTrace.phase("focus");
                     if (focused)
                     {
                         std::cout << "setting the focused app to " << callsign << std::endl;
@@ -4521,6 +5560,7 @@ namespace WPEFramework {
                     JsonObject urlResult;
                     if (!uri.empty())
                     {
+                        launchTrace.phase("url");
                         WPEFramework::Core::JSON::String urlString;
                         urlString = uri;
                         status = JSONRPCDirectLink(mCurrentService, callsign).Set<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "url",urlString);
@@ -4560,15 +5600,21 @@ namespace WPEFramework {
                     gLaunchMutex.lock();
                     gLaunchCount = 0;
                     gLaunchMutex.unlock();
-                    if (setSuspendResumeStateOnLaunch && deferLaunch && ((launchType == SUSPEND) || (launchType == RESUME)))
+                    bool launchDeferred = (setSuspendResumeStateOnLaunch && deferLaunch && ((launchType == SUSPEND) || (launchType == RESUME)));
+                    launchTrace.finish(true, launchTypeString, launchDeferred);
+                    if (launchDeferred)
                     {
                         std::cout << "deferring application launch " << std::endl;
                     }
-                    else
+                    else if (warmPoolRequest == 0)
                     {
                         onLaunched(callsign, launchTypeString);
                     }
                     response["launchType"] = launchTypeString;
+                    if ((warmPoolRequest == 0) && gWarmPool.recordLaunch(callsign, type))
+                    {
+                        std::cout << callsign << " is resumed from the warm pool" << std::endl;
+                    }
                 }
                 
             }
@@ -4576,12 +5622,14 @@ namespace WPEFramework {
             {
                 response["message"] = "failed to launch application";
             }
+            if (warmPoolRequest > 0)
+            {
+                gWarmPool.endPrelaunch(warmPoolRequest, result);
+            }
             gLaunchMutex.lock();
             gLaunchCount = 0;
             gLaunchMutex.unlock();
-	    gLaunchDestroyMutex.lock();
-            gLaunchApplications.erase(appCallsign);
-	    gLaunchDestroyMutex.unlock();
+            gAppRegistry.endLaunch(appCallsign);
             std::cout << "new launch count at loc2 is 0\n";
 
             returnResponse(result);
@@ -4601,6 +5649,7 @@ namespace WPEFramework {
                 uint32_t status;
                 const string callsign = parameters["callsign"].String();
                 std::cout << "about to suspend " << callsign << std::endl;
+                LaunchTracer::Session suspendTrace(gLaunchTracer, callsign, RDKSHELL_METHOD_SUSPEND);
 		string client;
                 if (parameters.HasLabel("client"))
                 {
@@ -4610,17 +5659,7 @@ namespace WPEFramework {
                 {
                     client = parameters["callsign"].String();
                 }
-                bool isApplicationBeingDestroyed = false;
-            	gLaunchDestroyMutex.lock();
-            	if (gDestroyApplications.find(client) != gDestroyApplications.end())
-            	{
-                    isApplicationBeingDestroyed = true;
-            	}
-            	if (gExternalDestroyApplications.find(client) != gExternalDestroyApplications.end())
-            	{
-                    isApplicationBeingDestroyed = true;
-            	}
-            	gLaunchDestroyMutex.unlock();
+                bool isApplicationBeingDestroyed = gAppRegistry.isBeingDestroyed(client);
             	if (isApplicationBeingDestroyed)
             	{
                     std::cout << "ignoring suspend for " << client << " as it is being destroyed " << std::endl;
@@ -4628,18 +5667,22 @@ namespace WPEFramework {
 		    response["message"] = "failed to suspend application";
                     returnResponse(result);
             	}
-                gDestroyMutex.lock();
+                suspendTrace.phase("stateControl");
+                std::shared_ptr<std::mutex> appDestroyMutex = destroyMutex(callsign);
+                appDestroyMutex->lock();
                 PluginHost::IStateControl* stateControl(mCurrentService->QueryInterfaceByCallsign<PluginHost::IStateControl>(callsign));
                 if (stateControl)
 		{
                     stateControl->Request(PluginHost::IStateControl::SUSPEND);
                     stateControl->Release();
-                    gDestroyMutex.unlock();
+                    appDestroyMutex->unlock();
+                    releaseDestroyMutex(callsign, appDestroyMutex);
                     status = Core::ERROR_NONE;
                 }
 		else
 		{
-                    gDestroyMutex.unlock();
+                    appDestroyMutex->unlock();
+                    releaseDestroyMutex(callsign, appDestroyMutex);
                     WPEFramework::Core::JSON::String stateString;
                     stateString = "suspended";
                     const string callsignWithVersion = callsign + ".1";
@@ -4652,7 +5695,9 @@ namespace WPEFramework {
                 }
                 else
                 {
+                    suspendTrace.phase("visibility");
                     setVisibility(callsign, false);
+                    suspendTrace.finish(true);
                     onSuspended(callsign);
                 }
             }
@@ -4676,17 +5721,7 @@ namespace WPEFramework {
             {
                 const string callsign = parameters["callsign"].String();
 		setVisibility(callsign, false);
-                bool isApplicationBeingLaunched = false;
-		gLaunchDestroyMutex.lock();
-                if (gLaunchApplications.find(callsign) != gLaunchApplications.end())
-                {
-                    isApplicationBeingLaunched = true;
-                }
-                else
-                {
-                    gDestroyApplications[callsign] = true;
-                }
-		gLaunchDestroyMutex.unlock();
+                bool isApplicationBeingLaunched = !gAppRegistry.beginDestroy(callsign);
                 if (isApplicationBeingLaunched)
                 {
                     std::cout << "failed to destroy " << callsign << " as launch in progress" << std::endl;
@@ -4694,9 +5729,13 @@ namespace WPEFramework {
                     returnResponse(false);
                 }
                 std::cout << "destroying " << callsign << std::endl;
-                gDestroyMutex.lock();
+                LaunchTracer::Session destroyTrace(gLaunchTracer, callsign, RDKSHELL_METHOD_DESTROY);
+                destroyTrace.phase("deactivate");
+                std::shared_ptr<std::mutex> appDestroyMutex = destroyMutex(callsign);
+                appDestroyMutex->lock();
                 uint32_t status = deactivate(mCurrentService, callsign);
-                gDestroyMutex.unlock();
+                appDestroyMutex->unlock();
+                releaseDestroyMutex(callsign, appDestroyMutex);
                 if (status > 0)
                 {
                     std::cout << "failed to destroy " << callsign << ".  status: " << status << std::endl;
@@ -4710,11 +5749,10 @@ namespace WPEFramework {
                         sFactoryModeStart = false;
                         sFactoryAppLaunchStatus = NOTLAUNCHED;
                     }
+                    destroyTrace.finish(true);
                     onDestroyed(callsign);
                 }
-		gLaunchDestroyMutex.lock();
-                gDestroyApplications.erase(callsign);
-		gLaunchDestroyMutex.unlock();
+                gAppRegistry.endDestroy(callsign);
             }
             if (!result)
             {
@@ -4929,6 +5967,7 @@ namespace WPEFramework {
                     result = CompositorController::launchApplication(client, uri, mimeType, topmost, focus);
 		    RdkShell::CompositorController::addListener(client, mEventListener);
                     gRdkShellMutex.unlock();
+                    wakeRenderThread();
 
                     if (!result)
                     {
@@ -4969,6 +6008,7 @@ namespace WPEFramework {
                     lockRdkShellMutex();
                     result = CompositorController::suspendApplication(client);
                     gRdkShellMutex.unlock();
+                    wakeRenderThread();
                 }
                 else if (mimeType == RDKSHELL_APPLICATION_MIME_TYPE_DAC_NATIVE)
                 {
@@ -5044,6 +6084,7 @@ namespace WPEFramework {
                     lockRdkShellMutex();
                     result = CompositorController::resumeApplication(client);
                     gRdkShellMutex.unlock();
+                    wakeRenderThread();
                 }
                 else if (mimeType == RDKSHELL_APPLICATION_MIME_TYPE_DAC_NATIVE)
                 {
@@ -5228,6 +6269,7 @@ namespace WPEFramework {
             lockRdkShellMutex();
             result = CompositorController::hideFullScreenImage();
             gRdkShellMutex.unlock();
+            wakeRenderThread();
 
             returnResponse(result);
         }
@@ -5349,55 +6391,14 @@ namespace WPEFramework {
             LOGINFOMETHOD();
             bool result = true;
 
-            JsonArray memoryInfo;
-
-            string method = "status";
-            Core::JSON::ArrayType<PluginHost::MetaData::Service> joResult;
-            auto thunderController = getThunderControllerClient();
-            thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), joResult);
-
-            /*std::cout << "DEACTIVATED: " << PluginHost::MetaData::Service::state::DEACTIVATED << std::endl;
-                    std::cout << "DEACTIVATION: " << PluginHost::MetaData::Service::state::DEACTIVATION << std::endl;
-                    std::cout << "ACTIVATED: " << PluginHost::MetaData::Service::state::ACTIVATED << std::endl;
-                    std::cout << "ACTIVATION: " << PluginHost::MetaData::Service::state::ACTIVATION << std::endl;
-                    std::cout << "DESTROYED: " << PluginHost::MetaData::Service::state::DESTROYED << std::endl;
-                    std::cout << "PRECONDITION: " << PluginHost::MetaData::Service::state::PRECONDITION << std::endl;
-                    std::cout << "SUSPENDED: " << PluginHost::MetaData::Service::state::SUSPENDED << std::endl;
-                    std::cout << "RESUMED: " << PluginHost::MetaData::Service::state::RESUMED << std::endl;*/
-
-            JsonArray stateArray;
-            for (uint16_t i = 0; i < joResult.Length(); i++)
+            if (parameters.HasLabel("refresh") && parameters["refresh"].Boolean())
             {
-                PluginHost::MetaData::Service service = joResult[i];
-                if (service.JSONState != PluginHost::MetaData::Service::state::DEACTIVATED &&
-                    service.JSONState != PluginHost::MetaData::Service::state::DEACTIVATION &&
-                    service.JSONState != PluginHost::MetaData::Service::state::PRECONDITION)
-                {
-                    std::string configLine;
-                    service.Configuration.ToString(configLine);
-                    if (!configLine.empty())
-                    {
-                        JsonObject serviceConfig = JsonObject(configLine.c_str());
-                        if (serviceConfig.HasLabel("clientidentifier"))
-                        {
-                            std::string callsign;
-                            service.Callsign.ToString(callsign);
-                            callsign.erase(std::remove(callsign.begin(),callsign.end(),'\"'),callsign.end());
-
-                            WPEFramework::Core::JSON::String stateString;
-                            const string callsignWithVersion = callsign + ".1";
-                            uint32_t stateStatus = getThunderControllerClient(callsignWithVersion)->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "state", stateString);
-
-                            if (stateStatus == 0)
-                            {
-                                result = pluginMemoryUsage(callsign, memoryInfo);
-                            }
-                        }
-                    }
-                }
+                gResourceTable.refresh();
             }
-
+            JsonArray memoryInfo;
+            uint64_t sampleAge = gResourceTable.toJson(memoryInfo);
             response["types"] = memoryInfo;
+            response["sampleAgeMs"] = sampleAge;
 
             returnResponse(result);
         }
@@ -5540,8 +6541,7 @@ namespace WPEFramework {
 
             std::string factoryAppCallsign("factoryapp");
             bool isFactoryAppRunning = false;
-            std::map<std::string, PluginData>::iterator pluginsEntry = gActivePluginsData.find(factoryAppCallsign);
-            if (pluginsEntry != gActivePluginsData.end())
+            if (gAppRegistry.isActive(factoryAppCallsign))
             {
                 std::cout << "factory app is running" << std::endl;
                 isFactoryAppRunning = true;
@@ -5579,14 +6579,11 @@ namespace WPEFramework {
             LOGINFOMETHOD();
             std::string factoryAppCallsign("factoryapp");
             bool isFactoryAppRunning = false;
-            gPluginDataMutex.lock();
-            std::map<std::string, PluginData>::iterator pluginsEntry = gActivePluginsData.find(factoryAppCallsign);
-            if (pluginsEntry != gActivePluginsData.end())
+            if (gAppRegistry.isActive(factoryAppCallsign))
             {
                 std::cout << "factory app is already running" << std::endl;
                 isFactoryAppRunning = true;
             }
-            gPluginDataMutex.unlock();
             if (!isFactoryAppRunning)
             {
                 std::cout << "nothing to do since factory app is not running\n";
@@ -5741,8 +6738,7 @@ namespace WPEFramework {
             bool ret = true;
             std::string callsign("factoryapp");
             bool isFactoryAppRunning = false;
-            std::map<std::string, PluginData>::iterator pluginsEntry = gActivePluginsData.find(callsign);
-            if (pluginsEntry != gActivePluginsData.end())
+            if (gAppRegistry.isActive(callsign))
             {
                 std::cout << "factory app is already running" << std::endl;
                 isFactoryAppRunning = true;
@@ -6115,6 +7111,7 @@ namespace WPEFramework {
                 CompositorController::setVisibility(clientList[i], !hide);
             }
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             returnResponse(true);
         }
 
@@ -6122,10 +7119,82 @@ namespace WPEFramework {
         {
             LOGINFOMETHOD();
             bool result = true;
+            bool toFile = parameters.HasLabel("format") || parameters.HasLabel("width") || parameters.HasLabel("height") ||
+                parameters.HasLabel("region") || parameters.HasLabel("path");
+            if (!toFile)
+            {
+                lockRdkShellMutex();
+                needsScreenshot = true;
+                gRdkShellMutex.unlock();
+                wakeRenderThread();
+                returnResponse(result);
+            }
+
+            ScreenshotEncoder::Options options;
+            unsigned int screenWidth = 0, screenHeight = 0;
             lockRdkShellMutex();
-            needsScreenshot = true;
+            CompositorController::getScreenResolution(screenWidth, screenHeight);
             gRdkShellMutex.unlock();
-            returnResponse(result);
+            // sizes are limited to the screen so a caller can not make the encoder allocate gigabytes
+            auto sizeParameter = [](const JsonObject& object, const char* name, uint32_t limit, uint32_t& value) -> bool {
+                const int64_t number = object[name].Number();
+                if ((number < 0) || ((limit > 0) && (number > limit)))
+                {
+                    return false;
+                }
+                value = (uint32_t)number;
+                return true;
+            };
+            if (parameters.HasLabel("format") && !ScreenshotEncoder::parseFormat(parameters["format"].String(), options.format))
+            {
+                response["message"] = "format must be one of raw, png or jpeg";
+                returnResponse(false);
+            }
+            if (!ScreenshotEncoder::isFormatSupported(options.format))
+            {
+                response["message"] = "format is not supported on this device";
+                returnResponse(false);
+            }
+            if ((parameters.HasLabel("width") && !sizeParameter(parameters, "width", screenWidth, options.width)) ||
+                (parameters.HasLabel("height") && !sizeParameter(parameters, "height", screenHeight, options.height)))
+            {
+                response["message"] = "width and height must be between 0 and the screen resolution";
+                returnResponse(false);
+            }
+            if (parameters.HasLabel("quality"))
+            {
+                options.quality = parameters["quality"].Number();
+            }
+            if (parameters.HasLabel("region"))
+            {
+                const JsonObject& region = parameters["region"].Object();
+                if (!(region.HasLabel("x") && region.HasLabel("y") && region.HasLabel("w") && region.HasLabel("h")))
+                {
+                    response["message"] = "please specify x, y, w and h of region";
+                    returnResponse(false);
+                }
+                if (!(sizeParameter(region, "x", screenWidth, options.regionX) && sizeParameter(region, "y", screenHeight, options.regionY) &&
+                    sizeParameter(region, "w", screenWidth, options.regionWidth) && sizeParameter(region, "h", screenHeight, options.regionHeight)))
+                {
+                    response["message"] = "region must be inside the screen";
+                    returnResponse(false);
+                }
+            }
+
+            lockRdkShellMutex();
+            const std::string name = parameters.HasLabel("path") ? parameters["path"].String() :
+                "screenshot_" + std::to_string(++gScreenshotCounter) + "." + ScreenshotEncoder::extension(options.format);
+            if (!outputFilePath(name, options.path))
+            {
+                gRdkShellMutex.unlock();
+                response["message"] = "path must be a file name, screenshots are written to " RDKSHELL_OUTPUT_DIRECTORY;
+                returnResponse(false);
+            }
+            gScreenshotRequests.push_back(options);
+            gRdkShellMutex.unlock();
+            wakeRenderThread();
+            response["path"] = options.path;
+            returnResponse(result);
         }
 
         uint32_t RDKShell::enableLogsFlushingWrapper(const JsonObject& parameters, JsonObject& response)
@@ -6338,6 +7407,337 @@ namespace WPEFramework {
             returnResponse(result);
         }
 
+        uint32_t RDKShell::getFrameStatsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonObject stats;
+            gFrameStats.toJson(stats);
+            response["stats"] = stats;
+            if (parameters.HasLabel("traceFile"))
+            {
+                string traceFile;
+                if (!outputFilePath(parameters["traceFile"].String(), traceFile))
+                {
+                    response["message"] = "traceFile must be a file name, it is written to " RDKSHELL_OUTPUT_DIRECTORY;
+                    result = false;
+                }
+                else if (!gFrameStats.writeChromeTrace(traceFile))
+                {
+                    response["message"] = "failed to write trace file";
+                    result = false;
+                }
+                else
+                {
+                    response["traceFile"] = traceFile;
+                }
+            }
+            if (parameters.HasLabel("reset") && parameters["reset"].Boolean())
+            {
+                gFrameStats.reset();
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getLaunchTimingsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            string callsign;
+            if (parameters.HasLabel("callsign"))
+            {
+                callsign = parameters["callsign"].String();
+            }
+            JsonArray timings;
+            gLaunchTracer.toJson(callsign, timings);
+            response["timings"] = timings;
+            if (parameters.HasLabel("reset") && parameters["reset"].Boolean())
+            {
+                gLaunchTracer.clear(callsign);
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getRequestQueueStatsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonObject stats;
+            gRequestPool.toJson(stats);
+            response["stats"] = stats;
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::setMemoryPressurePolicyWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            MemoryPressureManager::Config config = gMemoryPressure.config();
+            if (parameters.HasLabel("enable"))
+            {
+                config.enabled = parameters["enable"].Boolean();
+            }
+            if (parameters.HasLabel("interval"))
+            {
+                config.interval = parameters["interval"].Number();
+            }
+            const char* thresholdLabels[] = { "suspendThreshold", "hibernateThreshold", "destroyThreshold", "hysteresis" };
+            double* thresholds[] = { &config.suspendThreshold, &config.hibernateThreshold, &config.destroyThreshold, &config.hysteresis };
+            for (size_t i = 0; result && (i < 4); i++)
+            {
+                if (parameters.HasLabel(thresholdLabels[i]))
+                {
+                    const std::string text = parameters[thresholdLabels[i]].String();
+                    char* end = nullptr;
+                    double value = strtod(text.c_str(), &end);
+                    if (text.empty() || (end == nullptr) || (*end != '\0') || (value < 0))
+                    {
+                        result = false;
+                        response["message"] = string("invalid ") + thresholdLabels[i];
+                    }
+                    *thresholds[i] = value;
+                }
+            }
+            if (parameters.HasLabel("settleTime"))
+            {
+                config.settleTime = parameters["settleTime"].Number();
+            }
+            if (parameters.HasLabel("appRamLimit"))
+            {
+                config.appRamLimit = parameters["appRamLimit"].Number();
+            }
+            if (parameters.HasLabel("priorities"))
+            {
+                const JsonArray priorities = parameters["priorities"].Array();
+                config.priorities.clear();
+                for (int i = 0; i < priorities.Length(); i++)
+                {
+                    config.priorities.push_back(priorities[i].String());
+                }
+            }
+            if (result && ((config.suspendThreshold > config.hibernateThreshold) || (config.hibernateThreshold > config.destroyThreshold)))
+            {
+                result = false;
+                response["message"] = "thresholds must be suspend <= hibernate <= destroy";
+            }
+            if (result)
+            {
+                gMemoryPressure.configure(config);
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getMemoryPressureStatusWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonObject status;
+            gMemoryPressure.toJson(status);
+            response["status"] = status;
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::setWarmPoolConfigWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            WarmPool::Config config = gWarmPool.config();
+            if (parameters.HasLabel("enable"))
+            {
+                config.enabled = parameters["enable"].Boolean();
+            }
+            if (parameters.HasLabel("maxApps"))
+            {
+                config.maxApps = parameters["maxApps"].Number();
+            }
+            if (parameters.HasLabel("memoryBudget"))
+            {
+                config.memoryBudget = parameters["memoryBudget"].Number();
+            }
+            if (parameters.HasLabel("idleDelay"))
+            {
+                config.idleDelay = parameters["idleDelay"].Number();
+            }
+            gWarmPool.configure(config);
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getWarmPoolStatusWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonObject status;
+            gWarmPool.toJson(status);
+            response["status"] = status;
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::setEventCoalescingWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("events"))
+            {
+                result = false;
+                response["message"] = "please specify events";
+            }
+            if (result)
+            {
+                const JsonArray events = parameters["events"].Array();
+                std::vector<EventCoalescer::Rule> rules;
+                for (int i = 0; i < events.Length(); i++)
+                {
+                    const JsonObject& eventInfo = events[i].Object();
+                    if (!eventInfo.HasLabel("event"))
+                    {
+                        result = false;
+                        response["message"] = "please specify event";
+                        break;
+                    }
+                    EventCoalescer::Rule rule;
+                    rule.event = eventInfo["event"].String();
+                    rule.window = RDKSHELL_EVENT_COALESCING_WINDOW_IN_MS;
+                    if (eventInfo.HasLabel("window"))
+                    {
+                        rule.window = eventInfo["window"].Number();
+                    }
+                    if (eventInfo.HasLabel("key"))
+                    {
+                        rule.key = eventInfo["key"].String();
+                    }
+                    rules.push_back(rule);
+                }
+                if (result)
+                {
+                    gEventCoalescer.setRules(rules);
+                }
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getEventCoalescingWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonObject status;
+            gEventCoalescer.toJson(status);
+            response["status"] = status;
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getKeyRouteWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("keyCode") && !parameters.HasLabel("nativeKeyCode"))
+            {
+                response["message"] = "please specify keyCode or nativeKeyCode";
+                returnResponse(false);
+            }
+            const bool native = !parameters.HasLabel("keyCode");
+            const uint32_t keyCode = parameters[native ? "nativeKeyCode" : "keyCode"].Number();
+            const JsonArray modifiers = parameters.HasLabel("modifiers") ? parameters["modifiers"].Array() : JsonArray();
+            uint32_t flags = 0;
+            for (int i=0; i<modifiers.Length(); i++) {
+              flags |= getKeyFlag(modifiers[i].String());
+            }
+
+            // answered from the dispatch table, the compositor lock is not taken
+            KeyDispatchTable::Route route;
+            gKeyDispatchTable.lookup(native ? KeyDispatchTable::NATIVE_KEY_LISTENER : KeyDispatchTable::KEY_LISTENER, keyCode, flags, route);
+            JsonArray intercepts;
+            for (size_t i = 0; i < route.intercepts.size(); i++)
+            {
+                intercepts.Add(route.intercepts[i]);
+            }
+            JsonArray listeners;
+            for (size_t i = 0; i < route.listeners.size(); i++)
+            {
+                JsonObject listener;
+                listener["client"] = route.listeners[i].client;
+                listener["anyKey"] = (route.listeners[i].keyCode == ANY_KEY);
+                listener["activate"] = route.listeners[i].activate;
+                listener["propagate"] = route.listeners[i].propagate;
+                listeners.Add(listener);
+            }
+            response["intercepts"] = intercepts;
+            response["listeners"] = listeners;
+            response["registrations"] = gKeyDispatchTable.size();
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getInputLatencyWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonObject stats;
+            gInputLatency.toJson(stats);
+            response["stats"] = stats;
+            if (parameters.HasLabel("reset") && parameters["reset"].Boolean())
+            {
+                gInputLatency.reset();
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getStartupTimelineWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonObject timeline;
+            gStartupScheduler.toJson(timeline);
+            response["timeline"] = timeline;
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getTeardownReportWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonObject report;
+            gBulkTeardown.toJson(report);
+            response["report"] = report;
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getRialtoStatsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+#ifdef ENABLE_RIALTO_FEATURE
+            JsonObject stats;
+            rialtoConnector->getWaitStats(stats);
+            response["stats"] = stats;
+#else
+            result = false;
+            response["message"] = "rialto is not supported";
+#endif //ENABLE_RIALTO_FEATURE
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getTimerStatsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            std::vector<TimerWheel::OwnerStats> stats = TimerWheel::instance().stats();
+            JsonArray owners;
+            for (size_t i = 0; i < stats.size(); i++)
+            {
+                JsonObject owner;
+                owner["owner"] = stats[i].owner;
+                owner["scheduled"] = stats[i].scheduled;
+                owner["cancelled"] = stats[i].cancelled;
+                owner["fired"] = stats[i].fired;
+                owner["active"] = stats[i].active;
+                owner["averageLateUs"] = (stats[i].fired > 0) ? (uint32_t)(stats[i].totalLateUs / stats[i].fired) : 0;
+                owner["maxLateUs"] = (uint32_t)stats[i].maxLateUs;
+                owners.Add(owner);
+            }
+            response["owners"] = owners;
+            response["wakeups"] = TimerWheel::instance().wakeups();
+            returnResponse(result);
+        }
+
         uint32_t RDKShell::getBlockedAVApplicationsWrapper(const JsonObject& parameters, JsonObject& response)
         {
             LOGINFOMETHOD();
@@ -6403,18 +7803,7 @@ namespace WPEFramework {
             if (parameters.HasLabel("callsign"))
             {
                 std::string callsign = parameters["callsign"].String();
-                bool isApplicationBeingDestroyed = false;
-
-                gLaunchDestroyMutex.lock();
-                if (gDestroyApplications.find(callsign) != gDestroyApplications.end())
-                {
-                    isApplicationBeingDestroyed = true;
-                }
-                if (gExternalDestroyApplications.find(callsign) != gExternalDestroyApplications.end())
-                {
-                    isApplicationBeingDestroyed = true;
-                }
-                gLaunchDestroyMutex.unlock();
+                bool isApplicationBeingDestroyed = gAppRegistry.isBeingDestroyed(callsign);
 
                 if (isApplicationBeingDestroyed)
                 {
@@ -6441,8 +7830,7 @@ namespace WPEFramework {
                     }
                 }
 
-                std::thread requestsThread =
-                std::thread([=]()
+                bool submitted = gRequestPool.submit(RequestPool::LOW, callsign, [=]()
                 {
                     if (!waitForHibernateUnblocked(RDKSHELL_THUNDER_TIMEOUT))
                     {
@@ -6476,14 +7864,23 @@ namespace WPEFramework {
                     {
 			eventMsg["callsign"] = callsign;
                         eventMsg["success"] = true;
-                        gSuspendedOrHibernatedApplicationsMutex.lock();
-                        gSuspendedOrHibernatedApplications[callsign] = true;
-                        gSuspendedOrHibernatedApplicationsMutex.unlock();
+                        gAppRegistry.setSuspended(callsign, true);
                     }
                     notify(RDKShell::RDKSHELL_EVENT_ON_HIBERNATED, eventMsg);
+                }, [=]()
+                {
+                    // the caller was told the hibernate is queued, tell it that it will not happen
+                    JsonObject eventMsg;
+                    eventMsg["callsign"] = callsign;
+                    eventMsg["success"] = false;
+                    eventMsg["message"] = "hibernation cancelled";
+                    notify(RDKShell::RDKSHELL_EVENT_ON_HIBERNATED, eventMsg);
                 });
-                requestsThread.detach();
-                status = true;
+                if (!submitted)
+                {
+                    response["message"] = "request queue is full";
+                }
+                status = submitted;
             }
 
             returnResponse(status);
@@ -6496,8 +7893,9 @@ namespace WPEFramework {
             if (parameters.HasLabel("callsign"))
             {
                 std::string callsign = parameters["callsign"].String();
-                std::thread requestsThread =
-                std::thread([=]()
+                // a queued hibernate of the app is pointless once it is restored
+                gRequestPool.cancel(callsign);
+                bool submitted = gRequestPool.submit(RequestPool::HIGH, callsign, [=]()
                 {
                     auto thunderController = RDKShell::getThunderControllerClient();
                     JsonObject request, result, eventMsg;
@@ -6515,9 +7913,19 @@ namespace WPEFramework {
                         eventMsg["success"] = true;
                     }
                     notify(RDKShell::RDKSHELL_EVENT_ON_RESTORED, eventMsg);
+                }, [=]()
+                {
+                    JsonObject eventMsg;
+                    eventMsg["callsign"] = callsign;
+                    eventMsg["success"] = false;
+                    eventMsg["message"] = "restore cancelled";
+                    notify(RDKShell::RDKSHELL_EVENT_ON_RESTORED, eventMsg);
                 });
-                requestsThread.detach();
-                status = true;
+                if (!submitted)
+                {
+                    response["message"] = "request queue is full";
+                }
+                status = submitted;
             }
 
             returnResponse(status);
@@ -6526,10 +7934,78 @@ namespace WPEFramework {
 
         // Registered methods end
 
+        void RDKShell::processScreenshot(uint8_t* data, uint32_t size, unsigned int width, unsigned int height,
+            bool legacy, const std::vector<ScreenshotEncoder::Options>& requests)
+        {
+            if (legacy)
+            {
+                string screenshotBase64;
+                if (nullptr != data)
+                {
+                    Utils::String::imageEncoder(&data[0], size, true, screenshotBase64);
+                }
+                JsonObject params;
+                params["imageData"] = screenshotBase64;
+
+                // Calling Notify instead of  RDKShell::notify to avoid logging of entire screen content
+                LOGINFO("Notify %s", RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE.c_str());
+                Notify(RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE, params);
+            }
+
+            for (size_t i = 0; i < requests.size(); i++)
+            {
+                const ScreenshotEncoder::Options& options = requests[i];
+                std::vector<uint8_t> image, encoded;
+                uint32_t imageWidth = 0, imageHeight = 0;
+                bool success = false;
+                if ((nullptr != data) && (size >= width * height * 4))
+                {
+                    try
+                    {
+                        success = ScreenshotEncoder::transform(data, width, height, options, image, imageWidth, imageHeight) &&
+                            ScreenshotEncoder::encode(image, imageWidth, imageHeight, options.format, options.quality, encoded) &&
+                            ScreenshotEncoder::writeFile(options.path, encoded);
+                    }
+                    catch (const std::bad_alloc&)
+                    {
+                        std::cout << "not enough memory to encode screenshot " << options.path << std::endl;
+                        success = false;
+                    }
+                    if (success)
+                    {
+                        pruneScreenshots();
+                    }
+                }
+                JsonObject params;
+                params["success"] = success;
+                params["path"] = options.path;
+                params["format"] = ScreenshotEncoder::extension(options.format);
+                if (success)
+                {
+                    params["width"] = imageWidth;
+                    params["height"] = imageHeight;
+                    params["size"] = (uint32_t)encoded.size();
+                }
+                else
+                {
+                    params["message"] = "failed to create screenshot";
+                }
+                notify(RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE, params);
+            }
+
+            if ((nullptr != data) && (width > 0) && (height > 0))
+            {
+                mScreenCapture.onScreenCapture(&data[0], width, height);
+            }
+        }
+
         // Events begin
         void RDKShell::notify(const std::string& event, const JsonObject& parameters)
         {
-            sendNotify(event.c_str(), parameters);
+            if (!gEventCoalescer.dispatch(event, parameters))
+            {
+                sendNotify(event.c_str(), parameters);
+            }
         }
         // Events end
 
@@ -6598,14 +8074,73 @@ namespace WPEFramework {
                 sleep(1);
             }
 
+            std::vector<std::string> callsigns;
+            std::set<std::string> resumed;
             for (int i=0; i<stateList.Length(); i++)
             {
                 const JsonObject& stateInfo = stateList[i].Object();
                 if (stateInfo.HasLabel("callsign"))
                 {
-                   JsonObject destroyRequest, destroyResponse;
-                   destroyRequest["callsign"] = stateInfo["callsign"].String();
-                   destroyWrapper(destroyRequest, destroyResponse);
+                    callsigns.push_back(stateInfo["callsign"].String());
+                    if (stateInfo.HasLabel("state") && stateInfo["state"].String() == "resumed")
+                    {
+                        resumed.insert(stateInfo["callsign"].String());
+                    }
+                }
+            }
+
+            uint32_t fanOut = RDKSHELL_TEARDOWN_FAN_OUT;
+            char* fanOutValue = getenv("RDKSHELL_TEARDOWN_FAN_OUT");
+            if (NULL != fanOutValue && atoi(fanOutValue) > 0)
+            {
+                fanOut = atoi(fanOutValue);
+            }
+            uint32_t deadline = RDKSHELL_TEARDOWN_DEADLINE_IN_MS;
+            char* deadlineValue = getenv("RDKSHELL_TEARDOWN_DEADLINE_IN_MS");
+            if (NULL != deadlineValue && atoi(deadlineValue) > 0)
+            {
+                deadline = atoi(deadlineValue);
+            }
+
+            // suspending first stops rendering and releases av resources right away, apps
+            // that do not deactivate in time lose their display
+            std::vector<BulkTeardown::Stage> stages(3);
+            stages[0].name = "suspend";
+            stages[0].final = false;
+            stages[0].action = [this, resumed](const std::string& callsign) -> bool {
+                if (resumed.find(callsign) == resumed.end())
+                {
+                    return true;
+                }
+                JsonObject suspendRequest, suspendResponse;
+                suspendRequest["callsign"] = callsign;
+                suspendWrapper(suspendRequest, suspendResponse);
+                return suspendResponse["success"].Boolean();
+            };
+            stages[1].name = "destroy";
+            stages[1].final = true;
+            stages[1].action = [this](const std::string& callsign) -> bool {
+                JsonObject destroyRequest, destroyResponse;
+                destroyRequest["callsign"] = callsign;
+                destroyWrapper(destroyRequest, destroyResponse);
+                return destroyResponse["success"].Boolean();
+            };
+            stages[2].name = "kill";
+            stages[2].final = true;
+            stages[2].action = [this](const std::string& callsign) -> bool {
+                return kill(callsign);
+            };
+
+            std::vector<BulkTeardown::Outcome> outcomes = gBulkTeardown.run(callsigns, stages, fanOut, deadline);
+            JsonObject report;
+            gBulkTeardown.toJson(report);
+            std::cout << "RDKShell tore down " << outcomes.size() << " apps in " << report["totalMs"].Number() << " ms" << std::endl;
+            for (size_t i = 0; i < outcomes.size(); i++)
+            {
+                if (outcomes[i].straggler)
+                {
+                    std::cout << "RDKShell teardown straggler " << outcomes[i].callsign << " took " << outcomes[i].time
+                              << " ms, stopped by " << (outcomes[i].stage.empty() ? "none" : outcomes[i].stage) << std::endl;
                 }
             }
         }
@@ -6669,6 +8204,7 @@ namespace WPEFramework {
             lockRdkShellMutex();
             ret = CompositorController::moveToFront(client);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -6678,6 +8214,7 @@ namespace WPEFramework {
             lockRdkShellMutex();
             ret = CompositorController::moveToBack(client);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -6701,19 +8238,14 @@ namespace WPEFramework {
                 ret = CompositorController::moveBehind(client, target);
             }
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
         bool RDKShell::setFocus(const string& client)
         {
             bool ret = false;
-            bool isApplicationBeingDestroyed = false;
-            gLaunchDestroyMutex.lock();
-            if (gDestroyApplications.find(client) != gDestroyApplications.end())
-            {
-                isApplicationBeingDestroyed = true;
-            }
-            gLaunchDestroyMutex.unlock();
+            bool isApplicationBeingDestroyed = gAppRegistry.isBeingDestroyed(client, false);
             if (isApplicationBeingDestroyed)
             {
                 std::cout << "ignoring setFocus for " << client << " as it is being destroyed " << std::endl;
@@ -6724,73 +8256,58 @@ namespace WPEFramework {
             CompositorController::getFocused(previousFocusedClient);
             ret = CompositorController::setFocus(client);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
+            if (ret)
+            {
+                gAppRegistry.touch(client);
+            }
             std::string clientLower = toLower(client);
 
             if (previousFocusedClient != clientLower)
             {
-                std::map<std::string, PluginData> activePluginsData;
-                gPluginDataMutex.lock();
-                activePluginsData = gActivePluginsData;
-                gPluginDataMutex.unlock();
-
                 if (!previousFocusedClient.empty())
                 {
-                    std::map<std::string, PluginData>::iterator previousFocusedIterator;
-
-                    for (previousFocusedIterator = activePluginsData.begin(); previousFocusedIterator != activePluginsData.end(); previousFocusedIterator++)
+                    // compositor client names are lower case callsigns
+                    AppRegistry::AppPtr previousFocusedApp = gAppRegistry.findClient(previousFocusedClient);
+                    if (previousFocusedApp && previousFocusedApp->active)
                     {
-                        std::string compositorName = toLower(previousFocusedIterator->first);
-                        if (compositorName == previousFocusedClient)
-                        {
+                        const std::string& compositorName = previousFocusedClient;
 #ifdef HIBERNATE_SUPPORT_ENABLED
-                            // Skip for suspended and hibernated apps, since not needed and may cause unwanted restore from hibernation
-                            bool skipFocus = false;
-                            gSuspendedOrHibernatedApplicationsMutex.lock();
-                            if (gSuspendedOrHibernatedApplications.find(previousFocusedIterator->first) != gSuspendedOrHibernatedApplications.end())
-                            {
-                                skipFocus = gSuspendedOrHibernatedApplications[previousFocusedIterator->first];
-                            }
-
-                            // If app is not suspended nor hibernated, the hibernation for app can still be triggered
-                            // while waiting in a call to QueryInterfaceByCallsign() or Focused(). Further execution
-                            // of QueryInterfaceByCallsign() or Focused() may cause unwanted wakeup.
-                            // Make sure all new hibernations are blocked untill setting the focuse to false finished
-                            if (skipFocus == false)
-                            {
-                                setHibernateBlocked(true);
-                            }
-
-                            gSuspendedOrHibernatedApplicationsMutex.unlock();
-
-                            if (skipFocus == false)
-                            {
+                        // Skip for suspended and hibernated apps, since not needed and may cause unwanted restore from hibernation
+                        bool skipFocus = previousFocusedApp->suspendStateKnown && previousFocusedApp->suspended;
+
+                        // If app is not suspended nor hibernated, the hibernation for app can still be triggered
+                        // while waiting in a call to QueryInterfaceByCallsign() or Focused(). Further execution
+                        // of QueryInterfaceByCallsign() or Focused() may cause unwanted wakeup.
+                        // Make sure all new hibernations are blocked untill setting the focuse to false finished
+                        if (skipFocus == false)
+                        {
+                            setHibernateBlocked(true);
 #endif
-                                std::cout << "setting the focus of " << compositorName << " to false " << std::endl;
-                                Exchange::IFocus *focusedCallsign = mCurrentService->QueryInterfaceByCallsign<Exchange::IFocus>(previousFocusedIterator->first);
-                                if (focusedCallsign != NULL)
-                                {
-                                    uint32_t status = focusedCallsign->Focused(false);
-                                    std::cout << "result of set focus to false: " << status << std::endl;
-                                    focusedCallsign->Release();
-                                }
-#ifdef HIBERNATE_SUPPORT_ENABLED
-                                setHibernateBlocked(false);
-                             }
-                            else
+                            std::cout << "setting the focus of " << compositorName << " to false " << std::endl;
+                            Exchange::IFocus *focusedCallsign = mCurrentService->QueryInterfaceByCallsign<Exchange::IFocus>(previousFocusedApp->callsign);
+                            if (focusedCallsign != NULL)
                             {
-                                std::cout << "setting the focus for " << compositorName << " to false skipped, plugin suspended or hibernated " << std::endl;
+                                uint32_t status = focusedCallsign->Focused(false);
+                                std::cout << "result of set focus to false: " << status << std::endl;
+                                focusedCallsign->Release();
                             }
-#endif
-                            break;
+#ifdef HIBERNATE_SUPPORT_ENABLED
+                            setHibernateBlocked(false);
+                        }
+                        else
+                        {
+                            std::cout << "setting the focus for " << compositorName << " to false skipped, plugin suspended or hibernated " << std::endl;
                         }
+#endif
                     }
                 }
 
-                std::map<std::string, PluginData>::iterator focusedEntry = activePluginsData.find(client);
-                if (focusedEntry != activePluginsData.end())
+                AppRegistry::AppPtr focusedApp = gAppRegistry.find(client);
+                if (focusedApp && focusedApp->active)
                 {
                     std::cout << "setting the focus of " << client << " to true " << std::endl;
-                    Exchange::IFocus *focusedCallsign = mCurrentService->QueryInterfaceByCallsign<Exchange::IFocus>(client);
+                    Exchange::IFocus *focusedCallsign = mCurrentService->QueryInterfaceByCallsign<Exchange::IFocus>(focusedApp->callsign);
                     if (focusedCallsign != NULL)
                     {
                         uint32_t status = focusedCallsign->Focused(true);
@@ -6813,22 +8330,40 @@ namespace WPEFramework {
 
         bool RDKShell::kill(const string& client)
         {
-            bool ret = false;
+            std::shared_ptr<KillClientRequest> request = queueKill(client, nullptr);
+            sem_wait(&request->mSemaphore);
+            return request->mResult;
+        }
+
+        uint32_t RDKShell::killAsync(const string& client, const DisplayRequestCompletion& completion)
+        {
+            return queueKill(client, completion)->mToken;
+        }
+
+        std::shared_ptr<KillClientRequest> RDKShell::queueKill(const string& client, const DisplayRequestCompletion& completion)
+        {
             lockRdkShellMutex();
             RdkShell::CompositorController::removeListener(client, mEventListener);
             std::shared_ptr<KillClientRequest> request = std::make_shared<KillClientRequest>(client);
+            request->mToken = ++gDisplayRequestToken;
+            if (0 == request->mToken)
+            {
+                request->mToken = ++gDisplayRequestToken;
+            }
+            request->mCompletion = completion;
             gKillClientRequests.push_back(request);
+            gKeyDispatchTable.removeClient(client);
             gPluginDisplayNameMap.erase(client);
             std::cout << "removed displayname : "<<client<< std::endl;
             gRdkShellMutex.unlock();
-            sem_wait(&request->mSemaphore);
-            ret = request->mResult;
-            return ret;
+            wakeRenderThread();
+            return request;
         }
 
         bool RDKShell::addKeyIntercepts(const JsonArray& intercepts)
         {
             bool ret = true;
+            std::vector<KeyDispatchTable::Registration> registrations;
             for (int i=0; i<intercepts.Length(); i++)
             {
                 if (!(intercepts[i].Content() == JsonValue::type::OBJECT))
@@ -6862,191 +8397,120 @@ namespace WPEFramework {
                         continue;
                     }
                     const JsonArray modifiers = keyEntry.HasLabel("modifiers") ? keyEntry["modifiers"].Array() : JsonArray();
-                    const uint32_t keyCode = keyEntry["keyCode"].Number();
-                    ret = addKeyIntercept(keyCode, modifiers, client);
+                    KeyDispatchTable::Registration registration;
+                    registration.type = KeyDispatchTable::INTERCEPT;
+                    registration.client = client;
+                    registration.keyCode = keyEntry["keyCode"].Number();
+                    for (int m=0; m<modifiers.Length(); m++) {
+                      registration.flags |= getKeyFlag(modifiers[m].String());
+                    }
+                    registrations.push_back(registration);
                 }
             }
-            return ret;
+            // the valid entries are registered as one batch
+            const std::vector<std::map<std::string, RdkShellData>> properties(registrations.size());
+            lockRdkShellMutex();
+            bool registered = registerKeys(registrations, properties);
+            gRdkShellMutex.unlock();
+            if (registered)
+            {
+                gKeyDispatchTable.add(registrations);
+            }
+            return ret && registered;
         }
 
         bool RDKShell::addKeyIntercept(const uint32_t& keyCode, const JsonArray& modifiers, const string& client)
         {
-            uint32_t flags = 0;
+            KeyDispatchTable::Registration registration;
+            registration.type = KeyDispatchTable::INTERCEPT;
+            registration.client = client;
+            registration.keyCode = keyCode;
             for (int i=0; i<modifiers.Length(); i++) {
-              flags |= getKeyFlag(modifiers[i].String());
+              registration.flags |= getKeyFlag(modifiers[i].String());
             }
             bool ret = false;
-            gRdkShellMutex.lock();
-            ret = CompositorController::addKeyIntercept(client, keyCode, flags);
+            lockRdkShellMutex();
+            ret = registerKey(registration, std::map<std::string, RdkShellData>());
             gRdkShellMutex.unlock();
+            if (ret)
+            {
+                gKeyDispatchTable.add(std::vector<KeyDispatchTable::Registration>(1, registration));
+            }
             return ret;
         }
 
         bool RDKShell::removeKeyIntercept(const uint32_t& keyCode, const JsonArray& modifiers, const string& client)
         {
-            uint32_t flags = 0;
+            KeyDispatchTable::Registration registration;
+            registration.type = KeyDispatchTable::INTERCEPT;
+            registration.client = client;
+            registration.keyCode = keyCode;
             for (int i=0; i<modifiers.Length(); i++) {
-              flags |= getKeyFlag(modifiers[i].String());
+              registration.flags |= getKeyFlag(modifiers[i].String());
             }
             bool ret = false;
-            gRdkShellMutex.lock();
-            ret = CompositorController::removeKeyIntercept(client, keyCode, flags);
+            lockRdkShellMutex();
+            ret = unregisterKey(registration);
             gRdkShellMutex.unlock();
+            if (ret)
+            {
+                gKeyDispatchTable.remove(std::vector<KeyDispatchTable::Registration>(1, registration));
+            }
             return ret;
         }
 
         bool RDKShell::addKeyListeners(const string& client, const JsonArray& keys)
         {
-            gRdkShellMutex.lock();
-
-            bool result = true;
-
+            std::vector<KeyDispatchTable::Registration> registrations;
+            std::vector<std::map<std::string, RdkShellData>> properties;
             for (int i=0; i<keys.Length(); i++) {
-
-                result = false;
-                const JsonObject& keyInfo = keys[i].Object();
-
-                if (keyInfo.HasLabel("keyCode") && keyInfo.HasLabel("nativeKeyCode"))
-                {
-                    std::cout << "ERROR: keyCode and nativeKeyCode can't be set both at the same time" << std::endl;
-                }
-                else if (keyInfo.HasLabel("keyCode") || keyInfo.HasLabel("nativeKeyCode"))
-                {
-                    uint32_t keyCode = 0;
-
-                    if (keyInfo.HasLabel("keyCode"))
-                    {
-                        std::string keystring = keyInfo["keyCode"].String();
-                        if (keystring.compare("*") == 0)
-                        {
-                          keyCode = ANY_KEY;
-                        }
-                        else
-                        {
-                          keyCode = keyInfo["keyCode"].Number();
-                        }
-                    }
-                    else
-                    {
-                        std::string keystring = keyInfo["nativeKeyCode"].String();
-                        if (keystring.compare("*") == 0)
-                        {
-                            keyCode = ANY_KEY;
-                        }
-                        else
-                        {
-                            keyCode = keyInfo["nativeKeyCode"].Number();
-                        }
-                    }
-                    const JsonArray modifiers = keyInfo.HasLabel("modifiers") ? keyInfo["modifiers"].Array() : JsonArray();
-                    uint32_t flags = 0;
-                    for (int i=0; i<modifiers.Length(); i++) {
-                      flags |= getKeyFlag(modifiers[i].String());
-                    }
-                    std::map<std::string, RdkShellData> properties;
-                    if (keyInfo.HasLabel("activate"))
-                    {
-                        bool activate = keyInfo["activate"].Boolean();
-                        properties["activate"] = activate;
-                    }
-                    if (keyInfo.HasLabel("propagate"))
-                    {
-                        bool propagate = keyInfo["propagate"].Boolean();
-                        properties["propagate"] = propagate;
-                    }
-
-                    if (keyInfo.HasLabel("keyCode"))
-                    {
-                        result = CompositorController::addKeyListener(client, keyCode, flags, properties);
-                    }
-                    else
-                    {
-                        result = CompositorController::addNativeKeyListener(client, keyCode, flags, properties);
-                    }
-                }
-                else
+                KeyDispatchTable::Registration registration;
+                std::map<std::string, RdkShellData> keyProperties;
+                if (!parseKeyListener(client, keys[i].Object(), registration, keyProperties))
                 {
-                    std::cout << "ERROR: Neither keyCode nor nativeKeyCode provided" << std::endl;
-                }
-
-                if (result == false)
-                {
-                    break;
+                    return false;
                 }
+                registrations.push_back(registration);
+                properties.push_back(keyProperties);
             }
+
+            lockRdkShellMutex();
+            bool result = registerKeys(registrations, properties);
             gRdkShellMutex.unlock();
+            if (result)
+            {
+                gKeyDispatchTable.add(registrations);
+            }
             return result;
         }
 
         bool RDKShell::removeKeyListeners(const string& client, const JsonArray& keys)
         {
-            gRdkShellMutex.lock();
-
-            bool result = true;
-
+            std::vector<KeyDispatchTable::Registration> registrations;
             for (int i=0; i<keys.Length(); i++) {
-
-                result = false;
-                const JsonObject& keyInfo = keys[i].Object();
-
-                if (keyInfo.HasLabel("keyCode") && keyInfo.HasLabel("nativeKeyCode"))
-                {
-                    std::cout << "ERROR: keyCode and nativeKeyCode can't be set both at the same time" << std::endl;
-                }
-                else if (keyInfo.HasLabel("keyCode") || keyInfo.HasLabel("nativeKeyCode"))
-                {
-                    uint32_t keyCode = 0;
-                    if (keyInfo.HasLabel("keyCode"))
-                    {
-                        std::string keystring = keyInfo["keyCode"].String();
-                        if (keystring.compare("*") == 0)
-                        {
-                          keyCode = ANY_KEY;
-                        }
-                        else
-                        {
-                          keyCode = keyInfo["keyCode"].Number();
-                        }
-                    }
-                    else
-                    {
-                        std::string keystring = keyInfo["nativeKeyCode"].String();
-                        if (keystring.compare("*") == 0)
-                        {
-                          keyCode = ANY_KEY;
-                        }
-                        else
-                        {
-                          keyCode = keyInfo["nativeKeyCode"].Number();
-                        }
-                    }
-
-                    const JsonArray modifiers = keyInfo.HasLabel("modifiers") ? keyInfo["modifiers"].Array() : JsonArray();
-                    uint32_t flags = 0;
-                    for (int i=0; i<modifiers.Length(); i++) {
-                      flags |= getKeyFlag(modifiers[i].String());
-                    }
-
-                    if (keyInfo.HasLabel("keyCode"))
-                    {
-                        result = CompositorController::removeKeyListener(client, keyCode, flags);
-                    }
-                    else
-                    {
-                        result = CompositorController::removeNativeKeyListener(client, keyCode, flags);
-                    }
-                }
-                else
+                KeyDispatchTable::Registration registration;
+                std::map<std::string, RdkShellData> keyProperties;
+                if (!parseKeyListener(client, keys[i].Object(), registration, keyProperties))
                 {
-                    std::cout << "ERROR: Neither keyCode nor nativeKeyCode provided" << std::endl;
+                    return false;
                 }
+                registrations.push_back(registration);
+            }
 
+            lockRdkShellMutex();
+            bool result = true;
+            size_t removed = 0;
+            for (; removed < registrations.size(); removed++)
+            {
+                result = unregisterKey(registrations[removed]);
                 if (result == false)
                 {
                     break;
                 }
             }
             gRdkShellMutex.unlock();
+            registrations.resize(removed);
+            gKeyDispatchTable.remove(registrations);
             return result;
         }
 
@@ -7061,10 +8525,13 @@ namespace WPEFramework {
             auto promisePtr = std::make_shared<std::promise<bool>>(std::move(promise));
             auto result = promisePtr->get_future();
 
-            mTaskQueue.push([keyCode, flags, promisePtr](){
+            const uint32_t latencyId = gInputLatency.keyArrived(RdkShell::microseconds());
+            mTaskQueue.push([keyCode, flags, promisePtr, latencyId](){
                 bool status = CompositorController::injectKey(keyCode, flags);
+                gInputLatency.keyDispatched(latencyId, keyTargets(keyCode, flags), status, RdkShell::microseconds());
                 promisePtr->set_value(status);
             });
+            wakeRenderThread();
 
             return result.get();
         }
@@ -7099,6 +8566,7 @@ namespace WPEFramework {
                 {
                   keyClient = keyInputInfo.HasLabel("callsign")? keyInputInfo["callsign"].String(): "";
                 }
+                const uint32_t latencyId = gInputLatency.keyArrived(RdkShell::microseconds());
                 lockRdkShellMutex();
 		bool targetFound = false;
                 if (keyClient != "")
@@ -7111,11 +8579,16 @@ namespace WPEFramework {
                     targetFound = true;
                   }
                 }
+                bool generated = false;
                 if (targetFound || keyClient == "")
                 {
                   ret = CompositorController::generateKey(keyClient, keyCode, flags, virtualKey);
+                  generated = ret;
                 }
+                gInputLatency.keyDispatched(latencyId, keyClient.empty() ? keyTargets(keyCode, flags) : std::vector<std::string>(1, keyClient),
+                    generated, RdkShell::microseconds());
                 gRdkShellMutex.unlock();
+                wakeRenderThread();
             }
             return ret;
         }
@@ -7142,6 +8615,7 @@ namespace WPEFramework {
             resolutionWidth = w;
             resolutionHeight = h;
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return true;
         }
 
@@ -7167,23 +8641,62 @@ namespace WPEFramework {
             const bool virtualDisplay, const uint32_t virtualWidth, const uint32_t virtualHeight, const bool topmost, const bool focus)
         {
             bool ret = false;
-            if (!isClientExists(client))
+            std::shared_ptr<CreateDisplayRequest> request = queueCreateDisplay(client, displayName, displayWidth, displayHeight, virtualDisplay, virtualWidth, virtualHeight, nullptr);
+            if (request)
             {
-                lockRdkShellMutex();
-                std::shared_ptr<CreateDisplayRequest> request = std::make_shared<CreateDisplayRequest>(client, displayName, displayWidth, displayHeight, virtualDisplay, virtualWidth, virtualHeight);
-                gCreateDisplayRequests.push_back(request);
-                gRdkShellMutex.unlock();
                 sem_wait(&request->mSemaphore);
                 ret = request->mResult;
             }
-            else
+            lockRdkShellMutex();
+            RdkShell::CompositorController::addListener(client, mEventListener);
+            gRdkShellMutex.unlock();
+            return ret;
+        }
+
+        uint32_t RDKShell::createDisplayAsync(const string& client, const string& displayName, const uint32_t displayWidth, const uint32_t displayHeight,
+            const bool virtualDisplay, const uint32_t virtualWidth, const uint32_t virtualHeight, const DisplayRequestCompletion& completion)
+        {
+            std::shared_ptr<RdkShell::RdkShellEventListener> eventListener = mEventListener;
+            std::shared_ptr<CreateDisplayRequest> request = queueCreateDisplay(client, displayName, displayWidth, displayHeight, virtualDisplay, virtualWidth, virtualHeight,
+                [client, eventListener, completion](uint32_t token, bool result) {
+                    lockRdkShellMutex();
+                    RdkShell::CompositorController::addListener(client, eventListener);
+                    gRdkShellMutex.unlock();
+                    if (completion)
+                    {
+                        completion(token, result);
+                    }
+                });
+            if (!request)
+            {
+                lockRdkShellMutex();
+                RdkShell::CompositorController::addListener(client, mEventListener);
+                gRdkShellMutex.unlock();
+                return 0;
+            }
+            return request->mToken;
+        }
+
+        std::shared_ptr<CreateDisplayRequest> RDKShell::queueCreateDisplay(const string& client, const string& displayName, const uint32_t displayWidth, const uint32_t displayHeight,
+            const bool virtualDisplay, const uint32_t virtualWidth, const uint32_t virtualHeight, const DisplayRequestCompletion& completion)
+        {
+            if (isClientExists(client))
             {
                 std::cout << "Client " << client  << "already exist " << std::endl;
+                return nullptr;
             }
             lockRdkShellMutex();
-            RdkShell::CompositorController::addListener(client, mEventListener);
+            std::shared_ptr<CreateDisplayRequest> request = std::make_shared<CreateDisplayRequest>(client, displayName, displayWidth, displayHeight, virtualDisplay, virtualWidth, virtualHeight);
+            request->mToken = ++gDisplayRequestToken;
+            if (0 == request->mToken)
+            {
+                request->mToken = ++gDisplayRequestToken;
+            }
+            request->mCompletion = completion;
+            gCreateDisplayRequests.push_back(request);
             gRdkShellMutex.unlock();
-            return ret;
+            wakeRenderThread();
+            return request;
         }
 
         bool RDKShell::getClients(JsonArray& clients)
@@ -7235,8 +8748,9 @@ namespace WPEFramework {
             ret = CompositorController::setBounds(client, 0, 0, 1, 1); //forcing a compositor resize flush
             ret = CompositorController::setBounds(client, x, y, w, h);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             std::cout << "bounds set\n";
-            usleep(68000);
+            usleep(RDKSHELL_BOUNDS_SETTLE_TIME_IN_US);
             std::cout << "all set\n";
             return ret;
         }
@@ -7272,47 +8786,38 @@ namespace WPEFramework {
             }
             ret = CompositorController::setVisibility(client, visible);
             gRdkShellMutex.unlock();
-            
-            bool isApplicationBeingDestroyed = false;
-            gLaunchDestroyMutex.lock();
-            if (gDestroyApplications.find(client) != gDestroyApplications.end())
-            {
-                isApplicationBeingDestroyed = true;
-            }
-            if (gExternalDestroyApplications.find(client) != gExternalDestroyApplications.end())
+            wakeRenderThread();
+
+            if (!setBrowserVisibility(client, visible))
             {
-                 isApplicationBeingDestroyed = true;
+                return false;
             }
-            gLaunchDestroyMutex.unlock();
+            return ret;
+        }
+
+        // forwards the visibility of a WebKitBrowser client to the browser, false when the app is being destroyed
+        bool RDKShell::setBrowserVisibility(const string& client, const bool visible)
+        {
+            bool isApplicationBeingDestroyed = gAppRegistry.isBeingDestroyed(client);
             if (isApplicationBeingDestroyed)
             {
                 std::cout << "ignoring setvisibility for " << client << " as it is being destroyed " << std::endl;
                 return false;
             }
-            std::map<std::string, PluginData> activePluginsData;
-            gPluginDataMutex.lock();
-            activePluginsData = gActivePluginsData;
-            gPluginDataMutex.unlock();
-            std::map<std::string, PluginData>::iterator pluginsEntry = activePluginsData.find(client);
-            if (pluginsEntry != activePluginsData.end())
+            AppRegistry::AppPtr app = gAppRegistry.find(client);
+            if (app && app->active)
             {
-                PluginData& pluginData = pluginsEntry->second;
-                if (pluginData.mClassName.compare("WebKitBrowser") == 0)
+                if (app->className.compare("WebKitBrowser") == 0)
                 {
                     std::cout << "setting the visiblity of " << client << " to " << visible << std::endl;
                     uint32_t status = 0;
-                    gLaunchDestroyMutex.lock();
-                    if (gDestroyApplications.find(client) != gDestroyApplications.end())
-                    {
-                        isApplicationBeingDestroyed = true;
-                    }
-                    gLaunchDestroyMutex.unlock();
-					if (isApplicationBeingDestroyed)
+                    if (gAppRegistry.isBeingDestroyed(client, false))
                     {
                         std::cout << "ignoring setvisibility for " << client << " as it is being destroyed " << std::endl;
-						return false;
+                        return false;
                     }
-                    gDestroyMutex.lock();
+                    std::shared_ptr<std::mutex> appDestroyMutex = destroyMutex(client);
+                    appDestroyMutex->lock();
                     Exchange::IWebBrowser *browser = mCurrentService->QueryInterfaceByCallsign<Exchange::IWebBrowser>(client);
                     if (browser != NULL)
                     {
@@ -7323,7 +8828,8 @@ namespace WPEFramework {
                     {
                         status = 1;
                     }
-                    gDestroyMutex.unlock();
+                    appDestroyMutex->unlock();
+                    releaseDestroyMutex(client, appDestroyMutex);
                     if (status > 0)
                     {
                         std::cout << "failed to set visibility property to browser " << client << " with status code " << status << std::endl;
@@ -7331,7 +8837,7 @@ namespace WPEFramework {
                 }
             }
 
-            return ret;
+            return true;
         }
 
         bool RDKShell::getOpacity(const string& client, unsigned int& opacity)
@@ -7361,6 +8867,7 @@ namespace WPEFramework {
               ret = CompositorController::setOpacity(newClient, opacity);
             }
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7391,6 +8898,7 @@ namespace WPEFramework {
               ret = CompositorController::setScale(newClient, scaleX, scaleY);
             }
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7409,6 +8917,7 @@ namespace WPEFramework {
             lockRdkShellMutex();
             ret = CompositorController::setHolePunch(client, holePunch);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7418,76 +8927,261 @@ namespace WPEFramework {
             lockRdkShellMutex();
             ret = CompositorController::removeAnimation(client);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
+        namespace {
+            // the compositor takes the animated properties by name
+            AnimationTimeline::Animation compositorAnimation(const CompositorRequests::Animation& animation)
+            {
+                AnimationTimeline::Animation result;
+                result.client = animation.client;
+                result.duration = animation.duration;
+                if (animation.hasX)
+                {
+                    result.properties["x"] = animation.x;
+                }
+                if (animation.hasY)
+                {
+                    result.properties["y"] = animation.y;
+                }
+                if (animation.hasW)
+                {
+                    result.properties["w"] = animation.w;
+                }
+                if (animation.hasH)
+                {
+                    result.properties["h"] = animation.h;
+                }
+                if (animation.hasScaleX)
+                {
+                    result.properties["sx"] = animation.scaleX;
+                }
+                if (animation.hasScaleY)
+                {
+                    result.properties["sy"] = animation.scaleY;
+                }
+                if (animation.hasOpacity)
+                {
+                    result.properties["a"] = animation.opacity;
+                }
+                if (animation.hasTween)
+                {
+                    result.properties["tween"] = animation.tween;
+                }
+                if (animation.hasDelay)
+                {
+                    result.properties["delay"] = animation.delay;
+                }
+                return result;
+            }
+        }
+
         bool RDKShell::addAnimationList(const JsonArray& animations)
         {
+            double animationTime = 0;
+            std::vector<AnimationTimeline::Animation> parsedAnimations;
+            for (int i=0; i<animations.Length(); i++) {
+                CompositorRequests::Animation animation;
+                std::vector<std::string> invalidFields;
+                string message;
+                if (!CompositorRequests::parseAnimation(animations[i].Object(), animation, invalidFields, message))
+                {
+                    std::cout << "RDKShell ignoring animation " << i << ": " << message << std::endl;
+                    continue;
+                }
+                // the animation still runs without the fields it could not read
+                for (size_t f = 0; f < invalidFields.size(); f++)
+                {
+                    std::cout << "RDKShell unable to set " << invalidFields[f] << " for animation " << i << std::endl;
+                }
+                parsedAnimations.push_back(compositorAnimation(animation));
+                animationTime = std::max(animationTime, animation.length());
+            }
             lockRdkShellMutex();
+            for (size_t i = 0; i < parsedAnimations.size(); i++)
+            {
+                CompositorController::addAnimation(parsedAnimations[i].client, parsedAnimations[i].duration, parsedAnimations[i].properties);
+            }
+            gRdkShellMutex.unlock();
+            wakeRenderThread(animationTime * 1000 + RDKSHELL_IDLE_GRACE_PERIOD_IN_MS);
+            return true;
+        }
+
+        bool RDKShell::addAnimationTimeline(const JsonArray& animations, string& id, double& length, int& failedAnimation, string& message)
+        {
+            std::shared_ptr<AnimationTimeline> timeline = std::make_shared<AnimationTimeline>();
+            timeline->length = 0;
             for (int i=0; i<animations.Length(); i++) {
-                const JsonObject& animationInfo = animations[i].Object();
-                if (animationInfo.HasLabel("client") && animationInfo.HasLabel("duration"))
+                CompositorRequests::Animation animation;
+                std::vector<std::string> invalidFields;
+                if (!CompositorRequests::parseAnimation(animations[i].Object(), animation, invalidFields, message))
                 {
-                    const string client  = animationInfo["client"].String();
-                    const double duration = std::stod(animationInfo["duration"].String());
-                    std::map<std::string, RdkShellData> animationProperties;
-                    if (animationInfo.HasLabel("x"))
-                    {
-                        int32_t x = animationInfo["x"].Number();
-                        animationProperties["x"] = x;
-                    }
-                    if (animationInfo.HasLabel("y"))
-                    {
-                        int32_t y = animationInfo["y"].Number();
-                        animationProperties["y"] = y;
-                    }
-                    if (animationInfo.HasLabel("w"))
-                    {
-                        uint32_t width = animationInfo["w"].Number();
-                        animationProperties["w"] = width;
-                    }
-                    if (animationInfo.HasLabel("h"))
-                    {
-                        uint32_t height = animationInfo["h"].Number();
-                        animationProperties["h"] = height;
-                    }
-                    if (animationInfo.HasLabel("sx"))
-                    {
-                        double scaleX = std::stod(animationInfo["sx"].String());
-                        animationProperties["sx"] = scaleX;
-                    }
-                    if (animationInfo.HasLabel("sy"))
-                    {
-                        double scaleY = std::stod(animationInfo["sy"].String());
-                        animationProperties["sy"] = scaleY;
-                    }
-                    if (animationInfo.HasLabel("a"))
+                    failedAnimation = i;
+                    return false;
+                }
+                if (!invalidFields.empty())
+                {
+                    message = "invalid " + invalidFields[0];
+                    failedAnimation = i;
+                    return false;
+                }
+                timeline->animations.push_back(compositorAnimation(animation));
+                timeline->length = std::max(timeline->length, animation.length());
+            }
+            if (timeline->animations.empty())
+            {
+                message = "no animations";
+                return false;
+            }
+
+            lockRdkShellMutex();
+            if (id.empty())
+            {
+                id = "timeline" + std::to_string(++gAnimationTimelineCount);
+            }
+            timeline->id = id;
+            timeline->requestTime = RdkShell::microseconds();
+            timeline->startTime = 0;
+            gAnimationTimelines.push_back(timeline);
+            gRdkShellMutex.unlock();
+            length = timeline->length;
+            wakeRenderThread(timeline->length * 1000 + RDKSHELL_IDLE_GRACE_PERIOD_IN_MS);
+            return true;
+        }
+
+        namespace {
+            typedef CompositorRequests::TransactionOperation TransactionOperation;
+
+            // checks the clients of a parsed entry exist and fills in the values it did not
+            // give, must be called with the rdkshell mutex held
+            bool resolveTransactionOperation(TransactionOperation& operation, const std::vector<std::string>& clientList, string& message)
+            {
+                if (std::find(clientList.begin(), clientList.end(), operation.client) == clientList.end())
+                {
+                    message = "client not found";
+                    return false;
+                }
+                if ((operation.type == TransactionOperation::MOVE_BEHIND) &&
+                    (std::find(clientList.begin(), clientList.end(), operation.target) == clientList.end()))
+                {
+                    message = "target not found";
+                    return false;
+                }
+                if (operation.type == TransactionOperation::BOUNDS)
+                {
+                    unsigned int x = 0, y = 0, w = 0, h = 0;
+                    CompositorController::getBounds(operation.client, x, y, w, h);
+                    operation.x = operation.hasX ? operation.x : x;
+                    operation.y = operation.hasY ? operation.y : y;
+                    operation.w = operation.hasW ? operation.w : w;
+                    operation.h = operation.hasH ? operation.h : h;
+                }
+                else if (operation.type == TransactionOperation::SCALE)
+                {
+                    double scaleX = 1.0, scaleY = 1.0;
+                    CompositorController::getScale(operation.client, scaleX, scaleY);
+                    operation.scaleX = operation.hasScaleX ? operation.scaleX : scaleX;
+                    operation.scaleY = operation.hasScaleY ? operation.scaleY : scaleY;
+                }
+                return true;
+            }
+        }
+
+        bool RDKShell::applyTransaction(const JsonArray& operations, int& failedOperation, string& message)
+        {
+            failedOperation = -1;
+            if (operations.Length() == 0)
+            {
+                message = "no operations";
+                return false;
+            }
+            if (operations.Length() > RDKSHELL_MAX_TRANSACTION_OPERATIONS)
+            {
+                message = "too many operations";
+                return false;
+            }
+
+            // the parameters are read before taking the lock, the clients are checked and
+            // the changes applied under one lock so the render thread draws none or all of them
+            std::vector<TransactionOperation> parsedOperations(operations.Length());
+            for (int i = 0; i < operations.Length(); i++)
+            {
+                if (!CompositorRequests::parseTransactionOperation(operations[i].Object(), parsedOperations[i], message))
+                {
+                    failedOperation = i;
+                    return false;
+                }
+            }
+            bool boundsChanged = false;
+            {
+                RdkShellMutexLock lock;
+                std::vector<std::string> clientList;
+                CompositorController::getClients(clientList);
+                for (size_t i = 0; i < parsedOperations.size(); i++)
+                {
+                    if (!resolveTransactionOperation(parsedOperations[i], clientList, message))
                     {
-                        uint32_t opacity = animationInfo["a"].Number();
-                        animationProperties["a"] = opacity;
+                        failedOperation = i;
+                        return false;
                     }
-                    if (animationInfo.HasLabel("tween"))
+                }
+                for (size_t i = 0; i < parsedOperations.size(); i++)
+                {
+                    const TransactionOperation& operation = parsedOperations[i];
+                    bool applied = false;
+                    switch (operation.type)
                     {
-                        std::string tween = animationInfo["tween"].String();
-                        animationProperties["tween"] = tween;
+                        case TransactionOperation::BOUNDS:
+                            CompositorController::setBounds(operation.client, 0, 0, 1, 1); //forcing a compositor resize flush
+                            applied = CompositorController::setBounds(operation.client, operation.x, operation.y, operation.w, operation.h);
+                            boundsChanged = true;
+                            break;
+                        case TransactionOperation::OPACITY:
+                            applied = CompositorController::setOpacity(operation.client, operation.opacity);
+                            break;
+                        case TransactionOperation::SCALE:
+                            applied = CompositorController::setScale(operation.client, operation.scaleX, operation.scaleY);
+                            break;
+                        case TransactionOperation::VISIBILITY:
+                            applied = CompositorController::setVisibility(operation.client, operation.flag);
+                            break;
+                        case TransactionOperation::HOLE_PUNCH:
+                            applied = CompositorController::setHolePunch(operation.client, operation.flag);
+                            break;
+                        case TransactionOperation::MOVE_TO_FRONT:
+                            applied = CompositorController::moveToFront(operation.client);
+                            break;
+                        case TransactionOperation::MOVE_TO_BACK:
+                            applied = CompositorController::moveToBack(operation.client);
+                            break;
+                        case TransactionOperation::MOVE_BEHIND:
+                            applied = CompositorController::moveBehind(operation.client, operation.target);
+                            break;
                     }
-                    if (animationInfo.HasLabel("delay"))
+                    if (!applied && (failedOperation < 0))
                     {
-                        try
-                        {
-                          double duration = std::stod(animationInfo["delay"].String());
-                          animationProperties["delay"] = duration;
-                        }
-                        catch (...)
-                        {
-                          std::cout << "RDKShell unable to set delay for animation  " << std::endl;
-                        }
+                        // validated operations should not fail, report the first one but keep the rest applied
+                        failedOperation = i;
+                        message = "failed to apply operation";
                     }
-                    CompositorController::addAnimation(client, duration, animationProperties);
                 }
             }
-            gRdkShellMutex.unlock();
-            return true;
+            wakeRenderThread();
+            if (boundsChanged)
+            {
+                usleep(RDKSHELL_BOUNDS_SETTLE_TIME_IN_US);
+            }
+
+            for (size_t i = 0; i < parsedOperations.size(); i++)
+            {
+                if (parsedOperations[i].type == TransactionOperation::VISIBILITY)
+                {
+                    setBrowserVisibility(parsedOperations[i].client, parsedOperations[i].flag);
+                }
+            }
+            return failedOperation < 0;
         }
 
         bool RDKShell::enableInactivityReporting(const bool enable)
@@ -7532,9 +9226,15 @@ namespace WPEFramework {
         void RDKShell::onLaunched(const std::string& client, const string& launchType)
         {
             std::cout << "RDKShell onLaunched event received for " << client << std::endl;
+            gAppRegistry.touch(client);
             JsonObject params;
             params["client"] = client;
             params["launchType"] = launchType;
+            JsonObject timings;
+            if (gLaunchTracer.latestToJson(client, timings))
+            {
+                params["timings"] = timings;
+            }
             notify(RDKSHELL_EVENT_ON_LAUNCHED, params);
         }
 
@@ -7563,22 +9263,20 @@ namespace WPEFramework {
             return ret;
         }
 
-        bool RDKShell::pluginMemoryUsage(const string callsign, JsonArray& memoryInfo)
+        int32_t RDKShell::pluginMemoryUsage(const string& callsign)
         {
-            JsonObject memoryDetails;
-            Exchange::IMemory* pluginMemoryInterface(mCurrentService->QueryInterfaceByCallsign<Exchange::IMemory>(callsign.c_str()));
-            memoryDetails["callsign"] = callsign;
-            memoryDetails["ram"] = -1;
+            int32_t ram = -1;
+            Exchange::IMemory* pluginMemoryInterface = (nullptr != mCurrentService) ? mCurrentService->QueryInterfaceByCallsign<Exchange::IMemory>(callsign.c_str()) : nullptr;
             if (nullptr != pluginMemoryInterface)
             {
-                memoryDetails["ram"] = pluginMemoryInterface->Resident()/1024;
+                ram = pluginMemoryInterface->Resident()/1024;
+                pluginMemoryInterface->Release();
             }
             else
             {
                 std::cout << "Memory information not available for " << callsign << std::endl;
             }
-            memoryInfo.Add(memoryDetails);
-            return true;
+            return ram;
         }
 
 
@@ -7606,6 +9304,7 @@ namespace WPEFramework {
             lockRdkShellMutex();
             ret = CompositorController::setTopmost(callsign, topmost, focus);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7624,6 +9323,7 @@ namespace WPEFramework {
             lockRdkShellMutex();
             ret = CompositorController::setVirtualResolution(client, virtualWidth, virtualHeight);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7633,6 +9333,7 @@ namespace WPEFramework {
             lockRdkShellMutex();
             ret = CompositorController::enableVirtualDisplay(client, enable);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7674,6 +9375,12 @@ namespace WPEFramework {
                 JsonObject launchParams;
                launchParams["client"] = mCallSign;
                launchParams["launchType"] = (isSuspended)?"suspend":"resume";
+               JsonObject timings;
+               gLaunchTracer.completePending(mCallSign, "stateChange");
+               if (gLaunchTracer.latestToJson(mCallSign, timings))
+               {
+                   launchParams["timings"] = timings;
+               }
                mRDKShell.notify(RDKShell::RDKSHELL_EVENT_ON_LAUNCHED, launchParams);
                mLaunchEnabled = false;
             }
@@ -7699,6 +9406,7 @@ namespace WPEFramework {
                 ret = CompositorController::hideWatermark();
             }
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7709,6 +9417,7 @@ namespace WPEFramework {
             fullScreenImagePath = path;
             receivedFullScreenImageRequest = true;
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7744,7 +9453,7 @@ namespace WPEFramework {
                 {  
                     std::string serviceCallsign = SYSTEM_SERVICE_CALLSIGN;
                     serviceCallsign.append(".2");
-                    gSystemServiceConnection = RDKShell::getThunderControllerClient(serviceCallsign);
+                    gSystemServiceConnection = RDKShell::createThunderControllerClient(serviceCallsign);
                 }
             }
 
@@ -7795,6 +9504,7 @@ namespace WPEFramework {
             gRdkShellMutex.lock();
             bool ret = CompositorController::showCursor();
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7803,6 +9513,7 @@ namespace WPEFramework {
             gRdkShellMutex.lock();
             bool ret = CompositorController::hideCursor();
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -7811,6 +9522,7 @@ namespace WPEFramework {
             gRdkShellMutex.lock();
             bool ret = CompositorController::setCursorSize(width, height);
             gRdkShellMutex.unlock();
+            wakeRenderThread();
             return ret;
         }
 
@@ -26,6 +26,7 @@
 #include <rdkshell/linuxkeys.h>
 #include <interfaces/ICapture.h>
 #include "tptimer.h"
+#include "ScreenshotEncoder.h"
 #ifdef ENABLE_RIALTO_FEATURE
 #include "RialtoConnector.h"
 #define RIALTO_TIMEOUT_MILLIS 5000
@@ -40,6 +41,9 @@ namespace WPEFramework {
             JsonObject mRequest;
         };
 
+        struct CreateDisplayRequest;
+        struct KillClientRequest;
+
         class RDKShell :  public PluginHost::IPlugin, public PluginHost::JSONRPC {
         public:
             RDKShell();
@@ -146,6 +150,23 @@ namespace WPEFramework {
             static const string RDKSHELL_METHOD_KEY_REPEAT_CONFIG;
             static const string RDKSHELL_METHOD_GET_GRAPHICS_FRAME_RATE;
             static const string RDKSHELL_METHOD_SET_GRAPHICS_FRAME_RATE;
+            static const string RDKSHELL_METHOD_GET_FRAME_STATS;
+            static const string RDKSHELL_METHOD_GET_LAUNCH_TIMINGS;
+            static const string RDKSHELL_METHOD_GET_REQUEST_QUEUE_STATS;
+            static const string RDKSHELL_METHOD_APPLY_TRANSACTION;
+            static const string RDKSHELL_METHOD_SET_MEMORY_PRESSURE_POLICY;
+            static const string RDKSHELL_METHOD_GET_MEMORY_PRESSURE_STATUS;
+            static const string RDKSHELL_METHOD_SET_WARM_POOL_CONFIG;
+            static const string RDKSHELL_METHOD_GET_WARM_POOL_STATUS;
+            static const string RDKSHELL_METHOD_SET_EVENT_COALESCING;
+            static const string RDKSHELL_METHOD_GET_EVENT_COALESCING;
+            static const string RDKSHELL_METHOD_GET_KEY_ROUTE;
+            static const string RDKSHELL_METHOD_GET_INPUT_LATENCY;
+            static const string RDKSHELL_METHOD_ADD_ANIMATION_TIMELINE;
+            static const string RDKSHELL_METHOD_GET_STARTUP_TIMELINE;
+            static const string RDKSHELL_METHOD_GET_TEARDOWN_REPORT;
+            static const string RDKSHELL_METHOD_GET_RIALTO_STATS;
+            static const string RDKSHELL_METHOD_GET_TIMER_STATS;
 #ifdef HIBERNATE_SUPPORT_ENABLED
             static const string RDKSHELL_METHOD_HIBERNATE;
             static const string RDKSHELL_METHOD_RESTORE;
@@ -173,6 +194,10 @@ namespace WPEFramework {
             static const string RDKSHELL_EVENT_ON_EASTER_EGG;
             static const string RDKSHELL_EVENT_ON_WILL_DESTROY;
             static const string RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE;
+            static const string RDKSHELL_EVENT_ON_MEMORY_PRESSURE_ACTION;
+            static const string RDKSHELL_EVENT_ON_DISPLAY_CREATED;
+            static const string RDKSHELL_EVENT_ON_CLIENT_KILLED;
+            static const string RDKSHELL_EVENT_ON_ANIMATION_TIMELINE_COMPLETE;
 #ifdef HIBERNATE_SUPPORT_ENABLED
             static const string RDKSHELL_EVENT_ON_HIBERNATED;
             static const string RDKSHELL_EVENT_ON_RESTORED;
@@ -180,7 +205,7 @@ namespace WPEFramework {
 
             void notify(const std::string& event, const JsonObject& parameters);
             void pluginEventHandler(const JsonObject& parameters);
-            void launchRequestThread(RDKShellApiRequest apiRequest);
+            bool launchRequestThread(RDKShellApiRequest apiRequest);
 
         private/*registered methods (wrappers)*/:
 
@@ -272,6 +297,23 @@ namespace WPEFramework {
             uint32_t keyRepeatConfigWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t getGraphicsFrameRateWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t setGraphicsFrameRateWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getFrameStatsWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getLaunchTimingsWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getRequestQueueStatsWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t applyTransactionWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t setMemoryPressurePolicyWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getMemoryPressureStatusWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t setWarmPoolConfigWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getWarmPoolStatusWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t setEventCoalescingWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getEventCoalescingWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getKeyRouteWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getInputLatencyWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t addAnimationTimelineWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getStartupTimelineWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getTeardownReportWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getRialtoStatsWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getTimerStatsWrapper(const JsonObject& parameters, JsonObject& response);
 #ifdef HIBERNATE_SUPPORT_ENABLED
             uint32_t hibernateWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t restoreWrapper(const JsonObject& parameters, JsonObject& response);
@@ -286,7 +328,14 @@ namespace WPEFramework {
             bool moveBehind(const string& client, const string& target);
             bool setFocus(const string& client);
 	    bool getFocused(string& client);
+            // called once the render thread has handled an asynchronous request, with its token and result
+            typedef std::function<void(uint32_t, bool)> DisplayRequestCompletion;
             bool kill(const string& client);
+            uint32_t killAsync(const string& client, const DisplayRequestCompletion& completion);
+            std::shared_ptr<KillClientRequest> queueKill(const string& client, const DisplayRequestCompletion& completion);
+            bool stopContainer(const string& client, string& message);
+            void processScreenshot(uint8_t* data, uint32_t size, unsigned int width, unsigned int height,
+                bool legacy, const std::vector<ScreenshotEncoder::Options>& requests);
             bool addKeyIntercept(const uint32_t& keyCode, const JsonArray& modifiers, const string& client);
             bool addKeyIntercepts(const JsonArray& intercepts);
             bool removeKeyIntercept(const uint32_t& keyCode, const JsonArray& modifiers, const string& client);
@@ -302,12 +351,17 @@ namespace WPEFramework {
             bool createDisplay(const string& client, const string& displayName, const uint32_t displayWidth = 0, const uint32_t displayHeight = 0,
                 const bool virtualDisplay = false, const uint32_t virtualWidth = 0, const uint32_t virtualHeight = 0,
                 const bool topmost = false, const bool focus = false);
+            uint32_t createDisplayAsync(const string& client, const string& displayName, const uint32_t displayWidth, const uint32_t displayHeight,
+                const bool virtualDisplay, const uint32_t virtualWidth, const uint32_t virtualHeight, const DisplayRequestCompletion& completion);
+            std::shared_ptr<CreateDisplayRequest> queueCreateDisplay(const string& client, const string& displayName, const uint32_t displayWidth, const uint32_t displayHeight,
+                const bool virtualDisplay, const uint32_t virtualWidth, const uint32_t virtualHeight, const DisplayRequestCompletion& completion);
             bool getClients(JsonArray& clients);
             bool getZOrder(JsonArray& clients);
             bool getBounds(const string& client, JsonObject& bounds);
             bool setBounds(const string& client, const unsigned int x, const unsigned int y, const unsigned int w, const unsigned int h);
             bool getVisibility(const string& client, bool& visibility);
             bool setVisibility(const string& client, const bool visible);
+            bool setBrowserVisibility(const string& client, const bool visible);
             bool getOpacity(const string& client, unsigned int& opacity);
             bool setOpacity(const string& client, const unsigned int opacity);
             bool getScale(const string& client, double& scaleX, double& scaleY);
@@ -316,14 +370,18 @@ namespace WPEFramework {
             bool setHolePunch(const string& client, const bool holePunch);
             bool removeAnimation(const string& client);
             bool addAnimationList(const JsonArray& animations);
+            bool addAnimationTimeline(const JsonArray& animations, string& id, double& length, int& failedAnimation, string& message);
+            bool applyTransaction(const JsonArray& operations, int& failedOperation, string& message);
             bool enableInactivityReporting(const bool enable);
             bool setInactivityInterval(const uint32_t interval);
             bool resetInactivityTime();
+            // a warm pool request other than 0 launches the app to suspend for the pool, without onLaunched
+            uint32_t launchApp(const JsonObject& parameters, JsonObject& response, const uint32_t warmPoolRequest);
             void onLaunched(const std::string& client, const string& launchType);
             void onSuspended(const std::string& client);
             void onDestroyed(const std::string& client);
             bool systemMemory(uint32_t &freeKb, uint32_t & totalKb, uint32_t & availableKb, uint32_t & usedSwapKb);
-            bool pluginMemoryUsage(const string callsign, JsonArray& memoryInfo);
+            int32_t pluginMemoryUsage(const string& callsign);
             bool showWatermark(const bool enable);
             bool showFullScreenImage(std::string& path);
             void killAllApps(bool enableDestroyEvent=false);
@@ -355,6 +413,8 @@ namespace WPEFramework {
 
         public:
             static std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > getThunderControllerClient(std::string callsign="", std::string localidentifier="");
+            static std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > createThunderControllerClient(std::string callsign="", std::string localidentifier="");
+            static void releaseThunderControllerClients();
 
         private:
             static std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > getPackagerPlugin();
@@ -503,11 +563,6 @@ namespace WPEFramework {
 #endif //ENABLE_RIALTO_FEATURE
         };
 
-        struct PluginData
-        {
-          std::string mClassName;
-        };
-
         class PluginStateChangeData
         {
            public:
@@ -0,0 +1,273 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "RequestPool.h"
+#include <chrono>
+#include <iostream>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        RequestPool::RequestPool()
+            : mRunning(false)
+            , mGeneration(0)
+            , mMaxQueued(0)
+            , mQueued(0)
+            , mBusy(0)
+            , mCompleted(0)
+            , mRejected(0)
+            , mCancelled(0)
+            , mPeakQueued(0)
+            , mTotalWaitTime(0)
+            , mMaxWaitTime(0)
+        {
+            for (int i = 0; i < PRIORITY_COUNT; i++)
+            {
+                mSubmitted[i] = 0;
+            }
+        }
+
+        RequestPool::~RequestPool()
+        {
+            stop(0);
+        }
+
+        const char* RequestPool::priorityName(Priority priority)
+        {
+            switch (priority)
+            {
+                case HIGH: return "high";
+                case NORMAL: return "normal";
+                case LOW: return "low";
+                default: return "unknown";
+            }
+        }
+
+        uint64_t RequestPool::now()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void RequestPool::start(uint32_t threads, uint32_t maxQueued)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mRunning)
+            {
+                return;
+            }
+            mRunning = true;
+            mGeneration++;
+            mMaxQueued = maxQueued;
+            for (uint32_t i = 0; i < threads; i++)
+            {
+                // the first thread is kept for HIGH requests when there is more than one
+                bool highOnly = (threads > 1) && (i == 0);
+                mThreads.push_back(std::thread(&RequestPool::run, this, mGeneration, highOnly));
+            }
+        }
+
+        void RequestPool::stop(uint32_t timeoutInMs)
+        {
+            std::vector<std::thread> threads;
+            std::vector<Task> dropped;
+            bool joinThreads = true;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                if (!mRunning)
+                {
+                    return;
+                }
+                mRunning = false;
+                for (int i = 0; i < PRIORITY_COUNT; i++)
+                {
+                    mCancelled += mQueues[i].size();
+                    dropped.insert(dropped.end(), mQueues[i].begin(), mQueues[i].end());
+                    mQueues[i].clear();
+                }
+                mQueued = 0;
+                mTaskCondition.notify_all();
+                mIdleCondition.wait_for(lock, std::chrono::milliseconds(timeoutInMs), [this]() { return mBusy == 0; });
+                joinThreads = (mBusy == 0);
+                if (!joinThreads)
+                {
+                    std::cout << "request pool stopped with " << mBusy << " requests still running" << std::endl;
+                }
+                threads.swap(mThreads);
+            }
+            notifyDropped(dropped);
+            for (size_t i = 0; i < threads.size(); i++)
+            {
+                if (joinThreads)
+                {
+                    threads[i].join();
+                }
+                else
+                {
+                    // a request blocked in a thunder call must not hold up deinitialize, the
+                    // generation check makes its thread exit once the request returns
+                    threads[i].detach();
+                }
+            }
+        }
+
+        bool RequestPool::submit(Priority priority, const std::string& key, const std::function<void()>& work,
+            const std::function<void()>& dropped)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mRunning || (mQueued >= mMaxQueued))
+            {
+                mRejected++;
+                return false;
+            }
+            Task task;
+            task.key = key;
+            task.work = work;
+            task.dropped = dropped;
+            task.queuedTime = now();
+            mQueues[priority].push_back(task);
+            mSubmitted[priority]++;
+            mQueued++;
+            if (mQueued > mPeakQueued)
+            {
+                mPeakQueued = mQueued;
+            }
+            // the HIGH only thread may be the one woken for a lower priority request
+            mTaskCondition.notify_all();
+            return true;
+        }
+
+        uint32_t RequestPool::cancel(const std::string& key)
+        {
+            std::vector<Task> dropped;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                for (int i = 0; i < PRIORITY_COUNT; i++)
+                {
+                    std::deque<Task>& queue = mQueues[i];
+                    for (std::deque<Task>::iterator it = queue.begin(); it != queue.end();)
+                    {
+                        if (it->key == key)
+                        {
+                            dropped.push_back(*it);
+                            it = queue.erase(it);
+                        }
+                        else
+                        {
+                            it++;
+                        }
+                    }
+                }
+                mQueued -= dropped.size();
+                mCancelled += dropped.size();
+            }
+            notifyDropped(dropped);
+            return dropped.size();
+        }
+
+        bool RequestPool::isIdle()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return (mQueued == 0) && (mBusy == 0);
+        }
+
+        void RequestPool::notifyDropped(const std::vector<Task>& tasks)
+        {
+            // called without the lock, the callbacks send events and may submit again
+            for (size_t i = 0; i < tasks.size(); i++)
+            {
+                if (tasks[i].dropped)
+                {
+                    tasks[i].dropped();
+                }
+            }
+        }
+
+        bool RequestPool::hasTask(bool highOnly) const
+        {
+            return highOnly ? !mQueues[HIGH].empty() : (mQueued > 0);
+        }
+
+        void RequestPool::run(uint32_t generation, bool highOnly)
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (true)
+            {
+                mTaskCondition.wait(lock, [this, generation, highOnly]() { return (generation != mGeneration) || !mRunning || hasTask(highOnly); });
+                if ((generation != mGeneration) || !mRunning)
+                {
+                    break;
+                }
+                Task task;
+                for (int i = 0; i < PRIORITY_COUNT; i++)
+                {
+                    if (!mQueues[i].empty())
+                    {
+                        task = mQueues[i].front();
+                        mQueues[i].pop_front();
+                        break;
+                    }
+                }
+                mQueued--;
+                mBusy++;
+                uint64_t waitTime = now() - task.queuedTime;
+                mTotalWaitTime += waitTime;
+                if (waitTime > mMaxWaitTime)
+                {
+                    mMaxWaitTime = waitTime;
+                }
+                lock.unlock();
+
+                task.work();
+
+                lock.lock();
+                mBusy--;
+                mCompleted++;
+                if (mBusy == 0)
+                {
+                    mIdleCondition.notify_all();
+                }
+            }
+        }
+
+        void RequestPool::toJson(JsonObject& stats)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            stats["running"] = mRunning;
+            stats["threads"] = (uint32_t)mThreads.size();
+            stats["busy"] = mBusy;
+            stats["maxQueued"] = mMaxQueued;
+            stats["peakQueued"] = mPeakQueued;
+            JsonObject queued;
+            JsonObject submitted;
+            for (int i = 0; i < PRIORITY_COUNT; i++)
+            {
+                queued[priorityName((Priority)i)] = (uint32_t)mQueues[i].size();
+                submitted[priorityName((Priority)i)] = mSubmitted[i];
+            }
+            stats["queued"] = queued;
+            stats["submitted"] = submitted;
+            stats["completed"] = mCompleted;
+            stats["rejected"] = mRejected;
+            stats["cancelled"] = mCancelled;
+            uint32_t started = mCompleted + mBusy;
+            stats["averageWaitUs"] = (started > 0) ? (uint32_t)(mTotalWaitTime / started) : 0;
+            stats["maxWaitUs"] = (uint32_t)mMaxWaitTime;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,103 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Fixed set of threads for the requests RDKShell used to run on detached threads.
+        // Higher priorities are always served first and, with more than one thread, one
+        // thread only runs HIGH requests so slow LOW requests cannot hold them up. The total
+        // number of queued requests is bounded and requests can be cancelled per app or all
+        // at once on stop, the dropped callback of a request is called when it is cancelled.
+        class RequestPool
+        {
+        public:
+            enum Priority
+            {
+                HIGH = 0,
+                NORMAL,
+                LOW,
+                PRIORITY_COUNT
+            };
+
+            RequestPool();
+            ~RequestPool();
+            RequestPool(const RequestPool&) = delete;
+            RequestPool& operator=(const RequestPool&) = delete;
+
+            void start(uint32_t threads, uint32_t maxQueued);
+            // drops queued requests and waits up to timeoutInMs for running ones
+            void stop(uint32_t timeoutInMs);
+            // key is the callsign the request works on, it may be empty
+            // dropped is called instead of work if the request is cancelled before it runs
+            bool submit(Priority priority, const std::string& key, const std::function<void()>& work,
+                const std::function<void()>& dropped = std::function<void()>());
+            uint32_t cancel(const std::string& key);
+            // true when no request is queued or running
+            bool isIdle();
+            void toJson(JsonObject& stats);
+
+            static const char* priorityName(Priority priority);
+
+        private:
+            struct Task
+            {
+                std::string key;
+                std::function<void()> work;
+                std::function<void()> dropped;
+                uint64_t queuedTime;
+            };
+
+            void run(uint32_t generation, bool highOnly);
+            bool hasTask(bool highOnly) const;
+            static void notifyDropped(const std::vector<Task>& tasks);
+            static uint64_t now();
+
+            std::mutex mMutex;
+            std::condition_variable mTaskCondition;
+            std::condition_variable mIdleCondition;
+            std::deque<Task> mQueues[PRIORITY_COUNT];
+            std::vector<std::thread> mThreads;
+            bool mRunning;
+            uint32_t mGeneration;
+            uint32_t mMaxQueued;
+            uint32_t mQueued;
+            uint32_t mBusy;
+
+            uint32_t mSubmitted[PRIORITY_COUNT];
+            uint32_t mCompleted;
+            uint32_t mRejected;
+            uint32_t mCancelled;
+            uint32_t mPeakQueued;
+            uint64_t mTotalWaitTime;
+            uint64_t mMaxWaitTime;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
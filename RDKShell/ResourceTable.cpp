@@ -0,0 +1,166 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "ResourceTable.h"
+#include <chrono>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        const int32_t ResourceTable::NOT_SAMPLED;
+
+        ResourceTable::ResourceTable()
+            : mInterval(0)
+            , mSnapshotTime(0)
+            , mRunning(false)
+            , mRefreshRequested(false)
+        {
+        }
+
+        ResourceTable::~ResourceTable()
+        {
+            stop();
+        }
+
+        uint64_t ResourceTable::now()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void ResourceTable::start(uint32_t intervalInMs, const ClientsCallback& clients, const Sampler& sampler)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mRunning)
+            {
+                return;
+            }
+            mClients = clients;
+            mSampler = sampler;
+            mInterval = intervalInMs;
+            mRunning = true;
+            mRefreshRequested = true;
+            mThread = std::thread(&ResourceTable::run, this);
+        }
+
+        void ResourceTable::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mRunning)
+                {
+                    return;
+                }
+                mRunning = false;
+                mCondition.notify_all();
+            }
+            mThread.join();
+            // let a refresh forced by a caller finish before the sampler goes away
+            std::lock_guard<std::mutex> refreshLock(mRefreshMutex);
+            std::lock_guard<std::mutex> lock(mMutex);
+            mEntries.clear();
+            mSnapshotTime = 0;
+            mClients = ClientsCallback();
+            mSampler = Sampler();
+        }
+
+        void ResourceTable::requestRefresh()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRefreshRequested = true;
+            mCondition.notify_all();
+        }
+
+        void ResourceTable::refresh()
+        {
+            // one refresh at a time, a caller forcing a refresh waits for the running one
+            std::lock_guard<std::mutex> refreshLock(mRefreshMutex);
+            ClientsCallback clients;
+            Sampler sampler;
+            std::map<std::string, int32_t> previous;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mRunning)
+                {
+                    return;
+                }
+                clients = mClients;
+                sampler = mSampler;
+                previous = mEntries;
+            }
+
+            // sampling queries the plugins, so it runs without holding the table lock
+            std::map<std::string, int32_t> entries;
+            std::vector<std::string> callsigns = clients();
+            for (size_t i = 0; i < callsigns.size(); i++)
+            {
+                int32_t ram = sampler(callsigns[i]);
+                if (ram == NOT_SAMPLED)
+                {
+                    std::map<std::string, int32_t>::iterator it = previous.find(callsigns[i]);
+                    ram = (it != previous.end()) ? it->second : -1;
+                }
+                entries[callsigns[i]] = ram;
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mEntries.swap(entries);
+            mSnapshotTime = now();
+        }
+
+        void ResourceTable::run()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mRunning)
+            {
+                if (!mRefreshRequested)
+                {
+                    mCondition.wait_for(lock, std::chrono::milliseconds(mInterval), [this]() { return !mRunning || mRefreshRequested; });
+                }
+                if (!mRunning)
+                {
+                    break;
+                }
+                mRefreshRequested = false;
+                lock.unlock();
+                refresh();
+                lock.lock();
+            }
+        }
+
+        uint64_t ResourceTable::toJson(JsonArray& types)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (std::map<std::string, int32_t>::iterator it = mEntries.begin(); it != mEntries.end(); it++)
+            {
+                JsonObject memoryDetails;
+                memoryDetails["callsign"] = it->first;
+                memoryDetails["ram"] = it->second;
+                types.Add(memoryDetails);
+            }
+            return (mSnapshotTime > 0) ? (now() - mSnapshotTime) : 0;
+        }
+
+        int32_t ResourceTable::residentMemory(const std::string& callsign)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::map<std::string, int32_t>::iterator it = mEntries.find(callsign);
+            return (it != mEntries.end()) ? it->second : -1;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,80 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Resident memory of the running apps, sampled on a background thread so
+        // readers only copy the last snapshot. The clients callback names the apps to
+        // sample and the sampler returns the resident memory of one app in KB or -1.
+        // Apps the sampler must not wake up, such as suspended ones, return NOT_SAMPLED
+        // and keep their last sample.
+        class ResourceTable
+        {
+        public:
+            typedef std::function<std::vector<std::string>()> ClientsCallback;
+            typedef std::function<int32_t(const std::string&)> Sampler;
+
+            static const int32_t NOT_SAMPLED = -2;
+
+            ResourceTable();
+            ~ResourceTable();
+            ResourceTable(const ResourceTable&) = delete;
+            ResourceTable& operator=(const ResourceTable&) = delete;
+
+            void start(uint32_t intervalInMs, const ClientsCallback& clients, const Sampler& sampler);
+            void stop();
+            // wakes the sampling thread, used when apps come and go
+            void requestRefresh();
+            // samples on the calling thread
+            void refresh();
+            // returns the age of the snapshot in ms
+            uint64_t toJson(JsonArray& types);
+            // last sampled resident memory in KB, -1 when unknown
+            int32_t residentMemory(const std::string& callsign);
+
+        private:
+            void run();
+            static uint64_t now();
+
+            std::mutex mMutex;
+            std::mutex mRefreshMutex;
+            std::condition_variable mCondition;
+            std::thread mThread;
+            std::map<std::string, int32_t> mEntries;
+            ClientsCallback mClients;
+            Sampler mSampler;
+            uint32_t mInterval;
+            uint64_t mSnapshotTime;
+            bool mRunning;
+            bool mRefreshRequested;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
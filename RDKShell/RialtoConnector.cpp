@@ -73,13 +73,7 @@ namespace WPEFramework
     }
     const RialtoServerStates RialtoConnector::getCurrentAppState(const std::string &callsign)
     {
-        auto state = appStateMap.find(callsign);
-        if (state != appStateMap.end())
-        {
-            // If the state is not inactive, we have a problem.
-            return state->second;
-        }
-        return RialtoServerStates::ERROR;
+        return m_appStates.get(callsign);
     }
     bool RialtoConnector::deactivateSession(const std::string &callsign)
     {
@@ -95,40 +89,26 @@ namespace WPEFramework
     void RialtoConnector::stateChanged(const std::string &appId,
                                        const RialtoServerStates &state)
     {
-        {
-            std::lock_guard<std::mutex> lockguard(m_stateMutex);
-            appStateMap[appId] = state;
-        }
         LOGINFO("[RialtoConnector::stateChanged] State change announced for %s to %d, isActive ? %d ", appId.c_str(),
                 static_cast<int>(state), (state == RialtoServerStates::ACTIVE));
-        m_stateCond.notify_one();
+        m_appStates.set(appId, state);
     }
 
     // wait until socket is in given state
     // return true when state set, false on timeout
     bool RialtoConnector::waitForStateChange(const std::string& appId, const RialtoServerStates& state, int timeoutMillis)
     {
-        bool status = false;
-        std::unique_lock<std::mutex> lock(m_stateMutex);
-        auto startTime = std::chrono::steady_clock::now();
-        auto endTime = startTime + std::chrono::milliseconds(timeoutMillis);
-
-        while (std::chrono::steady_clock::now() < endTime)
-        {
-            if (appStateMap[appId] == state)
-            {
-                status = true;
-                break;
-            }
-
-            auto remainingTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - std::chrono::steady_clock::now());
-            if (remainingTime.count() <= 0)
-                break;
+        return m_appStates.wait(appId, state, timeoutMillis > 0 ? timeoutMillis : 0);
+    }
 
-            m_stateCond.wait_for(lock, remainingTime);
-        }
+    void RialtoConnector::waitForStateChangeAsync(const std::string& appId, const RialtoServerStates& state, int timeoutMillis, const std::function<void(bool)>& callback)
+    {
+        m_appStates.waitAsync(appId, state, timeoutMillis > 0 ? timeoutMillis : 0, callback);
+    }
 
-        return status;
+    void RialtoConnector::getWaitStats(JsonObject& stats)
+    {
+        m_appStates.toJson(stats);
     }
 
 } // namespace WPEFramework
@@ -23,8 +23,8 @@
 #include "UtilsLogging.h"
 #include <map>
 #include <string>
-#include <mutex>
-#include <condition_variable>
+#include <functional>
+#include "AppStateChannels.h"
 #include "rialto/ServerManagerServiceFactory.h"
 
 namespace WPEFramework
@@ -36,11 +36,14 @@ namespace WPEFramework
     class RialtoConnector : public IStateObserver, public std::enable_shared_from_this<RialtoConnector>
     {
     public:
-        RialtoConnector() : isInitialized(false) {}
+        RialtoConnector() : isInitialized(false), m_appStates(RialtoServerStates::ERROR) {}
         virtual ~RialtoConnector() = default;
         void initialize();
         bool initialized() { return isInitialized; }
         bool waitForStateChange(const std::string &appid, const RialtoServerStates &state, int timeoutMillis);
+        // callback gets true once the state is reached, false on timeout
+        void waitForStateChangeAsync(const std::string &appid, const RialtoServerStates &state, int timeoutMillis, const std::function<void(bool)> &callback);
+        void getWaitStats(JsonObject &stats);
         bool createAppSession(const std::string &callsign, const std::string &displayName, const std::string &appId);
         bool resumeSession(const std::string &callsign);
         bool suspendSession(const std::string &callsign);
@@ -53,10 +56,9 @@ namespace WPEFramework
 
     private:
         bool isInitialized;
-        std::mutex m_stateMutex;
-        std::condition_variable m_stateCond;
+        // declared first so it outlives the server manager service reporting into it
+        Plugin::AppStateChannels<RialtoServerStates> m_appStates;
         std::unique_ptr<IServerManagerService> m_serverManagerService;
-        std::map<std::string, RialtoServerStates> appStateMap;
 
         const RialtoServerStates getCurrentAppState(const std::string &callsign);
     };
@@ -0,0 +1,373 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "ScreenshotEncoder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#ifdef RDKSHELL_SCREENSHOT_PNG
+#include <zlib.h>
+#endif
+#ifdef RDKSHELL_SCREENSHOT_JPEG
+#include <setjmp.h>
+#include <jpeglib.h>
+#endif
+
+#define SCREENSHOT_BYTES_PER_PIXEL 4
+#define SCREENSHOT_DEFAULT_JPEG_QUALITY 85
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        ScreenshotEncoder::Options::Options()
+            : format(RAW)
+            , regionX(0)
+            , regionY(0)
+            , regionWidth(0)
+            , regionHeight(0)
+            , width(0)
+            , height(0)
+            , quality(SCREENSHOT_DEFAULT_JPEG_QUALITY)
+        {
+        }
+
+        bool ScreenshotEncoder::parseFormat(const std::string& name, Format& format)
+        {
+            if (strcasecmp(name.c_str(), "raw") == 0)
+            {
+                format = RAW;
+            }
+            else if (strcasecmp(name.c_str(), "png") == 0)
+            {
+                format = PNG;
+            }
+            else if ((strcasecmp(name.c_str(), "jpeg") == 0) || (strcasecmp(name.c_str(), "jpg") == 0))
+            {
+                format = JPEG;
+            }
+            else
+            {
+                return false;
+            }
+            return true;
+        }
+
+        bool ScreenshotEncoder::isFormatSupported(Format format)
+        {
+            switch (format)
+            {
+                case RAW:
+                    return true;
+#ifdef RDKSHELL_SCREENSHOT_PNG
+                case PNG:
+                    return true;
+#endif
+#ifdef RDKSHELL_SCREENSHOT_JPEG
+                case JPEG:
+                    return true;
+#endif
+                default:
+                    return false;
+            }
+        }
+
+        const char* ScreenshotEncoder::extension(Format format)
+        {
+            switch (format)
+            {
+                case PNG: return "png";
+                case JPEG: return "jpg";
+                default: return "rgba";
+            }
+        }
+
+        bool ScreenshotEncoder::isScreenshotFile(const std::string& name)
+        {
+            const size_t dot = name.rfind('.');
+            if ((dot == std::string::npos) || (dot == 0))
+            {
+                return false;
+            }
+            const std::string suffix = name.substr(dot + 1);
+            if (strcasecmp(suffix.c_str(), extension(RAW)) == 0)
+            {
+                return true;
+            }
+            // raw screenshots are written as .rgba, a .raw file is not one of ours
+            Format format = RAW;
+            return parseFormat(suffix, format) && (format != RAW);
+        }
+
+        bool ScreenshotEncoder::transform(const uint8_t* data, uint32_t width, uint32_t height, const Options& options,
+            std::vector<uint8_t>& output, uint32_t& outputWidth, uint32_t& outputHeight)
+        {
+            uint32_t regionX = options.regionX;
+            uint32_t regionY = options.regionY;
+            uint32_t regionWidth = (options.regionWidth > 0) ? options.regionWidth : width;
+            uint32_t regionHeight = (options.regionHeight > 0) ? options.regionHeight : height;
+            if ((nullptr == data) || (regionX >= width) || (regionY >= height))
+            {
+                return false;
+            }
+            if (regionWidth > width - regionX)
+            {
+                regionWidth = width - regionX;
+            }
+            if (regionHeight > height - regionY)
+            {
+                regionHeight = height - regionY;
+            }
+
+            // never larger than the screen, the sizes come straight from api callers
+            outputWidth = (options.width > 0) ? std::min(options.width, width) : regionWidth;
+            outputHeight = (options.height > 0) ? std::min(options.height, height) : regionHeight;
+            if ((options.width > 0) && (options.height == 0))
+            {
+                outputHeight = std::min((uint32_t)std::max<uint64_t>(1, (uint64_t)regionHeight * outputWidth / regionWidth), height);
+            }
+            else if ((options.height > 0) && (options.width == 0))
+            {
+                outputWidth = std::min((uint32_t)std::max<uint64_t>(1, (uint64_t)regionWidth * outputHeight / regionHeight), width);
+            }
+            output.resize((size_t)outputWidth * outputHeight * SCREENSHOT_BYTES_PER_PIXEL);
+
+            const size_t stride = (size_t)width * SCREENSHOT_BYTES_PER_PIXEL;
+            if ((outputWidth == regionWidth) && (outputHeight == regionHeight))
+            {
+                for (uint32_t y = 0; y < outputHeight; y++)
+                {
+                    memcpy(&output[(size_t)y * outputWidth * SCREENSHOT_BYTES_PER_PIXEL],
+                        data + (regionY + y) * stride + (size_t)regionX * SCREENSHOT_BYTES_PER_PIXEL,
+                        (size_t)outputWidth * SCREENSHOT_BYTES_PER_PIXEL);
+                }
+                return true;
+            }
+
+            // box filter: every output pixel averages the source pixels it covers,
+            // which degrades to nearest neighbour when scaling up
+            std::vector<uint32_t> columnStart(outputWidth + 1);
+            for (uint32_t x = 0; x <= outputWidth; x++)
+            {
+                columnStart[x] = regionX + (uint32_t)(((uint64_t)x * regionWidth) / outputWidth);
+            }
+            uint8_t* out = &output[0];
+            for (uint32_t y = 0; y < outputHeight; y++)
+            {
+                uint32_t y0 = regionY + (uint32_t)(((uint64_t)y * regionHeight) / outputHeight);
+                uint32_t y1 = regionY + (uint32_t)(((uint64_t)(y + 1) * regionHeight) / outputHeight);
+                if (y1 <= y0)
+                {
+                    y1 = y0 + 1;
+                }
+                for (uint32_t x = 0; x < outputWidth; x++)
+                {
+                    uint32_t x0 = columnStart[x];
+                    uint32_t x1 = (columnStart[x + 1] > x0) ? columnStart[x + 1] : x0 + 1;
+                    uint32_t sum[SCREENSHOT_BYTES_PER_PIXEL] = { 0, 0, 0, 0 };
+                    for (uint32_t sy = y0; sy < y1; sy++)
+                    {
+                        const uint8_t* pixel = data + sy * stride + (size_t)x0 * SCREENSHOT_BYTES_PER_PIXEL;
+                        for (uint32_t sx = x0; sx < x1; sx++, pixel += SCREENSHOT_BYTES_PER_PIXEL)
+                        {
+                            sum[0] += pixel[0];
+                            sum[1] += pixel[1];
+                            sum[2] += pixel[2];
+                            sum[3] += pixel[3];
+                        }
+                    }
+                    const uint32_t count = (y1 - y0) * (x1 - x0);
+                    for (int c = 0; c < SCREENSHOT_BYTES_PER_PIXEL; c++)
+                    {
+                        *out++ = (uint8_t)(sum[c] / count);
+                    }
+                }
+            }
+            return true;
+        }
+
+#ifdef RDKSHELL_SCREENSHOT_PNG
+        static void appendPngChunk(std::vector<uint8_t>& png, const char* type, const uint8_t* data, uint32_t length)
+        {
+            const uint8_t header[8] = { (uint8_t)(length >> 24), (uint8_t)(length >> 16), (uint8_t)(length >> 8), (uint8_t)length,
+                (uint8_t)type[0], (uint8_t)type[1], (uint8_t)type[2], (uint8_t)type[3] };
+            png.insert(png.end(), header, header + 8);
+            if (length > 0)
+            {
+                png.insert(png.end(), data, data + length);
+            }
+            uLong crc = crc32(0L, header + 4, 4);
+            if (length > 0)
+            {
+                crc = crc32(crc, data, length);
+            }
+            const uint8_t footer[4] = { (uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8), (uint8_t)crc };
+            png.insert(png.end(), footer, footer + 4);
+        }
+
+        static bool encodePng(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, std::vector<uint8_t>& output)
+        {
+            const size_t rowLength = (size_t)width * SCREENSHOT_BYTES_PER_PIXEL;
+            std::vector<uint8_t> rows((rowLength + 1) * height);
+            for (uint32_t y = 0; y < height; y++)
+            {
+                // filter type none, fast and good enough for ui content
+                rows[y * (rowLength + 1)] = 0;
+                memcpy(&rows[y * (rowLength + 1) + 1], &rgba[y * rowLength], rowLength);
+            }
+
+            uLongf compressedLength = compressBound(rows.size());
+            std::vector<uint8_t> compressed(compressedLength);
+            if (compress2(&compressed[0], &compressedLength, &rows[0], rows.size(), Z_BEST_SPEED) != Z_OK)
+            {
+                return false;
+            }
+
+            static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            const uint8_t header[13] = { (uint8_t)(width >> 24), (uint8_t)(width >> 16), (uint8_t)(width >> 8), (uint8_t)width,
+                (uint8_t)(height >> 24), (uint8_t)(height >> 16), (uint8_t)(height >> 8), (uint8_t)height,
+                8, 6, 0, 0, 0 };
+            output.clear();
+            output.reserve(compressedLength + 64);
+            output.insert(output.end(), signature, signature + 8);
+            appendPngChunk(output, "IHDR", header, sizeof(header));
+            appendPngChunk(output, "IDAT", &compressed[0], compressedLength);
+            appendPngChunk(output, "IEND", nullptr, 0);
+            return true;
+        }
+#endif
+
+#ifdef RDKSHELL_SCREENSHOT_JPEG
+        // the default error_exit of libjpeg calls exit(), jump back to encodeJpeg instead
+        struct JpegErrorManager
+        {
+            struct jpeg_error_mgr manager;
+            jmp_buf jump;
+        };
+
+        static void jpegErrorExit(j_common_ptr cinfo)
+        {
+            char message[JMSG_LENGTH_MAX];
+            (*cinfo->err->format_message)(cinfo, message);
+            std::cout << "screenshot jpeg encoding failed: " << message << std::endl;
+            longjmp(reinterpret_cast<JpegErrorManager*>(cinfo->err)->jump, 1);
+        }
+
+        static bool encodeJpeg(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, int quality, std::vector<uint8_t>& output)
+        {
+            struct jpeg_compress_struct cinfo;
+            JpegErrorManager jerr;
+            unsigned char* buffer = nullptr;
+            unsigned long bufferSize = 0;
+            // allocated before setjmp, longjmp must not skip any destructor
+            std::vector<uint8_t> row((size_t)width * 3);
+
+            memset(&cinfo, 0, sizeof(cinfo));
+            cinfo.err = jpeg_std_error(&jerr.manager);
+            jerr.manager.error_exit = jpegErrorExit;
+            if (setjmp(jerr.jump))
+            {
+                jpeg_destroy_compress(&cinfo);
+                free(buffer);
+                return false;
+            }
+            jpeg_create_compress(&cinfo);
+            jpeg_mem_dest(&cinfo, &buffer, &bufferSize);
+            cinfo.image_width = width;
+            cinfo.image_height = height;
+            cinfo.input_components = 3;
+            cinfo.in_color_space = JCS_RGB;
+            jpeg_set_defaults(&cinfo);
+            jpeg_set_quality(&cinfo, quality, TRUE);
+            jpeg_start_compress(&cinfo, TRUE);
+
+            while (cinfo.next_scanline < cinfo.image_height)
+            {
+                const uint8_t* pixel = &rgba[(size_t)cinfo.next_scanline * width * SCREENSHOT_BYTES_PER_PIXEL];
+                for (uint32_t x = 0; x < width; x++, pixel += SCREENSHOT_BYTES_PER_PIXEL)
+                {
+                    row[x * 3] = pixel[0];
+                    row[x * 3 + 1] = pixel[1];
+                    row[x * 3 + 2] = pixel[2];
+                }
+                JSAMPROW rowPointer = &row[0];
+                jpeg_write_scanlines(&cinfo, &rowPointer, 1);
+            }
+            jpeg_finish_compress(&cinfo);
+            jpeg_destroy_compress(&cinfo);
+
+            output.assign(buffer, buffer + bufferSize);
+            free(buffer);
+            return true;
+        }
+#endif
+
+        bool ScreenshotEncoder::encode(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, Format format, int quality,
+            std::vector<uint8_t>& output)
+        {
+            if ((width == 0) || (height == 0) || (rgba.size() < (size_t)width * height * SCREENSHOT_BYTES_PER_PIXEL))
+            {
+                return false;
+            }
+            switch (format)
+            {
+                case RAW:
+                    output = rgba;
+                    return true;
+#ifdef RDKSHELL_SCREENSHOT_PNG
+                case PNG:
+                    return encodePng(rgba, width, height, output);
+#endif
+#ifdef RDKSHELL_SCREENSHOT_JPEG
+                case JPEG:
+                    return encodeJpeg(rgba, width, height, (quality > 0 && quality <= 100) ? quality : SCREENSHOT_DEFAULT_JPEG_QUALITY, output);
+#endif
+                default:
+                    std::cout << "screenshot format " << extension(format) << " is not supported in this build" << std::endl;
+                    return false;
+            }
+        }
+
+        bool ScreenshotEncoder::writeFile(const std::string& path, const std::vector<uint8_t>& data)
+        {
+            // write to a temporary name first so readers never see a partial file
+            const std::string temporaryPath = path + ".tmp";
+            std::ofstream file(temporaryPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return false;
+            }
+            if (!data.empty())
+            {
+                file.write(reinterpret_cast<const char*>(&data[0]), data.size());
+            }
+            file.close();
+            if (file.fail() || (rename(temporaryPath.c_str(), path.c_str()) != 0))
+            {
+                remove(temporaryPath.c_str());
+                return false;
+            }
+            return true;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,70 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Crop, scale and compress RGBA screenshots taken by CompositorController::screenShot.
+        // PNG needs zlib and JPEG needs libjpeg at build time, raw is always available.
+        class ScreenshotEncoder
+        {
+        public:
+            enum Format
+            {
+                RAW = 0,
+                PNG,
+                JPEG
+            };
+
+            struct Options
+            {
+                Options();
+                Format format;
+                uint32_t regionX;
+                uint32_t regionY;
+                uint32_t regionWidth;
+                uint32_t regionHeight;
+                uint32_t width;
+                uint32_t height;
+                int quality;
+                std::string path;
+            };
+
+            static bool parseFormat(const std::string& name, Format& format);
+            static bool isFormatSupported(Format format);
+            static const char* extension(Format format);
+            // file names with the extension of one of the formats
+            static bool isScreenshotFile(const std::string& name);
+
+            // applies the region and target size of options. Only one size given keeps the aspect
+            // ratio of the region, none keeps its size
+            static bool transform(const uint8_t* data, uint32_t width, uint32_t height, const Options& options,
+                std::vector<uint8_t>& output, uint32_t& outputWidth, uint32_t& outputHeight);
+            static bool encode(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height, Format format, int quality,
+                std::vector<uint8_t>& output);
+            static bool writeFile(const std::string& path, const std::vector<uint8_t>& data);
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
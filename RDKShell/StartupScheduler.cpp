@@ -0,0 +1,245 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "StartupScheduler.h"
+#include <algorithm>
+#include <thread>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        StartupScheduler::StartupScheduler()
+            : mParallelism(1)
+            , mRunning(0)
+            , mTotalTime(0)
+            , mDone(false)
+        {
+        }
+
+        const char* StartupScheduler::stateName(State state)
+        {
+            switch (state)
+            {
+                case PENDING: return "pending";
+                case RUNNING: return "running";
+                case SUCCEEDED: return "succeeded";
+                case FAILED: return "failed";
+                case SKIPPED: return "skipped";
+                default: return "unknown";
+            }
+        }
+
+        void StartupScheduler::add(const Entry& entry)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mEntries.push_back(entry);
+            Result result;
+            result.name = entry.name;
+            result.state = PENDING;
+            result.start = 0;
+            result.end = 0;
+            mResults.push_back(result);
+        }
+
+        void StartupScheduler::clear()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mEntries.clear();
+            mResults.clear();
+            mTotalTime = 0;
+            mDone = false;
+        }
+
+        uint32_t StartupScheduler::elapsed() const
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStartTime).count();
+        }
+
+        void StartupScheduler::resolve()
+        {
+            // skipping an entry can make its dependents skip as well
+            bool changed = true;
+            while (changed)
+            {
+                changed = false;
+                for (size_t i = 0; i < mEntries.size(); i++)
+                {
+                    if (mResults[i].state != PENDING)
+                    {
+                        continue;
+                    }
+                    for (size_t d = 0; d < mEntries[i].dependsOn.size(); d++)
+                    {
+                        const std::string& dependency = mEntries[i].dependsOn[d];
+                        bool found = false;
+                        bool failed = false;
+                        for (size_t j = 0; j < mEntries.size(); j++)
+                        {
+                            if ((j == i) || (mEntries[j].name != dependency))
+                            {
+                                continue;
+                            }
+                            found = true;
+                            failed = failed || (mResults[j].state == FAILED) || (mResults[j].state == SKIPPED);
+                        }
+                        if (!found || failed)
+                        {
+                            mResults[i].state = SKIPPED;
+                            mResults[i].reason = (found ? "dependency did not succeed: " : "unknown dependency: ") + dependency;
+                            mResults[i].start = mResults[i].end = elapsed();
+                            changed = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        bool StartupScheduler::nextReady(size_t& index)
+        {
+            resolve();
+            for (size_t i = 0; i < mEntries.size(); i++)
+            {
+                if (mResults[i].state != PENDING)
+                {
+                    continue;
+                }
+                bool ready = true;
+                for (size_t d = 0; ready && (d < mEntries[i].dependsOn.size()); d++)
+                {
+                    for (size_t j = 0; j < mEntries.size(); j++)
+                    {
+                        if ((j != i) && (mEntries[j].name == mEntries[i].dependsOn[d]) && (mResults[j].state != SUCCEEDED))
+                        {
+                            ready = false;
+                            break;
+                        }
+                    }
+                }
+                if (ready)
+                {
+                    index = i;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void StartupScheduler::work()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (true)
+            {
+                size_t index = 0;
+                if (nextReady(index))
+                {
+                    mResults[index].state = RUNNING;
+                    mResults[index].start = elapsed();
+                    mRunning++;
+                    std::function<bool()> task = mEntries[index].task;
+                    lock.unlock();
+                    bool succeeded = task ? task() : true;
+                    lock.lock();
+                    mResults[index].state = succeeded ? SUCCEEDED : FAILED;
+                    mResults[index].end = elapsed();
+                    mRunning--;
+                    mCondition.notify_all();
+                    continue;
+                }
+                if (mRunning == 0)
+                {
+                    // nothing runs and nothing is ready, what is left waits on itself
+                    for (size_t i = 0; i < mResults.size(); i++)
+                    {
+                        if (mResults[i].state == PENDING)
+                        {
+                            mResults[i].state = SKIPPED;
+                            mResults[i].reason = "dependency cycle";
+                            mResults[i].start = mResults[i].end = elapsed();
+                        }
+                    }
+                    mDone = true;
+                    mCondition.notify_all();
+                    return;
+                }
+                mCondition.wait(lock);
+            }
+        }
+
+        bool StartupScheduler::run(uint32_t parallelism)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mParallelism = std::max(parallelism, 1u);
+                mStartTime = std::chrono::steady_clock::now();
+                mDone = false;
+            }
+            std::vector<std::thread> workers;
+            const size_t threads = std::min<size_t>(mParallelism, std::max<size_t>(mEntries.size(), 1));
+            for (size_t i = 1; i < threads; i++)
+            {
+                workers.push_back(std::thread(&StartupScheduler::work, this));
+            }
+            work();
+            for (size_t i = 0; i < workers.size(); i++)
+            {
+                workers[i].join();
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTotalTime = elapsed();
+            for (size_t i = 0; i < mResults.size(); i++)
+            {
+                if (mResults[i].state != SUCCEEDED)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<StartupScheduler::Result> StartupScheduler::timeline()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mResults;
+        }
+
+        void StartupScheduler::toJson(JsonObject& timeline)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            JsonArray entries;
+            for (size_t i = 0; i < mResults.size(); i++)
+            {
+                JsonObject entry;
+                entry["name"] = mResults[i].name;
+                entry["state"] = stateName(mResults[i].state);
+                entry["startMs"] = mResults[i].start;
+                entry["endMs"] = mResults[i].end;
+                if (!mResults[i].reason.empty())
+                {
+                    entry["reason"] = mResults[i].reason;
+                }
+                entries.Add(entry);
+            }
+            timeline["entries"] = entries;
+            timeline["parallelism"] = mParallelism;
+            timeline["totalMs"] = mTotalTime;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
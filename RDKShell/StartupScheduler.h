@@ -0,0 +1,98 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Runs the startup entries as a dependency graph. An entry starts once every entry
+        // it depends on has succeeded, entries that do not depend on each other run on up to
+        // parallelism threads. With a parallelism of 1 entries run in the order they were added.
+        class StartupScheduler
+        {
+        public:
+            struct Entry
+            {
+                std::string name;
+                // names of the entries that have to succeed first
+                std::vector<std::string> dependsOn;
+                std::function<bool()> task;
+            };
+
+            enum State
+            {
+                PENDING = 0,
+                RUNNING,
+                SUCCEEDED,
+                FAILED,
+                SKIPPED
+            };
+
+            struct Result
+            {
+                std::string name;
+                State state;
+                std::string reason;
+                // milliseconds since the scheduler started
+                uint32_t start;
+                uint32_t end;
+            };
+
+            StartupScheduler();
+            StartupScheduler(const StartupScheduler&) = delete;
+            StartupScheduler& operator=(const StartupScheduler&) = delete;
+
+            void add(const Entry& entry);
+            // forgets the entries and the timeline of the last run
+            void clear();
+            // blocks until every entry ran or was skipped, false when one did not succeed
+            bool run(uint32_t parallelism);
+            std::vector<Result> timeline();
+            void toJson(JsonObject& timeline);
+
+            static const char* stateName(State state);
+
+        private:
+            void work();
+            // called with mMutex held
+            bool nextReady(size_t& index);
+            void resolve();
+            uint32_t elapsed() const;
+
+            std::mutex mMutex;
+            std::condition_variable mCondition;
+            std::vector<Entry> mEntries;
+            std::vector<Result> mResults;
+            std::chrono::steady_clock::time_point mStartTime;
+            uint32_t mParallelism;
+            uint32_t mRunning;
+            uint32_t mTotalTime;
+            bool mDone;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,500 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "WarmPool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // apps launched less often are not worth the memory
+        static const uint32_t WARM_POOL_MIN_LAUNCHES = 2;
+        // a prelaunch that did not end by then has failed
+        static const uint64_t WARM_POOL_PRELAUNCH_TIMEOUT_IN_MS = 60000;
+        static const uint32_t WARM_POOL_MAX_HISTORY = 64;
+        // resident memory in KB counted for apps that were not seen running yet
+        static const int32_t WARM_POOL_DEFAULT_RAM = 256000;
+
+        WarmPool::Config::Config()
+            : enabled(false)
+            , maxApps(2)
+            , memoryBudget(0)
+            , idleDelay(60000)
+            , interval(10000)
+        {
+        }
+
+        WarmPool::HistoryEntry::HistoryEntry()
+            : count(0)
+            , lastLaunch(0)
+            , ram(-1)
+        {
+        }
+
+        WarmPool::WarmPool()
+            : mHistoryDirty(false)
+            , mNextPrelaunchId(1)
+            , mLastLaunchTime(0)
+            , mRunning(false)
+            , mHits(0)
+            , mMisses(0)
+            , mPrelaunches(0)
+            , mReleases(0)
+        {
+        }
+
+        WarmPool::~WarmPool()
+        {
+            stop();
+        }
+
+        uint64_t WarmPool::now()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        uint64_t WarmPool::wallTime()
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        void WarmPool::start(const std::string& historyPath, const Callbacks& callbacks)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mRunning)
+            {
+                return;
+            }
+            mHistoryPath = historyPath;
+            mCallbacks = callbacks;
+            loadHistory();
+            mLastLaunchTime = now();
+            mRunning = true;
+            mThread = std::thread(&WarmPool::run, this);
+        }
+
+        void WarmPool::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mRunning)
+                {
+                    return;
+                }
+                mRunning = false;
+                mCondition.notify_all();
+            }
+            mThread.join();
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mHistoryDirty)
+            {
+                writeHistory(mHistoryPath, serializeHistory());
+            }
+            mCallbacks = Callbacks();
+            mPrelaunching.clear();
+            mPooled.clear();
+        }
+
+        void WarmPool::configure(const Config& config)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mConfig = config;
+            if (mConfig.interval == 0)
+            {
+                mConfig.interval = 10000;
+            }
+            mCondition.notify_all();
+        }
+
+        WarmPool::Config WarmPool::config()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mConfig;
+        }
+
+        bool WarmPool::recordLaunch(const std::string& callsign, const std::string& type)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            HistoryEntry& entry = mHistory[callsign];
+            entry.count++;
+            entry.lastLaunch = wallTime();
+            if (!type.empty())
+            {
+                entry.type = type;
+            }
+            mHistoryDirty = true;
+            mLastLaunchTime = now();
+
+            bool pooled = (mPooled.erase(callsign) > 0);
+            if (pooled)
+            {
+                mHits++;
+            }
+            else if (mConfig.enabled)
+            {
+                mMisses++;
+            }
+            return pooled;
+        }
+
+        void WarmPool::cancelPrelaunch(const std::string& callsign)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (std::map<uint32_t, Prelaunch>::iterator it = mPrelaunching.begin(); it != mPrelaunching.end();)
+            {
+                if (it->second.callsign == callsign)
+                {
+                    std::cout << "warm pool prelaunch of " << callsign << " cancelled by a launch" << std::endl;
+                    it = mPrelaunching.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+            mLastLaunchTime = now();
+        }
+
+        bool WarmPool::isPrelaunchCurrent(uint32_t id)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mPrelaunching.find(id) != mPrelaunching.end();
+        }
+
+        void WarmPool::endPrelaunch(uint32_t id, bool success)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::map<uint32_t, Prelaunch>::iterator it = mPrelaunching.find(id);
+            if (it == mPrelaunching.end())
+            {
+                return;
+            }
+            if (success)
+            {
+                mPooled.insert(it->second.callsign);
+                mPrelaunches++;
+            }
+            mPrelaunching.erase(it);
+        }
+
+        int32_t WarmPool::estimatedRam(const HistoryEntry& entry)
+        {
+            return (entry.ram >= 0) ? entry.ram : WARM_POOL_DEFAULT_RAM;
+        }
+
+        std::vector<std::string> WarmPool::rankedApps()
+        {
+            std::vector<std::string> apps;
+            for (std::map<std::string, HistoryEntry>::iterator it = mHistory.begin(); it != mHistory.end(); it++)
+            {
+                apps.push_back(it->first);
+            }
+            std::sort(apps.begin(), apps.end(), [this](const std::string& first, const std::string& second) {
+                const HistoryEntry& firstEntry = mHistory[first];
+                const HistoryEntry& secondEntry = mHistory[second];
+                if (firstEntry.count != secondEntry.count)
+                {
+                    return firstEntry.count > secondEntry.count;
+                }
+                return firstEntry.lastLaunch > secondEntry.lastLaunch;
+            });
+            return apps;
+        }
+
+        void WarmPool::run()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mRunning)
+            {
+                mCondition.wait_for(lock, std::chrono::milliseconds(mConfig.interval));
+                if (!mRunning)
+                {
+                    break;
+                }
+                lock.unlock();
+                evaluate();
+                lock.lock();
+            }
+        }
+
+        void WarmPool::evaluate()
+        {
+            uint32_t prelaunchId = 0;
+            Config config;
+            Callbacks callbacks;
+            std::vector<std::string> historyApps;
+            std::vector<std::string> releaseApps;
+            std::string history;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                config = mConfig;
+                callbacks = mCallbacks;
+                if (!config.enabled)
+                {
+                    // nothing to sample, only give back what is still pooled and keep the launch counts
+                    releaseApps.assign(mPooled.begin(), mPooled.end());
+                    mPooled.clear();
+                    mReleases += releaseApps.size();
+                    if (mHistoryDirty)
+                    {
+                        history = serializeHistory();
+                    }
+                }
+                else
+                {
+                    for (std::map<std::string, HistoryEntry>::iterator it = mHistory.begin(); it != mHistory.end(); it++)
+                    {
+                        historyApps.push_back(it->first);
+                    }
+                }
+            }
+            if (!config.enabled)
+            {
+                if (!history.empty() && !writeHistory(mHistoryPath, history))
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mHistoryDirty = true;
+                }
+                for (size_t i = 0; i < releaseApps.size(); i++)
+                {
+                    std::cout << "warm pool releasing " << releaseApps[i] << std::endl;
+                    callbacks.release(releaseApps[i]);
+                }
+                return;
+            }
+
+            // the callbacks query the app registry and the plugins, keep them out of the lock
+            std::map<std::string, bool> running;
+            std::map<std::string, int32_t> ram;
+            for (size_t i = 0; i < historyApps.size(); i++)
+            {
+                running[historyApps[i]] = callbacks.isRunning(historyApps[i]);
+                ram[historyApps[i]] = running[historyApps[i]] ? callbacks.residentMemory(historyApps[i]) : -1;
+            }
+            bool canPrelaunch = callbacks.canPrelaunch();
+
+            std::string prelaunchApp;
+            std::string prelaunchType;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                const uint64_t currentTime = now();
+                for (std::map<std::string, int32_t>::iterator it = ram.begin(); it != ram.end(); it++)
+                {
+                    std::map<std::string, HistoryEntry>::iterator entry = mHistory.find(it->first);
+                    if ((entry != mHistory.end()) && (it->second > 0))
+                    {
+                        entry->second.ram = it->second;
+                    }
+                }
+                for (std::map<uint32_t, Prelaunch>::iterator it = mPrelaunching.begin(); it != mPrelaunching.end();)
+                {
+                    if ((currentTime - it->second.time) > WARM_POOL_PRELAUNCH_TIMEOUT_IN_MS)
+                    {
+                        it = mPrelaunching.erase(it);
+                    }
+                    else
+                    {
+                        it++;
+                    }
+                }
+                // pooled apps destroyed by someone else leave the pool
+                for (std::set<std::string>::iterator it = mPooled.begin(); it != mPooled.end();)
+                {
+                    std::map<std::string, bool>::iterator runningIt = running.find(*it);
+                    if ((runningIt == running.end()) || !runningIt->second)
+                    {
+                        it = mPooled.erase(it);
+                    }
+                    else
+                    {
+                        it++;
+                    }
+                }
+
+                std::vector<std::string> ranked = rankedApps();
+                // keep the best ranked apps that fit, release the rest
+                uint32_t pooledCount = 0;
+                int64_t pooledRam = 0;
+                for (size_t i = 0; i < ranked.size(); i++)
+                {
+                    if (mPooled.find(ranked[i]) == mPooled.end())
+                    {
+                        continue;
+                    }
+                    int32_t appRam = estimatedRam(mHistory[ranked[i]]);
+                    if ((pooledCount < config.maxApps) && ((config.memoryBudget == 0) || (pooledRam + appRam <= config.memoryBudget)))
+                    {
+                        pooledCount++;
+                        pooledRam += appRam;
+                    }
+                    else
+                    {
+                        releaseApps.push_back(ranked[i]);
+                        mPooled.erase(ranked[i]);
+                    }
+                }
+
+                if (canPrelaunch && mPrelaunching.empty() && ((currentTime - mLastLaunchTime) >= config.idleDelay))
+                {
+                    for (size_t i = 0; (i < ranked.size()) && (pooledCount < config.maxApps); i++)
+                    {
+                        const HistoryEntry& entry = mHistory[ranked[i]];
+                        if (entry.count < WARM_POOL_MIN_LAUNCHES)
+                        {
+                            break;
+                        }
+                        if (running[ranked[i]] || (mPooled.find(ranked[i]) != mPooled.end()))
+                        {
+                            continue;
+                        }
+                        if ((config.memoryBudget > 0) && (pooledRam + estimatedRam(entry) > config.memoryBudget))
+                        {
+                            continue;
+                        }
+                        prelaunchApp = ranked[i];
+                        prelaunchType = entry.type;
+                        prelaunchId = mNextPrelaunchId++;
+                        mPrelaunching[prelaunchId].callsign = prelaunchApp;
+                        mPrelaunching[prelaunchId].time = currentTime;
+                        break;
+                    }
+                }
+                mReleases += releaseApps.size();
+                if (mHistoryDirty)
+                {
+                    history = serializeHistory();
+                }
+            }
+
+            // only launches change the history, the file is written outside of the lock
+            if (!history.empty() && !writeHistory(mHistoryPath, history))
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mHistoryDirty = true;
+            }
+
+            for (size_t i = 0; i < releaseApps.size(); i++)
+            {
+                std::cout << "warm pool releasing " << releaseApps[i] << std::endl;
+                callbacks.release(releaseApps[i]);
+            }
+            if (!prelaunchApp.empty())
+            {
+                std::cout << "warm pool prelaunching " << prelaunchApp << std::endl;
+                callbacks.prelaunch(prelaunchApp, prelaunchType, prelaunchId);
+            }
+        }
+
+        void WarmPool::loadHistory()
+        {
+            // callsign type count lastLaunch, one app per line, older files also have the ram
+            std::ifstream file(mHistoryPath.c_str());
+            std::string line;
+            while (std::getline(file, line))
+            {
+                std::istringstream fields(line);
+                std::string callsign;
+                HistoryEntry entry;
+                if (fields >> callsign >> entry.type >> entry.count >> entry.lastLaunch)
+                {
+                    if (entry.type == "-")
+                    {
+                        entry.type.clear();
+                    }
+                    mHistory[callsign] = entry;
+                }
+            }
+        }
+
+        std::string WarmPool::serializeHistory()
+        {
+            // forget the least used apps so the file stays small
+            std::vector<std::string> ranked = rankedApps();
+            for (size_t i = WARM_POOL_MAX_HISTORY; i < ranked.size(); i++)
+            {
+                mHistory.erase(ranked[i]);
+            }
+            std::ostringstream contents;
+            for (std::map<std::string, HistoryEntry>::iterator it = mHistory.begin(); it != mHistory.end(); it++)
+            {
+                contents << it->first << " " << (it->second.type.empty() ? "-" : it->second.type) << " " << it->second.count << " "
+                         << it->second.lastLaunch << "\n";
+            }
+            mHistoryDirty = false;
+            return contents.str();
+        }
+
+        bool WarmPool::writeHistory(const std::string& path, const std::string& contents)
+        {
+            const std::string tempPath = path + ".tmp";
+            {
+                std::ofstream file(tempPath.c_str(), std::ios::trunc);
+                if (!file.is_open())
+                {
+                    std::cout << "unable to write launch history " << tempPath << std::endl;
+                    return false;
+                }
+                file << contents;
+            }
+            if (rename(tempPath.c_str(), path.c_str()) != 0)
+            {
+                std::cout << "unable to replace launch history " << path << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        void WarmPool::toJson(JsonObject& status)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            status["enabled"] = mConfig.enabled;
+            status["maxApps"] = mConfig.maxApps;
+            status["memoryBudget"] = mConfig.memoryBudget;
+            status["idleDelay"] = mConfig.idleDelay;
+            status["hits"] = mHits;
+            status["misses"] = mMisses;
+            status["prelaunches"] = mPrelaunches;
+            status["releases"] = mReleases;
+            JsonArray pooled;
+            for (std::set<std::string>::iterator it = mPooled.begin(); it != mPooled.end(); it++)
+            {
+                pooled.Add(*it);
+            }
+            status["pooled"] = pooled;
+            JsonArray history;
+            std::vector<std::string> ranked = rankedApps();
+            for (size_t i = 0; i < ranked.size(); i++)
+            {
+                const HistoryEntry& entry = mHistory[ranked[i]];
+                JsonObject app;
+                app["callsign"] = ranked[i];
+                app["type"] = entry.type;
+                app["launches"] = entry.count;
+                app["ram"] = entry.ram;
+                history.Add(app);
+            }
+            status["history"] = history;
+        }
+    } // namespace Plugin
+} // namespace WPEFramework
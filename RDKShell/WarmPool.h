@@ -0,0 +1,135 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        // Keeps the most frequently launched apps launched to suspend while the device is
+        // idle, so launching them later only resumes them. Launch counts are kept in a
+        // history file, the pool is limited in number of apps and in resident memory.
+        // The memory of an app is only known once it was seen running, until then it is
+        // counted at a conservative default. Nothing is sampled while the pool is disabled.
+        // Every prelaunch has its own request id, a launch of the app by the user cancels
+        // a prelaunch that is queued or still running.
+        class WarmPool
+        {
+        public:
+            struct Config
+            {
+                Config();
+                bool enabled;
+                uint32_t maxApps;
+                // resident memory of all pooled apps in KB
+                uint32_t memoryBudget;
+                // time without launches before the pool is filled, in ms
+                uint32_t idleDelay;
+                uint32_t interval;
+            };
+
+            struct Callbacks
+            {
+                // false while launches are running or memory is short
+                std::function<bool()> canPrelaunch;
+                std::function<bool(const std::string&)> isRunning;
+                // resident memory in KB, -1 when unknown
+                std::function<int32_t(const std::string&)> residentMemory;
+                // callsign, type and the request id to pass to the prelaunch calls
+                std::function<void(const std::string&, const std::string&, uint32_t)> prelaunch;
+                std::function<void(const std::string&)> release;
+            };
+
+            WarmPool();
+            ~WarmPool();
+            WarmPool(const WarmPool&) = delete;
+            WarmPool& operator=(const WarmPool&) = delete;
+
+            void start(const std::string& historyPath, const Callbacks& callbacks);
+            void stop();
+            void configure(const Config& config);
+            Config config();
+            // called for every successful launch by the user, returns true when the app was waiting in the pool
+            bool recordLaunch(const std::string& callsign, const std::string& type);
+            // called when the user starts launching an app, its prelaunch must not go on
+            void cancelPrelaunch(const std::string& callsign);
+            // false once the prelaunch was cancelled or timed out
+            bool isPrelaunchCurrent(uint32_t id);
+            void endPrelaunch(uint32_t id, bool success);
+            void toJson(JsonObject& status);
+
+        private:
+            struct HistoryEntry
+            {
+                HistoryEntry();
+                std::string type;
+                uint32_t count;
+                uint64_t lastLaunch;
+                // resident memory seen while the app ran, estimates its cost in the pool, not saved
+                int32_t ram;
+            };
+
+            void run();
+            void evaluate();
+            void loadHistory();
+            // the history file contents, clears the dirty flag
+            std::string serializeHistory();
+            static bool writeHistory(const std::string& path, const std::string& contents);
+            std::vector<std::string> rankedApps();
+            static int32_t estimatedRam(const HistoryEntry& entry);
+            static uint64_t now();
+            static uint64_t wallTime();
+
+            std::mutex mMutex;
+            std::condition_variable mCondition;
+            std::thread mThread;
+            Config mConfig;
+            Callbacks mCallbacks;
+            std::string mHistoryPath;
+            std::map<std::string, HistoryEntry> mHistory;
+            bool mHistoryDirty;
+            struct Prelaunch
+            {
+                std::string callsign;
+                uint64_t time;
+            };
+
+            // prelaunch requests that did not end yet by request id
+            std::map<uint32_t, Prelaunch> mPrelaunching;
+            uint32_t mNextPrelaunchId;
+            std::set<std::string> mPooled;
+            uint64_t mLastLaunchTime;
+            bool mRunning;
+            uint32_t mHits;
+            uint32_t mMisses;
+            uint32_t mPrelaunches;
+            uint32_t mReleases;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -43,9 +43,24 @@ RemotePlugin::Initialize(PluginHost::IShell *shell)
   if (address.empty())
     address = "127.0.0.1";
 
-  if (m_stream.Open(address, 
-                    m_config.Port.Value(),
-                    std::bind(&RemotePlugin::onRead, this, std::placeholders::_1)) < 0)
+  bool unix_transport = (m_config.Transport.Value() == "unix");
+  int rc;
+  if (unix_transport)
+  {
+    string path = m_config.SocketPath.Value();
+    if (path.empty())
+      path = "/tmp/RustAdapter-" + shell->Callsign() + ".sock";
+    m_stream.SetSharedMemory(m_config.SharedMemory.Value());
+    rc = m_stream.OpenUnix(path,
+                           std::bind(&RemotePlugin::onRead, this, std::placeholders::_1));
+  }
+  else
+  {
+    rc = m_stream.Open(address, 
+                       m_config.Port.Value(),
+                       std::bind(&RemotePlugin::onRead, this, std::placeholders::_1));
+  }
+  if (rc < 0)
   {
     return string("RustAdapter RemotePlugin couldn't open socket stream");
   }
@@ -58,7 +73,9 @@ RemotePlugin::Initialize(PluginHost::IShell *shell)
   if (m_config.AutoExec)
   {
     std::string lib_name = RustAdapter::GetLibraryPathOrName(m_config.LibName.Value(), shell->Callsign());
-    if ((m_remotePid = LaunchRemoteProcess(lib_name, m_stream.GetAddress(), m_stream.GetPort())) < 0)
+    // WPEHost takes unix:<path> in place of the host ip for the unix transport
+    string host = unix_transport ? "unix:" + m_stream.GetAddress() : m_stream.GetAddress();
+    if ((m_remotePid = LaunchRemoteProcess(lib_name, host, m_stream.GetPort())) < 0)
     {
       return string("RustAdapter RemotePlugin failed spawn remote process");
     }
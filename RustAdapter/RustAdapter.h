@@ -45,11 +45,17 @@ public:
       Add(_T("port"), &Port);
       Add(_T("autoexec"), &AutoExec);
       Add(_T("libname"), &LibName);
+      Add(_T("transport"), &Transport);
+      Add(_T("socketpath"), &SocketPath);
+      Add(_T("sharedmemory"), &SharedMemory);
       OutOfProcess = rhs.OutOfProcess;;
       Address = rhs.Address;
       Port = rhs.Port;
       AutoExec = rhs.AutoExec;
       LibName = rhs.LibName;
+      Transport = rhs.Transport;
+      SocketPath = rhs.SocketPath;
+      SharedMemory = rhs.SharedMemory;
     }
 
     Config() : Core::JSON::Container(), OutOfProcess(false)
@@ -59,6 +65,9 @@ public:
       Add(_T("port"), &Port);
       Add(_T("autoexec"), &AutoExec);
       Add(_T("libname"), &LibName);
+      Add(_T("transport"), &Transport);
+      Add(_T("socketpath"), &SocketPath);
+      Add(_T("sharedmemory"), &SharedMemory);
     }
     ~Config()
     {
@@ -69,6 +78,11 @@ public:
     Core::JSON::DecUInt16 Port;
     Core::JSON::Boolean AutoExec;
     Core::JSON::String LibName;
+    // out of process only: "tcp" (default) on address/port or "unix" on socketpath
+    Core::JSON::String Transport;
+    Core::JSON::String SocketPath;
+    // ring size in bytes per direction shared with the remote process, unix transport only
+    Core::JSON::DecUInt32 SharedMemory;
   };
 
   /**
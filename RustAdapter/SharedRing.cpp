@@ -0,0 +1,148 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SharedRing.h"
+#include <new>
+#include <string.h>
+
+#define RING_HEADER_SIZE 64
+
+static_assert(sizeof(SharedRing::Header) <= RING_HEADER_SIZE, "ring header does not fit");
+
+size_t SharedRing::Size(uint32_t capacity)
+{
+  return RING_HEADER_SIZE + capacity;
+}
+
+SharedRing::SharedRing()
+: m_header(nullptr)
+, m_data(nullptr)
+, m_capacity(0)
+{
+}
+
+void SharedRing::Init(void* base, uint32_t capacity)
+{
+  m_header = new (base) Header;
+  m_header->head = 0;
+  m_header->tail = 0;
+  // nothing was read yet, the first write has to wake the consumer
+  m_header->consumer_waiting = 1;
+  m_header->producer_waiting = 0;
+  m_header->capacity = capacity;
+  m_data = (char*)base + RING_HEADER_SIZE;
+  m_capacity = capacity;
+}
+
+void SharedRing::Attach(void* base, uint32_t capacity)
+{
+  m_header = (Header*)base;
+  m_data = (char*)base + RING_HEADER_SIZE;
+  m_capacity = capacity;
+}
+
+bool SharedRing::IsValid() const
+{
+  return m_header != nullptr && m_capacity > 0;
+}
+
+size_t SharedRing::Readable() const
+{
+  const uint64_t used = m_header->head.load() - m_header->tail.load();
+  return (used <= m_capacity) ? (size_t)used : 0;
+}
+
+size_t SharedRing::Writable() const
+{
+  const uint64_t used = m_header->head.load() - m_header->tail.load();
+  return (used <= m_capacity) ? (size_t)(m_capacity - used) : 0;
+}
+
+ssize_t SharedRing::Write(const char* data, size_t len, bool& notify)
+{
+  notify = false;
+  const uint64_t head = m_header->head.load(std::memory_order_relaxed);
+  const uint64_t tail = m_header->tail.load(std::memory_order_acquire);
+  const uint32_t capacity = m_capacity;
+  // also catches a tail moved past head, the difference wraps to a huge value
+  if (capacity == 0 || head - tail > capacity)
+    return -1;
+  size_t space = capacity - (size_t)(head - tail);
+  if (len > space)
+    len = space;
+  if (len == 0)
+    return 0;
+
+  size_t offset = (size_t)(head % capacity);
+  size_t first = (len < capacity - offset) ? len : capacity - offset;
+  memcpy(m_data + offset, data, first);
+  memcpy(m_data, data + first, len - first);
+
+  // seq_cst store and exchange pair with the consumer arming its flag and
+  // then checking head again, one of the two always sees the other
+  m_header->head.store(head + len);
+  notify = m_header->consumer_waiting.exchange(0) != 0;
+  return (ssize_t)len;
+}
+
+ssize_t SharedRing::Read(string& out, size_t max, bool& notify)
+{
+  notify = false;
+  const uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+  const uint64_t head = m_header->head.load(std::memory_order_acquire);
+  const uint32_t capacity = m_capacity;
+  if (capacity == 0 || head - tail > capacity)
+    return -1;
+  size_t len = (size_t)(head - tail);
+  if (len > max)
+    len = max;
+  if (len == 0)
+    return 0;
+
+  size_t offset = (size_t)(tail % capacity);
+  size_t first = (len < capacity - offset) ? len : capacity - offset;
+  out.append(m_data + offset, first);
+  out.append(m_data, len - first);
+
+  m_header->tail.store(tail + len);
+  notify = m_header->producer_waiting.exchange(0) != 0;
+  return (ssize_t)len;
+}
+
+bool SharedRing::WaitForData()
+{
+  m_header->consumer_waiting.store(1);
+  if (m_header->head.load() != m_header->tail.load())
+  {
+    m_header->consumer_waiting.store(0);
+    return false;
+  }
+  return true;
+}
+
+bool SharedRing::WaitForSpace()
+{
+  m_header->producer_waiting.store(1);
+  // a corrupt ring does not sleep either, the next Write reports it
+  if (m_header->head.load() - m_header->tail.load() != m_capacity)
+  {
+    m_header->producer_waiting.store(0);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,80 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+using std::string;
+
+/*
+ * Single producer, single consumer byte ring living in shared memory. The
+ * bytes are the same frames that would otherwise go over the socket, the
+ * ring only replaces the transport. A side that found the ring empty (or
+ * full) arms its flag with Wait* and sleeps on its eventfd, the other side
+ * is told to ring that eventfd when it makes progress.
+ *
+ * The other process can write anything to the header, so the capacity is
+ * kept in the ring object and head and tail are checked before every copy.
+ */
+class SharedRing
+{
+public:
+  struct Header
+  {
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> consumer_waiting;
+    std::atomic<uint32_t> producer_waiting;
+    // set by Init for the other side to read, never trusted by either side
+    uint32_t capacity;
+  };
+
+  // bytes needed for a ring with capacity bytes of data
+  static size_t Size(uint32_t capacity);
+
+  SharedRing();
+  // creates an empty ring at base, done once by the side creating the memory
+  void Init(void* base, uint32_t capacity);
+  // uses a ring of capacity bytes another process created
+  void Attach(void* base, uint32_t capacity);
+  bool IsValid() const;
+
+  // returns the number of bytes written, notify is set when the consumer
+  // sleeps and has to be woken. -1 when head and tail are corrupt.
+  ssize_t Write(const char* data, size_t len, bool& notify);
+  // appends up to max bytes to out, notify is set when the producer waits for space.
+  // -1 when head and tail are corrupt.
+  ssize_t Read(string& out, size_t max, bool& notify);
+
+  // false when the ring has data (space) after all and the caller should not sleep
+  bool WaitForData();
+  bool WaitForSpace();
+
+  size_t Readable() const;
+  size_t Writable() const;
+
+private:
+  Header* m_header;
+  char* m_data;
+  uint32_t m_capacity;
+};
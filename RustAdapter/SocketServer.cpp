@@ -20,17 +20,24 @@
 #include "Logger.h"
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/un.h>
 #include <netinet/ip.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <stdlib.h>
 
 enum CommandID
 {
   ID_INVOKE = 1,
   ID_ATTACH,
-  ID_EXIT
+  ID_EXIT,
+  ID_SHARED_MEMORY
 };
 
 #pragma pack(push,1)
@@ -52,6 +59,16 @@ struct AttachHeader
 };
 #pragma pack(pop)
 
+// sent with the memfd holding both rings, the eventfd the client sleeps on
+// and the eventfd the server sleeps on. The ring to the client comes first.
+#pragma pack(push,1)
+struct SharedMemoryHeader
+{
+  uint32_t command_id;
+  uint32_t ring_size;
+};
+#pragma pack(pop)
+
 #pragma pack(push,1)
 struct ResponseHeader
 {
@@ -61,23 +78,156 @@ struct ResponseHeader
 #pragma pack(pop) 
 
 Response::Response()
-: channel_id(0), json()
+: channel_id(0), json(), connection_id(0)
 {
 }
 
 Response::Response(uint32_t channel, const string& json_str)
-: channel_id(channel), json(json_str)
+: channel_id(channel), json(json_str), connection_id(0)
 {
 }
 
+// the invoke is answered with this when its client disconnects, the JSON-RPC internal error
+#define DISCONNECTED_ERROR_CODE -32603
+
 #define CLIENT_DISCONNECT -2
+#define CLIENT_YIELD 1
+
+#define LISTEN_BACKLOG 16
+#define MAX_EVENTS 32
+#define IDLE_TIMEOUT_MS 10000
+#define DRAIN_TIMEOUT_MS 100
+#define READ_CHUNK 16384
+// per turn budget of a readable client before the next one is served
+#define READ_BUDGET_BYTES 65536
+#define READ_BUDGET_RESPONSES 16
+#define MAX_JSON_LEN (64 * 1024 * 1024)
+
+#define SERVER_TOKEN 0
+#define WAKEUP_TOKEN 0xffffffffffffffffULL
+// marks the eventfd of a connection, the connection id is in the low 32 bits
+#define BELL_TOKEN_FLAG (1ULL << 32)
+
+struct SocketServer::Input
+{
+  Input() : offset(0) {}
+
+  string buffer;
+  size_t offset;
+};
+
+struct SocketServer::Connection
+{
+  Connection(uint32_t conn_id, int sock, const string& peer_address)
+  : id(conn_id), fd(sock), channels(0), ready(false), closed(false), write_offset(0)
+  , shared_memory(nullptr), shared_memory_size(0), client_bell(-1), server_bell(-1)
+  {
+    stats.connection_id = conn_id;
+    stats.peer = peer_address;
+    stats.bytes_read = 0;
+    stats.bytes_written = 0;
+    stats.responses_read = 0;
+    stats.messages_sent = 0;
+    stats.channels = 0;
+    stats.pending_write = 0;
+    stats.max_pending_write = 0;
+    stats.yields = 0;
+    stats.shared_memory = false;
+  }
+
+  const uint32_t id;
+  int fd;
+  // guarded by m_lock
+  uint32_t channels;
+
+  // only used by the Run thread
+  Input socket_in;
+  Input ring_in;
+  bool ready;
+
+  // guards everything below, fd is only closed with it held
+  std::mutex write_lock;
+  bool closed;
+  string write_buffer;
+  size_t write_offset;
+  ConnectionStats stats;
+
+  // invokes waiting for their response, the channel id in the high and the request id in the low 32 bits
+  std::set<uint64_t> in_flight;
+
+  // set up before the connection is published, frames go through the rings when mapped
+  void* shared_memory;
+  size_t shared_memory_size;
+  SharedRing to_client;
+  SharedRing to_server;
+  int client_bell;
+  int server_bell;
+};
+
+// the id member of a JSON-RPC request or response, false for notifications
+static bool ParseMessageId(const string& json, uint32_t& id)
+{
+  int depth = 0;
+  for (size_t i = 0; i < json.size(); ++i)
+  {
+    char c = json[i];
+    if (c == '"')
+    {
+      size_t end = i + 1;
+      while (end < json.size() && json[end] != '"')
+        end += (json[end] == '\\') ? 2 : 1;
+      if (end >= json.size())
+        return false;
+      if (depth == 1 && json.compare(i + 1, end - i - 1, "id") == 0)
+      {
+        size_t value = json.find_first_not_of(" \t\r\n", end + 1);
+        if (value != string::npos && json[value] == ':')
+        {
+          value = json.find_first_not_of(" \t\r\n", value + 1);
+          if (value == string::npos || json[value] < '0' || json[value] > '9')
+            return false;
+          id = (uint32_t)strtoul(json.c_str() + value, nullptr, 10);
+          return true;
+        }
+      }
+      i = end;
+    }
+    else if (c == '{' || c == '[')
+    {
+      depth++;
+    }
+    else if (c == '}' || c == ']')
+    {
+      depth--;
+    }
+  }
+  return false;
+}
+
+static uint64_t InvokeKey(uint32_t channel_id, uint32_t id)
+{
+  return ((uint64_t)channel_id << 32) | id;
+}
+
+static void RingBell(int bell)
+{
+  uint64_t one = 1;
+  ssize_t num = write(bell, &one, sizeof(one));
+  (void)num;
+}
 
 SocketServer::SocketServer()
 : m_serverSocket(0)
-, m_clientSocket(0)
+, m_epoll(-1)
+, m_wakeup(-1)
 , m_running(false)
+, m_draining(false)
+, m_threadStarted(false)
 , m_address()
 , m_port(0)
+, m_unix(false)
+, m_sharedMemorySize(0)
+, m_nextConnectionId(1)
 {
 
 }
@@ -93,7 +243,7 @@ int SocketServer::Open(const string& address, int port, const function<void (con
   struct sockaddr_in addr;
   int rc;
 
-  sock = socket(AF_INET, SOCK_STREAM, 0);
+  sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
 
   if (sock < 0)
   {
@@ -122,23 +272,6 @@ int SocketServer::Open(const string& address, int port, const function<void (con
   
   LOGDBG("SocketServer::Open host_ip=%s sin_addr=%d (note that INADDR_ANY=%d)", address.c_str(), addr.sin_addr.s_addr, INADDR_ANY);
 
-  int sock_flags = fcntl (sock, F_GETFD, 0);
-  if (sock_flags < 0)
-  {
-    LOGERR("SocketServer::Open fcntl get failed: %s", strerror(errno));
-    close(sock);
-    return -1;
-  }
-
-  sock_flags |= FD_CLOEXEC;
-
-  if (fcntl(sock, F_SETFD, sock_flags) < 0)
-  {
-    LOGERR("SocketServer::Open fcntl set failed: %s", strerror(errno));
-    close(sock);
-    return -1;
-  }
-
   if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0)
   {
     LOGERR("SocketServer::Open bind failed: %s", strerror(errno));
@@ -146,16 +279,11 @@ int SocketServer::Open(const string& address, int port, const function<void (con
     return -1;
   }
 
-  if (listen(sock, 4) < 0)
-  {
-    LOGERR("SocketServer::Open listen failed: %s", strerror(errno));
-    close(sock);
-    return -1;
-  }
-
-  m_reader = reader;
-  m_serverSocket = sock;
   m_address = address;
+  m_unix = false;
+
+  if (Listen(sock, reader) < 0)
+    return -1;
 
   if (port)
   {
@@ -179,6 +307,108 @@ int SocketServer::Open(const string& address, int port, const function<void (con
   return 0;
 }
 
+int SocketServer::OpenUnix(const string& path, const function<void (const Response&)>& reader)
+{
+  struct sockaddr_un addr;
+
+  if (path.empty() || path.length() >= sizeof(addr.sun_path))
+  {
+    LOGERR("SocketServer::OpenUnix invalid path '%s'", path.c_str());
+    return -1;
+  }
+
+  int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (sock < 0)
+  {
+    LOGERR("SocketServer::OpenUnix socket create failed: %s", strerror(errno));
+    return -1;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+  // a previous instance that did not shut down cleanly leaves its socket file behind
+  unlink(path.c_str());
+
+  if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+  {
+    LOGERR("SocketServer::OpenUnix bind %s failed: %s", path.c_str(), strerror(errno));
+    close(sock);
+    return -1;
+  }
+
+  m_address = path;
+  m_port = 0;
+  m_unix = true;
+
+  if (Listen(sock, reader) < 0)
+  {
+    unlink(path.c_str());
+    return -1;
+  }
+
+  LOGDBG("SocketServer::OpenUnix successfully running on %s, shared memory ring size %u", path.c_str(), m_sharedMemorySize);
+  return 0;
+}
+
+void SocketServer::SetSharedMemory(uint32_t ring_size)
+{
+  m_sharedMemorySize = ring_size;
+}
+
+int SocketServer::Listen(int sock, const function<void (const Response&)>& reader)
+{
+  if (listen(sock, LISTEN_BACKLOG) < 0)
+  {
+    LOGERR("SocketServer::Listen listen failed: %s", strerror(errno));
+    close(sock);
+    return -1;
+  }
+
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll < 0)
+  {
+    LOGERR("SocketServer::Listen epoll_create1 failed: %s", strerror(errno));
+    close(sock);
+    return -1;
+  }
+
+  int wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeup < 0)
+  {
+    LOGERR("SocketServer::Listen eventfd failed: %s", strerror(errno));
+    close(epoll);
+    close(sock);
+    return -1;
+  }
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN | EPOLLET;
+  ev.data.u64 = SERVER_TOKEN;
+  int rc = epoll_ctl(epoll, EPOLL_CTL_ADD, sock, &ev);
+  if (rc == 0)
+  {
+    ev.data.u64 = WAKEUP_TOKEN;
+    rc = epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup, &ev);
+  }
+  if (rc < 0)
+  {
+    LOGERR("SocketServer::Listen epoll_ctl failed: %s", strerror(errno));
+    close(wakeup);
+    close(epoll);
+    close(sock);
+    return -1;
+  }
+
+  m_reader = reader;
+  m_serverSocket = sock;
+  m_epoll = epoll;
+  m_wakeup = wakeup;
+  return 0;
+}
+
 int SocketServer::RunThread()
 {
   if (pthread_create(&m_thread, nullptr, SocketServer::RunThreadFunc, this) != 0)
@@ -186,6 +416,7 @@ int SocketServer::RunThread()
     LOGERR("SocketServer::Open failed to create thread: %s",strerror(errno));
     return -1;
   }
+  m_threadStarted = true;
   return 0;
 }
 
@@ -203,259 +434,758 @@ int SocketServer::Run()
 
   m_running = true;
 
+  // clients with input left over from their last turn, served round robin
+  std::vector<ConnectionPtr> ready;
+  struct epoll_event events[MAX_EVENTS];
+
   while (m_running)
   {
-    fd_set m_readSet;
-    fd_set m_exceptSet;
-    struct timeval tv;
-    int res;
-
-    FD_ZERO(&m_readSet);
-    FD_ZERO(&m_exceptSet);
-    FD_SET(m_serverSocket, &m_readSet);
-    FD_SET(m_serverSocket, &m_exceptSet);    
-    if (m_clientSocket)
-    {
-      FD_SET(m_clientSocket, &m_readSet);
-      FD_SET(m_clientSocket, &m_exceptSet);    
-    }
+    if (m_draining && !HasPendingWrites())
+      break;
 
-    tv.tv_sec = 10;
-    tv.tv_usec = 0;
-    res = select((m_clientSocket > m_serverSocket ? m_clientSocket : m_serverSocket) + 1, 
-                 &m_readSet, NULL, &m_exceptSet, &tv);
+    int timeout = !ready.empty() ? 0 : (m_draining ? DRAIN_TIMEOUT_MS : IDLE_TIMEOUT_MS);
+    int res = epoll_wait(m_epoll, events, MAX_EVENTS, timeout);
 
     if (!m_running)
       break;
 
     if (res < 0)
     {
-      LOGERR("SocketServer::Open select failed: %s", strerror(errno));
+      if (errno == EINTR)
+        continue;
+      LOGERR("SocketServer::Run epoll_wait failed: %s", strerror(errno));
+      m_running = false;
       return -1;
     }
 
-    if (res == 0)
-      continue;
+    for (int i = 0; i < res; ++i)
+    {
+      if (events[i].data.u64 == SERVER_TOKEN)
+      {
+        Accept();
+        continue;
+      }
+      if (events[i].data.u64 == WAKEUP_TOKEN)
+      {
+        uint64_t count;
+        while (read(m_wakeup, &count, sizeof(count)) > 0);
+        continue;
+      }
 
-    if (FD_ISSET(m_serverSocket, &m_readSet))
-    {
-      int clsock;
-      struct sockaddr_in claddr;
-      socklen_t cllen;
-      
-      cllen = sizeof(claddr);
-      memset(&claddr, 0, cllen);
-      
-      clsock = accept(m_serverSocket, (struct sockaddr*)&claddr, &cllen);
-      if (clsock < 0)
+      ConnectionPtr conn = FindConnection((uint32_t)events[i].data.u64);
+      if (!conn)
+        continue;
+
+      // the client either wrote to its ring or made room in ours
+      bool bell = (events[i].data.u64 & BELL_TOKEN_FLAG) != 0;
+      if (bell)
       {
-        LOGERR("SocketServer::Open accept failed: %s", strerror(errno));
+        uint64_t count;
+        while (read(conn->server_bell, &count, sizeof(count)) > 0);
       }
-      else
+
+      if (bell || (events[i].events & EPOLLOUT))
       {
-        LOGDBG("SocketServer::Open client connected");
-        m_clientSocket = clsock;
+        std::lock_guard<std::mutex> lock(conn->write_lock);
+        Flush(*conn);
+      }
+      // hangups and errors are noticed by the read that follows
+      if ((bell || (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) && !conn->ready)
+      {
+        conn->ready = true;
+        ready.push_back(conn);
       }
     }
 
-    if (m_clientSocket)
+    // one turn for every ready client, the ones that used up their budget
+    // queue up again behind those that became ready in the meantime
+    std::vector<ConnectionPtr> serving;
+    serving.swap(ready);
+    for (size_t i = 0; i < serving.size() && m_running; ++i)
     {
-      if (FD_ISSET(m_clientSocket, &m_readSet))
+      int rc = Service(serving[i]);
+      if (rc == CLIENT_YIELD)
       {
-        Response rsp;
-        int rc = ReadResponse(rsp);
-        if (rc >= 0)
-        {
-          m_reader(rsp);
-        }
-        else if (rc == CLIENT_DISCONNECT)
-        {
-          LOGDBG("SocketServer::Open client disconnected");
-          close(m_clientSocket);
-          m_clientSocket = 0;
-        }
+        ready.push_back(serving[i]);
+        continue;
+      }
+      serving[i]->ready = false;
+      if (rc == CLIENT_DISCONNECT)
+      {
+        CloseConnection(serving[i]);
       }
     }
   }
+  m_running = false;
   return 0;
 }
 
-string SocketServer::GetAddress() const
+void SocketServer::Accept()
 {
-  return m_address;
+  while (true)
+  {
+    struct sockaddr_storage claddr;
+    socklen_t cllen = sizeof(claddr);
+    memset(&claddr, 0, cllen);
+
+    int clsock = accept4(m_serverSocket, (struct sockaddr*)&claddr, &cllen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (clsock < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        LOGERR("SocketServer::Accept accept failed: %s", strerror(errno));
+      return;
+    }
+
+    string peer = m_address;
+    if (!m_unix)
+    {
+      struct sockaddr_in* inaddr = (struct sockaddr_in*)&claddr;
+      char ip[INET_ADDRSTRLEN] = {0};
+      inet_ntop(AF_INET, &inaddr->sin_addr, ip, sizeof(ip));
+      peer = string(ip) + ":" + std::to_string(ntohs(inaddr->sin_port));
+
+      // frames are written whole, waiting for more only delays the invoke
+      int nodelay = 1;
+      setsockopt(clsock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    }
+
+    ConnectionPtr conn;
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      conn = std::make_shared<Connection>(m_nextConnectionId++, clsock, peer);
+    }
+
+    // the shared memory message has to be the first thing the client reads
+    if (m_unix && m_sharedMemorySize > 0 && SetupSharedMemory(conn) < 0)
+    {
+      CloseConnection(conn);
+      continue;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.u64 = conn->id;
+    int rc = epoll_ctl(m_epoll, EPOLL_CTL_ADD, clsock, &ev);
+    if (rc == 0 && conn->shared_memory)
+    {
+      ev.events = EPOLLIN | EPOLLET;
+      ev.data.u64 = BELL_TOKEN_FLAG | conn->id;
+      rc = epoll_ctl(m_epoll, EPOLL_CTL_ADD, conn->server_bell, &ev);
+    }
+    if (rc < 0)
+    {
+      LOGERR("SocketServer::Accept epoll_ctl failed: %s", strerror(errno));
+      CloseConnection(conn);
+      continue;
+    }
+
+    std::set<uint32_t> attached;
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      m_connections[conn->id] = conn;
+      attached = m_attachedChannels;
+    }
+
+    LOGDBG("SocketServer::Accept client %u connected from %s%s", conn->id, peer.c_str(),
+      conn->shared_memory ? " using shared memory" : "");
+
+    // the client missed the attaches of channels opened before it connected
+    for (std::set<uint32_t>::const_iterator it = attached.begin(); it != attached.end(); ++it)
+    {
+      AttachHeader header = { htonl(ID_ATTACH), htonl(*it), (uint8_t)1 };
+      Queue(conn, string((const char*)&header, sizeof(header)));
+    }
+  }
 }
 
-int SocketServer::GetPort() const
+int SocketServer::SetupSharedMemory(const ConnectionPtr& conn)
 {
-  return m_port; 
+  // keeps the second ring header aligned
+  const uint32_t capacity = (m_sharedMemorySize + 63) & ~63u;
+  const size_t ring_size = SharedRing::Size(capacity);
+  const size_t size = 2 * ring_size;
+
+  int memfd = memfd_create("RustAdapter", MFD_CLOEXEC);
+  if (memfd < 0)
+  {
+    LOGERR("SocketServer::SetupSharedMemory memfd_create failed: %s", strerror(errno));
+    return -1;
+  }
+  if (ftruncate(memfd, (off_t)size) < 0)
+  {
+    LOGERR("SocketServer::SetupSharedMemory ftruncate failed: %s", strerror(errno));
+    close(memfd);
+    return -1;
+  }
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+  if (base == MAP_FAILED)
+  {
+    LOGERR("SocketServer::SetupSharedMemory mmap failed: %s", strerror(errno));
+    close(memfd);
+    return -1;
+  }
+
+  conn->shared_memory = base;
+  conn->shared_memory_size = size;
+  conn->to_client.Init(base, capacity);
+  conn->to_server.Init((char*)base + ring_size, capacity);
+  conn->client_bell = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  conn->server_bell = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (conn->client_bell < 0 || conn->server_bell < 0)
+  {
+    LOGERR("SocketServer::SetupSharedMemory eventfd failed: %s", strerror(errno));
+    close(memfd);
+    return -1;
+  }
+
+  SharedMemoryHeader header = { htonl(ID_SHARED_MEMORY), htonl(capacity) };
+  struct iovec iov;
+  iov.iov_base = &header;
+  iov.iov_len = sizeof(header);
+
+  int fds[3] = { memfd, conn->client_bell, conn->server_bell };
+  char control[CMSG_SPACE(sizeof(fds))];
+  memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+  // the socket buffer of a new connection is empty, the message always fits
+  ssize_t num = sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+  close(memfd);
+  if (num != (ssize_t)sizeof(header))
+  {
+    LOGERR("SocketServer::SetupSharedMemory sendmsg failed: num=%zd: %s", num, strerror(errno));
+    return -1;
+  }
+
+  conn->stats.shared_memory = true;
+  return 0;
 }
 
-void SocketServer::Close()
+int SocketServer::Service(const ConnectionPtr& conn)
 {
-  if (m_serverSocket > 0)
+  uint32_t responses = 0;
+  size_t bytes = 0;
+  bool socket_idle = false;
+  int rc = 0;
+
+  while (true)
   {
-    if (m_running)
+    Input* inputs[] = { &conn->socket_in, &conn->ring_in };
+    int parse_rc = 0;
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]) && parse_rc >= 0; ++i)
     {
-      m_running = false;
+      Response rsp;
+      while (responses < READ_BUDGET_RESPONSES && ParseResponse(*conn, *inputs[i], rsp, parse_rc))
+      {
+        m_reader(rsp);
+        responses++;
+        rsp = Response();
+      }
     }
-    close(m_clientSocket);
-    close(m_serverSocket);
-    m_serverSocket = 0;
+    if (parse_rc < 0)
+    {
+      rc = CLIENT_DISCONNECT;
+      break;
+    }
+    if (responses >= READ_BUDGET_RESPONSES || bytes >= READ_BUDGET_BYTES)
+    {
+      rc = CLIENT_YIELD;
+      break;
+    }
+
+    if (!socket_idle)
+    {
+      char chunk[READ_CHUNK];
+      ssize_t num = read(conn->fd, chunk, sizeof(chunk));
+      if (num > 0)
+      {
+        conn->socket_in.buffer.append(chunk, (size_t)num);
+        bytes += (size_t)num;
+        continue;
+      }
+      if (num < 0 && errno == EINTR)
+        continue;
+      if (num == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+      {
+        if (num < 0 && errno != ECONNRESET)
+          LOGERR("SocketServer::Service read failed: %s", strerror(errno));
+        rc = CLIENT_DISCONNECT;
+        break;
+      }
+      socket_idle = true;
+    }
+
+    if (!conn->shared_memory)
+      break;
+
+    bool notify = false;
+    ssize_t num = conn->to_server.Read(conn->ring_in.buffer, READ_CHUNK, notify);
+    if (num < 0)
+    {
+      LOGERR("SocketServer::Service client %u corrupted its shared memory ring, closing", conn->id);
+      rc = CLIENT_DISCONNECT;
+      break;
+    }
+    if (notify)
+      RingBell(conn->client_bell);
+    bytes += (size_t)num;
+    // the client rings the bell for anything it writes after this
+    if (num == 0 && conn->to_server.WaitForData())
+      break;
   }
+
+  std::lock_guard<std::mutex> lock(conn->write_lock);
+  conn->stats.bytes_read += bytes;
+  conn->stats.responses_read += responses;
+  if (rc == CLIENT_YIELD)
+    conn->stats.yields++;
+  return rc;
 }
 
-int SocketServer::ReadExact(uint8_t* p, int len)
+bool SocketServer::ParseResponse(Connection& conn, Input& in, Response& rsp, int& rc)
 {
-  if (!p || len <= 0)
-    return -1;
+  rc = 0;
+  size_t available = in.buffer.size() - in.offset;
+  if (available < sizeof(ResponseHeader))
+    return false;
 
-  if (m_serverSocket <= 0 || m_clientSocket <= 0)
-    return -1;
-
-  size_t remaining = (size_t)len;
+  ResponseHeader header;
+  memcpy(&header, in.buffer.data() + in.offset, sizeof(header));
+  uint32_t json_len = ntohl(header.json_len);
 
-  while (remaining > 0)
+  if (json_len > MAX_JSON_LEN)
   {
-    ssize_t num = read(m_clientSocket, p, remaining);
+    LOGERR("SocketServer::ParseResponse client %u sent json_len=%u, closing", conn.id, json_len);
+    rc = -1;
+    return false;
+  }
 
-    if (num <= 0)
+  if (available < sizeof(ResponseHeader) + json_len)
+  {
+    if (in.offset > 0)
     {
-        LOGERR("SocketServer::ReadExact failed: num=%zd", num);
+      // keep the partial response at the front, the buffer only grows up to one response
+      in.buffer.erase(0, in.offset);
+      in.offset = 0;
+    }
+    return false;
+  }
 
-        if (num == 0)
-          return CLIENT_DISCONNECT;
+  rsp.channel_id = ntohl(header.channel_id);
+  rsp.connection_id = conn.id;
+  rsp.json.assign(in.buffer, in.offset + sizeof(ResponseHeader), json_len);
+  in.offset += sizeof(ResponseHeader) + json_len;
 
-        return -1;
-    }
-    else
+  if (in.offset == in.buffer.size())
+  {
+    in.buffer.clear();
+    in.offset = 0;
+  }
+
+  uint32_t id;
+  if (ParseMessageId(rsp.json, id))
+  {
+    std::lock_guard<std::mutex> lock(conn.write_lock);
+    conn.in_flight.erase(InvokeKey(rsp.channel_id, id));
+  }
+
+  LOGDBG("SocketServer::ParseResponse client %u: channel_id=%u, json_len=%u",
+    conn.id, rsp.channel_id, json_len);
+  return true;
+}
+
+void SocketServer::CloseConnection(const ConnectionPtr& conn)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_connections.erase(conn->id);
+    for (std::map<uint32_t, uint32_t>::iterator it = m_channelOwner.begin(); it != m_channelOwner.end();)
     {
-      p += num;
-      remaining -= (size_t)num;
+      if (it->second == conn->id)
+        it = m_channelOwner.erase(it);
+      else
+        ++it;
     }
   }
 
-  if (remaining != 0)
+  std::set<uint64_t> in_flight;
   {
-    LOGERR("SocketServer::ReadExact: failed: remaining=%zu", remaining);
-    return -1;
+    std::lock_guard<std::mutex> lock(conn->write_lock);
+    if (conn->closed)
+      return;
+    conn->closed = true;
+    in_flight.swap(conn->in_flight);
+    LOGDBG("SocketServer::CloseConnection client %u disconnected: read %llu bytes/%u responses, wrote %llu bytes/%u messages, max pending %zu, yields %u",
+      conn->id,
+      (unsigned long long)conn->stats.bytes_read, conn->stats.responses_read,
+      (unsigned long long)conn->stats.bytes_written, conn->stats.messages_sent,
+      conn->stats.max_pending_write, conn->stats.yields);
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, conn->fd, nullptr);
+    close(conn->fd);
+    conn->fd = -1;
+
+    if (conn->server_bell >= 0)
+    {
+      epoll_ctl(m_epoll, EPOLL_CTL_DEL, conn->server_bell, nullptr);
+      close(conn->server_bell);
+      conn->server_bell = -1;
+    }
+    if (conn->client_bell >= 0)
+    {
+      close(conn->client_bell);
+      conn->client_bell = -1;
+    }
+    if (conn->shared_memory)
+    {
+      munmap(conn->shared_memory, conn->shared_memory_size);
+      conn->shared_memory = nullptr;
+    }
   }
 
-  return len;
+  // nobody else will answer them, the callers would wait forever
+  for (std::set<uint64_t>::const_iterator it = in_flight.begin(); it != in_flight.end(); ++it)
+    FailInvoke(conn->id, *it);
 }
 
-int SocketServer::SendInvoke(uint32_t channel_id, const string& token, const string& json)
+void SocketServer::FailInvoke(uint32_t connection_id, uint64_t invoke)
+{
+  const uint32_t id = (uint32_t)invoke;
+  Response rsp((uint32_t)(invoke >> 32), "{\"jsonrpc\":\"2.0\",\"id\":" + std::to_string(id) +
+    ",\"error\":{\"code\":" + std::to_string(DISCONNECTED_ERROR_CODE) + ",\"message\":\"remote plugin disconnected\"}}");
+  rsp.connection_id = connection_id;
+  LOGERR("SocketServer::FailInvoke client %u disconnected before answering channel_id=%u, id=%u", connection_id, rsp.channel_id, id);
+  m_reader(rsp);
+}
+
+int SocketServer::Queue(const ConnectionPtr& conn, const string& message)
 {
-  if (m_serverSocket <= 0 || m_clientSocket <= 0)
+  std::lock_guard<std::mutex> lock(conn->write_lock);
+  if (conn->closed)
     return -1;
-  
-  InvoketHeader header = {
-    htonl(ID_INVOKE),
-    htonl(channel_id),
-    htonl((uint32_t)token.length()),
-    htonl((uint32_t)json.length())
-  };
 
-  int num = send(m_clientSocket, &header, sizeof(header), MSG_NOSIGNAL);
-  if (num != sizeof(header))
-  {
-    LOGERR("SocketServer::SendInvoke failed to send header: num=%d", num);
+  conn->write_buffer.append(message);
+  conn->stats.messages_sent++;
+  // anything that does not fit the socket now is written on EPOLLOUT
+  if (Flush(*conn) < 0)
     return -1;
-  }
 
-  if (token.length() > 0)
+  size_t pending = conn->write_buffer.size() - conn->write_offset;
+  if (pending > conn->stats.max_pending_write)
+    conn->stats.max_pending_write = pending;
+  return 0;
+}
+
+int SocketServer::Flush(Connection& conn)
+{
+  if (conn.closed)
+    return -1;
+
+  while (conn.shared_memory && conn.write_offset < conn.write_buffer.size())
   {
-    num = send(m_clientSocket, token.c_str(), token.length(), MSG_NOSIGNAL);
-    if (num != (ssize_t)token.length())
+    bool notify = false;
+    ssize_t num = conn.to_client.Write(conn.write_buffer.data() + conn.write_offset,
+      conn.write_buffer.size() - conn.write_offset, notify);
+    if (num < 0)
     {
-      LOGERR("SocketServer::SendInvoke failed to send token: num=%d", num);
+      // the Run thread closes the connection on the hangup that follows
+      LOGERR("SocketServer::Flush client %u corrupted its shared memory ring, closing", conn.id);
+      shutdown(conn.fd, SHUT_RDWR);
       return -1;
     }
+    if (notify)
+      RingBell(conn.client_bell);
+    conn.write_offset += (size_t)num;
+    conn.stats.bytes_written += (uint64_t)num;
+    // the client rings the bell once it made room
+    if (num == 0 && conn.to_client.WaitForSpace())
+      break;
   }
 
-  if (json.length() > 0)
+  while (!conn.shared_memory && conn.write_offset < conn.write_buffer.size())
   {
-    num = send(m_clientSocket, json.c_str(), json.length(), MSG_NOSIGNAL);
-    if (num != (ssize_t)json.length())
+    ssize_t num = send(conn.fd, conn.write_buffer.data() + conn.write_offset,
+      conn.write_buffer.size() - conn.write_offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (num < 0)
     {
-      LOGERR("SocketServer::SendInvoke failed to send json: num=%d", num);
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+      // the Run thread closes the connection on the hangup that follows
+      LOGERR("SocketServer::Flush client %u send failed: %s", conn.id, strerror(errno));
       return -1;
     }
+    conn.write_offset += (size_t)num;
+    conn.stats.bytes_written += (uint64_t)num;
+  }
+
+  if (conn.write_offset == conn.write_buffer.size())
+  {
+    conn.write_buffer.clear();
+    conn.write_offset = 0;
   }
+  conn.stats.pending_write = conn.write_buffer.size() - conn.write_offset;
   return 0;
 }
 
-int SocketServer::SendAttach(uint32_t channel_id, bool attach)
+bool SocketServer::HasPendingWrites() const
+{
+  std::vector<ConnectionPtr> connections = AllConnections();
+  for (size_t i = 0; i < connections.size(); ++i)
+  {
+    std::lock_guard<std::mutex> lock(connections[i]->write_lock);
+    if (!connections[i]->closed && connections[i]->write_offset < connections[i]->write_buffer.size())
+      return true;
+  }
+  return false;
+}
+
+SocketServer::ConnectionPtr SocketServer::FindConnection(uint32_t id) const
+{
+  std::lock_guard<std::mutex> lock(m_lock);
+  std::map<uint32_t, ConnectionPtr>::const_iterator it = m_connections.find(id);
+  return (it != m_connections.end()) ? it->second : ConnectionPtr();
+}
+
+SocketServer::ConnectionPtr SocketServer::ConnectionFor(uint32_t channel_id)
+{
+  std::lock_guard<std::mutex> lock(m_lock);
+  std::map<uint32_t, uint32_t>::const_iterator owner = m_channelOwner.find(channel_id);
+  if (owner != m_channelOwner.end())
+  {
+    std::map<uint32_t, ConnectionPtr>::const_iterator it = m_connections.find(owner->second);
+    if (it != m_connections.end())
+      return it->second;
+  }
+
+  // a new channel goes to the client serving the fewest channels
+  ConnectionPtr conn;
+  for (std::map<uint32_t, ConnectionPtr>::const_iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+  {
+    if (!conn || it->second->channels < conn->channels)
+      conn = it->second;
+  }
+  if (conn)
+  {
+    m_channelOwner[channel_id] = conn->id;
+    conn->channels++;
+  }
+  return conn;
+}
+
+std::vector<SocketServer::ConnectionPtr> SocketServer::AllConnections() const
 {
-  if (m_serverSocket <= 0 || m_clientSocket <= 0)
+  std::lock_guard<std::mutex> lock(m_lock);
+  std::vector<ConnectionPtr> connections;
+  for (std::map<uint32_t, ConnectionPtr>::const_iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+    connections.push_back(it->second);
+  return connections;
+}
+
+void SocketServer::Wakeup()
+{
+  if (m_wakeup >= 0)
+  {
+    uint64_t one = 1;
+    ssize_t num = write(m_wakeup, &one, sizeof(one));
+    (void)num;
+  }
+}
+
+std::vector<ConnectionStats> SocketServer::GetConnectionStats() const
+{
+  std::lock_guard<std::mutex> lock(m_lock);
+  std::vector<ConnectionStats> stats;
+  for (std::map<uint32_t, ConnectionPtr>::const_iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+  {
+    std::lock_guard<std::mutex> conn_lock(it->second->write_lock);
+    stats.push_back(it->second->stats);
+    stats.back().channels = it->second->channels;
+  }
+  return stats;
+}
+
+string SocketServer::GetAddress() const
+{
+  return m_address;
+}
+
+int SocketServer::GetPort() const
+{
+  return m_port; 
+}
+
+void SocketServer::Close()
+{
+  if (m_serverSocket > 0)
+  {
+    if (m_running)
+    {
+      m_running = false;
+    }
+    Wakeup();
+    if (m_threadStarted)
+    {
+      if (!pthread_equal(m_thread, pthread_self()))
+        pthread_join(m_thread, nullptr);
+      else
+        pthread_detach(m_thread);
+      m_threadStarted = false;
+    }
+
+    std::vector<ConnectionPtr> connections = AllConnections();
+    for (size_t i = 0; i < connections.size(); ++i)
+      CloseConnection(connections[i]);
+
+    close(m_serverSocket);
+    close(m_epoll);
+    close(m_wakeup);
+    if (m_unix)
+      unlink(m_address.c_str());
+    m_serverSocket = 0;
+    m_epoll = -1;
+    m_wakeup = -1;
+    m_draining = false;
+  }
+}
+
+int SocketServer::SendInvoke(uint32_t channel_id, const string& token, const string& json)
+{
+  if (m_serverSocket <= 0)
     return -1;
 
-  AttachHeader header = {
-    htonl(ID_ATTACH),
+  ConnectionPtr conn = ConnectionFor(channel_id);
+  if (!conn)
+    return -1;
+  
+  InvoketHeader header = {
+    htonl(ID_INVOKE),
     htonl(channel_id),
-    attach ? (uint8_t)1 : (uint8_t)0
+    htonl((uint32_t)token.length()),
+    htonl((uint32_t)json.length())
   };
 
-  int num = send(m_clientSocket, &header, sizeof(header), MSG_NOSIGNAL);
-  if (num != sizeof(header))
+  string message;
+  message.reserve(sizeof(header) + token.length() + json.length());
+  message.append((const char*)&header, sizeof(header));
+  message.append(token);
+  message.append(json);
+
+  // tracked before it is written, the response may be read before Queue returns
+  uint32_t id;
+  const bool tracked = ParseMessageId(json, id);
+  if (tracked)
+  {
+    std::lock_guard<std::mutex> lock(conn->write_lock);
+    conn->in_flight.insert(InvokeKey(channel_id, id));
+  }
+
+  if (Queue(conn, message) < 0)
   {
-    LOGERR("SocketServer::SendAttach failed to send header: num=%d", num);
+    LOGERR("SocketServer::SendInvoke failed to send to client %u", conn->id);
+    if (tracked)
+    {
+      bool pending;
+      {
+        std::lock_guard<std::mutex> lock(conn->write_lock);
+        pending = conn->in_flight.erase(InvokeKey(channel_id, id)) > 0;
+      }
+      // answered here unless CloseConnection already did
+      if (pending)
+        FailInvoke(conn->id, InvokeKey(channel_id, id));
+    }
     return -1;
   }
   return 0;
 }
 
-int SocketServer::SendExit()
+int SocketServer::SendAttach(uint32_t channel_id, bool attach)
 {
-  if (m_serverSocket <= 0 || m_clientSocket <= 0)
+  if (m_serverSocket <= 0)
     return -1;
 
-  uint32_t command_id = htonl(ID_EXIT);
-  int num = send(m_clientSocket, &command_id, sizeof(command_id), MSG_NOSIGNAL);
-  if (num != sizeof(command_id))
+  std::vector<ConnectionPtr> connections;
   {
-    LOGERR("SocketServer::SendExit failed: num=%d", num);
-    return -1;
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (attach)
+    {
+      m_attachedChannels.insert(channel_id);
+    }
+    else
+    {
+      m_attachedChannels.erase(channel_id);
+      std::map<uint32_t, uint32_t>::iterator owner = m_channelOwner.find(channel_id);
+      if (owner != m_channelOwner.end())
+      {
+        std::map<uint32_t, ConnectionPtr>::iterator it = m_connections.find(owner->second);
+        if (it != m_connections.end() && it->second->channels > 0)
+          it->second->channels--;
+        m_channelOwner.erase(owner);
+      }
+    }
+    for (std::map<uint32_t, ConnectionPtr>::const_iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+      connections.push_back(it->second);
   }
 
-  /*break out of reader thread*/
-  m_running = false;
-
-  return 0;
-}
-
-int SocketServer::ReadResponse(Response& rsp)
-{
-  if (m_serverSocket <= 0 || m_clientSocket <= 0)
+  if (connections.empty())
     return -1;
 
-  ResponseHeader header;
-  int rc;
+  AttachHeader header = {
+    htonl(ID_ATTACH),
+    htonl(channel_id),
+    attach ? (uint8_t)1 : (uint8_t)0
+  };
 
-  if ((rc = ReadExact((uint8_t*)&header, (int)sizeof(ResponseHeader))) <= 0)
+  int rc = 0;
+  for (size_t i = 0; i < connections.size(); ++i)
   {
-    return rc;
+    if (Queue(connections[i], string((const char*)&header, sizeof(header))) < 0)
+    {
+      LOGERR("SocketServer::SendAttach failed to send to client %u", connections[i]->id);
+      rc = -1;
+    }
   }
+  return rc;
+}
 
-  rsp.channel_id = ntohl(header.channel_id);
-  header.json_len = ntohl(header.json_len);
+int SocketServer::SendExit()
+{
+  if (m_serverSocket <= 0)
+    return -1;
 
-  LOGDBG("SocketServer::ReadResponse read header: channel_id=%u, json_len=%u", 
-    rsp.channel_id, header.json_len);
+  std::vector<ConnectionPtr> connections = AllConnections();
+  if (connections.empty())
+    return -1;
 
-  if (header.json_len > 0)
+  uint32_t command_id = htonl(ID_EXIT);
+  int rc = 0;
+  for (size_t i = 0; i < connections.size(); ++i)
   {
-    uint8_t* buffer;
-    buffer = (uint8_t*)malloc(header.json_len+1);
-
-    if ((rc = ReadExact(buffer, (int)header.json_len)) <= 0)
+    if (Queue(connections[i], string((const char*)&command_id, sizeof(command_id))) < 0)
     {
-      free(buffer);
-      return rc;
+      LOGERR("SocketServer::SendExit failed to send to client %u", connections[i]->id);
+      rc = -1;
     }
-    
-    buffer[header.json_len] = 0;
-    rsp.json = (char*)buffer;
-    free(buffer);
   }
-  return 0;
-}
\ No newline at end of file
+
+  /*break out of reader thread once the exit messages are written*/
+  m_draining = true;
+  Wakeup();
+
+  return rc;
+}
@@ -20,7 +20,14 @@
 
 #include <string>
 #include <functional>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
 #include <pthread.h>
+#include "SharedRing.h"
 
 using std::string;
 using std::function;
@@ -29,17 +36,53 @@ struct Response
 {
   uint32_t channel_id;
   string json;
+  // the client connection the response was read from
+  uint32_t connection_id;
 
   Response();
   Response(uint32_t channel, const string& json_str);
 };
 
+struct ConnectionStats
+{
+  uint32_t connection_id;
+  string peer;
+  uint64_t bytes_read;
+  uint64_t bytes_written;
+  uint32_t responses_read;
+  uint32_t messages_sent;
+  // channels whose invokes are routed to this connection
+  uint32_t channels;
+  size_t pending_write;
+  size_t max_pending_write;
+  // times the connection gave up its turn with input still pending
+  uint32_t yields;
+  bool shared_memory;
+};
+
+/*
+ * Serves any number of remote plugin processes. Clients are non-blocking and
+ * registered edge-triggered with epoll, each with its own read and write
+ * buffer. A readable client is served for a bounded number of bytes and
+ * responses per turn and then goes to the back of the ready list, so one busy
+ * client can not starve the others. Invokes of a channel always go to the
+ * same client, attach, detach and exit go to all of them. Invokes a client
+ * has not answered when it goes away are answered with an error.
+ *
+ * Listens on TCP with Open or on a unix domain socket with OpenUnix. On a
+ * unix socket every client can be handed a pair of shared memory rings and
+ * eventfds right after it connects, frames then travel through the rings
+ * and the socket is only left to notice the client going away.
+ */
 class SocketServer
 {
 public:
   SocketServer();
   ~SocketServer();
   int Open(const string& address, int port, const function<void (const Response&)>& reader);
+  int OpenUnix(const string& path, const function<void (const Response&)>& reader);
+  // ring size in bytes per direction for clients of OpenUnix, 0 to keep frames on the socket
+  void SetSharedMemory(uint32_t ring_size);
   int RunThread();
   int Run();
   void Close();
@@ -48,16 +91,46 @@ public:
   int SendInvoke(uint32_t channel_id, const string& token, const string& json);
   int SendAttach(uint32_t channel_id, bool attach);
   int SendExit();
-  int ReadResponse(Response& cmd);
+  std::vector<ConnectionStats> GetConnectionStats() const;
 private:
-  int ReadExact(uint8_t* p, int len);
+  struct Connection;
+  typedef std::shared_ptr<Connection> ConnectionPtr;
+
+  int Listen(int sock, const function<void (const Response&)>& reader);
+  void Accept();
+  int SetupSharedMemory(const ConnectionPtr& conn);
+  int Service(const ConnectionPtr& conn);
+  struct Input;
+  bool ParseResponse(Connection& conn, Input& in, Response& rsp, int& rc);
+  void CloseConnection(const ConnectionPtr& conn);
+  void FailInvoke(uint32_t connection_id, uint64_t invoke);
+  int Queue(const ConnectionPtr& conn, const string& message);
+  int Flush(Connection& conn);
+  bool HasPendingWrites() const;
+  ConnectionPtr FindConnection(uint32_t id) const;
+  ConnectionPtr ConnectionFor(uint32_t channel_id);
+  std::vector<ConnectionPtr> AllConnections() const;
+  void Wakeup();
   static void* RunThreadFunc(void* arg);
 
   int m_serverSocket;
-  int m_clientSocket;  
+  int m_epoll;
+  int m_wakeup;
   function<void (const Response&)> m_reader;
-  bool m_running;
+  std::atomic<bool> m_running;
+  // set by SendExit, Run returns once the exit messages are written
+  std::atomic<bool> m_draining;
+  bool m_threadStarted;
   pthread_t m_thread;
   string m_address;
   int m_port;
+  bool m_unix;
+  uint32_t m_sharedMemorySize;
+
+  mutable std::mutex m_lock;
+  std::map<uint32_t, ConnectionPtr> m_connections;
+  std::map<uint32_t, uint32_t> m_channelOwner;
+  // replayed to clients connecting later
+  std::set<uint32_t> m_attachedChannels;
+  uint32_t m_nextConnectionId;
 };
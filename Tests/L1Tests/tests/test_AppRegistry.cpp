@@ -0,0 +1,201 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "AppRegistry.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+TEST(AppRegistryTest, keepsCallsignsAsGiven)
+{
+    Plugin::AppRegistry registry;
+    registry.activate("Netflix", "Cobalt");
+    registry.activate("netflix", "WebKitBrowser");
+
+    Plugin::AppRegistry::AppPtr upper = registry.find("Netflix");
+    Plugin::AppRegistry::AppPtr lower = registry.find("netflix");
+    ASSERT_TRUE(upper && lower);
+    EXPECT_EQ("Netflix", upper->callsign);
+    EXPECT_EQ("Cobalt", upper->className);
+    EXPECT_EQ("netflix", lower->callsign);
+    EXPECT_EQ("WebKitBrowser", lower->className);
+    EXPECT_FALSE(registry.find("NETFLIX"));
+    EXPECT_EQ(2u, registry.activeApps().size());
+
+    registry.deactivate("netflix");
+    EXPECT_TRUE(registry.isActive("Netflix"));
+    EXPECT_FALSE(registry.isActive("netflix"));
+}
+
+TEST(AppRegistryTest, findClient)
+{
+    Plugin::AppRegistry registry;
+    registry.activate("YouTube", "Cobalt");
+    Plugin::AppRegistry::AppPtr app = registry.findClient("youtube");
+    ASSERT_TRUE(app);
+    EXPECT_EQ("YouTube", app->callsign);
+    EXPECT_FALSE(registry.findClient("youtub"));
+    EXPECT_FALSE(registry.findClient("amazon"));
+
+    // an exact match wins
+    registry.activate("youtube", "WebKitBrowser");
+    app = registry.findClient("youtube");
+    ASSERT_TRUE(app);
+    EXPECT_EQ("youtube", app->callsign);
+}
+
+TEST(AppRegistryTest, launchAndDestroyExcludeEachOther)
+{
+    Plugin::AppRegistry registry;
+    EXPECT_FALSE(registry.isAnyLaunching());
+    EXPECT_TRUE(registry.beginLaunch("app"));
+    EXPECT_TRUE(registry.isAnyLaunching());
+    EXPECT_FALSE(registry.beginDestroy("app"));
+    EXPECT_FALSE(registry.isBeingDestroyed("app"));
+    registry.endLaunch("app");
+    EXPECT_FALSE(registry.isAnyLaunching());
+
+    EXPECT_TRUE(registry.beginDestroy("app"));
+    EXPECT_TRUE(registry.isBeingDestroyed("app"));
+    EXPECT_FALSE(registry.beginLaunch("app"));
+    // another app is not affected
+    EXPECT_TRUE(registry.beginLaunch("other"));
+    registry.endDestroy("app");
+    EXPECT_FALSE(registry.isBeingDestroyed("app"));
+    EXPECT_TRUE(registry.beginLaunch("app"));
+}
+
+TEST(AppRegistryTest, externalDestroy)
+{
+    Plugin::AppRegistry registry;
+    registry.activate("app", "Cobalt");
+    registry.beginExternalDestroy("app");
+    EXPECT_TRUE(registry.isBeingDestroyed("app"));
+    EXPECT_FALSE(registry.isBeingDestroyed("app", false));
+    registry.endExternalDestroy("app");
+    EXPECT_FALSE(registry.isBeingDestroyed("app"));
+
+    // a destroy through RDKShell is not also counted as an external one
+    EXPECT_TRUE(registry.beginDestroy("app"));
+    registry.beginExternalDestroy("app");
+    registry.endDestroy("app");
+    EXPECT_FALSE(registry.isBeingDestroyed("app"));
+}
+
+TEST(AppRegistryTest, entriesGoAwayWithTheirState)
+{
+    Plugin::AppRegistry registry;
+    registry.activate("app", "Cobalt");
+    registry.setSuspended("app", true);
+    Plugin::AppRegistry::AppPtr app = registry.find("app");
+    ASSERT_TRUE(app);
+    EXPECT_TRUE(app->suspendStateKnown);
+    EXPECT_TRUE(app->suspended);
+
+    registry.deactivate("app");
+    app = registry.find("app");
+    ASSERT_TRUE(app);
+    EXPECT_TRUE(app->className.empty());
+    registry.resetSuspended("app");
+    EXPECT_FALSE(registry.find("app"));
+
+    registry.beginLaunch("app");
+    registry.endLaunch("app");
+    EXPECT_FALSE(registry.find("app"));
+    registry.activate("app", "Cobalt");
+    registry.clear();
+    EXPECT_FALSE(registry.find("app"));
+}
+
+TEST(AppRegistryTest, snapshotsDoNotChange)
+{
+    Plugin::AppRegistry registry;
+    registry.activate("app", "Cobalt");
+    Plugin::AppRegistry::AppPtr before = registry.find("app");
+    registry.setSuspended("app", true);
+    registry.activate("app", "WebKitBrowser");
+
+    EXPECT_FALSE(before->suspended);
+    Plugin::AppRegistry::AppPtr after = registry.find("app");
+    EXPECT_TRUE(after->suspended);
+    // the class name of the first activation is kept
+    EXPECT_EQ("Cobalt", after->className);
+}
+
+TEST(AppRegistryTest, touchOrdersByUse)
+{
+    Plugin::AppRegistry registry;
+    registry.activate("first", "Cobalt");
+    registry.activate("second", "Cobalt");
+    EXPECT_EQ(0u, registry.find("first")->lastUsed);
+    registry.touch("first");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    registry.touch("second");
+    EXPECT_GT(registry.find("second")->lastUsed, registry.find("first")->lastUsed);
+}
+
+TEST(AppRegistryTest, concurrentReadersAndWriters)
+{
+    Plugin::AppRegistry registry;
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; r++) {
+        readers.push_back(std::thread([&registry, &done]() {
+            while (!done) {
+                std::vector<Plugin::AppRegistry::AppPtr> apps = registry.activeApps();
+                for (size_t i = 0; i < apps.size(); i++) {
+                    EXPECT_TRUE(apps[i]->active);
+                    EXPECT_FALSE(apps[i]->callsign.empty());
+                }
+                registry.isBeingDestroyed("app1");
+                registry.findClient("app2");
+            }
+        }));
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 4; w++) {
+        writers.push_back(std::thread([&registry, w]() {
+            const std::string callsign = "app" + std::to_string(w);
+            for (int i = 0; i < 1000; i++) {
+                registry.activate(callsign, "Cobalt");
+                if (registry.beginLaunch(callsign)) {
+                    registry.endLaunch(callsign);
+                }
+                registry.touch(callsign);
+                registry.deactivate(callsign);
+            }
+            registry.activate(callsign, "Cobalt");
+        }));
+    }
+    for (size_t i = 0; i < writers.size(); i++) {
+        writers[i].join();
+    }
+    done = true;
+    for (size_t i = 0; i < readers.size(); i++) {
+        readers[i].join();
+    }
+    // every write went into the index, none was lost to a concurrent one
+    EXPECT_EQ(4u, registry.activeApps().size());
+}
@@ -0,0 +1,181 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "AppStateChannels.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+enum class FakeRialtoState { UNINITIALIZED, NOT_RUNNING, INACTIVE, ACTIVE, ERROR };
+
+// stands in for the Rialto server manager, state changes are reported from its own
+// thread like the session servers do
+class FakeRialtoServer {
+public:
+    explicit FakeRialtoServer(Plugin::AppStateChannels<FakeRialtoState>& states) : mStates(states) {}
+    ~FakeRialtoServer()
+    {
+        for (size_t i = 0; i < mThreads.size(); i++) {
+            mThreads[i].join();
+        }
+    }
+
+    void changeState(const std::string& app, const std::vector<FakeRialtoState>& states)
+    {
+        Plugin::AppStateChannels<FakeRialtoState>& channels = mStates;
+        mThreads.push_back(std::thread([&channels, app, states]() {
+            for (size_t i = 0; i < states.size(); i++) {
+                channels.set(app, states[i]);
+            }
+        }));
+    }
+
+    void changeState(const std::string& app, FakeRialtoState state)
+    {
+        changeState(app, std::vector<FakeRialtoState>(1, state));
+    }
+
+private:
+    Plugin::AppStateChannels<FakeRialtoState>& mStates;
+    std::vector<std::thread> mThreads;
+};
+
+// returns once count waiters are registered, so state changes made after it can not be missed
+bool waitForPending(Plugin::AppStateChannels<FakeRialtoState>& states, uint32_t count)
+{
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        JsonObject stats;
+        states.toJson(stats);
+        if (stats["pending"].Number() >= count) {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    return false;
+}
+}
+
+TEST(AppStateChannelsTest, waitersOnlyWaitForTheirApp)
+{
+    Plugin::AppStateChannels<FakeRialtoState> states(FakeRialtoState::ERROR);
+    FakeRialtoServer server(states);
+    EXPECT_EQ(states.get("youtube"), FakeRialtoState::ERROR);
+
+    std::atomic<bool> netflixDone(false);
+    std::atomic<bool> netflixActive(false);
+    std::thread netflixWaiter([&states, &netflixDone, &netflixActive]() {
+        netflixActive = states.wait("netflix", FakeRialtoState::ACTIVE, 10000);
+        netflixDone = true;
+    });
+
+    // several waiters on the same app are all woken by one change
+    std::atomic<int> youtubeActive(0);
+    std::vector<std::thread> youtubeWaiters;
+    for (int i = 0; i < 4; i++) {
+        youtubeWaiters.push_back(std::thread([&states, &youtubeActive]() {
+            if (states.wait("youtube", FakeRialtoState::ACTIVE, 10000)) {
+                youtubeActive++;
+            }
+        }));
+    }
+    ASSERT_TRUE(waitForPending(states, 5));
+    server.changeState("youtube", FakeRialtoState::ACTIVE);
+    for (size_t i = 0; i < youtubeWaiters.size(); i++) {
+        youtubeWaiters[i].join();
+    }
+    EXPECT_EQ(youtubeActive.load(), 4);
+    // the netflix waiter is still waiting on its own channel
+    EXPECT_FALSE(netflixDone.load());
+
+    server.changeState("netflix", FakeRialtoState::ACTIVE);
+    netflixWaiter.join();
+    EXPECT_TRUE(netflixActive.load());
+    EXPECT_EQ(states.get("netflix"), FakeRialtoState::ACTIVE);
+}
+
+TEST(AppStateChannelsTest, transientStateAndTimeout)
+{
+    Plugin::AppStateChannels<FakeRialtoState> states(FakeRialtoState::ERROR);
+    FakeRialtoServer server(states);
+
+    // the app passes through active before the waiter gets to run again
+    std::atomic<bool> reached(false);
+    std::thread waiter([&states, &reached]() { reached = states.wait("app", FakeRialtoState::ACTIVE, 10000); });
+    ASSERT_TRUE(waitForPending(states, 1));
+    std::vector<FakeRialtoState> transitions;
+    transitions.push_back(FakeRialtoState::ACTIVE);
+    transitions.push_back(FakeRialtoState::INACTIVE);
+    server.changeState("app", transitions);
+    waiter.join();
+    EXPECT_TRUE(reached.load());
+
+    // a wait never returns before its timeout
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(states.wait("app", FakeRialtoState::NOT_RUNNING, 100));
+    EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(), 100);
+    EXPECT_TRUE(states.wait("app", FakeRialtoState::INACTIVE, 0));
+}
+
+TEST(AppStateChannelsTest, asyncWaiters)
+{
+    Plugin::AppStateChannels<FakeRialtoState> states(FakeRialtoState::ERROR);
+    FakeRialtoServer server(states);
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::string> results;
+    auto record = [&mutex, &condition, &results](const std::string& name) {
+        return [&mutex, &condition, &results, name](bool reached) {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(name + (reached ? ":reached" : ":timeout"));
+            condition.notify_all();
+        };
+    };
+
+    states.waitAsync("app", FakeRialtoState::ACTIVE, 10000, record("active"));
+    states.waitAsync("app", FakeRialtoState::NOT_RUNNING, 100, record("stopped"));
+
+    // the short timeout expires first, the state change comes after it
+    std::unique_lock<std::mutex> lock(mutex);
+    EXPECT_TRUE(condition.wait_for(lock, std::chrono::seconds(5), [&results]() { return results.size() == 1; }));
+    lock.unlock();
+    server.changeState("app", FakeRialtoState::ACTIVE);
+    lock.lock();
+    EXPECT_TRUE(condition.wait_for(lock, std::chrono::seconds(5), [&results]() { return results.size() == 2; }));
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0], std::string("stopped:timeout"));
+    EXPECT_EQ(results[1], std::string("active:reached"));
+    lock.unlock();
+
+    // already in the state, the callback runs right away
+    states.waitAsync("app", FakeRialtoState::ACTIVE, 100, record("again"));
+    lock.lock();
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[2], std::string("again:reached"));
+}
@@ -0,0 +1,134 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BulkTeardown.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+// holds a stage back until the test opens it
+class Gate {
+public:
+    Gate() : mOpen(false) {}
+
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOpen = true;
+        mCondition.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this]() { return mOpen; });
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mOpen;
+};
+
+class FakeController {
+public:
+    void record(const std::string& step)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSteps.push_back(step);
+    }
+
+    std::vector<std::string> steps()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSteps;
+    }
+
+private:
+    std::mutex mMutex;
+    std::vector<std::string> mSteps;
+};
+}
+
+TEST(BulkTeardownTest, escalatesStragglers)
+{
+    // the destroy of the hung app only returns once the gate is opened after the run
+    std::shared_ptr<Gate> gate = std::make_shared<Gate>();
+    std::shared_ptr<FakeController> controller = std::make_shared<FakeController>();
+    std::vector<Plugin::BulkTeardown::Stage> stages(3);
+    stages[0].name = "suspend";
+    stages[0].final = false;
+    stages[0].action = [controller](const std::string& callsign) {
+        controller->record(callsign + ".suspend");
+        return true;
+    };
+    stages[1].name = "destroy";
+    stages[1].final = true;
+    stages[1].action = [controller, gate](const std::string& callsign) {
+        if (callsign == "hung") {
+            gate->wait();
+        }
+        controller->record(callsign + ".destroy");
+        return callsign != "failing";
+    };
+    stages[2].name = "kill";
+    stages[2].final = true;
+    stages[2].action = [controller](const std::string& callsign) {
+        controller->record(callsign + ".kill");
+        return true;
+    };
+
+    std::vector<std::string> apps;
+    apps.push_back("first");
+    apps.push_back("hung");
+    apps.push_back("second");
+    apps.push_back("failing");
+    apps.push_back("third");
+    apps.push_back("fourth");
+
+    Plugin::BulkTeardown teardown;
+    std::vector<Plugin::BulkTeardown::Outcome> outcomes = teardown.run(apps, stages, 3, 1000);
+    gate->open();
+
+    ASSERT_EQ(outcomes.size(), apps.size());
+    for (size_t i = 0; i < outcomes.size(); i++) {
+        EXPECT_TRUE(outcomes[i].success);
+        const bool escalated = (apps[i] == "hung") || (apps[i] == "failing");
+        EXPECT_EQ(outcomes[i].straggler, escalated);
+        EXPECT_EQ(outcomes[i].stage, std::string(escalated ? "kill" : "destroy"));
+    }
+    ASSERT_EQ(outcomes[1].timedOut.size(), 1u);
+    EXPECT_EQ(outcomes[1].timedOut[0], std::string("destroy"));
+    EXPECT_TRUE(outcomes[3].timedOut.empty());
+
+    // the hung destroy is still owned by the teardown and finishes before join returns
+    teardown.join();
+    std::vector<std::string> steps = controller->steps();
+    EXPECT_NE(std::find(steps.begin(), steps.end(), std::string("hung.destroy")), steps.end());
+    EXPECT_EQ(steps.size(), 6u + 6u + 2u);
+}
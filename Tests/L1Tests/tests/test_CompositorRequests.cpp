@@ -0,0 +1,229 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "CompositorRequests.h"
+
+#include <string>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+typedef Plugin::CompositorRequests::TransactionOperation TransactionOperation;
+
+JsonObject entry(const char* method, const char* client)
+{
+    JsonObject object;
+    object["method"] = method;
+    object["client"] = client;
+    return object;
+}
+}
+
+TEST(CompositorRequestsTest, parseNumber)
+{
+    JsonObject object;
+    object["number"] = 0.5;
+    object["text"] = "1.25";
+    object["invalid"] = "1.25x";
+    object["empty"] = "";
+    double value = 0;
+    EXPECT_TRUE(Plugin::CompositorRequests::parseNumber(object, "number", value));
+    EXPECT_DOUBLE_EQ(value, 0.5);
+    EXPECT_TRUE(Plugin::CompositorRequests::parseNumber(object, "text", value));
+    EXPECT_DOUBLE_EQ(value, 1.25);
+    EXPECT_FALSE(Plugin::CompositorRequests::parseNumber(object, "invalid", value));
+    EXPECT_FALSE(Plugin::CompositorRequests::parseNumber(object, "empty", value));
+    EXPECT_FALSE(Plugin::CompositorRequests::parseNumber(object, "missing", value));
+}
+
+TEST(CompositorRequestsTest, transactionBoundsAndScale)
+{
+    TransactionOperation operation;
+    std::string message;
+    JsonObject bounds = entry("setBounds", "Org.RDK.Netflix");
+    bounds["x"] = 10;
+    bounds["w"] = 640;
+    ASSERT_TRUE(Plugin::CompositorRequests::parseTransactionOperation(bounds, operation, message));
+    EXPECT_EQ(operation.type, TransactionOperation::BOUNDS);
+    EXPECT_EQ(operation.client, std::string("org.rdk.netflix"));
+    // only the given values are set, the caller keeps the current ones for the others
+    EXPECT_TRUE(operation.hasX);
+    EXPECT_FALSE(operation.hasY);
+    EXPECT_TRUE(operation.hasW);
+    EXPECT_FALSE(operation.hasH);
+    EXPECT_EQ(operation.x, 10u);
+    EXPECT_EQ(operation.w, 640u);
+
+    JsonObject scale;
+    scale["method"] = "setScale";
+    scale["callsign"] = "ResidentApp";
+    scale["sy"] = "0.5";
+    ASSERT_TRUE(Plugin::CompositorRequests::parseTransactionOperation(scale, operation, message));
+    EXPECT_EQ(operation.type, TransactionOperation::SCALE);
+    EXPECT_EQ(operation.client, std::string("residentapp"));
+    EXPECT_FALSE(operation.hasScaleX);
+    EXPECT_TRUE(operation.hasScaleY);
+    EXPECT_DOUBLE_EQ(operation.scaleY, 0.5);
+    // nothing is left over from the previous entry
+    EXPECT_FALSE(operation.hasX);
+
+    scale["sy"] = "half";
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(scale, operation, message));
+    EXPECT_EQ(message, std::string("invalid sy"));
+}
+
+TEST(CompositorRequestsTest, transactionValidation)
+{
+    TransactionOperation operation;
+    std::string message;
+
+    JsonObject noMethod;
+    noMethod["client"] = "ResidentApp";
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(noMethod, operation, message));
+    EXPECT_EQ(message, std::string("please specify method"));
+
+    JsonObject noClient;
+    noClient["method"] = "moveToFront";
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(noClient, operation, message));
+    EXPECT_EQ(message, std::string("please specify client"));
+
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(entry("setOpacity", "ResidentApp"), operation, message));
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(entry("setVisibility", "ResidentApp"), operation, message));
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(entry("setHolePunch", "ResidentApp"), operation, message));
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(entry("moveBehind", "ResidentApp"), operation, message));
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(entry("setScale", "ResidentApp"), operation, message));
+    EXPECT_FALSE(Plugin::CompositorRequests::parseTransactionOperation(entry("launch", "ResidentApp"), operation, message));
+    EXPECT_EQ(message, std::string("unsupported method launch"));
+
+    JsonObject behind = entry("moveBehind", "ResidentApp");
+    behind["target"] = "Org.RDK.Netflix";
+    ASSERT_TRUE(Plugin::CompositorRequests::parseTransactionOperation(behind, operation, message));
+    EXPECT_EQ(operation.type, TransactionOperation::MOVE_BEHIND);
+    EXPECT_EQ(operation.target, std::string("org.rdk.netflix"));
+
+    JsonObject visible = entry("setVisibility", "ResidentApp");
+    visible["visible"] = true;
+    ASSERT_TRUE(Plugin::CompositorRequests::parseTransactionOperation(visible, operation, message));
+    EXPECT_EQ(operation.type, TransactionOperation::VISIBILITY);
+    EXPECT_TRUE(operation.flag);
+
+    JsonObject opacity = entry("setOpacity", "ResidentApp");
+    opacity["opacity"] = 50;
+    ASSERT_TRUE(Plugin::CompositorRequests::parseTransactionOperation(opacity, operation, message));
+    EXPECT_EQ(operation.opacity, 50u);
+}
+
+TEST(CompositorRequestsTest, animationProperties)
+{
+    JsonObject object;
+    object["client"] = "Netflix";
+    object["duration"] = "0.5";
+    object["x"] = -10;
+    object["y"] = 20;
+    object["w"] = 640;
+    object["h"] = 360;
+    object["sx"] = "1.5";
+    object["sy"] = 0.5;
+    object["a"] = 50;
+    object["tween"] = "exponential";
+    object["delay"] = "0.25";
+
+    Plugin::CompositorRequests::Animation animation;
+    std::vector<std::string> invalidFields;
+    std::string message;
+    ASSERT_TRUE(Plugin::CompositorRequests::parseAnimation(object, animation, invalidFields, message));
+    EXPECT_TRUE(invalidFields.empty());
+    EXPECT_EQ("Netflix", animation.client);
+    EXPECT_DOUBLE_EQ(0.5, animation.duration);
+    EXPECT_TRUE(animation.hasX && animation.hasY && animation.hasW && animation.hasH);
+    EXPECT_EQ(-10, animation.x);
+    EXPECT_EQ(20, animation.y);
+    EXPECT_EQ(640u, animation.w);
+    EXPECT_EQ(360u, animation.h);
+    EXPECT_DOUBLE_EQ(1.5, animation.scaleX);
+    EXPECT_DOUBLE_EQ(0.5, animation.scaleY);
+    EXPECT_EQ(50u, animation.opacity);
+    EXPECT_EQ("exponential", animation.tween);
+    EXPECT_DOUBLE_EQ(0.25, animation.delay);
+    EXPECT_DOUBLE_EQ(0.75, animation.length());
+}
+
+TEST(CompositorRequestsTest, animationOnlyGivenProperties)
+{
+    JsonObject object;
+    object["client"] = "app";
+    object["duration"] = 2;
+    object["a"] = 0;
+
+    Plugin::CompositorRequests::Animation animation;
+    std::vector<std::string> invalidFields;
+    std::string message;
+    ASSERT_TRUE(Plugin::CompositorRequests::parseAnimation(object, animation, invalidFields, message));
+    EXPECT_TRUE(animation.hasOpacity);
+    EXPECT_FALSE(animation.hasX || animation.hasY || animation.hasW || animation.hasH);
+    EXPECT_FALSE(animation.hasScaleX || animation.hasScaleY || animation.hasTween || animation.hasDelay);
+    EXPECT_DOUBLE_EQ(2, animation.length());
+}
+
+TEST(CompositorRequestsTest, animationInvalidOptionalFieldsAreLeftOut)
+{
+    JsonObject object;
+    object["client"] = "app";
+    object["duration"] = "1";
+    object["delay"] = "soon";
+    object["sx"] = "";
+    object["x"] = 5;
+
+    Plugin::CompositorRequests::Animation animation;
+    std::vector<std::string> invalidFields;
+    std::string message;
+    // the animation itself is still valid
+    ASSERT_TRUE(Plugin::CompositorRequests::parseAnimation(object, animation, invalidFields, message));
+    ASSERT_EQ(2u, invalidFields.size());
+    EXPECT_EQ("sx", invalidFields[0]);
+    EXPECT_EQ("delay", invalidFields[1]);
+    EXPECT_FALSE(animation.hasDelay);
+    EXPECT_FALSE(animation.hasScaleX);
+    EXPECT_TRUE(animation.hasX);
+    EXPECT_DOUBLE_EQ(1, animation.length());
+}
+
+TEST(CompositorRequestsTest, animationRequiredFields)
+{
+    Plugin::CompositorRequests::Animation animation;
+    std::vector<std::string> invalidFields;
+    std::string message;
+
+    JsonObject noDuration;
+    noDuration["client"] = "app";
+    EXPECT_FALSE(Plugin::CompositorRequests::parseAnimation(noDuration, animation, invalidFields, message));
+    EXPECT_EQ("please specify client and duration", message);
+
+    JsonObject noClient;
+    noClient["duration"] = 1;
+    EXPECT_FALSE(Plugin::CompositorRequests::parseAnimation(noClient, animation, invalidFields, message));
+
+    JsonObject badDuration;
+    badDuration["client"] = "app";
+    badDuration["duration"] = "long";
+    EXPECT_FALSE(Plugin::CompositorRequests::parseAnimation(badDuration, animation, invalidFields, message));
+    EXPECT_EQ("invalid duration", message);
+}
@@ -0,0 +1,269 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "EventCoalescer.h"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+// records what the coalescer sends, with the value of one parameter
+class Subscriber {
+public:
+    Plugin::EventCoalescer::Sender sender(const std::string& parameter)
+    {
+        return [this, parameter](const std::string& event, const JsonObject& parameters) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mEvents.push_back(std::make_pair(event, parameters[parameter.c_str()].String()));
+        };
+    }
+    std::vector<std::pair<std::string, std::string>> events()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEvents;
+    }
+    size_t count()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEvents.size();
+    }
+
+private:
+    std::mutex mMutex;
+    std::vector<std::pair<std::string, std::string>> mEvents;
+};
+
+// long enough that only flushes send held back events during a test
+const uint32_t LONG_WINDOW_MS = 60000;
+
+Plugin::EventCoalescer::Rule rule(const std::string& event, uint32_t window, const std::string& key = "")
+{
+    Plugin::EventCoalescer::Rule result;
+    result.event = event;
+    result.window = window;
+    result.key = key;
+    return result;
+}
+
+JsonObject parameters(const std::string& client, const std::string& value)
+{
+    JsonObject result;
+    result["client"] = client;
+    result["value"] = value;
+    return result;
+}
+
+bool waitFor(const std::function<bool()>& condition)
+{
+    for (int i = 0; i < 5000; i++) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return condition();
+}
+}
+
+TEST(EventCoalescerTest, notRunningLeavesEventsToCaller)
+{
+    Plugin::EventCoalescer coalescer;
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onFocus", LONG_WINDOW_MS)));
+    EXPECT_FALSE(coalescer.dispatch("onFocus", parameters("a", "1")));
+    EXPECT_FALSE(coalescer.dispatch("onOther", parameters("a", "1")));
+
+    Subscriber subscriber;
+    coalescer.start(subscriber.sender("value"));
+    coalescer.stop();
+    EXPECT_FALSE(coalescer.dispatch("onFocus", parameters("a", "1")));
+    EXPECT_EQ(0u, subscriber.count());
+}
+
+TEST(EventCoalescerTest, eventsWithoutRuleGoOutRightAway)
+{
+    Subscriber subscriber;
+    Plugin::EventCoalescer coalescer;
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onFocus", 0)));
+    coalescer.start(subscriber.sender("value"));
+
+    // a zero window does not hold events back either
+    EXPECT_TRUE(coalescer.dispatch("onOther", parameters("a", "1")));
+    EXPECT_TRUE(coalescer.dispatch("onFocus", parameters("a", "2")));
+    std::vector<std::pair<std::string, std::string>> events = subscriber.events();
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(std::make_pair(std::string("onOther"), std::string("1")), events[0]);
+    EXPECT_EQ(std::make_pair(std::string("onFocus"), std::string("2")), events[1]);
+    coalescer.stop();
+}
+
+TEST(EventCoalescerTest, latestValueWins)
+{
+    Subscriber subscriber;
+    Plugin::EventCoalescer coalescer;
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onFocus", LONG_WINDOW_MS)));
+    coalescer.start(subscriber.sender("value"));
+
+    EXPECT_TRUE(coalescer.dispatch("onFocus", parameters("a", "1")));
+    EXPECT_TRUE(coalescer.dispatch("onFocus", parameters("b", "2")));
+    EXPECT_TRUE(coalescer.dispatch("onFocus", parameters("c", "3")));
+    EXPECT_EQ(0u, subscriber.count());
+    coalescer.stop();
+
+    std::vector<std::pair<std::string, std::string>> events = subscriber.events();
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ("3", events[0].second);
+    JsonObject status;
+    coalescer.toJson(status);
+    EXPECT_EQ("3", status["received"].String());
+    EXPECT_EQ("1", status["sent"].String());
+    EXPECT_EQ("2", status["coalesced"].String());
+    EXPECT_EQ("0", status["pending"].String());
+}
+
+TEST(EventCoalescerTest, heldBackEventGoesOutAfterWindow)
+{
+    Subscriber subscriber;
+    Plugin::EventCoalescer coalescer;
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onFocus", 20)));
+    coalescer.start(subscriber.sender("value"));
+
+    EXPECT_TRUE(coalescer.dispatch("onFocus", parameters("a", "1")));
+    ASSERT_TRUE(waitFor([&]() { return subscriber.count() == 1; }));
+    EXPECT_EQ("1", subscriber.events()[0].second);
+    coalescer.stop();
+    EXPECT_EQ(1u, subscriber.count());
+}
+
+TEST(EventCoalescerTest, keyedEventsAreMergedPerKey)
+{
+    Subscriber subscriber;
+    Plugin::EventCoalescer coalescer;
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onSize", LONG_WINDOW_MS, "client")));
+    coalescer.start(subscriber.sender("value"));
+
+    coalescer.dispatch("onSize", parameters("a", "a1"));
+    coalescer.dispatch("onSize", parameters("b", "b1"));
+    coalescer.dispatch("onSize", parameters("a", "a2"));
+    coalescer.dispatch("onSize", parameters("b", "b2"));
+    coalescer.dispatch("onSize", parameters("a", "a3"));
+    EXPECT_EQ(0u, subscriber.count());
+    JsonObject status;
+    coalescer.toJson(status);
+    EXPECT_EQ("2", status["pending"].String());
+
+    // stopping sends what is held back
+    coalescer.stop();
+    std::vector<std::pair<std::string, std::string>> events = subscriber.events();
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ("a3", events[0].second);
+    EXPECT_EQ("b2", events[1].second);
+}
+
+TEST(EventCoalescerTest, heldBackEventsGoOutBeforeLaterEvents)
+{
+    Subscriber subscriber;
+    Plugin::EventCoalescer coalescer;
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onFocus", LONG_WINDOW_MS)));
+    coalescer.start(subscriber.sender("value"));
+
+    coalescer.dispatch("onFocus", parameters("a", "1"));
+    coalescer.dispatch("onFocus", parameters("b", "2"));
+    coalescer.dispatch("onLaunched", parameters("b", "3"));
+    coalescer.dispatch("onFocus", parameters("c", "4"));
+
+    std::vector<std::pair<std::string, std::string>> events = subscriber.events();
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(std::make_pair(std::string("onFocus"), std::string("2")), events[0]);
+    EXPECT_EQ(std::make_pair(std::string("onLaunched"), std::string("3")), events[1]);
+    coalescer.stop();
+    ASSERT_EQ(3u, subscriber.count());
+    EXPECT_EQ("4", subscriber.events()[2].second);
+}
+
+TEST(EventCoalescerTest, setRulesSendsHeldBackEvents)
+{
+    Subscriber subscriber;
+    Plugin::EventCoalescer coalescer;
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onFocus", LONG_WINDOW_MS)));
+    coalescer.start(subscriber.sender("value"));
+
+    coalescer.dispatch("onFocus", parameters("a", "1"));
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>());
+    ASSERT_EQ(1u, subscriber.count());
+    EXPECT_EQ(0u, coalescer.rules().size());
+
+    // without rules nothing is held back anymore
+    coalescer.dispatch("onFocus", parameters("a", "2"));
+    EXPECT_EQ(2u, subscriber.count());
+    coalescer.stop();
+}
+
+TEST(EventCoalescerTest, eventsOfEachSourceStayInOrder)
+{
+    const int sources = 8;
+    const int eventsPerSource = 500;
+    Subscriber subscriber;
+    Plugin::EventCoalescer coalescer;
+    coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onSize", 1, "client")));
+    coalescer.start(subscriber.sender("value"));
+
+    // every source raises coalesced and plain events while the window expires and the rules change
+    std::vector<std::thread> threads;
+    for (int source = 0; source < sources; source++) {
+        threads.push_back(std::thread([&coalescer, source]() {
+            for (int i = 0; i < eventsPerSource; i++) {
+                char value[32];
+                snprintf(value, sizeof(value), "%02d%06d", source, i);
+                coalescer.dispatch((i % 3 == 0) ? "onLaunched" : "onSize", parameters(std::to_string(source), value));
+            }
+        }));
+    }
+    for (int i = 0; i < 20; i++) {
+        coalescer.setRules(std::vector<Plugin::EventCoalescer::Rule>(1, rule("onSize", 1 + i % 2, "client")));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    coalescer.stop();
+
+    std::map<int, int> last;
+    std::vector<std::pair<std::string, std::string>> events = subscriber.events();
+    for (size_t i = 0; i < events.size(); i++) {
+        int source = std::stoi(events[i].second.substr(0, 2));
+        int sequence = std::stoi(events[i].second.substr(2));
+        if (last.find(source) != last.end()) {
+            EXPECT_GT(sequence, last[source]) << "source " << source;
+        }
+        last[source] = sequence;
+    }
+    // the last event of every source is never coalesced away
+    ASSERT_EQ((size_t)sources, last.size());
+    for (int source = 0; source < sources; source++) {
+        EXPECT_EQ(eventsPerSource - 1, last[source]);
+    }
+}
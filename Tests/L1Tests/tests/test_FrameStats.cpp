@@ -0,0 +1,126 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "FrameStats.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+using namespace WPEFramework;
+
+namespace {
+const double FRAME_BUDGET_US = 16667;
+
+Plugin::FrameStats::Frame frame(double drawUs, double frameUs)
+{
+    Plugin::FrameStats::Frame frame;
+    frame.phaseTime[Plugin::FrameStats::DRAW] = drawUs;
+    frame.phaseTime[Plugin::FrameStats::FRAME] = frameUs;
+    return frame;
+}
+
+JsonObject phase(JsonObject& stats, const char* name)
+{
+    return stats["phases"].Object()[name].Object();
+}
+}
+
+TEST(FrameStatsTest, histogramAndPercentiles)
+{
+    Plugin::FrameStats stats;
+    // 90 frames in the 8..16 ms bucket and 10 missing the deadline in the 33..66 ms bucket
+    for (int i = 0; i < 90; i++) {
+        Plugin::FrameStats::Frame fast = frame(3000, 10000);
+        stats.record(fast, FRAME_BUDGET_US);
+    }
+    for (int i = 0; i < 10; i++) {
+        Plugin::FrameStats::Frame slow = frame(30000, 40000 + i);
+        stats.record(slow, FRAME_BUDGET_US);
+    }
+
+    JsonObject json;
+    stats.toJson(json);
+    EXPECT_EQ(json["frames"].Number(), 100);
+    EXPECT_EQ(json["missedDeadlines"].Number(), 10);
+    JsonObject frames = phase(json, "frame");
+    EXPECT_EQ(frames["count"].Number(), 100);
+    EXPECT_EQ(frames["maxUs"].Number(), 40009);
+    EXPECT_EQ(frames["p50Us"].Number(), 16667);
+    EXPECT_EQ(frames["p99Us"].Number(), 66667);
+    EXPECT_EQ(frames["histogram"].Object()["16ms"].Number(), 90);
+    EXPECT_EQ(frames["histogram"].Object()["66ms"].Number(), 10);
+    EXPECT_EQ(phase(json, "draw")["p50Us"].Number(), 4000);
+    // the screenshot phase only counts frames that took one
+    EXPECT_EQ(phase(json, "screenshot")["count"].Number(), 0);
+}
+
+TEST(FrameStatsTest, slowestFramesAndReset)
+{
+    Plugin::FrameStats stats;
+    for (int i = 0; i < 30; i++) {
+        Plugin::FrameStats::Frame slow = frame(0, 20000 + i * 1000);
+        slow.tasks = i;
+        stats.record(slow, FRAME_BUDGET_US);
+    }
+
+    JsonObject json;
+    stats.toJson(json);
+    JsonArray slowest = json["slowestFrames"].Array();
+    ASSERT_EQ(slowest.Length(), 10);
+    // the ten slowest, slowest first
+    EXPECT_EQ(slowest[0].Object()["frameUs"].Number(), 49000);
+    EXPECT_EQ(slowest[0].Object()["tasks"].Number(), 29);
+    EXPECT_EQ(slowest[9].Object()["frameUs"].Number(), 40000);
+
+    stats.reset();
+    JsonObject cleared;
+    stats.toJson(cleared);
+    EXPECT_EQ(cleared["frames"].Number(), 0);
+    EXPECT_EQ(cleared["slowestFrames"].Array().Length(), 0);
+    EXPECT_EQ(phase(cleared, "frame")["p99Us"].Number(), 0);
+}
+
+TEST(FrameStatsTest, chromeTrace)
+{
+    Plugin::FrameStats stats;
+    Plugin::FrameStats::Frame first = frame(2000, 5000);
+    first.startTime = 1000;
+    first.phaseTime[Plugin::FrameStats::REQUESTS] = 500;
+    stats.record(first, FRAME_BUDGET_US);
+    Plugin::FrameStats::Frame second = frame(3000, 20000);
+    second.startTime = 17667;
+    stats.record(second, FRAME_BUDGET_US);
+
+    const std::string path = "/tmp/FrameStatsTest-" + std::to_string(getpid()) + ".json";
+    ASSERT_TRUE(stats.writeChromeTrace(path));
+    std::ifstream file(path.c_str());
+    std::stringstream trace;
+    trace << file.rdbuf();
+    unlink(path.c_str());
+
+    // phases are laid out back to back from the start of their frame
+    EXPECT_NE(trace.str().find("{\"name\":\"frame 1\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":1000,\"dur\":5000"), std::string::npos);
+    EXPECT_NE(trace.str().find("{\"name\":\"requests\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":1000,\"dur\":500}"), std::string::npos);
+    EXPECT_NE(trace.str().find("{\"name\":\"draw\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":1500,\"dur\":2000}"), std::string::npos);
+    EXPECT_NE(trace.str().find("\"missedDeadline\":true"), std::string::npos);
+    EXPECT_FALSE(stats.writeChromeTrace("/nonexistent/trace.json"));
+}
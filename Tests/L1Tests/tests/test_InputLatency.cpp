@@ -0,0 +1,190 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "InputLatency.h"
+
+#include <string>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+std::vector<std::string> clients(const std::string& first, const std::string& second = "")
+{
+    std::vector<std::string> result(1, first);
+    if (!second.empty()) {
+        result.push_back(second);
+    }
+    return result;
+}
+
+std::string value(JsonObject& stats, const char* name)
+{
+    return stats[name].String();
+}
+
+std::string stageValue(JsonObject& stats, const char* stage, const char* name)
+{
+    return stats["all"].Object()[stage].Object()[name].String();
+}
+
+std::string clientValue(JsonObject& stats, const std::string& client, const char* stage, const char* name)
+{
+    JsonArray all = stats["clients"].Array();
+    for (int i = 0; i < all.Length(); i++) {
+        JsonObject entry = all[i].Object();
+        if (entry["client"].String() == client) {
+            return entry[stage].Object()[name].String();
+        }
+    }
+    return "";
+}
+
+// a key that takes dispatchUs to dispatch and is drawn renderUs later
+void press(Plugin::InputLatency& latency, double& time, double dispatchUs, double renderUs, const std::vector<std::string>& receivers)
+{
+    uint32_t id = latency.keyArrived(time);
+    latency.keyDispatched(id, receivers, true, time + dispatchUs);
+    latency.frameRendered(time + dispatchUs, time + dispatchUs + renderUs);
+    time += 1000000;
+}
+}
+
+TEST(InputLatencyTest, stagesOfOneKey)
+{
+    Plugin::InputLatency latency;
+    uint32_t id = latency.keyArrived(1000);
+    latency.keyDispatched(id, clients("app"), true, 1300);
+    latency.frameRendered(1500, 5500);
+
+    JsonObject stats;
+    latency.toJson(stats);
+    EXPECT_EQ("1", value(stats, "keys"));
+    EXPECT_EQ("1", value(stats, "rendered"));
+    EXPECT_EQ("0", value(stats, "pending"));
+    EXPECT_EQ("300", stageValue(stats, "dispatch", "averageUs"));
+    EXPECT_EQ("4200", stageValue(stats, "render", "averageUs"));
+    EXPECT_EQ("4500", stageValue(stats, "total", "averageUs"));
+    EXPECT_EQ("4500", stageValue(stats, "total", "maxUs"));
+    // percentiles are the upper bound of their bucket
+    EXPECT_EQ("500", stageValue(stats, "dispatch", "p50Us"));
+    EXPECT_EQ("8000", stageValue(stats, "total", "p50Us"));
+    EXPECT_EQ("1", stats["all"].Object()["total"].Object()["histogram"].Object()["8ms"].String());
+    EXPECT_EQ("4500", clientValue(stats, "app", "total", "averageUs"));
+}
+
+TEST(InputLatencyTest, percentiles)
+{
+    Plugin::InputLatency latency;
+    double time = 0;
+    // 90 fast keys, 9 within two frames and one slow one
+    for (int i = 0; i < 90; i++) {
+        press(latency, time, 100, 1400, clients("app"));
+    }
+    for (int i = 0; i < 9; i++) {
+        press(latency, time, 100, 29900, clients("app"));
+    }
+    press(latency, time, 100, 99900, clients("app"));
+
+    JsonObject stats;
+    latency.toJson(stats);
+    EXPECT_EQ("100", value(stats, "rendered"));
+    EXPECT_EQ("2000", stageValue(stats, "total", "p50Us"));
+    EXPECT_EQ("33333", stageValue(stats, "total", "p99Us"));
+    EXPECT_EQ("100000", stageValue(stats, "total", "maxUs"));
+
+    // the last bucket reports the maximum
+    press(latency, time, 100, 499900, clients("app"));
+    press(latency, time, 100, 599900, clients("app"));
+    JsonObject slower;
+    latency.toJson(slower);
+    EXPECT_EQ("600000", stageValue(slower, "total", "p99Us"));
+    EXPECT_EQ("2", slower["all"].Object()["total"].Object()["histogram"].Object()["max"].String());
+}
+
+TEST(InputLatencyTest, statsPerClient)
+{
+    Plugin::InputLatency latency;
+    double time = 0;
+    press(latency, time, 100, 900, clients("first"));
+    press(latency, time, 100, 9900, clients("first", "second"));
+
+    JsonObject stats;
+    latency.toJson(stats);
+    EXPECT_EQ("2", clientValue(stats, "first", "total", "count"));
+    EXPECT_EQ("5500", clientValue(stats, "first", "total", "averageUs"));
+    EXPECT_EQ("1", clientValue(stats, "second", "total", "count"));
+    EXPECT_EQ("10000", clientValue(stats, "second", "total", "averageUs"));
+    EXPECT_EQ("2", stageValue(stats, "total", "count"));
+}
+
+TEST(InputLatencyTest, keysDispatchedDuringDrawWaitForNextFrame)
+{
+    Plugin::InputLatency latency;
+    uint32_t id = latency.keyArrived(1000);
+    latency.keyDispatched(id, clients("app"), true, 2000);
+    latency.frameRendered(1500, 3000);
+    JsonObject stats;
+    latency.toJson(stats);
+    EXPECT_EQ("0", value(stats, "rendered"));
+    EXPECT_EQ("1", value(stats, "pending"));
+
+    latency.frameRendered(3000, 4000);
+    JsonObject after;
+    latency.toJson(after);
+    EXPECT_EQ("1", value(after, "rendered"));
+    EXPECT_EQ("3000", stageValue(after, "total", "averageUs"));
+}
+
+TEST(InputLatencyTest, failedAndDroppedKeys)
+{
+    Plugin::InputLatency latency;
+    uint32_t failed = latency.keyArrived(0);
+    latency.keyDispatched(failed, clients("app"), false, 10);
+    // keys that never get dispatched are dropped once too many are pending
+    for (int i = 0; i < 300; i++) {
+        latency.keyArrived(i);
+    }
+    latency.frameRendered(1000, 2000);
+
+    JsonObject stats;
+    latency.toJson(stats);
+    EXPECT_EQ("301", value(stats, "keys"));
+    EXPECT_EQ("1", value(stats, "failed"));
+    EXPECT_EQ("44", value(stats, "dropped"));
+    EXPECT_EQ("256", value(stats, "pending"));
+    EXPECT_EQ("0", value(stats, "rendered"));
+    EXPECT_EQ("0", stageValue(stats, "total", "p99Us"));
+}
+
+TEST(InputLatencyTest, reset)
+{
+    Plugin::InputLatency latency;
+    double time = 0;
+    press(latency, time, 100, 900, clients("app"));
+    latency.reset();
+
+    JsonObject stats;
+    latency.toJson(stats);
+    EXPECT_EQ("0", value(stats, "keys"));
+    EXPECT_EQ("0", value(stats, "rendered"));
+    EXPECT_EQ("0", stageValue(stats, "total", "count"));
+    EXPECT_EQ(0, stats["clients"].Array().Length());
+}
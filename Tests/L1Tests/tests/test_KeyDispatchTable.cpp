@@ -0,0 +1,148 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "KeyDispatchTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+// the modifier flags are only compared by the table
+const uint32_t FLAGS_SHIFT = 8;
+}
+
+TEST(KeyDispatchTableTest, lookup)
+{
+    Plugin::KeyDispatchTable table;
+    std::vector<Plugin::KeyDispatchTable::Registration> registrations(3);
+    registrations[0].type = Plugin::KeyDispatchTable::INTERCEPT;
+    registrations[0].client = "ResidentApp";
+    registrations[0].keyCode = 36;
+    registrations[1].client = "org.rdk.Netflix";
+    registrations[1].keyCode = 36;
+    registrations[1].flags = FLAGS_SHIFT;
+    registrations[2].client = "searchanddiscovery";
+    registrations[2].keyCode = Plugin::KeyDispatchTable::ANY_KEY_CODE;
+    registrations[2].flags = FLAGS_SHIFT;
+    table.add(registrations);
+
+    Plugin::KeyDispatchTable::Route route;
+    table.lookup(Plugin::KeyDispatchTable::KEY_LISTENER, 36, 0, route);
+    EXPECT_EQ(route.intercepts, std::vector<std::string>(1, "ResidentApp"));
+    EXPECT_TRUE(route.listeners.empty());
+    table.lookup(Plugin::KeyDispatchTable::KEY_LISTENER, 36, FLAGS_SHIFT, route);
+    ASSERT_EQ(route.listeners.size(), 2u);
+    EXPECT_EQ(route.listeners[0].client, std::string("org.rdk.Netflix"));
+    EXPECT_EQ(route.listeners[1].client, std::string("searchanddiscovery"));
+
+    table.removeClient("org.rdk.Netflix");
+    table.lookup(Plugin::KeyDispatchTable::KEY_LISTENER, 36, FLAGS_SHIFT, route);
+    ASSERT_EQ(route.listeners.size(), 1u);
+    EXPECT_EQ(route.listeners[0].client, std::string("searchanddiscovery"));
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(KeyDispatchTableTest, removeRegistrations)
+{
+    Plugin::KeyDispatchTable table;
+    std::vector<Plugin::KeyDispatchTable::Registration> registrations(2);
+    registrations[0].client = "org.rdk.Netflix";
+    registrations[0].keyCode = 36;
+    registrations[1].type = Plugin::KeyDispatchTable::NATIVE_KEY_LISTENER;
+    registrations[1].client = "org.rdk.Netflix";
+    registrations[1].keyCode = 36;
+    table.add(registrations);
+    EXPECT_TRUE(table.contains(registrations[0]));
+
+    // key listeners and native key listeners of the same key are kept apart
+    table.remove(std::vector<Plugin::KeyDispatchTable::Registration>(1, registrations[0]));
+    EXPECT_FALSE(table.contains(registrations[0]));
+    EXPECT_TRUE(table.contains(registrations[1]));
+    Plugin::KeyDispatchTable::Route route;
+    table.lookup(Plugin::KeyDispatchTable::KEY_LISTENER, 36, 0, route);
+    EXPECT_TRUE(route.listeners.empty());
+    table.lookup(Plugin::KeyDispatchTable::NATIVE_KEY_LISTENER, 36, 0, route);
+    ASSERT_EQ(route.listeners.size(), 1u);
+
+    table.removeClient("org.rdk.Netflix");
+    EXPECT_EQ(table.size(), 0u);
+}
+
+// replays a remote control key stream against the registrations of a device with many apps
+// and prints the time to find the clients of each key, the way keyTargets() collects them
+TEST(KeyDispatchTableTest, keyReplayBenchmark)
+{
+    const int clientCount = 64;
+    const int keyCount = 20000;
+    const uint32_t keyCodes[] = { 13, 27, 37, 38, 39, 40, 48, 49, 50, 51, 112, 113, 114, 115, 173, 174, 175, 179, 227, 228 };
+    const size_t keyCodeCount = sizeof(keyCodes) / sizeof(keyCodes[0]);
+
+    Plugin::KeyDispatchTable table;
+    std::vector<Plugin::KeyDispatchTable::Registration> registrations;
+    for (int i = 0; i < clientCount; i++) {
+        const std::string client = "app" + std::to_string(i);
+        for (size_t k = 0; k < 4; k++) {
+            Plugin::KeyDispatchTable::Registration registration;
+            registration.type = (i % 8 == 0) ? Plugin::KeyDispatchTable::INTERCEPT : Plugin::KeyDispatchTable::KEY_LISTENER;
+            registration.client = client;
+            registration.keyCode = keyCodes[(i + k * 5) % keyCodeCount];
+            registration.flags = (k == 3) ? FLAGS_SHIFT : 0;
+            registrations.push_back(registration);
+        }
+        if (i % 16 == 0) {
+            Plugin::KeyDispatchTable::Registration registration;
+            registration.client = client;
+            registration.keyCode = Plugin::KeyDispatchTable::ANY_KEY_CODE;
+            registrations.push_back(registration);
+        }
+    }
+    table.add(registrations);
+
+    std::vector<double> lookupUs;
+    lookupUs.reserve(keyCount);
+    size_t delivered = 0;
+    for (int i = 0; i < keyCount; i++) {
+        const uint32_t keyCode = keyCodes[(i * 7) % keyCodeCount];
+        const uint32_t flags = (i % 10 == 0) ? FLAGS_SHIFT : 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Plugin::KeyDispatchTable::Route route;
+        table.lookup(Plugin::KeyDispatchTable::KEY_LISTENER, keyCode, flags, route);
+        std::vector<std::string> clients(route.intercepts);
+        for (size_t l = 0; l < route.listeners.size(); l++) {
+            clients.push_back(route.listeners[l].client);
+        }
+        lookupUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        delivered += clients.size();
+    }
+
+    std::sort(lookupUs.begin(), lookupUs.end());
+    std::cout << "key lookup over " << keyCount << " keys with " << clientCount << " clients and "
+              << registrations.size() << " registrations: p50 " << lookupUs[lookupUs.size() / 2]
+              << " us, p99 " << lookupUs[lookupUs.size() * 99 / 100] << " us, "
+              << delivered << " deliveries" << std::endl;
+    EXPECT_EQ(table.size(), registrations.size());
+    EXPECT_GT(delivered, 0u);
+}
@@ -0,0 +1,142 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "LaunchTracer.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+using namespace WPEFramework;
+
+TEST(LaunchTracerTest, phasesInOrder)
+{
+    Plugin::LaunchTracer tracer;
+    {
+        Plugin::LaunchTracer::Session session(tracer, "org.rdk.Netflix", "launch");
+        session.phase("activate");
+        session.phase("createDisplay");
+        session.finish(true, "create");
+    }
+
+    JsonObject trace;
+    ASSERT_TRUE(tracer.latestToJson("org.rdk.Netflix", trace));
+    EXPECT_EQ(trace["id"].Number(), 1);
+    EXPECT_EQ(trace["operation"].String(), std::string("launch"));
+    EXPECT_EQ(trace["launchType"].String(), std::string("create"));
+    EXPECT_TRUE(trace["success"].Boolean());
+    EXPECT_FALSE(trace["pending"].Boolean());
+    JsonArray phases = trace["phases"].Array();
+    ASSERT_EQ(phases.Length(), 2);
+    EXPECT_EQ(phases[0].Object()["name"].String(), std::string("activate"));
+    EXPECT_EQ(phases[1].Object()["name"].String(), std::string("createDisplay"));
+    // phases are back to back and inside the trace
+    EXPECT_EQ(phases[0].Object()["offsetUs"].Number() + phases[0].Object()["durationUs"].Number(), phases[1].Object()["offsetUs"].Number());
+    EXPECT_LE(phases[1].Object()["offsetUs"].Number() + phases[1].Object()["durationUs"].Number(), trace["durationUs"].Number());
+    EXPECT_FALSE(tracer.latestToJson("org.rdk.YouTube", trace));
+}
+
+TEST(LaunchTracerTest, unfinishedSessionFails)
+{
+    Plugin::LaunchTracer tracer;
+    {
+        Plugin::LaunchTracer::Session session(tracer, "ResidentApp", "suspend");
+        session.phase("suspend");
+    }
+    JsonObject trace;
+    ASSERT_TRUE(tracer.latestToJson("ResidentApp", trace));
+    EXPECT_FALSE(trace["success"].Boolean());
+    EXPECT_EQ(trace["phases"].Array().Length(), 1);
+
+    // sessions without a client are not stored
+    {
+        Plugin::LaunchTracer::Session session(tracer, "", "launch");
+        session.finish(true);
+    }
+    JsonArray traces;
+    tracer.toJson("", traces);
+    EXPECT_EQ(traces.Length(), 1);
+}
+
+TEST(LaunchTracerTest, completePending)
+{
+    Plugin::LaunchTracer tracer;
+    {
+        Plugin::LaunchTracer::Session session(tracer, "org.rdk.Netflix", "launch");
+        session.phase("activate");
+        session.finish(true, "create", true);
+    }
+    JsonObject pending;
+    ASSERT_TRUE(tracer.latestToJson("org.rdk.Netflix", pending));
+    EXPECT_TRUE(pending["pending"].Boolean());
+
+    EXPECT_TRUE(tracer.completePending("org.rdk.Netflix", "firstFrame"));
+    EXPECT_FALSE(tracer.completePending("org.rdk.Netflix", "firstFrame"));
+    JsonObject completed;
+    ASSERT_TRUE(tracer.latestToJson("org.rdk.Netflix", completed));
+    EXPECT_FALSE(completed["pending"].Boolean());
+    JsonArray phases = completed["phases"].Array();
+    ASSERT_EQ(phases.Length(), 2);
+    EXPECT_EQ(phases[1].Object()["name"].String(), std::string("firstFrame"));
+    EXPECT_EQ(phases[1].Object()["offsetUs"].Number(), pending["durationUs"].Number());
+    EXPECT_EQ(completed["durationUs"].Number(), pending["durationUs"].Number() + phases[1].Object()["durationUs"].Number());
+
+    // failed requests never wait for completion
+    {
+        Plugin::LaunchTracer::Session session(tracer, "org.rdk.YouTube", "launch");
+        session.finish(false, "create", true);
+    }
+    EXPECT_FALSE(tracer.completePending("org.rdk.YouTube", "firstFrame"));
+}
+
+TEST(LaunchTracerTest, boundedHistory)
+{
+    Plugin::LaunchTracer tracer;
+    for (int i = 0; i < 12; i++) {
+        Plugin::LaunchTracer::Session session(tracer, "org.rdk.Netflix", "launch");
+        session.finish(true);
+    }
+    JsonArray traces;
+    tracer.toJson("org.rdk.Netflix", traces);
+    ASSERT_EQ(traces.Length(), 8);
+    EXPECT_EQ(traces[0].Object()["id"].Number(), 5);
+    EXPECT_EQ(traces[7].Object()["id"].Number(), 12);
+
+    // the client that has been quiet the longest is dropped past 64 clients
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    for (int i = 0; i < 64; i++) {
+        char client[16];
+        snprintf(client, sizeof(client), "app%02d", i);
+        Plugin::LaunchTracer::Session session(tracer, client, "launch");
+        session.finish(true);
+    }
+    JsonObject trace;
+    EXPECT_FALSE(tracer.latestToJson("org.rdk.Netflix", trace));
+    EXPECT_TRUE(tracer.latestToJson("app00", trace));
+    EXPECT_TRUE(tracer.latestToJson("app63", trace));
+
+    tracer.clear("app00");
+    EXPECT_FALSE(tracer.latestToJson("app00", trace));
+    tracer.clear("");
+    JsonArray cleared;
+    tracer.toJson("", cleared);
+    EXPECT_EQ(cleared.Length(), 0);
+}
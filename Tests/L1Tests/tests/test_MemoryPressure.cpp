@@ -0,0 +1,287 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "MemoryPressure.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+typedef Plugin::MemoryPressureManager Manager;
+typedef std::map<std::string, std::pair<Manager::Action, uint64_t>> Applied;
+
+Manager::Candidate candidate(const std::string& callsign, uint64_t lastUsed, int32_t ram = 1000, bool suspended = false)
+{
+    Manager::Candidate result;
+    result.callsign = callsign;
+    result.lastUsed = lastUsed;
+    result.ram = ram;
+    result.suspended = suspended;
+    return result;
+}
+
+// defaults: suspend at 10%, hibernate at 20%, destroy at 40%, 5 points hysteresis
+Manager::Config config(bool hibernateSupported = true)
+{
+    Manager::Config result;
+    result.hibernateSupported = hibernateSupported;
+    return result;
+}
+
+std::string select(const Manager::Config& config, Manager::Action level, const std::vector<Manager::Candidate>& candidates,
+    const Applied& applied, Manager::Action& action)
+{
+    std::string callsign;
+    action = Manager::NONE;
+    if (!Manager::selectVictim(config, level, candidates, applied, callsign, action)) {
+        return "";
+    }
+    return callsign;
+}
+}
+
+TEST(MemoryPressureTest, pressureLevelThresholds)
+{
+    Manager::Config settings = config();
+    EXPECT_EQ(Manager::NONE, Manager::pressureLevel(settings, 0, Manager::NONE));
+    EXPECT_EQ(Manager::NONE, Manager::pressureLevel(settings, 9.99, Manager::NONE));
+    EXPECT_EQ(Manager::SUSPEND, Manager::pressureLevel(settings, 10, Manager::NONE));
+    EXPECT_EQ(Manager::HIBERNATE, Manager::pressureLevel(settings, 20, Manager::NONE));
+    EXPECT_EQ(Manager::HIBERNATE, Manager::pressureLevel(settings, 39.9, Manager::NONE));
+    EXPECT_EQ(Manager::DESTROY, Manager::pressureLevel(settings, 40, Manager::NONE));
+    EXPECT_EQ(Manager::DESTROY, Manager::pressureLevel(settings, 100, Manager::NONE));
+}
+
+TEST(MemoryPressureTest, pressureLevelHysteresis)
+{
+    Manager::Config settings = config();
+    // a level is kept until the average drops the hysteresis below its threshold
+    EXPECT_EQ(Manager::SUSPEND, Manager::pressureLevel(settings, 5, Manager::SUSPEND));
+    EXPECT_EQ(Manager::NONE, Manager::pressureLevel(settings, 4.9, Manager::SUSPEND));
+    EXPECT_EQ(Manager::DESTROY, Manager::pressureLevel(settings, 35, Manager::DESTROY));
+    EXPECT_EQ(Manager::HIBERNATE, Manager::pressureLevel(settings, 34.9, Manager::DESTROY));
+    EXPECT_EQ(Manager::HIBERNATE, Manager::pressureLevel(settings, 15, Manager::DESTROY));
+    EXPECT_EQ(Manager::SUSPEND, Manager::pressureLevel(settings, 14.9, Manager::DESTROY));
+    // levels above the current one still need their full threshold
+    EXPECT_EQ(Manager::SUSPEND, Manager::pressureLevel(settings, 19.9, Manager::SUSPEND));
+    EXPECT_EQ(Manager::HIBERNATE, Manager::pressureLevel(settings, 39.9, Manager::HIBERNATE));
+}
+
+TEST(MemoryPressureTest, selectVictimNothingWithoutPressure)
+{
+    std::vector<Manager::Candidate> candidates;
+    candidates.push_back(candidate("a", 1));
+    Manager::Action action;
+    EXPECT_EQ("", select(config(), Manager::NONE, candidates, Applied(), action));
+    EXPECT_EQ("", select(config(), Manager::DESTROY, std::vector<Manager::Candidate>(), Applied(), action));
+}
+
+TEST(MemoryPressureTest, selectVictimLeastRecentlyUsedFirst)
+{
+    std::vector<Manager::Candidate> candidates;
+    candidates.push_back(candidate("recent", 300));
+    candidates.push_back(candidate("oldest", 100));
+    candidates.push_back(candidate("older", 200));
+    Manager::Action action;
+    EXPECT_EQ("oldest", select(config(), Manager::SUSPEND, candidates, Applied(), action));
+    EXPECT_EQ(Manager::SUSPEND, action);
+}
+
+TEST(MemoryPressureTest, selectVictimPriorities)
+{
+    Manager::Config settings = config();
+    settings.priorities.push_back("kept");
+    settings.priorities.push_back("listed");
+
+    std::vector<Manager::Candidate> candidates;
+    candidates.push_back(candidate("kept", 1));
+    candidates.push_back(candidate("listed", 2));
+    candidates.push_back(candidate("unlisted", 3));
+    Manager::Action action;
+    // unlisted apps go first, even if used more recently
+    EXPECT_EQ("unlisted", select(settings, Manager::SUSPEND, candidates, Applied(), action));
+
+    // then the listed ones from the end of the list
+    candidates.pop_back();
+    EXPECT_EQ("listed", select(settings, Manager::SUSPEND, candidates, Applied(), action));
+    candidates.pop_back();
+    EXPECT_EQ("kept", select(settings, Manager::SUSPEND, candidates, Applied(), action));
+}
+
+TEST(MemoryPressureTest, selectVictimEscalates)
+{
+    std::vector<Manager::Candidate> candidates;
+    candidates.push_back(candidate("a", 100));
+    candidates.push_back(candidate("b", 200));
+    Applied applied;
+    Manager::Action action;
+
+    // suspend level only suspends, once every app is suspended nothing is left to do
+    applied["a"] = std::make_pair(Manager::SUSPEND, 150);
+    EXPECT_EQ("b", select(config(), Manager::SUSPEND, candidates, applied, action));
+    EXPECT_EQ(Manager::SUSPEND, action);
+    applied["b"] = std::make_pair(Manager::SUSPEND, 250);
+    EXPECT_EQ("", select(config(), Manager::SUSPEND, candidates, applied, action));
+
+    // a higher level takes the next step on the least recently used app
+    EXPECT_EQ("a", select(config(), Manager::HIBERNATE, candidates, applied, action));
+    EXPECT_EQ(Manager::HIBERNATE, action);
+    EXPECT_EQ("a", select(config(), Manager::DESTROY, candidates, applied, action));
+    EXPECT_EQ(Manager::HIBERNATE, action);
+
+    applied["a"] = std::make_pair(Manager::HIBERNATE, 150);
+    EXPECT_EQ("b", select(config(), Manager::HIBERNATE, candidates, applied, action));
+    EXPECT_EQ(Manager::HIBERNATE, action);
+    EXPECT_EQ("a", select(config(), Manager::DESTROY, candidates, applied, action));
+    EXPECT_EQ(Manager::DESTROY, action);
+
+    // destroyed apps are not picked again
+    applied["a"] = std::make_pair(Manager::DESTROY, 150);
+    EXPECT_EQ("b", select(config(), Manager::DESTROY, candidates, applied, action));
+    EXPECT_EQ(Manager::HIBERNATE, action);
+}
+
+TEST(MemoryPressureTest, selectVictimWithoutHibernation)
+{
+    std::vector<Manager::Candidate> candidates;
+    candidates.push_back(candidate("a", 100, 1000, true));
+    Manager::Action action;
+    // already suspended apps skip the suspend step
+    EXPECT_EQ("", select(config(false), Manager::SUSPEND, candidates, Applied(), action));
+    EXPECT_EQ("", select(config(false), Manager::HIBERNATE, candidates, Applied(), action));
+    EXPECT_EQ("a", select(config(false), Manager::DESTROY, candidates, Applied(), action));
+    EXPECT_EQ(Manager::DESTROY, action);
+    EXPECT_EQ("a", select(config(true), Manager::HIBERNATE, candidates, Applied(), action));
+    EXPECT_EQ(Manager::HIBERNATE, action);
+}
+
+TEST(MemoryPressureTest, selectVictimStaleActionsStartOver)
+{
+    std::vector<Manager::Candidate> candidates;
+    candidates.push_back(candidate("a", 500));
+    Applied applied;
+    // used again after it was destroyed, the app is a fresh candidate
+    applied["a"] = std::make_pair(Manager::DESTROY, 400);
+    Manager::Action action;
+    EXPECT_EQ("a", select(config(), Manager::SUSPEND, candidates, applied, action));
+    EXPECT_EQ(Manager::SUSPEND, action);
+}
+
+TEST(MemoryPressureTest, selectVictimAppRamLimit)
+{
+    Manager::Config settings = config();
+    settings.appRamLimit = 50000;
+    std::vector<Manager::Candidate> candidates;
+    candidates.push_back(candidate("small", 100, 10000));
+    candidates.push_back(candidate("large", 200, 80000));
+    Manager::Action action;
+
+    // no pressure, only the app over the limit is acted on
+    EXPECT_EQ("large", select(settings, Manager::NONE, candidates, Applied(), action));
+    EXPECT_EQ(Manager::SUSPEND, action);
+    Applied applied;
+    applied["large"] = std::make_pair(Manager::SUSPEND, 250);
+    EXPECT_EQ("large", select(settings, Manager::NONE, candidates, applied, action));
+    EXPECT_EQ(Manager::HIBERNATE, action);
+    applied["large"] = std::make_pair(Manager::HIBERNATE, 250);
+    EXPECT_EQ("", select(settings, Manager::NONE, candidates, applied, action));
+
+    // suspending keeps the memory, without hibernation the app is destroyed
+    settings.hibernateSupported = false;
+    applied["large"] = std::make_pair(Manager::SUSPEND, 250);
+    EXPECT_EQ("large", select(settings, Manager::NONE, candidates, applied, action));
+    EXPECT_EQ(Manager::DESTROY, action);
+}
+
+TEST(MemoryPressureTest, readPressure)
+{
+    const std::string path = "/tmp/rdkshell_test_pressure";
+    {
+        std::ofstream file(path.c_str());
+        file << "some avg10=12.50 avg60=3.00 avg300=1.00 total=1234" << std::endl;
+        file << "full avg10=4.25 avg60=1.00 avg300=0.50 total=567" << std::endl;
+    }
+    double someAvg10 = 0;
+    double fullAvg10 = 0;
+    EXPECT_TRUE(Manager::readPressure(path, someAvg10, fullAvg10));
+    EXPECT_DOUBLE_EQ(12.5, someAvg10);
+    EXPECT_DOUBLE_EQ(4.25, fullAvg10);
+
+    {
+        std::ofstream file(path.c_str());
+        file << "garbage" << std::endl;
+    }
+    EXPECT_FALSE(Manager::readPressure(path, someAvg10, fullAvg10));
+    std::remove(path.c_str());
+    EXPECT_FALSE(Manager::readPressure(path, someAvg10, fullAvg10));
+}
+
+TEST(MemoryPressureTest, warningLevelActsOncePerSettleTime)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::pair<std::string, Manager::Action>> actions;
+
+    Manager manager;
+    Manager::Config settings = config();
+    settings.enabled = true;
+    settings.interval = 10;
+    manager.configure(settings);
+    manager.start(
+        []() {
+            std::vector<Manager::Candidate> candidates;
+            candidates.push_back(candidate("b", 200));
+            candidates.push_back(candidate("a", 100));
+            return candidates;
+        },
+        [&](const std::string& callsign, Manager::Action action) {
+            std::lock_guard<std::mutex> lock(mutex);
+            actions.push_back(std::make_pair(callsign, action));
+            condition.notify_all();
+            return true;
+        });
+
+    manager.setWarningLevel(Manager::HIBERNATE);
+    EXPECT_EQ(Manager::HIBERNATE, manager.level());
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(condition.wait_for(lock, std::chrono::seconds(5), [&]() { return !actions.empty(); }));
+    }
+    // the next action has to wait for the PSI average to settle
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    manager.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(1u, actions.size());
+    EXPECT_EQ("a", actions[0].first);
+    // apps are taken one step at a time
+    EXPECT_EQ(Manager::SUSPEND, actions[0].second);
+    EXPECT_EQ(Manager::NONE, manager.level());
+}
@@ -162,6 +162,23 @@ TEST_F(RDKShellTest, RegisteredMethods){
     EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("launchFactoryApp")));
     EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("launchFactoryAppShortcut")));
     EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("enableInputEvents")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getFrameStats")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getLaunchTimings")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getRequestQueueStats")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("applyTransaction")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("setMemoryPressurePolicy")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getMemoryPressureStatus")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("setWarmPoolConfig")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getWarmPoolStatus")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("setEventCoalescing")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getEventCoalescing")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getKeyRoute")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getInputLatency")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("addAnimationTimeline")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getStartupTimeline")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getTeardownReport")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getRialtoStats")));
+    EXPECT_EQ(Core::ERROR_NONE, handler.Exists(_T("getTimerStats")));
     }
 TEST_F(RDKShellTest, enableInputEvents)
 {
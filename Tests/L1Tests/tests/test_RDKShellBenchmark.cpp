@@ -0,0 +1,342 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2024 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "RDKShell.h"
+#include "rdkshell.h"
+#include "rdkshellmock.h"
+#include "ServiceMock.h"
+#include "FactoriesImplementation.h"
+#include "ThunderPortability.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef USE_THUNDER_R4
+
+using namespace WPEFramework;
+
+namespace {
+
+// the plugin of every benchmark app, launch sets its state and url through the dispatcher
+class BenchmarkApp : public PluginHost::IPlugin, public PluginHost::JSONRPC {
+public:
+    BenchmarkApp()
+    {
+        Register<Core::JSON::String, void>(_T("state"), &BenchmarkApp::setProperty, this);
+        Register<Core::JSON::String, void>(_T("url"), &BenchmarkApp::setProperty, this);
+    }
+
+    const string Initialize(PluginHost::IShell* service) override
+    {
+        return string();
+    }
+    void Deinitialize(PluginHost::IShell* service) override
+    {
+    }
+    string Information() const override
+    {
+        return string();
+    }
+
+    BEGIN_INTERFACE_MAP(BenchmarkApp)
+    INTERFACE_ENTRY(PluginHost::IPlugin)
+    INTERFACE_ENTRY(PluginHost::IDispatcher)
+    END_INTERFACE_MAP
+
+private:
+    uint32_t setProperty(const Core::JSON::String& value)
+    {
+        return Core::ERROR_NONE;
+    }
+};
+
+}
+
+// Headless benchmark of the RDKShell JSON-RPC api. The compositor is a mock that answers
+// immediately and the plugin is initialized against a mocked service whose apps are already
+// activated, so the numbers are the cost of RDKShell itself: parsing, locking and the
+// bookkeeping around every call, launch included. Concurrent clients invoke a weighted mix of
+// methods and the results are written as JSON, to RDKSHELL_BENCHMARK_OUTPUT when set, so runs
+// can be diffed.
+// RDKSHELL_BENCHMARK_CLIENTS and RDKSHELL_BENCHMARK_CALLS change the load.
+class RDKShellBenchmark : public ::testing::Test {
+protected:
+    Core::ProxyType<Plugin::RDKShell> plugin;
+    Core::JSONRPC::Handler& handler;
+    RDKShellImplMock      *p_rdkShellImplMock     = nullptr ;
+    CompositorImplMock    *p_compositorImplMock   = nullptr ;
+    RdkShellApiImplMock   *p_rdkShellApiImplMock  = nullptr ;
+    testing::NiceMock<ServiceMock> service;
+    testing::NiceMock<ServiceMock> appShell;
+    testing::NiceMock<FactoriesImplementation> factoriesImplementation;
+    Core::ProxyType<BenchmarkApp> app;
+
+    RDKShellBenchmark()
+        : plugin(Core::ProxyType<Plugin::RDKShell>::Create())
+        , handler(*(plugin))
+        , app(Core::ProxyType<BenchmarkApp>::Create())
+    {
+        p_rdkShellApiImplMock  = new testing::NiceMock <RdkShellApiImplMock>;
+        RdkShell::RdkShellApi::setImpl(p_rdkShellApiImplMock);
+
+        p_compositorImplMock  = new testing::NiceMock <CompositorImplMock>;
+        RdkShell::CompositorController::setImpl(p_compositorImplMock);
+
+        p_rdkShellImplMock  = new testing::NiceMock <RDKShellImplMock>;
+        RDKShell::setImpl(p_rdkShellImplMock);
+
+        // the direct links launch uses to set the app state build their messages from the factories
+        PluginHost::IFactories::Assign(&factoriesImplementation);
+        stubService();
+        EXPECT_EQ(string(""), plugin->Initialize(&service));
+    }
+    virtual ~RDKShellBenchmark()
+    {
+        plugin->Deinitialize(&service);
+        PluginHost::IFactories::Assign(nullptr);
+
+        RdkShell::RdkShellApi::setImpl(nullptr);
+        delete p_rdkShellApiImplMock;
+        RDKShell::setImpl(nullptr);
+        delete p_rdkShellImplMock;
+        RdkShell::CompositorController::setImpl(nullptr);
+        delete p_compositorImplMock;
+    }
+
+    // every benchmark app is an activated plugin, other callsigns are unavailable
+    void stubService()
+    {
+        using ::testing::_;
+        ON_CALL(service, QueryInterfaceByCallsign(_, _))
+            .WillByDefault(::testing::Invoke([this](const uint32_t id, const string& name) -> void* {
+                if (name.compare(0, 12, "benchmarkapp") != 0) {
+                    return nullptr;
+                }
+                if (id == PluginHost::IShell::ID) {
+                    return static_cast<PluginHost::IShell*>(&appShell);
+                }
+                return app->QueryInterface(id);
+            }));
+        ON_CALL(appShell, State()).WillByDefault(::testing::Return(PluginHost::IShell::state::ACTIVATED));
+    }
+
+    void stubCompositor(const std::vector<std::string>& apps)
+    {
+        using ::testing::_;
+        ON_CALL(*p_compositorImplMock, getClients(_))
+            .WillByDefault(::testing::Invoke([apps](std::vector<std::string>& clients) {
+                clients = apps;
+                return true;
+            }));
+        ON_CALL(*p_compositorImplMock, launchApplication(_, _, _, _, _)).WillByDefault(::testing::Return(true));
+        ON_CALL(*p_compositorImplMock, setFocus(_)).WillByDefault(::testing::Return(true));
+        ON_CALL(*p_compositorImplMock, setVisibility(_, _)).WillByDefault(::testing::Return(true));
+        ON_CALL(*p_compositorImplMock, getVisibility(_, _))
+            .WillByDefault(::testing::Invoke([](const std::string& client, bool& visible) {
+                visible = true;
+                return true;
+            }));
+        ON_CALL(*p_compositorImplMock, moveToFront(_)).WillByDefault(::testing::Return(true));
+        ON_CALL(*p_compositorImplMock, setBounds(_, _, _, _, _)).WillByDefault(::testing::Return(true));
+        ON_CALL(*p_compositorImplMock, getBounds(_, _, _, _, _))
+            .WillByDefault(::testing::Invoke([](const std::string& client, uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) {
+                x = 0;
+                y = 0;
+                width = 1920;
+                height = 1080;
+                return true;
+            }));
+        ON_CALL(*p_compositorImplMock, getZOrder(_))
+            .WillByDefault(::testing::Invoke([apps](std::vector<std::string>& clients) {
+                clients = apps;
+                return true;
+            }));
+    }
+};
+
+namespace {
+
+struct BenchmarkClient {
+    DECL_CORE_JSONRPC_CONX connection;
+
+    explicit BenchmarkClient(uint32_t id)
+        : INIT_CONX(id, 0)
+    {
+    }
+};
+
+struct BenchmarkMethod {
+    const char* name;
+    // relative share of the calls
+    uint32_t weight;
+};
+
+const BenchmarkMethod benchmarkMethods[] = {
+    { "launch", 4 },
+    { "launchApplication", 4 },
+    { "setFocus", 16 },
+    { "setVisibility", 16 },
+    { "getVisibility", 12 },
+    { "getClients", 20 },
+    { "getZOrder", 8 },
+    { "moveToFront", 8 },
+    // sleeps RDKSHELL_BOUNDS_SETTLE_TIME_IN_US after every call, kept rare so it does not dominate
+    { "setBounds", 2 },
+    { "getBounds", 8 }
+};
+const size_t benchmarkMethodCount = sizeof(benchmarkMethods) / sizeof(benchmarkMethods[0]);
+
+std::string benchmarkParameters(const std::string& method, const std::string& app)
+{
+    if (method == "launch") {
+        return "{\"callsign\":\"" + app + "\",\"uri\":\"http://localhost/" + app + "\"}";
+    } else if (method == "launchApplication") {
+        return "{\"client\":\"" + app + "\",\"uri\":\"/usr/bin/" + app + "\",\"mimeType\":\"application/native\"}";
+    } else if (method == "setVisibility") {
+        return "{\"client\":\"" + app + "\",\"visible\":true}";
+    } else if (method == "setBounds") {
+        return "{\"client\":\"" + app + "\",\"x\":0,\"y\":0,\"w\":1280,\"h\":720}";
+    } else if ((method == "getClients") || (method == "getZOrder")) {
+        return "{}";
+    }
+    return "{\"client\":\"" + app + "\"}";
+}
+
+uint32_t benchmarkSetting(const char* name, uint32_t defaultValue)
+{
+    const char* value = getenv(name);
+    return ((value != nullptr) && (atoi(value) > 0)) ? atoi(value) : defaultValue;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(fraction * sorted.size());
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+}
+
+TEST_F(RDKShellBenchmark, mixedApiCalls)
+{
+    const uint32_t clientCount = benchmarkSetting("RDKSHELL_BENCHMARK_CLIENTS", 8);
+    const uint32_t callCount = benchmarkSetting("RDKSHELL_BENCHMARK_CALLS", 8000);
+
+    std::vector<std::string> apps;
+    for (int i = 0; i < 16; i++) {
+        apps.push_back("benchmarkapp" + std::to_string(i));
+    }
+    stubCompositor(apps);
+
+    uint32_t totalWeight = 0;
+    for (size_t m = 0; m < benchmarkMethodCount; m++) {
+        totalWeight += benchmarkMethods[m].weight;
+    }
+
+    // per client and method durations in microseconds, merged after the run
+    std::vector<std::vector<std::vector<double>>> durations(clientCount, std::vector<std::vector<double>>(benchmarkMethodCount));
+    std::vector<std::vector<uint32_t>> errors(clientCount, std::vector<uint32_t>(benchmarkMethodCount, 0));
+    std::atomic<uint32_t> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> clients;
+    for (uint32_t c = 0; c < clientCount; c++) {
+        clients.push_back(std::thread([&, c]() {
+            BenchmarkClient client(c + 1);
+            string response;
+            // every client has its own seed so clients call different methods on different apps
+            uint32_t seed = c * 2654435761u + 1;
+            ready++;
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (uint32_t i = c; i < callCount; i += clientCount) {
+                seed = seed * 1103515245u + 12345u;
+                uint32_t pick = (seed >> 8) % totalWeight;
+                size_t m = 0;
+                while (pick >= benchmarkMethods[m].weight) {
+                    pick -= benchmarkMethods[m].weight;
+                    m++;
+                }
+                const std::string method = benchmarkMethods[m].name;
+                const std::string parameters = benchmarkParameters(method, apps[(seed >> 4) % apps.size()]);
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                uint32_t status = handler.Invoke(client.connection, method, parameters, response);
+                durations[c][m].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+                if ((status != Core::ERROR_NONE) || (response.find("\"success\":true") == string::npos)) {
+                    errors[c][m]++;
+                }
+            }
+        }));
+    }
+    while (ready < clientCount) {
+        std::this_thread::yield();
+    }
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    go = true;
+    for (size_t c = 0; c < clients.size(); c++) {
+        clients[c].join();
+    }
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream report;
+    report << "{\"clients\":" << clientCount << ",\"calls\":" << callCount
+           << ",\"wallMs\":" << static_cast<uint64_t>(wallSeconds * 1000)
+           << ",\"callsPerSecond\":" << static_cast<uint64_t>(callCount / wallSeconds) << ",\"methods\":[";
+    uint32_t totalErrors = 0;
+    for (size_t m = 0; m < benchmarkMethodCount; m++) {
+        std::vector<double> all;
+        uint32_t methodErrors = 0;
+        for (uint32_t c = 0; c < clientCount; c++) {
+            all.insert(all.end(), durations[c][m].begin(), durations[c][m].end());
+            methodErrors += errors[c][m];
+        }
+        std::sort(all.begin(), all.end());
+        totalErrors += methodErrors;
+        report << (m ? "," : "") << "{\"method\":\"" << benchmarkMethods[m].name << "\""
+               << ",\"calls\":" << all.size()
+               << ",\"errors\":" << methodErrors
+               << ",\"callsPerSecond\":" << static_cast<uint64_t>(all.size() / wallSeconds)
+               << ",\"p50Us\":" << static_cast<uint64_t>(percentile(all, 0.5))
+               << ",\"p99Us\":" << static_cast<uint64_t>(percentile(all, 0.99))
+               << ",\"p999Us\":" << static_cast<uint64_t>(percentile(all, 0.999))
+               << ",\"maxUs\":" << static_cast<uint64_t>(all.empty() ? 0 : all.back()) << "}";
+    }
+    report << "]}";
+
+    std::cout << report.str() << std::endl;
+    const char* output = getenv("RDKSHELL_BENCHMARK_OUTPUT");
+    if (output != nullptr) {
+        std::ofstream file(output);
+        file << report.str() << std::endl;
+        EXPECT_TRUE(file.good());
+    }
+    EXPECT_EQ(totalErrors, 0u);
+}
+
+#endif /* !USE_THUNDER_R4 */
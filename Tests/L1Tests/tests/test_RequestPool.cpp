@@ -0,0 +1,199 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "RequestPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+// holds a pool thread until opened
+class Gate {
+public:
+    Gate()
+        : mEntered(false)
+        , mOpen(false)
+    {
+    }
+
+    void pass()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mEntered = true;
+        mCondition.notify_all();
+        mCondition.wait(lock, [this]() { return mOpen; });
+    }
+    void waitEntered()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this]() { return mEntered; });
+    }
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOpen = true;
+        mCondition.notify_all();
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mEntered;
+    bool mOpen;
+};
+
+bool waitIdle(Plugin::RequestPool& pool)
+{
+    for (int i = 0; i < 5000; i++) {
+        if (pool.isIdle()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+}
+
+TEST(RequestPoolTest, higherPrioritiesFirst)
+{
+    Plugin::RequestPool pool;
+    pool.start(1, 16);
+    Gate gate;
+    ASSERT_TRUE(pool.submit(Plugin::RequestPool::LOW, "", [&gate]() { gate.pass(); }));
+    gate.waitEntered();
+
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&mutex, &order](const std::string& name) {
+        return [&mutex, &order, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::LOW, "", record("low")));
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::NORMAL, "", record("normal")));
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::HIGH, "", record("high1")));
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::HIGH, "", record("high2")));
+    EXPECT_FALSE(pool.isIdle());
+    gate.open();
+    ASSERT_TRUE(waitIdle(pool));
+
+    const std::vector<std::string> expected = { "high1", "high2", "normal", "low" };
+    EXPECT_EQ(order, expected);
+}
+
+TEST(RequestPoolTest, highRequestsNotHeldUpByLow)
+{
+    Plugin::RequestPool pool;
+    pool.start(2, 16);
+    Gate gate;
+    ASSERT_TRUE(pool.submit(Plugin::RequestPool::LOW, "", [&gate]() { gate.pass(); }));
+    gate.waitEntered();
+
+    // the second thread only runs HIGH requests
+    std::atomic<bool> high(false);
+    std::atomic<bool> normal(false);
+    ASSERT_TRUE(pool.submit(Plugin::RequestPool::NORMAL, "", [&normal]() { normal = true; }));
+    ASSERT_TRUE(pool.submit(Plugin::RequestPool::HIGH, "", [&high]() { high = true; }));
+    for (int i = 0; (i < 5000) && !high; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(high.load());
+    EXPECT_FALSE(normal.load());
+    gate.open();
+    ASSERT_TRUE(waitIdle(pool));
+    EXPECT_TRUE(normal.load());
+}
+
+TEST(RequestPoolTest, boundedQueueAndCancel)
+{
+    Plugin::RequestPool pool;
+    pool.start(1, 3);
+    Gate gate;
+    ASSERT_TRUE(pool.submit(Plugin::RequestPool::NORMAL, "", [&gate]() { gate.pass(); }));
+    gate.waitEntered();
+
+    std::atomic<int> ran(0);
+    std::atomic<int> dropped(0);
+    auto work = [&ran]() { ran++; };
+    auto drop = [&dropped]() { dropped++; };
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::NORMAL, "org.rdk.Netflix", work, drop));
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::LOW, "org.rdk.Netflix", work, drop));
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::NORMAL, "ResidentApp", work, drop));
+    // the running request does not count against the bound
+    EXPECT_FALSE(pool.submit(Plugin::RequestPool::HIGH, "ResidentApp", work, drop));
+
+    EXPECT_EQ(pool.cancel("org.rdk.Netflix"), 2u);
+    EXPECT_EQ(dropped.load(), 2);
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::HIGH, "ResidentApp", work, drop));
+    gate.open();
+    ASSERT_TRUE(waitIdle(pool));
+    EXPECT_EQ(ran.load(), 2);
+
+    JsonObject stats;
+    pool.toJson(stats);
+    EXPECT_EQ(stats["completed"].Number(), 3);
+    EXPECT_EQ(stats["rejected"].Number(), 1);
+    EXPECT_EQ(stats["cancelled"].Number(), 2);
+    EXPECT_EQ(stats["peakQueued"].Number(), 3);
+    EXPECT_EQ(stats["submitted"].Object()["normal"].Number(), 3);
+}
+
+TEST(RequestPoolTest, stopDropsQueuedAndWaitsForRunning)
+{
+    Plugin::RequestPool pool;
+    pool.start(1, 16);
+    Gate gate;
+    std::atomic<bool> finished(false);
+    ASSERT_TRUE(pool.submit(Plugin::RequestPool::NORMAL, "", [&gate, &finished]() {
+        gate.pass();
+        finished = true;
+    }));
+    gate.waitEntered();
+
+    std::atomic<int> ran(0);
+    std::atomic<int> dropped(0);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(pool.submit(Plugin::RequestPool::LOW, "", [&ran]() { ran++; }, [&dropped]() { dropped++; }));
+    }
+    std::thread opener([&gate]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        gate.open();
+    });
+    pool.stop(5000);
+    opener.join();
+    EXPECT_TRUE(finished.load());
+    EXPECT_EQ(ran.load(), 0);
+    EXPECT_EQ(dropped.load(), 4);
+    EXPECT_FALSE(pool.submit(Plugin::RequestPool::HIGH, "", [&ran]() { ran++; }));
+
+    // a stopped pool can be started again
+    pool.start(1, 16);
+    EXPECT_TRUE(pool.submit(Plugin::RequestPool::HIGH, "", [&ran]() { ran++; }));
+    ASSERT_TRUE(waitIdle(pool));
+    EXPECT_EQ(ran.load(), 1);
+}
@@ -0,0 +1,155 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "ResourceTable.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+// apps and their memory as the plugin would report them
+class FakeApps {
+public:
+    void set(const std::string& callsign, int32_t ram)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mApps[callsign] = ram;
+    }
+    void remove(const std::string& callsign)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mApps.erase(callsign);
+    }
+    std::vector<std::string> callsigns()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<std::string> callsigns;
+        for (std::map<std::string, int32_t>::iterator it = mApps.begin(); it != mApps.end(); it++) {
+            callsigns.push_back(it->first);
+        }
+        return callsigns;
+    }
+    int32_t sample(const std::string& callsign)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSamples[callsign]++;
+        return mApps[callsign];
+    }
+    int samples(const std::string& callsign)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSamples[callsign];
+    }
+
+private:
+    std::mutex mMutex;
+    std::map<std::string, int32_t> mApps;
+    std::map<std::string, int> mSamples;
+};
+
+// long enough that only explicit refreshes sample during a test
+const uint32_t INTERVAL_MS = 60000;
+
+bool waitForSample(Plugin::ResourceTable& table, const std::string& callsign, int32_t ram)
+{
+    for (int i = 0; i < 5000; i++) {
+        if (table.residentMemory(callsign) == ram) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+}
+
+TEST(ResourceTableTest, samplesOnStartAndRefresh)
+{
+    FakeApps apps;
+    apps.set("org.rdk.Netflix", 120000);
+    apps.set("ResidentApp", 80000);
+    Plugin::ResourceTable table;
+    EXPECT_EQ(table.residentMemory("org.rdk.Netflix"), -1);
+    table.start(INTERVAL_MS, [&apps]() { return apps.callsigns(); }, [&apps](const std::string& callsign) { return apps.sample(callsign); });
+    ASSERT_TRUE(waitForSample(table, "org.rdk.Netflix", 120000));
+    EXPECT_EQ(table.residentMemory("ResidentApp"), 80000);
+
+    apps.set("org.rdk.Netflix", 150000);
+    apps.remove("ResidentApp");
+    table.refresh();
+    EXPECT_EQ(table.residentMemory("org.rdk.Netflix"), 150000);
+    EXPECT_EQ(table.residentMemory("ResidentApp"), -1);
+
+    // the sampling thread picks up requested refreshes
+    apps.set("org.rdk.YouTube", 90000);
+    table.requestRefresh();
+    ASSERT_TRUE(waitForSample(table, "org.rdk.YouTube", 90000));
+
+    JsonArray entries;
+    table.toJson(entries);
+    ASSERT_EQ(entries.Length(), 2);
+    EXPECT_EQ(entries[0].Object()["callsign"].String(), std::string("org.rdk.Netflix"));
+    EXPECT_EQ(entries[0].Object()["ram"].Number(), 150000);
+
+    table.stop();
+    EXPECT_EQ(table.residentMemory("org.rdk.Netflix"), -1);
+    // nothing is sampled once stopped
+    table.refresh();
+    EXPECT_EQ(table.residentMemory("org.rdk.Netflix"), -1);
+}
+
+TEST(ResourceTableTest, notSampledKeepsLastSample)
+{
+    FakeApps apps;
+    apps.set("org.rdk.Netflix", 120000);
+    std::atomic<bool> suspended(false);
+    Plugin::ResourceTable table;
+    table.start(INTERVAL_MS, [&apps]() { return apps.callsigns(); }, [&apps, &suspended](const std::string& callsign) {
+        if (suspended && (callsign == "org.rdk.Netflix")) {
+            return Plugin::ResourceTable::NOT_SAMPLED;
+        }
+        return apps.sample(callsign);
+    });
+    ASSERT_TRUE(waitForSample(table, "org.rdk.Netflix", 120000));
+    const int samples = apps.samples("org.rdk.Netflix");
+
+    suspended = true;
+    apps.set("org.rdk.Netflix", 10000);
+    apps.set("org.rdk.YouTube", 90000);
+    table.refresh();
+    EXPECT_EQ(table.residentMemory("org.rdk.Netflix"), 120000);
+    EXPECT_EQ(table.residentMemory("org.rdk.YouTube"), 90000);
+    EXPECT_EQ(apps.samples("org.rdk.Netflix"), samples);
+
+    // an app that was never sampled is unknown
+    table.stop();
+    table.start(INTERVAL_MS, [&apps]() { return apps.callsigns(); }, [](const std::string&) { return Plugin::ResourceTable::NOT_SAMPLED; });
+    table.refresh();
+    EXPECT_EQ(table.residentMemory("org.rdk.Netflix"), -1);
+    JsonArray entries;
+    table.toJson(entries);
+    EXPECT_EQ(entries.Length(), 2);
+}
@@ -0,0 +1,659 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "SocketServer.h"
+#include "SharedRing.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Round trip latency and throughput of the out of process RustAdapter transports: TCP on
+// loopback, a unix domain socket, and a unix domain socket with the shared memory rings.
+// The remote side is a minimal WPEHost stand in that answers every invoke with its json.
+// Results are written as JSON, to RUSTADAPTER_BENCHMARK_OUTPUT when set.
+
+namespace {
+
+// command ids and frame layouts of SocketServer.cpp
+const uint32_t kInvoke = 1;
+const uint32_t kAttach = 2;
+const uint32_t kExit = 3;
+const uint32_t kSharedMemory = 4;
+
+class EchoClient {
+public:
+    EchoClient()
+        : mSocket(-1)
+        , mMemory(nullptr)
+        , mMemorySize(0)
+        , mClientBell(-1)
+        , mServerBell(-1)
+        , mInvokes(0)
+    {
+    }
+
+    ~EchoClient()
+    {
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+        if (mMemory != nullptr) {
+            munmap(mMemory, mMemorySize);
+        }
+        for (int fd : { mSocket, mClientBell, mServerBell }) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    bool connectTcp(int port)
+    {
+        mSocket = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        return connect(mSocket, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+    }
+
+    bool connectUnix(const std::string& path, bool sharedMemory)
+    {
+        mSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(mSocket, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            return false;
+        }
+        return !sharedMemory || receiveSharedMemory();
+    }
+
+    void start()
+    {
+        mThread = std::thread(&EchoClient::run, this);
+    }
+
+    uint32_t invokes() const { return mInvokes; }
+
+private:
+    bool receiveSharedMemory()
+    {
+        uint32_t header[2];
+        struct iovec iov = { header, sizeof(header) };
+        int fds[3];
+        char control[CMSG_SPACE(sizeof(fds))];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if ((recvmsg(mSocket, &msg, MSG_WAITALL) != sizeof(header)) || (ntohl(header[0]) != kSharedMemory)) {
+            return false;
+        }
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        if ((cmsg == nullptr) || (cmsg->cmsg_type != SCM_RIGHTS)) {
+            return false;
+        }
+        memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+        const uint32_t capacity = ntohl(header[1]);
+        mMemorySize = 2 * SharedRing::Size(capacity);
+        mMemory = mmap(nullptr, mMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+        close(fds[0]);
+        mClientBell = fds[1];
+        mServerBell = fds[2];
+        if (mMemory == MAP_FAILED) {
+            mMemory = nullptr;
+            return false;
+        }
+        mToClient.Attach(mMemory, capacity);
+        mToServer.Attach((char*)mMemory + SharedRing::Size(capacity), capacity);
+        return true;
+    }
+
+    void ringServer()
+    {
+        uint64_t one = 1;
+        EXPECT_EQ(write(mServerBell, &one, sizeof(one)), (ssize_t)sizeof(one));
+    }
+
+    void waitForBell()
+    {
+        struct pollfd fds[2] = { { mClientBell, POLLIN, 0 }, { mSocket, POLLIN, 0 } };
+        poll(fds, 2, 100);
+        uint64_t count;
+        ssize_t num = read(mClientBell, &count, sizeof(count));
+        (void)num;
+    }
+
+    void send(const std::string& frame)
+    {
+        if (mMemory == nullptr) {
+            size_t offset = 0;
+            while (offset < frame.size()) {
+                ssize_t num = ::send(mSocket, frame.data() + offset, frame.size() - offset, MSG_NOSIGNAL);
+                if (num <= 0) {
+                    return;
+                }
+                offset += num;
+            }
+            return;
+        }
+        size_t offset = 0;
+        while (offset < frame.size()) {
+            bool notify = false;
+            ssize_t num = mToServer.Write(frame.data() + offset, frame.size() - offset, notify);
+            if (num < 0) {
+                return;
+            }
+            if (notify) {
+                ringServer();
+            }
+            offset += num;
+            if ((num == 0) && mToServer.WaitForSpace()) {
+                waitForBell();
+            }
+        }
+    }
+
+    // false once the socket is closed
+    bool receive()
+    {
+        if (mMemory == nullptr) {
+            char chunk[65536];
+            ssize_t num = recv(mSocket, chunk, sizeof(chunk), 0);
+            if (num <= 0) {
+                return false;
+            }
+            mInput.append(chunk, num);
+            return true;
+        }
+        bool notify = false;
+        const ssize_t num = mToClient.Read(mInput, 1 << 20, notify);
+        if (num < 0) {
+            return false;
+        }
+        if (num == 0) {
+            if (mToClient.WaitForData()) {
+                waitForBell();
+                char probe;
+                if (recv(mSocket, &probe, 1, MSG_DONTWAIT | MSG_PEEK) == 0) {
+                    return false;
+                }
+            }
+        }
+        if (notify) {
+            ringServer();
+        }
+        return true;
+    }
+
+    void run()
+    {
+        while (receive()) {
+            size_t offset = 0;
+            while (mInput.size() - offset >= 4) {
+                uint32_t header[4];
+                memcpy(header, mInput.data() + offset, std::min<size_t>(sizeof(header), mInput.size() - offset));
+                const uint32_t command = ntohl(header[0]);
+                if (command == kExit) {
+                    return;
+                }
+                if (command == kAttach) {
+                    if (mInput.size() - offset < 9) {
+                        break;
+                    }
+                    offset += 9;
+                    continue;
+                }
+                ASSERT_EQ(command, kInvoke);
+                if (mInput.size() - offset < sizeof(header)) {
+                    break;
+                }
+                const size_t tokenLength = ntohl(header[2]);
+                const size_t jsonLength = ntohl(header[3]);
+                if (mInput.size() - offset < sizeof(header) + tokenLength + jsonLength) {
+                    break;
+                }
+                uint32_t response[2] = { header[1], header[3] };
+                std::string frame((const char*)response, sizeof(response));
+                frame.append(mInput, offset + sizeof(header) + tokenLength, jsonLength);
+                offset += sizeof(header) + tokenLength + jsonLength;
+                mInvokes++;
+                send(frame);
+            }
+            mInput.erase(0, offset);
+        }
+    }
+
+    int mSocket;
+    void* mMemory;
+    size_t mMemorySize;
+    int mClientBell;
+    int mServerBell;
+    SharedRing mToClient;
+    SharedRing mToServer;
+    std::string mInput;
+    std::atomic<uint32_t> mInvokes;
+    std::thread mThread;
+};
+
+int connectLoopback(int port)
+{
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+std::string responseFrame(uint32_t channel, const std::string& json)
+{
+    uint32_t header[2] = { htonl(channel), htonl((uint32_t)json.size()) };
+    return std::string((const char*)header, sizeof(header)) + json;
+}
+
+template <typename PREDICATE>
+bool waitFor(PREDICATE predicate, int timeoutMs)
+{
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+uint32_t benchmarkSetting(const char* name, uint32_t defaultValue)
+{
+    const char* value = getenv(name);
+    return ((value != nullptr) && (atoi(value) > 0)) ? atoi(value) : defaultValue;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(fraction * sorted.size());
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+struct TransportResult {
+    std::string name;
+    double p50Us;
+    double p99Us;
+    double megabytesPerSecond;
+    uint32_t errors;
+};
+
+std::string payload(size_t size)
+{
+    std::string json = "{\"jsonrpc\":\"2.0\",\"id\":1,\"params\":\"";
+    json.append(size > json.size() + 2 ? size - json.size() - 2 : 0, 'x');
+    json += "\"}";
+    return json;
+}
+
+TransportResult measure(const std::string& transport)
+{
+    const uint32_t roundTrips = benchmarkSetting("RUSTADAPTER_BENCHMARK_ROUND_TRIPS", 2000);
+    const uint32_t largeSize = benchmarkSetting("RUSTADAPTER_BENCHMARK_LARGE_BYTES", 65536);
+    const uint32_t largeCount = benchmarkSetting("RUSTADAPTER_BENCHMARK_LARGE_COUNT", 400);
+    const uint32_t window = 8;
+    const std::string path = "/tmp/RustAdapterBenchmark-" + std::to_string(getpid()) + ".sock";
+
+    TransportResult result = { transport, 0, 0, 0, 0 };
+    std::atomic<uint32_t> received(0);
+    std::atomic<uint32_t> receivedBytes(0);
+    SocketServer server;
+    auto reader = [&received, &receivedBytes](const Response& rsp) {
+        receivedBytes += rsp.json.size();
+        received++;
+    };
+
+    EchoClient client;
+    if (transport == "tcp") {
+        EXPECT_EQ(server.Open("127.0.0.1", 0, reader), 0);
+        EXPECT_EQ(server.RunThread(), 0);
+        EXPECT_TRUE(client.connectTcp(server.GetPort()));
+    } else {
+        server.SetSharedMemory(transport == "shm" ? 1 << 20 : 0);
+        EXPECT_EQ(server.OpenUnix(path, reader), 0);
+        EXPECT_EQ(server.RunThread(), 0);
+        EXPECT_TRUE(client.connectUnix(path, transport == "shm"));
+    }
+    client.start();
+    while (server.GetConnectionStats().empty()) {
+        std::this_thread::yield();
+    }
+
+    // latency, one small invoke at a time
+    const std::string small = payload(128);
+    std::vector<double> latencies;
+    for (uint32_t i = 0; i < roundTrips; i++) {
+        const uint32_t expected = received + 1;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (server.SendInvoke(1, "token", small) != 0) {
+            result.errors++;
+            continue;
+        }
+        while (received < expected) {
+            std::this_thread::yield();
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    result.p50Us = percentile(latencies, 0.5);
+    result.p99Us = percentile(latencies, 0.99);
+
+    // throughput, large invokes with a few in flight
+    const std::string large = payload(largeSize);
+    const uint32_t base = received;
+    const uint32_t baseBytes = receivedBytes;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < largeCount; i++) {
+        while (base + i - received >= window) {
+            std::this_thread::yield();
+        }
+        if (server.SendInvoke(1, "token", large) != 0) {
+            result.errors++;
+        }
+    }
+    while (received < base + largeCount - result.errors) {
+        std::this_thread::yield();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // the payload crosses the transport twice
+    result.megabytesPerSecond = 2.0 * (receivedBytes - baseBytes) / seconds / (1024 * 1024);
+    EXPECT_EQ(receivedBytes - baseBytes, largeCount * large.size());
+
+    std::vector<ConnectionStats> stats = server.GetConnectionStats();
+    EXPECT_EQ(stats.size(), 1u);
+    if (!stats.empty()) {
+        EXPECT_EQ(stats[0].shared_memory, transport == "shm");
+    }
+    EXPECT_EQ(server.SendExit(), 0);
+    server.Close();
+    EXPECT_EQ(client.invokes(), roundTrips + largeCount);
+    return result;
+}
+
+}
+
+TEST(RustAdapterTransport, roundTripBenchmark)
+{
+    std::vector<TransportResult> results;
+    for (const char* transport : { "tcp", "unix", "shm" }) {
+        results.push_back(measure(transport));
+    }
+
+    std::ostringstream report;
+    report << "{\"transports\":[";
+    for (size_t i = 0; i < results.size(); i++) {
+        report << (i ? "," : "") << "{\"transport\":\"" << results[i].name << "\""
+               << ",\"p50Us\":" << static_cast<uint64_t>(results[i].p50Us)
+               << ",\"p99Us\":" << static_cast<uint64_t>(results[i].p99Us)
+               << ",\"megabytesPerSecond\":" << static_cast<uint64_t>(results[i].megabytesPerSecond) << "}";
+        EXPECT_EQ(results[i].errors, 0u);
+    }
+    report << "]}";
+
+    std::cout << report.str() << std::endl;
+    const char* output = getenv("RUSTADAPTER_BENCHMARK_OUTPUT");
+    if (output != nullptr) {
+        std::ofstream file(output);
+        file << report.str() << std::endl;
+        EXPECT_TRUE(file.good());
+    }
+}
+
+// one client writes responses as fast as it can, the invokes of another client are still
+// answered within a turn of the flooding one
+TEST(RustAdapterTransport, floodingClientDoesNotStarveOthers)
+{
+    std::atomic<uint32_t> flooded(0);
+    std::atomic<uint32_t> echoed(0);
+    SocketServer server;
+    ASSERT_EQ(server.Open("127.0.0.1", 0, [&flooded, &echoed](const Response& rsp) {
+        if (rsp.channel_id == 1) {
+            flooded++;
+        } else {
+            echoed++;
+        }
+    }), 0);
+    ASSERT_EQ(server.RunThread(), 0);
+
+    const int flooder = connectLoopback(server.GetPort());
+    ASSERT_GE(flooder, 0);
+    ASSERT_TRUE(waitFor([&server]() { return server.GetConnectionStats().size() == 1; }, 5000));
+    EchoClient echo;
+    ASSERT_TRUE(echo.connectTcp(server.GetPort()));
+    echo.start();
+    ASSERT_TRUE(waitFor([&server]() { return server.GetConnectionStats().size() == 2; }, 5000));
+
+    // a new channel goes to the client with the fewest channels, the first one on a tie
+    EXPECT_EQ(server.SendInvoke(1, "token", payload(64)), 0);
+    EXPECT_EQ(server.SendInvoke(2, "token", payload(64)), 0);
+    ASSERT_TRUE(waitFor([&echoed]() { return echoed == 1; }, 5000));
+
+    std::atomic<bool> flooding(true);
+    std::thread flood([flooder, &flooding]() {
+        std::string frames;
+        for (int i = 0; i < 64; i++) {
+            frames += responseFrame(1, payload(1024));
+        }
+        while (flooding) {
+            if (send(flooder, frames.data(), frames.size(), MSG_NOSIGNAL) <= 0) {
+                break;
+            }
+        }
+    });
+    ASSERT_TRUE(waitFor([&flooded]() { return flooded > 1000; }, 5000));
+
+    const uint32_t roundTrips = 50;
+    double maxLatencyMs = 0;
+    for (uint32_t i = 0; i < roundTrips; i++) {
+        const uint32_t expected = echoed + 1;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        EXPECT_EQ(server.SendInvoke(2, "token", payload(64)), 0);
+        if (!waitFor([&echoed, expected]() { return echoed >= expected; }, 2000)) {
+            ADD_FAILURE() << "invoke " << i << " starved by the flooding client";
+            break;
+        }
+        maxLatencyMs = std::max(maxLatencyMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    const uint32_t floodedDuring = flooded;
+
+    std::vector<ConnectionStats> stats = server.GetConnectionStats();
+    flooding = false;
+    shutdown(flooder, SHUT_RDWR);
+    flood.join();
+    close(flooder);
+
+    std::cout << "echo round trips next to a flooding client: max " << maxLatencyMs << " ms, "
+              << floodedDuring << " flooded responses" << std::endl;
+    EXPECT_EQ(echoed.load(), roundTrips + 1);
+    EXPECT_LT(maxLatencyMs, 500);
+    ASSERT_EQ(stats.size(), 2u);
+    // the flooding client kept using up its budget and gave up its turn
+    EXPECT_GT(stats[0].yields, 0u);
+    EXPECT_EQ(stats[1].responses_read, roundTrips + 1);
+
+    // the echo client stops once its socket is closed
+    server.Close();
+}
+
+// invokes a client has not answered when it disconnects are failed back to the reader
+TEST(RustAdapterTransport, disconnectFailsInFlightInvokes)
+{
+    std::mutex lock;
+    std::vector<Response> responses;
+    SocketServer server;
+    ASSERT_EQ(server.Open("127.0.0.1", 0, [&lock, &responses](const Response& rsp) {
+        std::lock_guard<std::mutex> guard(lock);
+        responses.push_back(rsp);
+    }), 0);
+    ASSERT_EQ(server.RunThread(), 0);
+
+    const int client = connectLoopback(server.GetPort());
+    ASSERT_GE(client, 0);
+    ASSERT_TRUE(waitFor([&server]() { return server.GetConnectionStats().size() == 1; }, 5000));
+
+    EXPECT_EQ(server.SendInvoke(5, "token", "{\"jsonrpc\":\"2.0\",\"id\":7,\"method\":\"a\",\"params\":{\"id\":9}}"), 0);
+    EXPECT_EQ(server.SendInvoke(5, "token", "{\"jsonrpc\":\"2.0\",\"id\":8,\"method\":\"b\"}"), 0);
+    // notifications do not wait for a response
+    EXPECT_EQ(server.SendInvoke(5, "token", "{\"jsonrpc\":\"2.0\",\"method\":\"c\"}"), 0);
+    const std::string answer = responseFrame(5, "{\"jsonrpc\":\"2.0\",\"result\":{\"id\":7},\"id\":8}");
+    EXPECT_EQ(send(client, answer.data(), answer.size(), MSG_NOSIGNAL), (ssize_t)answer.size());
+    ASSERT_TRUE(waitFor([&lock, &responses]() {
+        std::lock_guard<std::mutex> guard(lock);
+        return responses.size() == 1;
+    }, 5000));
+
+    close(client);
+    ASSERT_TRUE(waitFor([&lock, &responses]() {
+        std::lock_guard<std::mutex> guard(lock);
+        return responses.size() == 2;
+    }, 5000));
+    server.Close();
+
+    std::lock_guard<std::mutex> guard(lock);
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_EQ(responses[1].channel_id, 5u);
+    EXPECT_NE(responses[1].json.find("\"id\":7"), std::string::npos);
+    EXPECT_NE(responses[1].json.find("\"error\""), std::string::npos);
+}
+
+// head, tail and capacity in the header are written by the other process and are never trusted
+TEST(RustAdapterTransport, sharedRingRejectsCorruptHeader)
+{
+    const uint32_t capacity = 64;
+    std::vector<char> memory(SharedRing::Size(capacity));
+    SharedRing producer;
+    producer.Init(memory.data(), capacity);
+    SharedRing consumer;
+    consumer.Attach(memory.data(), capacity);
+    SharedRing::Header* header = (SharedRing::Header*)memory.data();
+
+    bool notify = false;
+    std::string out;
+    EXPECT_EQ(producer.Write("0123456789", 10, notify), 10);
+    EXPECT_TRUE(notify);
+    // a capacity the other side wrote is ignored, it would divide by zero
+    header->capacity = 0;
+    EXPECT_EQ(producer.Write("0123456789", 10, notify), 10);
+    EXPECT_EQ(consumer.Read(out, 1 << 20, notify), 20);
+    EXPECT_EQ(out, "01234567890123456789");
+
+    // tail moved past head
+    header->tail = header->head + 1;
+    EXPECT_EQ(producer.Write("0123456789", 10, notify), -1);
+    EXPECT_EQ(consumer.Read(out, 1 << 20, notify), -1);
+    EXPECT_FALSE(producer.WaitForSpace());
+
+    // more readable than the ring holds
+    header->tail = 0;
+    header->head = capacity + 1;
+    EXPECT_EQ(producer.Write("0123456789", 10, notify), -1);
+    EXPECT_EQ(consumer.Read(out, 1 << 20, notify), -1);
+    EXPECT_EQ(out.size(), 20u);
+}
+
+// a client that corrupts the ring it writes to is disconnected
+TEST(RustAdapterTransport, corruptRingClosesConnection)
+{
+    const std::string path = "/tmp/RustAdapterCorruptRing-" + std::to_string(getpid()) + ".sock";
+    std::atomic<uint32_t> received(0);
+    SocketServer server;
+    server.SetSharedMemory(4096);
+    ASSERT_EQ(server.OpenUnix(path, [&received](const Response&) { received++; }), 0);
+    ASSERT_EQ(server.RunThread(), 0);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(connect(sock, (struct sockaddr*)&addr, sizeof(addr)), 0);
+
+    uint32_t header[2];
+    struct iovec iov = { header, sizeof(header) };
+    int fds[3];
+    char control[CMSG_SPACE(sizeof(fds))];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ASSERT_EQ(recvmsg(sock, &msg, MSG_WAITALL), (ssize_t)sizeof(header));
+    memcpy(fds, CMSG_DATA(CMSG_FIRSTHDR(&msg)), sizeof(fds));
+    const uint32_t capacity = ntohl(header[1]);
+    const size_t size = 2 * SharedRing::Size(capacity);
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+    ASSERT_NE(memory, MAP_FAILED);
+    ASSERT_TRUE(waitFor([&server]() { return server.GetConnectionStats().size() == 1; }, 5000));
+
+    SharedRing::Header* toServer = (SharedRing::Header*)((char*)memory + SharedRing::Size(capacity));
+    toServer->head = (uint64_t)capacity * 4;
+    uint64_t one = 1;
+    EXPECT_EQ(write(fds[2], &one, sizeof(one)), (ssize_t)sizeof(one));
+
+    EXPECT_TRUE(waitFor([&server]() { return server.GetConnectionStats().empty(); }, 5000));
+    char probe;
+    EXPECT_EQ(recv(sock, &probe, 1, 0), 0);
+    EXPECT_EQ(received.load(), 0u);
+
+    server.Close();
+    munmap(memory, size);
+    for (int fd : { sock, fds[0], fds[1], fds[2] }) {
+        close(fd);
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "ScreenshotEncoder.h"
+
+#include <stdint.h>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+// every pixel holds its own coordinates so crops can be checked
+std::vector<uint8_t> image(uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> rgba((size_t)width * height * 4);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t* pixel = &rgba[((size_t)y * width + x) * 4];
+            pixel[0] = (uint8_t)x;
+            pixel[1] = (uint8_t)y;
+            pixel[2] = 0;
+            pixel[3] = 255;
+        }
+    }
+    return rgba;
+}
+}
+
+TEST(ScreenshotEncoderTest, cropsRegion)
+{
+    const std::vector<uint8_t> screen = image(64, 32);
+    Plugin::ScreenshotEncoder::Options options;
+    options.regionX = 10;
+    options.regionY = 4;
+    options.regionWidth = 8;
+    options.regionHeight = 100;
+    std::vector<uint8_t> output;
+    uint32_t width = 0, height = 0;
+    ASSERT_TRUE(Plugin::ScreenshotEncoder::transform(&screen[0], 64, 32, options, output, width, height));
+    // the region is clipped to the screen
+    EXPECT_EQ(width, 8u);
+    EXPECT_EQ(height, 28u);
+    ASSERT_EQ(output.size(), 8u * 28u * 4u);
+    EXPECT_EQ(output[0], 10);
+    EXPECT_EQ(output[1], 4);
+    EXPECT_EQ(output[(27 * 8 + 7) * 4], 17);
+    EXPECT_EQ(output[(27 * 8 + 7) * 4 + 1], 31);
+
+    options.regionX = 64;
+    EXPECT_FALSE(Plugin::ScreenshotEncoder::transform(&screen[0], 64, 32, options, output, width, height));
+}
+
+TEST(ScreenshotEncoderTest, scalesKeepingAspectRatio)
+{
+    const std::vector<uint8_t> screen = image(64, 32);
+    std::vector<uint8_t> output;
+    uint32_t width = 0, height = 0;
+
+    Plugin::ScreenshotEncoder::Options widthOnly;
+    widthOnly.width = 16;
+    ASSERT_TRUE(Plugin::ScreenshotEncoder::transform(&screen[0], 64, 32, widthOnly, output, width, height));
+    EXPECT_EQ(width, 16u);
+    EXPECT_EQ(height, 8u);
+    // box filter over the 4x4 pixels of the first output pixel
+    EXPECT_EQ(output[0], 1);
+    EXPECT_EQ(output[1], 1);
+
+    Plugin::ScreenshotEncoder::Options heightOnly;
+    heightOnly.height = 8;
+    heightOnly.regionWidth = 32;
+    ASSERT_TRUE(Plugin::ScreenshotEncoder::transform(&screen[0], 64, 32, heightOnly, output, width, height));
+    EXPECT_EQ(width, 8u);
+    EXPECT_EQ(height, 8u);
+
+    Plugin::ScreenshotEncoder::Options both;
+    both.width = 32;
+    both.height = 4;
+    ASSERT_TRUE(Plugin::ScreenshotEncoder::transform(&screen[0], 64, 32, both, output, width, height));
+    EXPECT_EQ(width, 32u);
+    EXPECT_EQ(height, 4u);
+
+    // never larger than the screen
+    Plugin::ScreenshotEncoder::Options larger;
+    larger.width = 1000;
+    ASSERT_TRUE(Plugin::ScreenshotEncoder::transform(&screen[0], 64, 32, larger, output, width, height));
+    EXPECT_EQ(width, 64u);
+    EXPECT_EQ(height, 32u);
+}
+
+TEST(ScreenshotEncoderTest, formatsAndFileNames)
+{
+    Plugin::ScreenshotEncoder::Format format = Plugin::ScreenshotEncoder::RAW;
+    EXPECT_TRUE(Plugin::ScreenshotEncoder::parseFormat("JPEG", format));
+    EXPECT_EQ(format, Plugin::ScreenshotEncoder::JPEG);
+    EXPECT_FALSE(Plugin::ScreenshotEncoder::parseFormat("gif", format));
+    EXPECT_TRUE(Plugin::ScreenshotEncoder::isFormatSupported(Plugin::ScreenshotEncoder::RAW));
+
+    const std::vector<uint8_t> screen = image(4, 2);
+    std::vector<uint8_t> encoded;
+    ASSERT_TRUE(Plugin::ScreenshotEncoder::encode(screen, 4, 2, Plugin::ScreenshotEncoder::RAW, 0, encoded));
+    EXPECT_EQ(encoded, screen);
+    EXPECT_FALSE(Plugin::ScreenshotEncoder::encode(screen, 4, 4, Plugin::ScreenshotEncoder::RAW, 0, encoded));
+
+    // only these are pruned from the output directory
+    EXPECT_TRUE(Plugin::ScreenshotEncoder::isScreenshotFile("screenshot_1.rgba"));
+    EXPECT_TRUE(Plugin::ScreenshotEncoder::isScreenshotFile("home.png"));
+    EXPECT_TRUE(Plugin::ScreenshotEncoder::isScreenshotFile("home.JPEG"));
+    EXPECT_FALSE(Plugin::ScreenshotEncoder::isScreenshotFile("frames.json"));
+    EXPECT_FALSE(Plugin::ScreenshotEncoder::isScreenshotFile("dump.raw"));
+    EXPECT_FALSE(Plugin::ScreenshotEncoder::isScreenshotFile(".png"));
+    EXPECT_FALSE(Plugin::ScreenshotEncoder::isScreenshotFile("png"));
+}
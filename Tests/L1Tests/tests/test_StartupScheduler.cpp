@@ -0,0 +1,156 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "StartupScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+// stands in for the Thunder controller, records the activations and how many ran at once
+class FakeController {
+public:
+    FakeController() : mActive(0), mPeak(0), mArrived(0) {}
+
+    bool activate(const std::string& callsign, bool succeed)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mActivated.push_back(callsign);
+        return succeed;
+    }
+
+    // returns once count activations are in here at the same time, false if they never are
+    bool activateTogether(const std::string& callsign, int count)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mActivated.push_back(callsign);
+        mArrived++;
+        mCondition.notify_all();
+        return mCondition.wait_for(lock, std::chrono::seconds(5), [this, count]() { return mArrived >= count; });
+    }
+
+    bool activateCounted(const std::string& callsign)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mActive++;
+            mPeak = std::max(mPeak, mActive);
+            mActivated.push_back(callsign);
+        }
+        std::this_thread::yield();
+        std::lock_guard<std::mutex> lock(mMutex);
+        mActive--;
+        return true;
+    }
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    int mActive;
+    int mPeak;
+    int mArrived;
+    std::vector<std::string> mActivated;
+};
+}
+
+TEST(StartupSchedulerTest, dependencies)
+{
+    FakeController controller;
+    Plugin::StartupScheduler scheduler;
+    const char* names[] = { "org.rdk.Display", "org.rdk.Network", "ResidentApp", "org.rdk.Bluetooth", "SearchAndDiscovery" };
+    std::vector<std::string> dependsOn[5];
+    dependsOn[2].push_back("org.rdk.Display");
+    dependsOn[2].push_back("org.rdk.Network");
+    dependsOn[4].push_back("org.rdk.Bluetooth");
+    for (int i = 0; i < 5; i++) {
+        Plugin::StartupScheduler::Entry entry;
+        entry.name = names[i];
+        entry.dependsOn = dependsOn[i];
+        const std::string name = names[i];
+        if (dependsOn[i].empty()) {
+            // the three entries without dependencies only succeed if they run side by side
+            const bool succeed = (name != "org.rdk.Bluetooth");
+            entry.task = [&controller, name, succeed]() { return controller.activateTogether(name, 3) && succeed; };
+        } else {
+            entry.task = [&controller, name]() { return controller.activate(name, true); };
+        }
+        scheduler.add(entry);
+    }
+
+    EXPECT_FALSE(scheduler.run(3));
+    std::vector<Plugin::StartupScheduler::Result> timeline = scheduler.timeline();
+    ASSERT_EQ(timeline.size(), 5u);
+    EXPECT_EQ(timeline[0].state, Plugin::StartupScheduler::SUCCEEDED);
+    EXPECT_EQ(timeline[1].state, Plugin::StartupScheduler::SUCCEEDED);
+    EXPECT_EQ(timeline[2].state, Plugin::StartupScheduler::SUCCEEDED);
+    EXPECT_GE(timeline[2].start, std::max(timeline[0].end, timeline[1].end));
+    EXPECT_EQ(timeline[3].state, Plugin::StartupScheduler::FAILED);
+    EXPECT_EQ(timeline[4].state, Plugin::StartupScheduler::SKIPPED);
+    ASSERT_EQ(controller.mActivated.size(), 4u);
+    // ResidentApp only starts once both of its dependencies are done
+    EXPECT_EQ(controller.mActivated[3], std::string("ResidentApp"));
+}
+
+TEST(StartupSchedulerTest, sequentialWithoutParallelism)
+{
+    FakeController controller;
+    Plugin::StartupScheduler scheduler;
+    const char* names[] = { "first", "second", "third" };
+    for (int i = 0; i < 3; i++) {
+        Plugin::StartupScheduler::Entry entry;
+        entry.name = names[i];
+        const std::string name = names[i];
+        entry.task = [&controller, name]() { return controller.activateCounted(name); };
+        scheduler.add(entry);
+    }
+
+    EXPECT_TRUE(scheduler.run(1));
+    EXPECT_EQ(controller.mPeak, 1);
+    ASSERT_EQ(controller.mActivated.size(), 3u);
+    EXPECT_EQ(controller.mActivated[0], std::string("first"));
+    EXPECT_EQ(controller.mActivated[1], std::string("second"));
+    EXPECT_EQ(controller.mActivated[2], std::string("third"));
+}
+
+TEST(StartupSchedulerTest, clear)
+{
+    FakeController controller;
+    Plugin::StartupScheduler scheduler;
+    Plugin::StartupScheduler::Entry entry;
+    entry.name = "first";
+    entry.task = [&controller]() { return controller.activate("first", true); };
+    scheduler.add(entry);
+    EXPECT_TRUE(scheduler.run(1));
+
+    // a plugin that is initialized again adds its entries again
+    scheduler.clear();
+    EXPECT_TRUE(scheduler.timeline().empty());
+    scheduler.add(entry);
+    EXPECT_TRUE(scheduler.run(1));
+    EXPECT_EQ(scheduler.timeline().size(), 1u);
+    EXPECT_EQ(controller.mActivated.size(), 2u);
+}
@@ -0,0 +1,299 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Module.h"
+
+#include "tptimer.h"
+#include "TimerWheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+int64_t millisecondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// polls instead of sleeping a fixed time so slow machines only make the test slower
+bool waitFor(const std::function<bool()>& condition, int timeoutMs = 5000)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (!condition()) {
+        if (millisecondsSince(start) > timeoutMs) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// the TpTimer this tree had before the wheel: a Core::TimerType, and so a thread, per timer
+class ThreadTpTimer {
+private:
+    class Job {
+    public:
+        Job(ThreadTpTimer* timer)
+            : m_timer(timer)
+        {
+        }
+        Job(const Job& copy)
+            : m_timer(copy.m_timer)
+        {
+        }
+        Job& operator=(const Job&) = delete;
+
+        bool operator==(const Job& RHS) const
+        {
+            return (m_timer == RHS.m_timer);
+        }
+
+        uint64_t Timed(const uint64_t)
+        {
+            m_timer->Timed();
+            return 0;
+        }
+
+    private:
+        ThreadTpTimer* m_timer;
+    };
+
+public:
+    ThreadTpTimer(std::atomic<uint32_t>& fired)
+        : m_baseTimer(64 * 1024, "ThunderPluginBaseTimer")
+        , m_job(this)
+        , m_fired(fired)
+        , m_intervalInMs(0)
+        , m_isActive(false)
+    {
+    }
+    ~ThreadTpTimer()
+    {
+        stop();
+    }
+
+    void start(int msec)
+    {
+        m_intervalInMs = msec;
+        m_isActive = true;
+        m_baseTimer.Revoke(m_job);
+        m_baseTimer.Schedule(Core::Time::Now().Add(m_intervalInMs), m_job);
+    }
+    void stop()
+    {
+        m_isActive = false;
+        m_baseTimer.Revoke(m_job);
+    }
+
+private:
+    void Timed()
+    {
+        m_fired++;
+        if (m_isActive) {
+            m_baseTimer.Schedule(Core::Time::Now().Add(m_intervalInMs), m_job);
+        }
+    }
+
+    Core::TimerType<Job> m_baseTimer;
+    Job m_job;
+    std::atomic<uint32_t>& m_fired;
+    int m_intervalInMs;
+    std::atomic<bool> m_isActive;
+};
+}
+
+TEST(TimerWheelTest, firesCancelsAndRepeats)
+{
+    Plugin::TimerWheel wheel;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<int64_t> shortFired(-1);
+    std::atomic<int64_t> longFired(-1);
+    std::atomic<int> cancelledFired(0);
+    std::atomic<int> repeats(0);
+
+    wheel.schedule("short", 20, 0, [&shortFired, start]() { shortFired = millisecondsSince(start); });
+    // further out than the first level of the wheel, reaches it by cascading
+    wheel.schedule("long", 300, 0, [&longFired, start]() { longFired = millisecondsSince(start); });
+    Plugin::TimerWheel::Handle cancelled = wheel.schedule("cancelled", 50, 0, [&cancelledFired]() { cancelledFired++; });
+    Plugin::TimerWheel::Handle periodic = wheel.schedule("periodic", 10, 0, [&repeats]() { repeats++; }, 10);
+
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled));
+    EXPECT_TRUE(waitFor([&longFired, &repeats]() { return (longFired >= 0) && (repeats >= 3); }));
+    EXPECT_TRUE(wheel.cancel(periodic));
+    const int repeated = repeats.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // timers never fire early, how late they are depends on the machine
+    EXPECT_GE(shortFired.load(), 20);
+    EXPECT_GE(longFired.load(), 300);
+    EXPECT_EQ(cancelledFired.load(), 0);
+    EXPECT_EQ(repeats.load(), repeated);
+
+    std::vector<Plugin::TimerWheel::OwnerStats> stats = wheel.stats();
+    ASSERT_EQ(stats.size(), 4u);
+    for (size_t i = 0; i < stats.size(); i++) {
+        EXPECT_EQ(stats[i].active, 0u);
+        if (stats[i].owner == "cancelled") {
+            EXPECT_EQ(stats[i].cancelled, 1u);
+            EXPECT_EQ(stats[i].fired, 0u);
+        }
+    }
+}
+
+TEST(TimerWheelTest, slackCoalescesWakeups)
+{
+    Plugin::TimerWheel wheel;
+    std::mutex mutex;
+    std::vector<uint32_t> firedOnWakeup;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<int64_t> earliest(INT64_MAX);
+    for (int i = 0; i < 16; i++) {
+        wheel.schedule("slack", 100 + i, 64, [&wheel, &mutex, &firedOnWakeup, &earliest, start]() {
+            const int64_t now = millisecondsSince(start);
+            if (now < earliest) {
+                earliest = now;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            firedOnWakeup.push_back(wheel.wakeups());
+        });
+    }
+    EXPECT_TRUE(waitFor([&mutex, &firedOnWakeup]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return firedOnWakeup.size() == 16;
+    }));
+    // 100..115 ms with 64 ms of slack all round up to 128 ms and fire on the same wakeup
+    EXPECT_GE(earliest.load(), 115);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 1; i < firedOnWakeup.size(); i++) {
+        EXPECT_EQ(firedOnWakeup[i], firedOnWakeup[0]);
+    }
+}
+
+TEST(TimerWheelTest, tpTimer)
+{
+    std::atomic<int> singleShot(0);
+    std::atomic<int> periodic(0);
+    Plugin::TpTimer once("once");
+    once.connect([&singleShot]() { singleShot++; });
+    once.setSingleShot(true);
+    once.start(10);
+    Plugin::TpTimer repeating("repeating");
+    repeating.connect([&periodic]() { periodic++; });
+    repeating.start(10);
+    EXPECT_TRUE(waitFor([&singleShot, &periodic]() { return (singleShot == 1) && (periodic >= 3); }));
+    repeating.stop();
+    const int repeated = periodic.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(once.isActive());
+    EXPECT_FALSE(repeating.isActive());
+    EXPECT_EQ(singleShot.load(), 1);
+    EXPECT_EQ(periodic.load(), repeated);
+}
+
+TEST(TimerWheelTest, tpTimerBlockingCallback)
+{
+    std::atomic<bool> blocked(false);
+    std::atomic<bool> release(false);
+    std::atomic<bool> returned(false);
+    Plugin::TpTimer blocking("blocking");
+    blocking.connect([&blocked, &release, &returned]() {
+        blocked = true;
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        returned = true;
+    });
+    blocking.setSingleShot(true);
+    blocking.start(1);
+    ASSERT_TRUE(waitFor([&blocked]() { return blocked.load(); }));
+
+    // the blocking callback runs on the dispatch thread, the wheel keeps firing
+    std::atomic<int> fired(0);
+    Plugin::TimerWheel::instance().schedule("other", 10, 0, [&fired]() { fired++; });
+    EXPECT_TRUE(waitFor([&fired]() { return fired == 1; }));
+    EXPECT_FALSE(returned.load());
+
+    // stopping waits for the running callback
+    std::thread releaser([&release]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        release = true;
+    });
+    blocking.stop();
+    EXPECT_TRUE(returned.load());
+    releaser.join();
+}
+
+// dozens of short lived timers as seen on devices, on the TpTimer this tree had before the
+// wheel against the current one with a few ms of slack. Prints the numbers, the run time is
+// not asserted on as it depends on the machine.
+TEST(TimerWheelTest, wakeupBenchmark)
+{
+    const int timerCount = 48;
+    const int runMs = 1000;
+    const int slackMs = 8;
+
+    std::atomic<uint32_t> threadFired(0);
+    {
+        std::vector<std::unique_ptr<ThreadTpTimer>> timers;
+        for (int i = 0; i < timerCount; i++) {
+            timers.push_back(std::unique_ptr<ThreadTpTimer>(new ThreadTpTimer(threadFired)));
+            timers.back()->start(20 + (i * 7) % 40);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(runMs));
+        for (size_t i = 0; i < timers.size(); i++) {
+            timers[i]->stop();
+        }
+    }
+
+    std::atomic<uint32_t> wheelFired(0);
+    const uint32_t wakeupsBefore = Plugin::TimerWheel::instance().wakeups();
+    {
+        std::vector<std::unique_ptr<Plugin::TpTimer>> timers;
+        for (int i = 0; i < timerCount; i++) {
+            timers.push_back(std::unique_ptr<Plugin::TpTimer>(new Plugin::TpTimer("benchmark")));
+            timers.back()->connect([&wheelFired]() { wheelFired++; });
+            timers.back()->setSlack(slackMs);
+            timers.back()->start(20 + (i * 7) % 40);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(runMs));
+        for (size_t i = 0; i < timers.size(); i++) {
+            timers[i]->stop();
+        }
+    }
+    const uint32_t wheelWakeups = Plugin::TimerWheel::instance().wakeups() - wakeupsBefore;
+
+    // every callback of the old TpTimer is a wakeup of its own timer thread
+    std::cout << "TpTimer over " << runMs << " ms with " << timerCount << " timers: Core::TimerType "
+              << timerCount << " threads, " << threadFired.load() << " wakeups; timer wheel 2 threads, "
+              << wheelWakeups << " wheel wakeups (" << wheelFired.load() << " callbacks)" << std::endl;
+    EXPECT_GT(threadFired.load(), 0u);
+    EXPECT_GT(wheelFired.load(), 0u);
+}
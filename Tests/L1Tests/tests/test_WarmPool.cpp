@@ -0,0 +1,376 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include "WarmPool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+const char* HISTORY_PATH = "/tmp/rdkshell_test_launch_history";
+
+// the apps as the plugin would report them, prelaunches end right away
+class FakeDevice {
+public:
+    FakeDevice()
+        : mPool(nullptr)
+        , mSamples(0)
+    {
+    }
+    Plugin::WarmPool::Callbacks callbacks(Plugin::WarmPool& pool)
+    {
+        mPool = &pool;
+        Plugin::WarmPool::Callbacks callbacks;
+        callbacks.canPrelaunch = []() { return true; };
+        callbacks.isRunning = [this](const std::string& callsign) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mSamples++;
+            return mRunning.find(callsign) != mRunning.end();
+        };
+        callbacks.residentMemory = [this](const std::string& callsign) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mSamples++;
+            std::map<std::string, int32_t>::iterator it = mRam.find(callsign);
+            return (it == mRam.end()) ? -1 : it->second;
+        };
+        callbacks.prelaunch = [this](const std::string& callsign, const std::string&, uint32_t id) {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mRunning.insert(callsign);
+                mPrelaunched.push_back(callsign);
+            }
+            mPool->endPrelaunch(id, true);
+        };
+        callbacks.release = [this](const std::string& callsign) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRunning.erase(callsign);
+            mReleased.push_back(callsign);
+        };
+        return callbacks;
+    }
+    void setRunning(const std::string& callsign, bool running)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (running) {
+            mRunning.insert(callsign);
+        } else {
+            mRunning.erase(callsign);
+        }
+    }
+    void setRam(const std::string& callsign, int32_t ram)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRam[callsign] = ram;
+    }
+    std::vector<std::string> prelaunched()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPrelaunched;
+    }
+    std::vector<std::string> released()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mReleased;
+    }
+    uint32_t samples()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSamples;
+    }
+
+private:
+    std::mutex mMutex;
+    Plugin::WarmPool* mPool;
+    std::set<std::string> mRunning;
+    std::map<std::string, int32_t> mRam;
+    std::vector<std::string> mPrelaunched;
+    std::vector<std::string> mReleased;
+    uint32_t mSamples;
+};
+
+void writeHistory(const std::string& contents)
+{
+    std::ofstream file(HISTORY_PATH, std::ios::trunc);
+    file << contents;
+}
+
+std::string readHistory()
+{
+    std::ifstream file(HISTORY_PATH);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+Plugin::WarmPool::Config config(uint32_t maxApps, uint32_t memoryBudget)
+{
+    Plugin::WarmPool::Config config;
+    config.enabled = true;
+    config.maxApps = maxApps;
+    config.memoryBudget = memoryBudget;
+    config.idleDelay = 0;
+    config.interval = 10;
+    return config;
+}
+
+bool waitFor(const std::function<bool()>& condition)
+{
+    for (int i = 0; i < 5000; i++) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return condition();
+}
+
+// lets the pool run a few more intervals
+void settle()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+std::string pooled(Plugin::WarmPool& pool)
+{
+    JsonObject status;
+    pool.toJson(status);
+    std::string result;
+    JsonArray apps = status["pooled"].Array();
+    for (int i = 0; i < apps.Length(); i++) {
+        result += (result.empty() ? "" : ",") + apps[i].String();
+    }
+    return result;
+}
+
+class WarmPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        std::remove(HISTORY_PATH);
+    }
+    void TearDown() override
+    {
+        std::remove(HISTORY_PATH);
+    }
+};
+}
+
+TEST_F(WarmPoolTest, prelaunchesMostLaunchedApps)
+{
+    writeHistory("rare Lightning 1 100\nfirst HtmlApp 5 100\nsecond - 3 100\n");
+    FakeDevice device;
+    Plugin::WarmPool pool;
+    pool.configure(config(2, 0));
+    pool.start(HISTORY_PATH, device.callbacks(pool));
+
+    ASSERT_TRUE(waitFor([&]() { return device.prelaunched().size() == 2; }));
+    settle();
+    pool.stop();
+
+    // apps launched once are not worth the memory
+    std::vector<std::string> prelaunched = device.prelaunched();
+    ASSERT_EQ(2u, prelaunched.size());
+    EXPECT_EQ("first", prelaunched[0]);
+    EXPECT_EQ("second", prelaunched[1]);
+}
+
+TEST_F(WarmPoolTest, launchFromPoolIsAHit)
+{
+    writeHistory("app - 2 100\n");
+    FakeDevice device;
+    Plugin::WarmPool pool;
+    pool.configure(config(1, 0));
+    pool.start(HISTORY_PATH, device.callbacks(pool));
+    ASSERT_TRUE(waitFor([&]() { return pooled(pool) == "app"; }));
+
+    EXPECT_TRUE(pool.recordLaunch("app", ""));
+    EXPECT_FALSE(pool.recordLaunch("other", ""));
+    JsonObject status;
+    pool.toJson(status);
+    EXPECT_EQ("1", status["hits"].String());
+    EXPECT_EQ("1", status["misses"].String());
+    EXPECT_EQ("", pooled(pool));
+    pool.stop();
+}
+
+TEST_F(WarmPoolTest, unknownRamCountsAtConservativeDefault)
+{
+    writeHistory("measured - 3 100\nunknown - 5 100\n");
+    FakeDevice device;
+    // the user runs measured once, unknown never ran since the history was loaded
+    device.setRunning("measured", true);
+    device.setRam("measured", 50000);
+    Plugin::WarmPool pool;
+    pool.configure(config(2, 100000));
+    pool.start(HISTORY_PATH, device.callbacks(pool));
+    ASSERT_TRUE(waitFor([&]() { return device.samples() >= 4; }));
+    device.setRunning("measured", false);
+
+    ASSERT_TRUE(waitFor([&]() { return !device.prelaunched().empty(); }));
+    settle();
+    pool.stop();
+
+    // unknown is launched more often but might not fit the budget
+    std::vector<std::string> prelaunched = device.prelaunched();
+    ASSERT_EQ(1u, prelaunched.size());
+    EXPECT_EQ("measured", prelaunched[0]);
+}
+
+TEST_F(WarmPoolTest, releasesAppsOverBudget)
+{
+    writeHistory("first - 5 100\nsecond - 3 100\n");
+    FakeDevice device;
+    device.setRam("first", 40000);
+    device.setRam("second", 40000);
+    device.setRunning("first", true);
+    device.setRunning("second", true);
+    Plugin::WarmPool pool;
+    pool.configure(config(2, 0));
+    pool.start(HISTORY_PATH, device.callbacks(pool));
+    ASSERT_TRUE(waitFor([&]() { return device.samples() >= 4; }));
+    device.setRunning("first", false);
+    device.setRunning("second", false);
+    ASSERT_TRUE(waitFor([&]() { return pooled(pool) == "first,second"; }));
+
+    // the lower ranked app goes once the pool no longer fits
+    Plugin::WarmPool::Config smaller = config(2, 100000);
+    device.setRam("second", 70000);
+    pool.configure(smaller);
+    ASSERT_TRUE(waitFor([&]() { return !device.released().empty(); }));
+    EXPECT_EQ("first", pooled(pool));
+    pool.stop();
+
+    std::vector<std::string> released = device.released();
+    ASSERT_EQ(1u, released.size());
+    EXPECT_EQ("second", released[0]);
+}
+
+TEST_F(WarmPoolTest, disabledPoolReleasesAndStopsSampling)
+{
+    writeHistory("app - 2 100\n");
+    FakeDevice device;
+    Plugin::WarmPool pool;
+    pool.configure(config(1, 0));
+    pool.start(HISTORY_PATH, device.callbacks(pool));
+    ASSERT_TRUE(waitFor([&]() { return pooled(pool) == "app"; }));
+
+    Plugin::WarmPool::Config disabled = config(1, 0);
+    disabled.enabled = false;
+    pool.configure(disabled);
+    ASSERT_TRUE(waitFor([&]() { return device.released().size() == 1; }));
+    settle();
+    uint32_t samples = device.samples();
+    settle();
+    EXPECT_EQ(samples, device.samples());
+    EXPECT_EQ("", pooled(pool));
+    pool.stop();
+}
+
+TEST_F(WarmPoolTest, cancelledPrelaunchIsNotPooled)
+{
+    writeHistory("app - 2 100\n");
+    FakeDevice device;
+    Plugin::WarmPool pool;
+    uint32_t prelaunchId = 0;
+    Plugin::WarmPool::Callbacks callbacks = device.callbacks(pool);
+    std::mutex mutex;
+    // the user launches the app while its prelaunch is running
+    callbacks.prelaunch = [&](const std::string& callsign, const std::string&, uint32_t id) {
+        pool.cancelPrelaunch(callsign);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (prelaunchId == 0) {
+            prelaunchId = id;
+        }
+    };
+    Plugin::WarmPool::Config settings = config(1, 0);
+    pool.configure(settings);
+    pool.start(HISTORY_PATH, callbacks);
+    ASSERT_TRUE(waitFor([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return prelaunchId != 0;
+    }));
+    settings.enabled = false;
+    pool.configure(settings);
+
+    uint32_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = prelaunchId;
+    }
+    EXPECT_FALSE(pool.isPrelaunchCurrent(id));
+    pool.endPrelaunch(id, true);
+    EXPECT_EQ("", pooled(pool));
+    pool.stop();
+}
+
+TEST_F(WarmPoolTest, historyKeepsOnlyLaunches)
+{
+    // older files also have the ram
+    writeHistory("app HtmlApp 2 100 80000\n");
+    FakeDevice device;
+    device.setRunning("app", true);
+    device.setRam("app", 60000);
+    Plugin::WarmPool pool;
+    Plugin::WarmPool::Config settings = config(1, 0);
+    pool.configure(settings);
+    pool.start(HISTORY_PATH, device.callbacks(pool));
+    ASSERT_TRUE(waitFor([&]() { return device.samples() >= 2; }));
+    device.setRam("app", 90000);
+    ASSERT_TRUE(waitFor([&]() { return device.samples() >= 6; }));
+
+    // memory changes do not rewrite the file, launches do
+    EXPECT_EQ("app HtmlApp 2 100 80000\n", readHistory());
+    pool.recordLaunch("app", "");
+    ASSERT_TRUE(waitFor([&]() { return readHistory().find("app HtmlApp 3 ") == 0; }));
+    pool.stop();
+    std::string history = readHistory();
+    EXPECT_EQ(history.size() - 1, history.find('\n'));
+    std::istringstream fields(history);
+    std::string callsign, type, extra;
+    uint32_t count = 0;
+    uint64_t lastLaunch = 0;
+    ASSERT_TRUE(static_cast<bool>(fields >> callsign >> type >> count >> lastLaunch));
+    EXPECT_EQ(3u, count);
+    EXPECT_GT(lastLaunch, 100u);
+    EXPECT_FALSE(static_cast<bool>(fields >> extra));
+
+    // the counts survive a restart
+    Plugin::WarmPool reloaded;
+    reloaded.start(HISTORY_PATH, device.callbacks(reloaded));
+    JsonObject status;
+    reloaded.toJson(status);
+    reloaded.stop();
+    JsonArray apps = status["history"].Array();
+    ASSERT_EQ(1, apps.Length());
+    EXPECT_EQ("app", apps[0].Object()["callsign"].String());
+    EXPECT_EQ("3", apps[0].Object()["launches"].String());
+    EXPECT_EQ("-1", apps[0].Object()["ram"].String());
+}
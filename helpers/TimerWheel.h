@@ -0,0 +1,449 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2024 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace WPEFramework {
+
+namespace Plugin {
+
+    // Runs the timers of every owner in the process on one thread. Timers are kept in a
+    // hierarchical wheel of 1 ms ticks, so scheduling and cancelling are O(1). A timer may
+    // fire up to its slack late: its expiry is rounded up onto a grid of that size so timers
+    // that allow slack share wakeups. Callbacks run on the wheel thread and must not block,
+    // callbacks that may block are handed to the dispatch thread that all such timers share.
+    class TimerWheel {
+    public:
+        typedef uint64_t Handle;
+
+        struct OwnerStats {
+            std::string owner;
+            uint32_t scheduled;
+            uint32_t cancelled;
+            uint32_t fired;
+            uint32_t active;
+            uint64_t totalLateUs;
+            uint64_t maxLateUs;
+        };
+
+        static TimerWheel& instance()
+        {
+            static TimerWheel wheel;
+            return wheel;
+        }
+
+        TimerWheel()
+            : mEpoch(std::chrono::steady_clock::now())
+            , mNext(0)
+            , mPlannedWakeup(UINT64_MAX)
+            , mNextHandle(0)
+            , mRunning(0)
+            , mDispatching(0)
+            , mStop(false)
+            , mWakeups(0)
+        {
+        }
+
+        ~TimerWheel()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStop = true;
+            }
+            mCondition.notify_all();
+            mDispatchCondition.notify_all();
+            if (mThread.joinable()) {
+                mThread.join();
+            }
+            if (mDispatchThread.joinable()) {
+                mDispatchThread.join();
+            }
+        }
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        // intervalMs of 0 fires once, otherwise the timer repeats until cancelled. With blocking
+        // set the callback runs on the dispatch thread, expiries it has not run yet are coalesced.
+        Handle schedule(const std::string& owner, uint32_t delayMs, uint32_t slackMs, const std::function<void()>& callback, uint32_t intervalMs = 0, bool blocking = false)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mTimers.empty() && (mRunning == 0)) {
+                // nothing to cascade, skips the ticks the wheel was idle for
+                const uint64_t now = currentTick();
+                mNext = (now > mNext) ? now : mNext;
+            }
+            std::unique_ptr<Timer> timer(new Timer());
+            timer->handle = ++mNextHandle;
+            timer->owner = owner;
+            timer->requested = currentTick() + delayMs;
+            timer->due = roundUp(timer->requested, slackMs);
+            timer->slack = slackMs;
+            timer->interval = intervalMs;
+            timer->blocking = blocking;
+            timer->callback = callback;
+            timer->slot = nullptr;
+            place(timer.get());
+            const Handle handle = timer->handle;
+            const uint64_t due = timer->due;
+            mTimers[handle] = std::move(timer);
+
+            OwnerStats& stats = ownerStats(owner);
+            stats.scheduled++;
+            stats.active++;
+
+            if (!mThread.joinable()) {
+                mThread = std::thread(&TimerWheel::run, this);
+            } else if (due < mPlannedWakeup) {
+                mCondition.notify_all();
+            }
+            return handle;
+        }
+
+        // false when the timer already fired or was cancelled. Blocks until a running callback of
+        // the timer returns, unless called from that callback, so the caller must not hold a lock
+        // the callback takes or both threads deadlock.
+        bool cancel(Handle handle)
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            bool cancelled = false;
+            std::unordered_map<Handle, std::unique_ptr<Timer>>::iterator timer = mTimers.find(handle);
+            if (timer != mTimers.end()) {
+                if (timer->second->slot != nullptr) {
+                    timer->second->slot->erase(timer->second->position);
+                }
+                OwnerStats& stats = ownerStats(timer->second->owner);
+                stats.cancelled++;
+                stats.active--;
+                mTimers.erase(timer);
+                cancelled = true;
+            }
+            std::deque<Dispatch>::iterator queued = std::find_if(mDispatchQueue.begin(), mDispatchQueue.end(),
+                [handle](const Dispatch& dispatch) { return dispatch.first == handle; });
+            if (queued != mDispatchQueue.end()) {
+                mDispatchQueue.erase(queued);
+                cancelled = true;
+            }
+            while ((handle != 0)
+                && (((mRunning == handle) && (std::this_thread::get_id() != mThread.get_id()))
+                    || ((mDispatching == handle) && (std::this_thread::get_id() != mDispatchThread.get_id())))) {
+                mRunningCondition.wait(lock);
+            }
+            return cancelled;
+        }
+
+        std::vector<OwnerStats> stats()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            std::vector<OwnerStats> owners;
+            for (std::map<std::string, OwnerStats>::const_iterator it = mOwners.begin(); it != mOwners.end(); it++) {
+                owners.push_back(it->second);
+            }
+            return owners;
+        }
+
+        // times the wheel thread woke up, blocking expiries wake the dispatch thread as well
+        uint32_t wakeups()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mWakeups;
+        }
+
+    private:
+        static const int LEVEL_BITS = 6;
+        static const int LEVELS = 4;
+        static const uint64_t SLOTS = 1 << LEVEL_BITS;
+        static const uint64_t SLOT_MASK = SLOTS - 1;
+
+        struct Timer {
+            Handle handle;
+            std::string owner;
+            // ticks are milliseconds since the wheel was created
+            uint64_t requested;
+            uint64_t due;
+            uint32_t slack;
+            uint32_t interval;
+            bool blocking;
+            std::function<void()> callback;
+            // null while the timer is being fired
+            std::list<Timer*>* slot;
+            std::list<Timer*>::iterator position;
+        };
+
+        typedef std::pair<Handle, std::function<void()>> Dispatch;
+
+        static uint64_t roundUp(uint64_t tick, uint32_t slack)
+        {
+            uint64_t grid = 1;
+            while ((grid << 1) <= slack) {
+                grid <<= 1;
+            }
+            return ((tick + grid - 1) / grid) * grid;
+        }
+
+        uint64_t currentTick() const
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mEpoch).count();
+        }
+
+        OwnerStats& ownerStats(const std::string& owner)
+        {
+            std::map<std::string, OwnerStats>::iterator it = mOwners.find(owner);
+            if (it == mOwners.end()) {
+                OwnerStats stats = { owner, 0, 0, 0, 0, 0, 0 };
+                it = mOwners.insert(std::make_pair(owner, stats)).first;
+            }
+            return it->second;
+        }
+
+        // called with mMutex held, mNext is the next tick that is processed
+        void place(Timer* timer)
+        {
+            uint64_t due = (timer->due > mNext) ? timer->due : mNext;
+            int level = 0;
+            while ((level < LEVELS - 1) && ((due - mNext) >> (LEVEL_BITS * (level + 1))) != 0) {
+                level++;
+            }
+            const uint64_t horizon = (uint64_t)1 << (LEVEL_BITS * LEVELS);
+            if (due - mNext >= horizon) {
+                // parked in the last slot of the wheel and placed again when cascaded
+                due = mNext + horizon - 1;
+            }
+            std::list<Timer*>& slot = mSlots[level][(due >> (LEVEL_BITS * level)) & SLOT_MASK];
+            timer->slot = &slot;
+            timer->position = slot.insert(slot.end(), timer);
+        }
+
+        void cascade(int level, uint64_t index)
+        {
+            std::list<Timer*> timers;
+            timers.swap(mSlots[level][index]);
+            for (std::list<Timer*>::iterator it = timers.begin(); it != timers.end(); it++) {
+                place(*it);
+            }
+        }
+
+        // processes tick mNext and collects the timers that expire on it
+        void advance(std::vector<Handle>& expired)
+        {
+            const uint64_t index = mNext & SLOT_MASK;
+            if (index == 0) {
+                for (int level = 1; level < LEVELS; level++) {
+                    const uint64_t levelIndex = (mNext >> (LEVEL_BITS * level)) & SLOT_MASK;
+                    cascade(level, levelIndex);
+                    if (levelIndex != 0) {
+                        break;
+                    }
+                }
+            }
+            std::list<Timer*> timers;
+            timers.swap(mSlots[0][index]);
+            for (std::list<Timer*>::iterator it = timers.begin(); it != timers.end(); it++) {
+                if ((*it)->due > mNext) {
+                    place(*it);
+                    continue;
+                }
+                (*it)->slot = nullptr;
+                expired.push_back((*it)->handle);
+            }
+            mNext++;
+        }
+
+        static uint64_t earliestDue(const std::list<Timer*>& slot)
+        {
+            uint64_t earliest = UINT64_MAX;
+            for (std::list<Timer*>::const_iterator it = slot.begin(); it != slot.end(); it++) {
+                if ((*it)->due < earliest) {
+                    earliest = (*it)->due;
+                }
+            }
+            return earliest;
+        }
+
+        // the first occupied slot of every level bounds the next expiry
+        uint64_t nextExpiry() const
+        {
+            uint64_t next = UINT64_MAX;
+            for (uint64_t i = 0; i < SLOTS; i++) {
+                const std::list<Timer*>& slot = mSlots[0][(mNext + i) & SLOT_MASK];
+                if (!slot.empty()) {
+                    next = earliestDue(slot);
+                    break;
+                }
+            }
+            for (int level = 1; level < LEVELS; level++) {
+                const uint64_t current = (mNext >> (LEVEL_BITS * level)) & SLOT_MASK;
+                // the current slot holds either this block or the next round of the level
+                uint64_t earliest = earliestDue(mSlots[level][current]);
+                for (uint64_t i = 1; i < SLOTS; i++) {
+                    const std::list<Timer*>& slot = mSlots[level][(current + i) & SLOT_MASK];
+                    if (!slot.empty()) {
+                        const uint64_t due = earliestDue(slot);
+                        earliest = (due < earliest) ? due : earliest;
+                        break;
+                    }
+                }
+                next = (earliest < next) ? earliest : next;
+            }
+            return next;
+        }
+
+        void fire(std::unique_lock<std::mutex>& lock, Handle handle)
+        {
+            std::unordered_map<Handle, std::unique_ptr<Timer>>::iterator it = mTimers.find(handle);
+            if (it == mTimers.end()) {
+                // cancelled by a callback that ran before it
+                return;
+            }
+            Timer* timer = it->second.get();
+            const uint64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mEpoch).count();
+            const uint64_t lateUs = (nowUs > timer->requested * 1000) ? nowUs - timer->requested * 1000 : 0;
+            OwnerStats& stats = ownerStats(timer->owner);
+            stats.fired++;
+            stats.totalLateUs += lateUs;
+            stats.maxLateUs = (lateUs > stats.maxLateUs) ? lateUs : stats.maxLateUs;
+
+            std::function<void()> callback = timer->callback;
+            const bool blocking = timer->blocking;
+            if (timer->interval == 0) {
+                stats.active--;
+                mTimers.erase(it);
+            } else {
+                // periodic timers keep their phase unless they fell behind
+                const uint64_t now = currentTick();
+                timer->requested += timer->interval;
+                if (timer->requested <= now) {
+                    timer->requested = now + timer->interval;
+                }
+                timer->due = roundUp(timer->requested, timer->slack);
+                place(timer);
+            }
+            if (blocking) {
+                dispatch(handle, callback);
+                return;
+            }
+            mRunning = handle;
+            lock.unlock();
+            if (callback) {
+                callback();
+            }
+            lock.lock();
+            mRunning = 0;
+            mRunningCondition.notify_all();
+        }
+
+        // called with mMutex held
+        void dispatch(Handle handle, const std::function<void()>& callback)
+        {
+            for (std::deque<Dispatch>::const_iterator it = mDispatchQueue.begin(); it != mDispatchQueue.end(); it++) {
+                if (it->first == handle) {
+                    return;
+                }
+            }
+            mDispatchQueue.push_back(Dispatch(handle, callback));
+            if (!mDispatchThread.joinable()) {
+                mDispatchThread = std::thread(&TimerWheel::runDispatch, this);
+            } else {
+                mDispatchCondition.notify_one();
+            }
+        }
+
+        void runDispatch()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (true) {
+                mDispatchCondition.wait(lock, [this]() { return mStop || !mDispatchQueue.empty(); });
+                if (mStop) {
+                    break;
+                }
+                Dispatch dispatch = mDispatchQueue.front();
+                mDispatchQueue.pop_front();
+                mDispatching = dispatch.first;
+                lock.unlock();
+                if (dispatch.second) {
+                    dispatch.second();
+                }
+                lock.lock();
+                mDispatching = 0;
+                mRunningCondition.notify_all();
+            }
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (!mStop) {
+                const uint64_t now = currentTick();
+                std::vector<Handle> expired;
+                while (mNext <= now) {
+                    advance(expired);
+                }
+                for (size_t i = 0; i < expired.size(); i++) {
+                    fire(lock, expired[i]);
+                }
+                if (!expired.empty()) {
+                    continue;
+                }
+                mPlannedWakeup = nextExpiry();
+                if (mPlannedWakeup == UINT64_MAX) {
+                    mCondition.wait(lock);
+                } else {
+                    mCondition.wait_until(lock, mEpoch + std::chrono::milliseconds(mPlannedWakeup));
+                }
+                mPlannedWakeup = UINT64_MAX;
+                mWakeups++;
+            }
+        }
+
+        const std::chrono::steady_clock::time_point mEpoch;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::condition_variable mRunningCondition;
+        std::condition_variable mDispatchCondition;
+        std::thread mThread;
+        std::thread mDispatchThread;
+        std::deque<Dispatch> mDispatchQueue;
+        std::list<Timer*> mSlots[LEVELS][SLOTS];
+        std::unordered_map<Handle, std::unique_ptr<Timer>> mTimers;
+        std::map<std::string, OwnerStats> mOwners;
+        uint64_t mNext;
+        uint64_t mPlannedWakeup;
+        Handle mNextHandle;
+        Handle mRunning;
+        Handle mDispatching;
+        bool mStop;
+        uint32_t mWakeups;
+    };
+}
+}
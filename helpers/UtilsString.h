@@ -19,6 +19,12 @@
 
 #pragma once
 
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace Utils {
 namespace String {
     // locale-wise comparison
@@ -158,41 +164,109 @@ namespace String {
                                         "abcdefghijklmnopqrstuvwxyz"
                                         "0123456789+/";
 
+#if defined(__SSSE3__)
+    // 12 input bytes -> 16 base64 characters, reads 16 bytes so the caller keeps 4 bytes of slack
+    inline void imageEncoderBlock(const uint8_t* input, char* output)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t0, t1);
+
+        // offsets to add per range: A-Z, a-z, 0-9 (10 entries), '+', '/'
+        const __m128i offsets = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        range = _mm_sub_epi8(range, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range)));
+    }
+    static const uint32_t imageEncoderBlockInput = 12;
+    static const uint32_t imageEncoderBlockRead = 16;
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    // 48 input bytes -> 64 base64 characters
+    inline void imageEncoderBlock(const uint8_t* input, char* output)
+    {
+        const uint8_t* table = reinterpret_cast<const uint8_t*>(base64_chars);
+        uint8x16x4_t lookup;
+        lookup.val[0] = vld1q_u8(table);
+        lookup.val[1] = vld1q_u8(table + 16);
+        lookup.val[2] = vld1q_u8(table + 32);
+        lookup.val[3] = vld1q_u8(table + 48);
+
+        const uint8x16x3_t in = vld3q_u8(input);
+        const uint8x16_t mask = vdupq_n_u8(0x3F);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vorrq_u8(vshrq_n_u8(in.val[1], 4), vandq_u8(vshlq_n_u8(in.val[0], 4), mask));
+        out.val[2] = vorrq_u8(vshrq_n_u8(in.val[2], 6), vandq_u8(vshlq_n_u8(in.val[1], 2), mask));
+        out.val[3] = vandq_u8(in.val[2], mask);
+        out.val[0] = vqtbl4q_u8(lookup, out.val[0]);
+        out.val[1] = vqtbl4q_u8(lookup, out.val[1]);
+        out.val[2] = vqtbl4q_u8(lookup, out.val[2]);
+        out.val[3] = vqtbl4q_u8(lookup, out.val[3]);
+        vst4q_u8(reinterpret_cast<uint8_t*>(output), out);
+    }
+    static const uint32_t imageEncoderBlockInput = 48;
+    static const uint32_t imageEncoderBlockRead = 48;
+#else
+    inline void imageEncoderBlock(const uint8_t* input, char* output)
+    {
+        for (int i = 0; i < 4; i++, input += 3, output += 4) {
+            const uint32_t value = (input[0] << 16) | (input[1] << 8) | input[2];
+            output[0] = base64_chars[(value >> 18) & 0x3F];
+            output[1] = base64_chars[(value >> 12) & 0x3F];
+            output[2] = base64_chars[(value >> 6) & 0x3F];
+            output[3] = base64_chars[value & 0x3F];
+        }
+    }
+    static const uint32_t imageEncoderBlockInput = 12;
+    static const uint32_t imageEncoderBlockRead = 12;
+#endif
 
+    // Appends the base64 encoding of object to result. The output is sized up front and
+    // filled in blocks, which matters for screenshots where the input is several MB.
     inline void imageEncoder(const uint8_t object[], const uint32_t length, const bool padding, string& result)
     {
-        uint8_t state = 0;
-        uint32_t index = 0;
-        uint8_t lastStuff = 0;
-
-        while (index < length) {
-            if (state == 0) {
-                result += base64_chars[((object[index] & 0xFC) >> 2)];
-                lastStuff = ((object[index] & 0x03) << 4);
-                state = 1;
-            } else if (state == 1) {
-                result += base64_chars[(((object[index] & 0xF0) >> 4) | lastStuff)];
-                lastStuff = ((object[index] & 0x0F) << 2);
-                state = 2;
-            } else if (state == 2) {
-                result += base64_chars[(((object[index] & 0xC0) >> 6) | lastStuff)];
-                result += base64_chars[(object[index] & 0x3F)];
-                state = 0;
-            }
-            index++;
+        const uint32_t fullGroups = length / 3;
+        const uint32_t remaining = length % 3;
+        const size_t offset = result.size();
+        size_t encodedLength = fullGroups * 4;
+        if (remaining != 0) {
+            encodedLength += (padding == true) ? 4 : (remaining + 1);
         }
-        if (state != 0) {
-            result += base64_chars[lastStuff];
+        result.resize(offset + encodedLength);
 
+        char* output = &result[offset];
+        uint32_t index = 0;
+        while ((length - index) >= imageEncoderBlockRead) {
+            imageEncoderBlock(&object[index], output);
+            index += imageEncoderBlockInput;
+            output += (imageEncoderBlockInput / 3) * 4;
+        }
+        while ((length - index) >= 3) {
+            const uint32_t value = (object[index] << 16) | (object[index + 1] << 8) | object[index + 2];
+            output[0] = base64_chars[(value >> 18) & 0x3F];
+            output[1] = base64_chars[(value >> 12) & 0x3F];
+            output[2] = base64_chars[(value >> 6) & 0x3F];
+            output[3] = base64_chars[value & 0x3F];
+            output += 4;
+            index += 3;
+        }
+        if (remaining == 1) {
+            *output++ = base64_chars[(object[index] & 0xFC) >> 2];
+            *output++ = base64_chars[(object[index] & 0x03) << 4];
             if (padding == true) {
-                if (state == 1) {
-                    result += _T("==");
-                } else {
-                    result += _T("=");
-                }
+                *output++ = '=';
+                *output++ = '=';
+            }
+        } else if (remaining == 2) {
+            *output++ = base64_chars[(object[index] & 0xFC) >> 2];
+            *output++ = base64_chars[((object[index] & 0x03) << 4) | ((object[index + 1] & 0xF0) >> 4)];
+            *output++ = base64_chars[(object[index + 1] & 0x0F) << 2];
+            if (padding == true) {
+                *output++ = '=';
             }
         }
-
     }
 
 /**
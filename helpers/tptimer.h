@@ -20,55 +20,35 @@
 #ifndef TTIMER_H
 #define TTIMER_H
 
-//#include <core/Timer.h>
 #include <plugins/plugins.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include "TimerWheel.h"
 
 namespace WPEFramework {
 
 namespace Plugin {
+    // Schedules on the process wide TimerWheel instead of running a timer thread per instance.
+    // Callbacks may block, so they run on the wheel's shared dispatch thread, not the wheel thread.
     class TpTimer {
-    private:
-        class TpTimerJob {
-        private:
-            TpTimerJob() = delete;
-            TpTimerJob& operator=(const TpTimerJob& RHS) = delete;
-
-        public:
-            TpTimerJob(TpTimer* tpt)
-                : m_tptimer(tpt)
-            {
-            }
-            TpTimerJob(const TpTimerJob& copy)
-                : m_tptimer(copy.m_tptimer)
-            {
-            }
-            ~TpTimerJob() {}
-
-            inline bool operator==(const TpTimerJob& RHS) const
-            {
-                return (m_tptimer == RHS.m_tptimer);
-            }
-
-        public:
-            uint64_t Timed(const uint64_t scheduledTime)
-            {
-                if (m_tptimer) {
-                    m_tptimer->Timed();
-                }
-                return 0;
-            }
-
-        private:
-            TpTimer* m_tptimer;
-        };
-
     public:
         TpTimer()
-            : baseTimer(64 * 1024, "ThunderPluginBaseTimer")
-            , m_timerJob(this)
+            : m_owner("TpTimer")
+            , m_handle(0)
             , m_isActive(false)
             , m_isSingleShot(false)
             , m_intervalInMs(-1)
+            , m_slackInMs(0)
+        {
+        }
+        explicit TpTimer(const std::string& owner)
+            : m_owner(owner)
+            , m_handle(0)
+            , m_isActive(false)
+            , m_isSingleShot(false)
+            , m_intervalInMs(-1)
+            , m_slackInMs(0)
         {
         }
         ~TpTimer()
@@ -80,16 +60,18 @@ namespace Plugin {
         {
             return m_isActive;
         }
+        // waits for a running callback unless called from it, see TimerWheel::cancel()
         void stop()
         {
-            baseTimer.Revoke(m_timerJob);
+            TimerWheel::instance().cancel(m_handle);
             m_isActive = false;
         }
         void start()
         {
-            baseTimer.Revoke(m_timerJob);
-            baseTimer.Schedule(Core::Time::Now().Add(m_intervalInMs), m_timerJob);
+            TimerWheel::instance().cancel(m_handle);
             m_isActive = true;
+            const uint32_t interval = m_intervalInMs > 0 ? m_intervalInMs : 0;
+            m_handle = TimerWheel::instance().schedule(m_owner, interval, m_slackInMs, std::bind(&TpTimer::Timed, this), m_isSingleShot ? 0 : interval, true);
         }
         void start(int msec)
         {
@@ -104,6 +86,11 @@ namespace Plugin {
         {
             m_intervalInMs = msec;
         }
+        // lets the timer fire up to msec late so its wakeups are shared with other timers
+        void setSlack(int msec)
+        {
+            m_slackInMs = msec > 0 ? msec : 0;
+        }
 
         void connect(std::function<void()> callback)
         {
@@ -113,24 +100,21 @@ namespace Plugin {
     private:
         void Timed()
         {
+            // cleared before the callback so it can start the timer again
+            if (m_isSingleShot) {
+                m_isActive = false;
+            }
             if (onTimeoutCallback != nullptr) {
                 onTimeoutCallback();
             }
-
-            if (m_isActive) {
-                if (m_isSingleShot) {
-                    stop();
-                } else {
-                    start();
-                }
-            }
         }
 
-        WPEFramework::Core::TimerType<TpTimerJob> baseTimer;
-        TpTimerJob m_timerJob;
-        bool m_isActive;
+        std::string m_owner;
+        TimerWheel::Handle m_handle;
+        std::atomic<bool> m_isActive;
         bool m_isSingleShot;
         int m_intervalInMs;
+        int m_slackInMs;
 
         std::function<void()> onTimeoutCallback;
     };